@@ -810,4 +810,93 @@ ret_code_t ble_advertising_advdata_update(ble_advertising_t   * const p_advertis
 }
 
 
+ret_code_t ble_advertising_advdata_slot_find(ble_advertising_t  * const p_advertising,
+                                             uint8_t                    ad_type,
+                                             ble_advdata_slot_t * const p_slot)
+{
+    VERIFY_PARAM_NOT_NULL(p_advertising);
+    if (p_advertising->initialized == false)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    return ble_advdata_slot_find(p_advertising->adv_data.adv_data.p_data,
+                                 p_advertising->adv_data.adv_data.len,
+                                 ad_type,
+                                 p_slot);
+}
+
+
+ret_code_t ble_advertising_advdata_patch(ble_advertising_t        * const p_advertising,
+                                         ble_advdata_slot_t const * const p_slot,
+                                         uint16_t                         offset,
+                                         uint8_t            const * const p_data,
+                                         uint16_t                         len)
+{
+    VERIFY_PARAM_NOT_NULL(p_advertising);
+    if (p_advertising->initialized == false)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    ble_gap_adv_data_t new_adv_data = p_advertising->adv_data;
+
+    // The SoftDevice requires new buffers while advertising, so the data is patched in the swap
+    // buffer. Only the encoded length is copied; nothing is encoded again.
+    new_adv_data.adv_data.p_data =
+        (p_advertising->adv_data.adv_data.p_data != p_advertising->enc_advdata[0]) ?
+         p_advertising->enc_advdata[0] : p_advertising->enc_advdata[1];
+    memcpy(new_adv_data.adv_data.p_data,
+           p_advertising->adv_data.adv_data.p_data,
+           new_adv_data.adv_data.len);
+
+    ret_code_t ret = ble_advdata_slot_write(new_adv_data.adv_data.p_data,
+                                            new_adv_data.adv_data.len,
+                                            p_slot,
+                                            offset,
+                                            p_data,
+                                            len);
+    VERIFY_SUCCESS(ret);
+
+    if (new_adv_data.scan_rsp_data.len > 0)
+    {
+        new_adv_data.scan_rsp_data.p_data =
+            (p_advertising->adv_data.scan_rsp_data.p_data != p_advertising->enc_scan_rsp_data[0]) ?
+             p_advertising->enc_scan_rsp_data[0] : p_advertising->enc_scan_rsp_data[1];
+        memcpy(new_adv_data.scan_rsp_data.p_data,
+               p_advertising->adv_data.scan_rsp_data.p_data,
+               new_adv_data.scan_rsp_data.len);
+    }
+
+    memcpy(&p_advertising->adv_data, &new_adv_data, sizeof(p_advertising->adv_data));
+    p_advertising->p_adv_data = &p_advertising->adv_data;
+
+    return sd_ble_gap_adv_set_configure(&p_advertising->adv_handle,
+                                        p_advertising->p_adv_data,
+                                        NULL);
+}
+
+
+ret_code_t ble_advertising_advdata_uint8_patch(ble_advertising_t        * const p_advertising,
+                                               ble_advdata_slot_t const * const p_slot,
+                                               uint16_t                         offset,
+                                               uint8_t                          value)
+{
+    return ble_advertising_advdata_patch(p_advertising, p_slot, offset, &value, sizeof(value));
+}
+
+
+ret_code_t ble_advertising_advdata_uint16_patch(ble_advertising_t        * const p_advertising,
+                                                ble_advdata_slot_t const * const p_slot,
+                                                uint16_t                         offset,
+                                                uint16_t                         value)
+{
+    uint8_t encoded[sizeof(uint16_t)];
+
+    (void)uint16_encode(value, encoded);
+
+    return ble_advertising_advdata_patch(p_advertising, p_slot, offset, encoded, sizeof(encoded));
+}
+
+
 #endif // NRF_MODULE_ENABLED(BLE_ADVERTISING)
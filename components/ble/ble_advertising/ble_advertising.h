@@ -343,6 +343,73 @@ ret_code_t ble_advertising_advdata_update(ble_advertising_t   * const p_advertis
                                           ble_advdata_t const * const p_advdata,
                                           ble_advdata_t const * const p_srdata);
 
+
+/**@brief   Function for finding a patchable slot in the current advertising data.
+ *
+ * @details The advertising data encoded by @ref ble_advertising_init or
+ *          @ref ble_advertising_advdata_update is used as a template. Find the slot of each
+ *          dynamic field once, then update the field with @ref ble_advertising_advdata_patch
+ *          instead of encoding the whole payload again. The slot stays valid until the
+ *          advertising data is encoded again.
+ *
+ * @param[in]  p_advertising Advertising Module instance.
+ * @param[in]  ad_type       AD type of the field, for example
+ *                           @ref BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA.
+ * @param[out] p_slot        Location of the field in the advertising data.
+ *
+ * @retval @ref NRF_ERROR_NULL          If a NULL pointer was provided.
+ * @retval @ref NRF_ERROR_INVALID_STATE If advertising instance was not initialized.
+ * @retval @ref NRF_SUCCESS or any error from @ref ble_advdata_slot_find.
+ */
+ret_code_t ble_advertising_advdata_slot_find(ble_advertising_t  * const p_advertising,
+                                             uint8_t                    ad_type,
+                                             ble_advdata_slot_t * const p_slot);
+
+
+/**@brief   Function for updating a field of the advertising data in place.
+ *
+ * @details The current advertising data is copied to the swap buffer, the field is updated there,
+ *          and the buffers are handed to the SoftDevice. The update is effective even if
+ *          advertising has already been started. The scan response data is kept.
+ *
+ * @param[in]  p_advertising Advertising Module instance.
+ * @param[in]  p_slot        Slot found with @ref ble_advertising_advdata_slot_find.
+ * @param[in]  offset        Offset within the field.
+ * @param[in]  p_data        New data.
+ * @param[in]  len           Length of \p p_data.
+ *
+ * @retval @ref NRF_ERROR_NULL          If a NULL pointer was provided.
+ * @retval @ref NRF_ERROR_INVALID_STATE If advertising instance was not initialized.
+ * @retval @ref NRF_SUCCESS or any error from @ref ble_advdata_slot_write or
+ *         @ref sd_ble_gap_adv_set_configure().
+ */
+ret_code_t ble_advertising_advdata_patch(ble_advertising_t        * const p_advertising,
+                                         ble_advdata_slot_t const * const p_slot,
+                                         uint16_t                         offset,
+                                         uint8_t            const * const p_data,
+                                         uint16_t                         len);
+
+
+/**@brief   Function for updating a one-octet value in a field of the advertising data.
+ *
+ * @details See @ref ble_advertising_advdata_patch.
+ */
+ret_code_t ble_advertising_advdata_uint8_patch(ble_advertising_t        * const p_advertising,
+                                               ble_advdata_slot_t const * const p_slot,
+                                               uint16_t                         offset,
+                                               uint8_t                          value);
+
+
+/**@brief   Function for updating a two-octet value in a field of the advertising data. The value
+ *          is encoded in little-endian format.
+ *
+ * @details See @ref ble_advertising_advdata_patch.
+ */
+ret_code_t ble_advertising_advdata_uint16_patch(ble_advertising_t        * const p_advertising,
+                                                ble_advdata_slot_t const * const p_slot,
+                                                uint16_t                         offset,
+                                                uint16_t                         value);
+
 /** @} */
 
 
@@ -49,6 +49,7 @@
 NRF_LOG_MODULE_REGISTER();
 
 #define SRV_DISC_START_HANDLE  0x0001                    /**< The start handle value used during service discovery. */
+#define DB_HASH_UUID           0x2B2A                    /**< UUID of the Database Hash characteristic. */
 #define DB_DISCOVERY_MAX_USERS BLE_DB_DISCOVERY_MAX_SRV  /**< The maximum number of users/registrations allowed by this module. */
 #define MODULE_INITIALIZED (m_initialized == true)       /**< Macro designating whether the module has been initialized properly. */
 
@@ -269,6 +270,59 @@ static void discovery_complete_evt_trigger(ble_db_discovery_t * p_db_discovery,
 }
 
 
+/**@brief     Function for adding a request to the GATT queue and counting it.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] p_req          Pointer to the request.
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @return    The error code returned by @ref nrf_ble_gq_item_add.
+ */
+static uint32_t gatt_req_add(ble_db_discovery_t * p_db_discovery,
+                             nrf_ble_gq_req_t   * p_req,
+                             uint16_t             conn_handle)
+{
+    uint32_t err_code = nrf_ble_gq_item_add(mp_gatt_queue, p_req, conn_handle);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        p_db_discovery->req_count++;
+    }
+
+    return err_code;
+}
+
+
+/**@brief     Function for storing the discovered services in the cache and indicating it to the
+ *            application.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void cache_update(ble_db_discovery_t * p_db_discovery,
+                         uint16_t             conn_handle)
+{
+    ble_db_discovery_cache_t * p_cache = p_db_discovery->p_cache;
+    ble_db_discovery_evt_t     evt;
+
+    memcpy(p_cache->services, p_db_discovery->services, sizeof(p_cache->services));
+    memcpy(p_cache->db_hash, p_db_discovery->db_hash, sizeof(p_cache->db_hash));
+    p_cache->entry_count   = m_num_of_handlers_reg;
+    p_cache->db_hash_valid = p_db_discovery->db_hash_valid;
+
+    memset(&evt, 0, sizeof(evt));
+
+    evt.conn_handle    = conn_handle;
+    evt.evt_type       = BLE_DB_DISCOVERY_CACHE_UPDATED;
+    evt.params.p_cache = p_cache;
+
+    if (m_evt_handler)
+    {
+        m_evt_handler(&evt);
+    }
+}
+
+
 /**@brief     Function for handling service discovery completion.
  *
  * @details   This function will be used to determine if there are more services to be discovered,
@@ -316,7 +370,7 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
         db_srv_disc_req.error_handler.p_ctx                = p_db_discovery;
         db_srv_disc_req.error_handler.cb                   = discovery_error_handler;
 
-        err_code = nrf_ble_gq_item_add(mp_gatt_queue, &db_srv_disc_req, conn_handle);
+        err_code = gatt_req_add(p_db_discovery, &db_srv_disc_req, conn_handle);
 
         if (err_code != NRF_SUCCESS)
         {
@@ -330,6 +384,11 @@ static void on_srv_disc_completion(ble_db_discovery_t * p_db_discovery,
         // No more service discovery is needed.
         p_db_discovery->discovery_in_progress  = false;
 
+        if (p_db_discovery->p_cache != NULL)
+        {
+            cache_update(p_db_discovery, conn_handle);
+        }
+
         discovery_available_evt_trigger(p_db_discovery, conn_handle);
     }
 }
@@ -477,7 +536,7 @@ static uint32_t characteristics_discover(ble_db_discovery_t * p_db_discovery,
     db_char_disc_req.error_handler.p_ctx    = p_db_discovery;
     db_char_disc_req.error_handler.cb       = discovery_error_handler;
 
-    return nrf_ble_gq_item_add(mp_gatt_queue, &db_char_disc_req, conn_handle);
+    return gatt_req_add(p_db_discovery, &db_char_disc_req, conn_handle);
 }
 
 
@@ -575,7 +634,7 @@ static uint32_t descriptors_discover(ble_db_discovery_t * p_db_discovery,
     db_desc_disc_req.error_handler.p_ctx    = p_db_discovery;
     db_desc_disc_req.error_handler.cb       = discovery_error_handler;
 
-    return nrf_ble_gq_item_add(mp_gatt_queue, &db_desc_disc_req, conn_handle);
+    return gatt_req_add(p_db_discovery, &db_desc_disc_req, conn_handle);
 }
 
 
@@ -917,14 +976,19 @@ uint32_t ble_db_discovery_evt_register(ble_uuid_t const * p_uuid)
 }
 
 
-static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery, uint16_t conn_handle)
+/**@brief     Function for resetting the DB discovery instance for a new discovery.
+ *
+ * @param[out] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in]  conn_handle    Connection Handle.
+ *
+ * @return     The error code returned by @ref nrf_ble_gq_conn_handle_register.
+ */
+static uint32_t discovery_instance_reset(ble_db_discovery_t * const p_db_discovery,
+                                         uint16_t                   conn_handle)
 {
-    ret_code_t          err_code;
-    ble_gatt_db_srv_t * p_srv_being_discovered;
-    nrf_ble_gq_req_t    db_srv_disc_req;
+    ret_code_t err_code;
 
     memset(p_db_discovery, 0x00, sizeof(ble_db_discovery_t));
-    memset(&db_srv_disc_req, 0x00, sizeof(nrf_ble_gq_req_t));
 
     err_code = nrf_ble_gq_conn_handle_register(mp_gatt_queue, conn_handle);
     VERIFY_SUCCESS(err_code);
@@ -937,6 +1001,25 @@ static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery, uint1
     p_db_discovery->curr_srv_ind      = 0;
     p_db_discovery->curr_char_ind     = 0;
 
+    return NRF_SUCCESS;
+}
+
+
+/**@brief     Function for starting the discovery of the first registered service.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ *
+ * @return    The error code returned by @ref nrf_ble_gq_item_add.
+ */
+static uint32_t srv_discovery_start(ble_db_discovery_t * const p_db_discovery, uint16_t conn_handle)
+{
+    ret_code_t          err_code;
+    ble_gatt_db_srv_t * p_srv_being_discovered;
+    nrf_ble_gq_req_t    db_srv_disc_req;
+
+    memset(&db_srv_disc_req, 0x00, sizeof(nrf_ble_gq_req_t));
+
     p_srv_being_discovered = &(p_db_discovery->services[p_db_discovery->curr_srv_ind]);
     p_srv_being_discovered->srv_uuid = m_registered_handlers[p_db_discovery->curr_srv_ind];
 
@@ -949,7 +1032,7 @@ static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery, uint1
     db_srv_disc_req.error_handler.p_ctx                = p_db_discovery;
     db_srv_disc_req.error_handler.cb                   = discovery_error_handler;
 
-    err_code = nrf_ble_gq_item_add(mp_gatt_queue, &db_srv_disc_req, conn_handle);
+    err_code = gatt_req_add(p_db_discovery, &db_srv_disc_req, conn_handle);
 
     if (err_code == NRF_SUCCESS)
     {
@@ -960,6 +1043,172 @@ static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery, uint1
 }
 
 
+static uint32_t discovery_start(ble_db_discovery_t * const p_db_discovery, uint16_t conn_handle)
+{
+    ret_code_t err_code;
+
+    err_code = discovery_instance_reset(p_db_discovery, conn_handle);
+    VERIFY_SUCCESS(err_code);
+
+    return srv_discovery_start(p_db_discovery, conn_handle);
+}
+
+
+/**@brief     Function for checking whether the cache matches the peer and the registered services.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ *
+ * @retval    True if the services can be taken from the cache.
+ * @retval    False if a full discovery is required.
+ */
+static bool is_cache_valid(ble_db_discovery_t const * p_db_discovery)
+{
+    ble_db_discovery_cache_t const * p_cache = p_db_discovery->p_cache;
+
+    if ((p_cache->entry_count == 0) || (p_cache->entry_count != m_num_of_handlers_reg))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        if (!BLE_UUID_EQ(&(p_cache->services[i].srv_uuid), &(m_registered_handlers[i])))
+        {
+            return false;
+        }
+    }
+
+    if (p_cache->db_hash_valid != p_db_discovery->db_hash_valid)
+    {
+        return false;
+    }
+
+    // A peer without a Database Hash cannot be verified. The application must clear the cache
+    // on Service Changed in that case.
+    return (!p_cache->db_hash_valid
+            || (memcmp(p_cache->db_hash, p_db_discovery->db_hash, sizeof(p_cache->db_hash)) == 0));
+}
+
+
+/**@brief     Function for raising the discovery events with the services from the cache.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void cached_services_apply(ble_db_discovery_t * p_db_discovery,
+                                  uint16_t             conn_handle)
+{
+    ble_db_discovery_cache_t const * p_cache = p_db_discovery->p_cache;
+
+    NRF_LOG_DEBUG("Database Hash unchanged, using cached services on connection handle 0x%x.",
+                  conn_handle);
+
+    p_db_discovery->from_cache = true;
+
+    for (uint32_t i = 0; i < m_num_of_handlers_reg; i++)
+    {
+        bool is_srv_found = (p_cache->services[i].handle_range.start_handle != 0);
+
+        p_db_discovery->services[i] = p_cache->services[i];
+        p_db_discovery->curr_srv_ind = i;
+
+        if (is_srv_found)
+        {
+            p_db_discovery->srv_count++;
+        }
+
+        discovery_complete_evt_trigger(p_db_discovery, is_srv_found, conn_handle);
+    }
+
+    p_db_discovery->discoveries_count     = m_num_of_handlers_reg;
+    p_db_discovery->discovery_in_progress = false;
+
+    discovery_available_evt_trigger(p_db_discovery, conn_handle);
+}
+
+
+/**@brief     Function for continuing the discovery after the Database Hash has been read.
+ *
+ * @param[in] p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in] conn_handle    Connection Handle.
+ */
+static void on_db_hash_read_done(ble_db_discovery_t * p_db_discovery,
+                                 uint16_t             conn_handle)
+{
+    uint32_t err_code;
+
+    p_db_discovery->db_hash_read_pending = false;
+
+    if (is_cache_valid(p_db_discovery))
+    {
+        cached_services_apply(p_db_discovery, conn_handle);
+        return;
+    }
+
+    err_code = srv_discovery_start(p_db_discovery, conn_handle);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        discovery_error_handler(err_code, p_db_discovery, conn_handle);
+    }
+}
+
+
+/**@brief Function for interception of errors of the Database Hash read.
+ *
+ * @details A failed read only means that the cache cannot be verified. The discovery continues
+ *          without it.
+ *
+ * @param[in] nrf_error   Error code.
+ * @param[in] p_ctx       Parameter from the event handler.
+ * @param[in] conn_handle Connection handle.
+ */
+static void db_hash_read_error_handler(uint32_t   nrf_error,
+                                       void     * p_ctx,
+                                       uint16_t   conn_handle)
+{
+    ble_db_discovery_t * p_db_discovery = (ble_db_discovery_t *)p_ctx;
+
+    NRF_LOG_DEBUG("Database Hash read failed with error 0x%x.", nrf_error);
+
+    p_db_discovery->db_hash_valid = false;
+    on_db_hash_read_done(p_db_discovery, conn_handle);
+}
+
+
+/**@brief     Function for handling the response to the Database Hash read.
+ *
+ * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
+ * @param[in] p_ble_gattc_evt   Pointer to the GATT Client event.
+ */
+static void on_db_hash_read_rsp(ble_db_discovery_t       * p_db_discovery,
+                                ble_gattc_evt_t    const * p_ble_gattc_evt)
+{
+    if (   !p_db_discovery->db_hash_read_pending
+        || (p_ble_gattc_evt->conn_handle != p_db_discovery->conn_handle))
+    {
+        return;
+    }
+
+    ble_gattc_evt_char_val_by_uuid_read_rsp_t const * p_val =
+        &(p_ble_gattc_evt->params.char_val_by_uuid_read_rsp);
+
+    if (   (p_ble_gattc_evt->gatt_status == BLE_GATT_STATUS_SUCCESS)
+        && (p_val->count >= 1)
+        && (p_val->value_len == BLE_DB_DISCOVERY_DB_HASH_LEN))
+    {
+        // Each entry in handle_value is the attribute handle followed by the value.
+        memcpy(p_db_discovery->db_hash,
+               &(p_val->handle_value[sizeof(uint16_t)]),
+               BLE_DB_DISCOVERY_DB_HASH_LEN);
+
+        p_db_discovery->db_hash_valid = true;
+    }
+
+    on_db_hash_read_done(p_db_discovery, p_ble_gattc_evt->conn_handle);
+}
+
+
 uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery, uint16_t conn_handle)
 {
     VERIFY_PARAM_NOT_NULL(p_db_discovery);
@@ -980,6 +1229,59 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * const p_db_discovery, uint1
 }
 
 
+uint32_t ble_db_discovery_start_cached(ble_db_discovery_t       * p_db_discovery,
+                                       uint16_t                   conn_handle,
+                                       ble_db_discovery_cache_t * p_cache)
+{
+    ret_code_t       err_code;
+    nrf_ble_gq_req_t db_hash_read_req;
+
+    VERIFY_PARAM_NOT_NULL(p_db_discovery);
+    VERIFY_PARAM_NOT_NULL(p_cache);
+    VERIFY_MODULE_INITIALIZED();
+
+    if (m_num_of_handlers_reg == 0)
+    {
+        // No user modules were registered. There are no services to discover.
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_db_discovery->discovery_in_progress)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    err_code = discovery_instance_reset(p_db_discovery, conn_handle);
+    VERIFY_SUCCESS(err_code);
+
+    p_db_discovery->p_cache = p_cache;
+
+    memset(&db_hash_read_req, 0x00, sizeof(nrf_ble_gq_req_t));
+
+    db_hash_read_req.type                                                = NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID;
+    db_hash_read_req.params.gattc_read_by_uuid.uuid.type                 = BLE_UUID_TYPE_BLE;
+    db_hash_read_req.params.gattc_read_by_uuid.uuid.uuid                 = DB_HASH_UUID;
+    db_hash_read_req.params.gattc_read_by_uuid.handle_range.start_handle = SRV_DISC_START_HANDLE;
+    db_hash_read_req.params.gattc_read_by_uuid.handle_range.end_handle   = BLE_GATT_HANDLE_END;
+    db_hash_read_req.error_handler.p_ctx                                 = p_db_discovery;
+    db_hash_read_req.error_handler.cb                                    = db_hash_read_error_handler;
+
+    // Set before queuing, as the error handler can be called before nrf_ble_gq_item_add returns.
+    p_db_discovery->db_hash_read_pending  = true;
+    p_db_discovery->discovery_in_progress = true;
+
+    err_code = gatt_req_add(p_db_discovery, &db_hash_read_req, conn_handle);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        p_db_discovery->db_hash_read_pending  = false;
+        p_db_discovery->discovery_in_progress = false;
+    }
+
+    return err_code;
+}
+
+
 /**@brief     Function for handling disconnected event.
  *
  * @param[in] p_db_discovery    Pointer to the DB Discovery structure.
@@ -1019,6 +1321,10 @@ void ble_db_discovery_on_ble_evt(ble_evt_t const * p_ble_evt,
             on_descriptor_discovery_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
             break;
 
+        case BLE_GATTC_EVT_CHAR_VAL_BY_UUID_READ_RSP:
+            on_db_hash_read_rsp(p_db_discovery, &(p_ble_evt->evt.gattc_evt));
+            break;
+
         case BLE_GAP_EVT_DISCONNECTED:
             on_disconnected(p_db_discovery, &(p_ble_evt->evt.gap_evt));
             break;
@@ -64,6 +64,10 @@
  * @note The application must propagate BLE stack events to this module by calling
  *       ble_db_discovery_on_ble_evt().
  *
+ * @note To skip the discovery on reconnections to bonded peers, start it with
+ *       @ref ble_db_discovery_start_cached and keep a @ref ble_db_discovery_cache_t for each
+ *       bonded peer in persistent storage.
+ *
  */
 
 #ifndef BLE_DB_DISCOVERY_H__
@@ -124,6 +128,7 @@ NRF_SDH_BLE_OBSERVERS(_name ## _obs,
 #endif //!(defined(__LINT__))
 
 #define BLE_DB_DISCOVERY_MAX_SRV        6   /**< Maximum number of services supported by this module. This also indicates the maximum number of users allowed to be registered to this module (one user per service). */
+#define BLE_DB_DISCOVERY_DB_HASH_LEN    16  /**< Length of the value of the Database Hash characteristic. */
 
 
 /**@brief DB Discovery event type. */
@@ -132,9 +137,29 @@ typedef enum
     BLE_DB_DISCOVERY_COMPLETE,      /**< Event indicating that the discovery of one service is complete. */
     BLE_DB_DISCOVERY_ERROR,         /**< Event indicating that an internal error has occurred in the DB Discovery module. This could typically be because of the SoftDevice API returning an error code during the DB discover.*/
     BLE_DB_DISCOVERY_SRV_NOT_FOUND, /**< Event indicating that the service was not found at the peer.*/
-    BLE_DB_DISCOVERY_AVAILABLE      /**< Event indicating that the DB discovery instance is available.*/
+    BLE_DB_DISCOVERY_AVAILABLE,     /**< Event indicating that the DB discovery instance is available.*/
+    BLE_DB_DISCOVERY_CACHE_UPDATED  /**< Event indicating that a discovery started with @ref ble_db_discovery_start_cached has filled in the cache. The application should store the cache persistently. This event is raised before @ref BLE_DB_DISCOVERY_AVAILABLE. */
 } ble_db_discovery_evt_type_t;
 
+/**@brief Structure for holding the layout of the GATT database at a bonded peer.
+ *
+ * @details The cache is filled in by a discovery started with @ref ble_db_discovery_start_cached.
+ *          On the next connection to the same peer, the Database Hash characteristic of the peer
+ *          is read. If the hash has not changed, the services are taken from the cache instead
+ *          of being discovered.
+ *
+ * @note If the peer has no Database Hash characteristic, the cache is used without
+ *       verification. The application must then clear the cache (set entry_count to 0) when
+ *       the peer indicates Service Changed.
+ */
+typedef struct
+{
+    ble_gatt_db_srv_t services[BLE_DB_DISCOVERY_MAX_SRV];    /**< Registered services, in the order of registration. A zero handle range means that the service was not found at the peer. */
+    uint8_t           entry_count;                           /**< Number of valid entries in services. 0 if the cache is empty. */
+    bool              db_hash_valid;                         /**< Whether db_hash holds the Database Hash of the peer. */
+    uint8_t           db_hash[BLE_DB_DISCOVERY_DB_HASH_LEN]; /**< Database Hash of the peer when the services were discovered. */
+} ble_db_discovery_cache_t;
+
 /**@brief Structure containing the event from the DB discovery module to the application. */
 typedef struct
 {
@@ -145,6 +170,7 @@ typedef struct
         ble_gatt_db_srv_t   discovered_db;  /**< Structure containing the information about the GATT Database at the server. This will be filled when the event type is @ref BLE_DB_DISCOVERY_COMPLETE. The UUID field of this will be filled when the event type is @ref BLE_DB_DISCOVERY_SRV_NOT_FOUND. */
         void const        * p_db_instance;  /**< Pointer to DB discovery instance @ref ble_db_discovery_t, indicating availability to the new discovery process. This will be filled when the event type is @ref BLE_DB_DISCOVERY_AVAILABLE. */
         uint32_t            err_code;       /**< nRF Error code indicating the type of error which occurred in the DB Discovery module. This will be filled when the event type is @ref BLE_DB_DISCOVERY_ERROR. */
+        ble_db_discovery_cache_t const * p_cache; /**< Pointer to the cache that was filled in. This will be filled when the event type is @ref BLE_DB_DISCOVERY_CACHE_UPDATED. */
     } params;
 } ble_db_discovery_evt_t;
 
@@ -176,6 +202,12 @@ typedef struct
     uint16_t                    conn_handle;                                /**< Connection handle on which the discovery is started. */
     uint32_t                    pending_usr_evt_index;                      /**< The index to the pending user event array, pointing to the last added pending user event. */
     ble_db_discovery_user_evt_t pending_usr_evts[BLE_DB_DISCOVERY_MAX_SRV]; /**< Whenever a discovery related event is to be raised to a user module, it is stored in this array first. When all expected services have been discovered, all pending events are sent to the corresponding user modules. */
+    ble_db_discovery_cache_t  * p_cache;                                    /**< Cache of the services at the peer, if the discovery was started with @ref ble_db_discovery_start_cached. */
+    bool                        db_hash_read_pending;                       /**< Variable to indicate whether the read of the Database Hash is in progress. */
+    bool                        db_hash_valid;                              /**< Whether db_hash holds the Database Hash read in this discovery. */
+    uint8_t                     db_hash[BLE_DB_DISCOVERY_DB_HASH_LEN];      /**< Database Hash read in this discovery. */
+    bool                        from_cache;                                 /**< Whether the last discovery took the services from the cache. */
+    uint16_t                    req_count;                                  /**< Number of GATT requests made by the last discovery. Each request is one round trip to the peer. */
 } ble_db_discovery_t;
 
 /**@brief DB discovery module initialization struct. */
@@ -253,6 +285,37 @@ uint32_t ble_db_discovery_start(ble_db_discovery_t * p_db_discovery,
                                 uint16_t             conn_handle);
 
 
+/**@brief Function for starting the discovery of the GATT database at the server, using a cache
+ *        of the services at the peer.
+ *
+ * @details The Database Hash of the peer is read first. If it matches the hash in @p p_cache and
+ *          the cache holds the currently registered services, the discovery events are raised
+ *          with the cached services and no further requests are made. Otherwise, a full
+ *          discovery is made, @p p_cache is filled in, and @ref BLE_DB_DISCOVERY_CACHE_UPDATED
+ *          is raised.
+ *
+ * @param[out]    p_db_discovery Pointer to the DB Discovery structure.
+ * @param[in]     conn_handle    The handle of the connection for which the discovery should be
+ *                               started.
+ * @param[in,out] p_cache        Cache of the services at the peer, loaded from persistent
+ *                               storage, or zero-initialized for an unknown peer. Must stay
+ *                               valid until @ref BLE_DB_DISCOVERY_AVAILABLE is raised.
+ *
+ * @retval NRF_SUCCESS             Operation success.
+ * @retval NRF_ERROR_NULL          When a NULL pointer is passed as input.
+ * @retval NRF_ERROR_INVALID_STATE If this function is called without calling the
+ *                                 @ref ble_db_discovery_init, or without calling
+ *                                 @ref ble_db_discovery_evt_register.
+ * @retval NRF_ERROR_BUSY          If a discovery is already in progress using
+ *                                 @p p_db_discovery.
+ * @return                         This API propagates the error code returned by functions:
+ *                                 @ref nrf_ble_gq_conn_handle_register and @ref nrf_ble_gq_item_add.
+ */
+uint32_t ble_db_discovery_start_cached(ble_db_discovery_t       * p_db_discovery,
+                                       uint16_t                   conn_handle,
+                                       ble_db_discovery_cache_t * p_cache);
+
+
 /**@brief Function for handling the Application's BLE Stack events.
  *
  * @param[in]     p_ble_evt Pointer to the BLE event received.
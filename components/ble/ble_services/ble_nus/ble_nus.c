@@ -60,6 +60,7 @@ NRF_LOG_MODULE_REGISTER();
 
 #define BLE_NUS_MAX_RX_CHAR_LEN        BLE_NUS_MAX_DATA_LEN /**< Maximum length of the RX Characteristic (in bytes). */
 #define BLE_NUS_MAX_TX_CHAR_LEN        BLE_NUS_MAX_DATA_LEN /**< Maximum length of the TX Characteristic (in bytes). */
+#define BLE_NUS_DEFAULT_DATA_LEN       (BLE_GATT_ATT_MTU_DEFAULT - OPCODE_LENGTH - HANDLE_LENGTH) /**< Maximum length of data in one notification before the ATT MTU exchange. */
 
 #define NUS_BASE_UUID                  {{0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E}} /**< Used vendor specific UUID. */
 
@@ -85,6 +86,12 @@ static void on_connect(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
         NRF_LOG_ERROR("Link context for 0x%02X connection handle could not be fetched.",
                       p_ble_evt->evt.gap_evt.conn_handle);
     }
+    else
+    {
+        // The link context may hold the state of a previous connection.
+        memset(&p_client->stream, 0, sizeof(p_client->stream));
+        p_client->max_data_len = BLE_NUS_DEFAULT_DATA_LEN;
+    }
 
     /* Check the hosts CCCD value to inform of readiness to send data using the RX characteristic */
     memset(&gatts_val, 0, sizeof(ble_gatts_value_t));
@@ -116,6 +123,121 @@ static void on_connect(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
 }
 
 
+/**@brief Function for ending a stream and notifying the application.
+ *
+ * @param[in] p_nus       Nordic UART Service structure.
+ * @param[in] conn_handle Connection handle of the stream.
+ * @param[in] p_client    Link context of the stream.
+ * @param[in] status      Status reported in @ref BLE_NUS_EVT_STREAM_DONE.
+ */
+static void stream_end(ble_nus_t                * p_nus,
+                       uint16_t                   conn_handle,
+                       ble_nus_client_context_t * p_client,
+                       uint32_t                   status)
+{
+    ble_nus_evt_t evt;
+
+    memset(&evt, 0, sizeof(ble_nus_evt_t));
+    evt.type                     = BLE_NUS_EVT_STREAM_DONE;
+    evt.p_nus                    = p_nus;
+    evt.conn_handle              = conn_handle;
+    evt.p_link_ctx               = p_client;
+    evt.params.stream.bytes_sent = p_client->stream.bytes_sent;
+    evt.params.stream.status     = status;
+
+    p_client->stream.active = false;
+
+    NRF_LOG_DEBUG("Stream on 0x%02X ended after %d bytes, status 0x%x.",
+                  conn_handle, evt.params.stream.bytes_sent, status);
+
+    if (p_nus->data_handler != NULL)
+    {
+        p_nus->data_handler(&evt);
+    }
+}
+
+
+/**@brief Function for queuing stream data until the SoftDevice runs out of TX buffers.
+ *
+ * @param[in] p_nus       Nordic UART Service structure.
+ * @param[in] conn_handle Connection handle of the stream.
+ * @param[in] p_client    Link context of the stream.
+ *
+ * @retval NRF_SUCCESS If all data has been queued, or if queuing must resume on
+ *                     @ref BLE_GATTS_EVT_HVN_TX_COMPLETE. Otherwise, an error code is returned.
+ */
+static uint32_t stream_pump(ble_nus_t                * p_nus,
+                            uint16_t                   conn_handle,
+                            ble_nus_client_context_t * p_client)
+{
+    ret_code_t               err_code = NRF_SUCCESS;
+    ble_gatts_hvx_params_t   hvx_params;
+    ble_nus_stream_t       * p_stream = &p_client->stream;
+
+    memset(&hvx_params, 0, sizeof(hvx_params));
+
+    hvx_params.handle = p_nus->tx_handles.value_handle;
+    hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+
+    while (!p_stream->all_queued)
+    {
+        if ((p_stream->remaining == 0) && (p_stream->producer != NULL))
+        {
+            p_stream->remaining = p_stream->producer(conn_handle,
+                                                     &p_stream->p_data,
+                                                     p_stream->p_context);
+        }
+
+        if (p_stream->remaining == 0)
+        {
+            p_stream->all_queued = true;
+            break;
+        }
+
+        uint16_t length = (uint16_t)MIN(p_stream->remaining, p_client->max_data_len);
+
+        hvx_params.p_data = p_stream->p_data;
+        hvx_params.p_len  = &length;
+
+        err_code = sd_ble_gatts_hvx(conn_handle, &hvx_params);
+        if (err_code != NRF_SUCCESS)
+        {
+            break;
+        }
+
+        p_stream->p_data     += length;
+        p_stream->remaining  -= length;
+        p_stream->bytes_sent += length;
+        p_stream->tx_pending++;
+    }
+
+    return (err_code == NRF_ERROR_RESOURCES) ? NRF_SUCCESS : err_code;
+}
+
+
+/**@brief Function for continuing a stream, and ending it when done or when an error occurs.
+ *
+ * @param[in] p_nus       Nordic UART Service structure.
+ * @param[in] conn_handle Connection handle of the stream.
+ * @param[in] p_client    Link context of the stream.
+ */
+static void stream_continue(ble_nus_t                * p_nus,
+                            uint16_t                   conn_handle,
+                            ble_nus_client_context_t * p_client)
+{
+    uint32_t err_code = stream_pump(p_nus, conn_handle, p_client);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        stream_end(p_nus, conn_handle, p_client, err_code);
+    }
+    else if (p_client->stream.all_queued && (p_client->stream.tx_pending == 0))
+    {
+        stream_end(p_nus, conn_handle, p_client, NRF_SUCCESS);
+    }
+}
+
+
 /**@brief Function for handling the @ref BLE_GATTS_EVT_WRITE event from the SoftDevice.
  *
  * @param[in] p_nus     Nordic UART Service structure.
@@ -156,6 +278,11 @@ static void on_write(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
             {
                 p_client->is_notification_enabled = false;
                 evt.type                          = BLE_NUS_EVT_COMM_STOPPED;
+
+                if (p_client->stream.active)
+                {
+                    stream_end(p_nus, evt.conn_handle, p_client, NRF_ERROR_INVALID_STATE);
+                }
             }
 
             if (p_nus->data_handler != NULL)
@@ -202,6 +329,15 @@ static void on_hvx_tx_complete(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
         return;
     }
 
+    if (p_client->stream.active)
+    {
+        uint16_t count = p_ble_evt->evt.gatts_evt.params.hvn_tx_complete.count;
+
+        p_client->stream.tx_pending -= MIN(count, p_client->stream.tx_pending);
+        stream_continue(p_nus, p_ble_evt->evt.gatts_evt.conn_handle, p_client);
+        return;
+    }
+
     if ((p_client->is_notification_enabled) && (p_nus->data_handler != NULL))
     {
         memset(&evt, 0, sizeof(ble_nus_evt_t));
@@ -215,6 +351,31 @@ static void on_hvx_tx_complete(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
 }
 
 
+/**@brief Function for handling the @ref BLE_GAP_EVT_DISCONNECTED event from the SoftDevice.
+ *
+ * @param[in] p_nus     Nordic UART Service structure.
+ * @param[in] p_ble_evt Pointer to the event received from BLE stack.
+ */
+static void on_disconnect(ble_nus_t * p_nus, ble_evt_t const * p_ble_evt)
+{
+    ret_code_t                 err_code;
+    ble_nus_client_context_t * p_client;
+
+    err_code = blcm_link_ctx_get(p_nus->p_link_ctx_storage,
+                                 p_ble_evt->evt.gap_evt.conn_handle,
+                                 (void *) &p_client);
+    if (err_code != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    if (p_client->stream.active)
+    {
+        stream_end(p_nus, p_ble_evt->evt.gap_evt.conn_handle, p_client, BLE_ERROR_INVALID_CONN_HANDLE);
+    }
+}
+
+
 void ble_nus_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
 {
     if ((p_context == NULL) || (p_ble_evt == NULL))
@@ -230,6 +391,10 @@ void ble_nus_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
             on_connect(p_nus, p_ble_evt);
             break;
 
+        case BLE_GAP_EVT_DISCONNECTED:
+            on_disconnect(p_nus, p_ble_evt);
+            break;
+
         case BLE_GATTS_EVT_WRITE:
             on_write(p_nus, p_ble_evt);
             break;
@@ -351,4 +516,150 @@ uint32_t ble_nus_data_send(ble_nus_t * p_nus,
 }
 
 
+/**@brief Function for starting a stream from a buffer or a producer.
+ *
+ * @param[in] p_nus       Nordic UART Service structure.
+ * @param[in] conn_handle Connection handle of the destination client.
+ * @param[in] p_data      Data to be sent, or NULL if streaming from a producer.
+ * @param[in] length      Length of the data.
+ * @param[in] producer    Producer of the data, or NULL if streaming a buffer.
+ * @param[in] p_context   Context passed to the producer.
+ */
+static uint32_t stream_start(ble_nus_t               * p_nus,
+                             uint16_t                  conn_handle,
+                             uint8_t const           * p_data,
+                             uint32_t                  length,
+                             ble_nus_stream_producer_t producer,
+                             void                    * p_context)
+{
+    ret_code_t                 err_code;
+    ble_nus_client_context_t * p_client;
+
+    err_code = blcm_link_ctx_get(p_nus->p_link_ctx_storage, conn_handle, (void *) &p_client);
+    VERIFY_SUCCESS(err_code);
+
+    if ((conn_handle == BLE_CONN_HANDLE_INVALID) || (p_client == NULL))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    if (!p_client->is_notification_enabled)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_client->stream.active)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    memset(&p_client->stream, 0, sizeof(p_client->stream));
+
+    p_client->stream.p_data    = p_data;
+    p_client->stream.remaining = length;
+    p_client->stream.producer  = producer;
+    p_client->stream.p_context = p_context;
+    p_client->stream.active    = true;
+
+    err_code = stream_pump(p_nus, conn_handle, p_client);
+    if ((err_code != NRF_SUCCESS) && (p_client->stream.tx_pending == 0))
+    {
+        // Nothing was sent, so the stream did not start.
+        p_client->stream.active = false;
+        return err_code;
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        // Part of the data was queued. Report how much, as for errors later in the stream.
+        stream_end(p_nus, conn_handle, p_client, err_code);
+    }
+    else if (p_client->stream.all_queued && (p_client->stream.tx_pending == 0))
+    {
+        // The producer had no data.
+        stream_end(p_nus, conn_handle, p_client, NRF_SUCCESS);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_nus_stream_start(ble_nus_t     * p_nus,
+                              uint16_t        conn_handle,
+                              uint8_t const * p_data,
+                              uint32_t        length)
+{
+    VERIFY_PARAM_NOT_NULL(p_nus);
+    VERIFY_PARAM_NOT_NULL(p_data);
+
+    if (length == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return stream_start(p_nus, conn_handle, p_data, length, NULL, NULL);
+}
+
+
+uint32_t ble_nus_stream_producer_start(ble_nus_t               * p_nus,
+                                       uint16_t                  conn_handle,
+                                       ble_nus_stream_producer_t producer,
+                                       void                    * p_context)
+{
+    VERIFY_PARAM_NOT_NULL(p_nus);
+    VERIFY_PARAM_NOT_NULL(producer);
+
+    return stream_start(p_nus, conn_handle, NULL, 0, producer, p_context);
+}
+
+
+uint32_t ble_nus_stream_stop(ble_nus_t * p_nus, uint16_t conn_handle)
+{
+    ret_code_t                 err_code;
+    ble_nus_client_context_t * p_client;
+
+    VERIFY_PARAM_NOT_NULL(p_nus);
+
+    err_code = blcm_link_ctx_get(p_nus->p_link_ctx_storage, conn_handle, (void *) &p_client);
+    VERIFY_SUCCESS(err_code);
+
+    if ((conn_handle == BLE_CONN_HANDLE_INVALID) || (p_client == NULL))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    if (!p_client->stream.active)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_client->stream.active = false;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_nus_on_gatt_evt(ble_nus_t * p_nus, nrf_ble_gatt_evt_t const * p_gatt_evt)
+{
+    ret_code_t                 err_code;
+    ble_nus_client_context_t * p_client;
+
+    if ((p_nus == NULL) || (p_gatt_evt->evt_id != NRF_BLE_GATT_EVT_ATT_MTU_UPDATED))
+    {
+        return;
+    }
+
+    err_code = blcm_link_ctx_get(p_nus->p_link_ctx_storage,
+                                 p_gatt_evt->conn_handle,
+                                 (void *) &p_client);
+    if (err_code != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    uint16_t const att_mtu = p_gatt_evt->params.att_mtu_effective;
+
+    p_client->max_data_len = MIN(att_mtu - OPCODE_LENGTH - HANDLE_LENGTH, BLE_NUS_MAX_DATA_LEN);
+}
+
 #endif // NRF_MODULE_ENABLED(BLE_NUS)
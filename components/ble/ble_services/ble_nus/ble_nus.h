@@ -70,6 +70,7 @@
 #include "ble_srv_common.h"
 #include "nrf_sdh_ble.h"
 #include "ble_link_ctx_manager.h"
+#include "nrf_ble_gatt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -115,6 +116,7 @@ typedef enum
     BLE_NUS_EVT_TX_RDY,       /**< Service is ready to accept new data to be transmitted. */
     BLE_NUS_EVT_COMM_STARTED, /**< Notification has been enabled. */
     BLE_NUS_EVT_COMM_STOPPED, /**< Notification has been disabled. */
+    BLE_NUS_EVT_STREAM_DONE,  /**< A stream started with @ref ble_nus_stream_start or @ref ble_nus_stream_producer_start has ended. */
 } ble_nus_evt_type_t;
 
 
@@ -133,13 +135,58 @@ typedef struct
 } ble_nus_evt_rx_data_t;
 
 
+/**@brief   Nordic UART Service @ref BLE_NUS_EVT_STREAM_DONE event data.
+ *
+ * @details This structure is passed to an event when @ref BLE_NUS_EVT_STREAM_DONE occurs.
+ */
+typedef struct
+{
+    uint32_t bytes_sent; /**< Number of bytes queued for transmission during the stream. */
+    uint32_t status;     /**< NRF_SUCCESS if all data has been transmitted, otherwise the error that ended the stream. */
+} ble_nus_evt_stream_t;
+
+
+/**@brief   Stream data producer type.
+ *
+ * @details Called when a stream needs more data. The producer points @p pp_data to the next
+ *          block of data and returns its length. The block is split into notifications by the
+ *          service without being copied, so it must stay valid until the producer is called
+ *          again or the stream ends.
+ *
+ * @param[in]  conn_handle Connection handle of the stream.
+ * @param[out] pp_data     Pointer to the next block of data.
+ * @param[in]  p_context   Context passed to @ref ble_nus_stream_producer_start.
+ *
+ * @return Length of the block, or 0 to end the stream.
+ */
+typedef uint32_t (* ble_nus_stream_producer_t)(uint16_t          conn_handle,
+                                               uint8_t const  ** pp_data,
+                                               void            * p_context);
+
+
+/**@brief   Nordic UART Service stream state. */
+typedef struct
+{
+    uint8_t const           * p_data;     /**< Next byte to be sent. */
+    uint32_t                  remaining;  /**< Number of bytes left at p_data. */
+    ble_nus_stream_producer_t producer;   /**< Producer of more data, or NULL when streaming a single buffer. */
+    void                    * p_context;  /**< Context passed to the producer. */
+    uint32_t                  bytes_sent; /**< Number of bytes queued for transmission so far. */
+    uint16_t                  tx_pending; /**< Number of notifications queued in the SoftDevice and not yet transmitted. */
+    bool                      active;     /**< Whether a stream is ongoing. */
+    bool                      all_queued; /**< Whether all data of the stream has been queued. */
+} ble_nus_stream_t;
+
+
 /**@brief Nordic UART Service client context structure.
  *
  * @details This structure contains state context related to hosts.
  */
 typedef struct
 {
-    bool is_notification_enabled; /**< Variable to indicate if the peer has enabled notification of the RX characteristic.*/
+    bool             is_notification_enabled; /**< Variable to indicate if the peer has enabled notification of the RX characteristic.*/
+    uint16_t         max_data_len;            /**< Maximum length of data in one notification, based on the ATT MTU of the link. */
+    ble_nus_stream_t stream;                  /**< State of the stream to this host. */
 } ble_nus_client_context_t;
 
 
@@ -156,6 +203,7 @@ typedef struct
     union
     {
         ble_nus_evt_rx_data_t rx_data; /**< @ref BLE_NUS_EVT_RX_DATA event data. */
+        ble_nus_evt_stream_t  stream;  /**< @ref BLE_NUS_EVT_STREAM_DONE event data. */
     } params;
 } ble_nus_evt_t;
 
@@ -217,6 +265,17 @@ uint32_t ble_nus_init(ble_nus_t * p_nus, ble_nus_init_t const * p_nus_init);
 void ble_nus_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context);
 
 
+/**@brief   Function for handling the GATT module's events.
+ *
+ * @details Updates the notification size of streams to the negotiated ATT MTU. Call this
+ *          function from the event handler of the GATT module.
+ *
+ * @param[in] p_nus      Nordic UART Service structure.
+ * @param[in] p_gatt_evt Event received from the GATT module.
+ */
+void ble_nus_on_gatt_evt(ble_nus_t * p_nus, nrf_ble_gatt_evt_t const * p_gatt_evt);
+
+
 /**@brief   Function for sending a data to the peer.
  *
  * @details This function sends the input string as an RX characteristic notification to the
@@ -235,6 +294,80 @@ uint32_t ble_nus_data_send(ble_nus_t * p_nus,
                            uint16_t    conn_handle);
 
 
+/**@brief   Function for streaming a buffer to the peer.
+ *
+ * @details The buffer is split into notifications of the largest size the ATT MTU of the link
+ *          allows. Notifications are queued until the SoftDevice runs out of TX buffers, and
+ *          queuing resumes on every @ref BLE_GATTS_EVT_HVN_TX_COMPLETE, so that every connection
+ *          event can be filled. The data is not copied, and the buffer must stay valid until
+ *          @ref BLE_NUS_EVT_STREAM_DONE.
+ *
+ *          @ref BLE_NUS_EVT_TX_RDY is not generated while a stream is ongoing.
+ *
+ *          If an error occurs after part of the data has been queued, the stream ends with
+ *          @ref BLE_NUS_EVT_STREAM_DONE reporting the error, also when it occurs in this function.
+ *
+ * @note    The notification size follows the ATT MTU negotiated by the GATT module, see
+ *          @ref ble_nus_on_gatt_evt. Until then, the default ATT MTU is used.
+ *
+ * @param[in] p_nus       Pointer to the Nordic UART Service structure.
+ * @param[in] conn_handle Connection Handle of the destination client.
+ * @param[in] p_data      Data to be sent.
+ * @param[in] length      Length of the data.
+ *
+ * @retval NRF_SUCCESS             If the stream was started.
+ * @retval NRF_ERROR_NULL          If p_nus or p_data is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM If length is 0.
+ * @retval NRF_ERROR_NOT_FOUND     If there is no client on conn_handle.
+ * @retval NRF_ERROR_INVALID_STATE If the client has not enabled notifications.
+ * @retval NRF_ERROR_BUSY          If a stream is already ongoing to the client.
+ * @return Otherwise, the error returned by @ref sd_ble_gatts_hvx for the first notification.
+ */
+uint32_t ble_nus_stream_start(ble_nus_t     * p_nus,
+                              uint16_t        conn_handle,
+                              uint8_t const * p_data,
+                              uint32_t        length);
+
+
+/**@brief   Function for streaming data from a producer to the peer.
+ *
+ * @details Works like @ref ble_nus_stream_start, except that the data is requested from
+ *          @p producer one block at a time. The stream ends when the producer returns 0.
+ *
+ * @param[in] p_nus       Pointer to the Nordic UART Service structure.
+ * @param[in] conn_handle Connection Handle of the destination client.
+ * @param[in] producer    Function providing the data.
+ * @param[in] p_context   Context passed to the producer.
+ *
+ * @retval NRF_SUCCESS             If the stream was started.
+ * @retval NRF_ERROR_NULL          If p_nus or producer is NULL.
+ * @retval NRF_ERROR_NOT_FOUND     If there is no client on conn_handle.
+ * @retval NRF_ERROR_INVALID_STATE If the client has not enabled notifications.
+ * @retval NRF_ERROR_BUSY          If a stream is already ongoing to the client.
+ * @return Otherwise, the error returned by @ref sd_ble_gatts_hvx for the first notification.
+ */
+uint32_t ble_nus_stream_producer_start(ble_nus_t               * p_nus,
+                                       uint16_t                  conn_handle,
+                                       ble_nus_stream_producer_t producer,
+                                       void                    * p_context);
+
+
+/**@brief   Function for stopping a stream.
+ *
+ * @details Notifications that have already been queued are still transmitted.
+ *          @ref BLE_NUS_EVT_STREAM_DONE is not generated.
+ *
+ * @param[in] p_nus       Pointer to the Nordic UART Service structure.
+ * @param[in] conn_handle Connection Handle of the destination client.
+ *
+ * @retval NRF_SUCCESS             If the stream was stopped.
+ * @retval NRF_ERROR_NULL          If p_nus is NULL.
+ * @retval NRF_ERROR_NOT_FOUND     If there is no client on conn_handle.
+ * @retval NRF_ERROR_INVALID_STATE If no stream is ongoing to the client.
+ */
+uint32_t ble_nus_stream_stop(ble_nus_t * p_nus, uint16_t conn_handle);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -75,7 +75,15 @@ NRF_SDH_BLE_OBSERVER(_name ## _ble_obs,
 #define NRF_BLE_OTS_SIZE_CHAR_LEN       (2*sizeof(uint32_t))
 #define BLE_OTS_FEATURE_LEN             (2*sizeof(uint32_t))
 #define BLE_OTS_NAME_MAX_SIZE           128
+/**@brief Maximum size of an object, in bytes.
+ *
+ * @details The object data is held in RAM in @ref ble_ots_object_t. Define this in sdk_config.h to
+ *          serve larger objects. The value must be at least the size of the L2CAP receive buffer
+ *          (1024 bytes) and must fit in 16 bits, because transfers use 16-bit lengths.
+ */
+#ifndef BLE_OTS_MAX_OBJ_SIZE
 #define BLE_OTS_MAX_OBJ_SIZE            1028
+#endif
 #define BLE_OTS_INVALID_CID             0x0000 /**< Invalid connection ID. */
 #define BLE_OTS_PSM                     0x0025
 #define BLE_OTS_MAX_OACP_SIZE           21
@@ -210,7 +218,8 @@ struct ble_ots_l2cap_s
     ble_l2cap_ch_rx_params_t rx_params;
     ble_l2cap_ch_tx_params_t tx_params;
     uint16_t                 remaining_bytes;       /**< The number of remaining bytes in the current transfer. */
-    uint16_t                 transmitted_bytes;
+    uint16_t                 queued_bytes;          /**< The number of bytes of the current transfer passed to the SoftDevice. */
+    uint16_t                 transmitted_bytes;     /**< The number of bytes of the current transfer sent to the peer. */
     uint16_t                 received_bytes;
     uint16_t                 transfer_len;          /**< The total number of bytes in the current transfer. */
     uint16_t                 local_cid;             /**< Connection ID of the current connection. */
@@ -51,6 +51,8 @@ NRF_LOG_MODULE_REGISTER();
 
 #define SDU_SIZE 1024
 
+STATIC_ASSERT(BLE_OTS_MAX_OBJ_SIZE >= SDU_SIZE);
+STATIC_ASSERT(BLE_OTS_MAX_OBJ_SIZE <= UINT16_MAX);
 
 static uint8_t data[SDU_SIZE];
 static ble_data_t m_sdu_buf =
@@ -133,33 +135,43 @@ static void receive_resume(ble_ots_l2cap_t * p_ots_l2cap)
     }
 }
 
-/**@brief This function sends the next MTU of the object.
+/**@brief This function queues the next SDUs of the object.
+ *
+ * @details SDUs are passed to the SoftDevice until its transmit queue for the channel is full, so
+ *          that the next SDU is already queued when the peer returns credits. The remaining SDUs
+ *          are queued from the BLE_L2CAP_EVT_CH_TX events as the queue drains.
  *
  * @param[in] p_ots_l2cap Object Transfer Service structure.
  */
 static void send_resume(ble_ots_l2cap_t * p_ots_l2cap)
 {
     ret_code_t err_code;
-    uint16_t   tx_size;
-
-    tx_size = MIN(p_ots_l2cap->transfer_len - p_ots_l2cap->transmitted_bytes,
-                  p_ots_l2cap->tx_params.tx_mtu);
-
     ble_data_t obj;
-    obj.p_data = &p_ots_l2cap->tx_transfer_buffer.p_data[p_ots_l2cap->transmitted_bytes];
-    obj.len    = tx_size;
 
-    err_code = sd_ble_l2cap_ch_tx(p_ots_l2cap->p_ots_oacp->p_ots->conn_handle,
-                                  p_ots_l2cap->local_cid,
-                                  &obj);
-    if (err_code == NRF_ERROR_RESOURCES)
+    while (p_ots_l2cap->queued_bytes < p_ots_l2cap->transfer_len)
     {
-        return; // Too many SDUs queued for transmission, the transmission will be tried again on the next BLE_L2CAP_EVT_CH_TX event.
-    }
+        obj.p_data = &p_ots_l2cap->tx_transfer_buffer.p_data[p_ots_l2cap->queued_bytes];
+        obj.len    = MIN(p_ots_l2cap->transfer_len - p_ots_l2cap->queued_bytes,
+                         p_ots_l2cap->tx_params.tx_mtu);
+
+        err_code = sd_ble_l2cap_ch_tx(p_ots_l2cap->p_ots_oacp->p_ots->conn_handle,
+                                      p_ots_l2cap->local_cid,
+                                      &obj);
+        if (err_code == NRF_ERROR_RESOURCES)
+        {
+            return; // Too many SDUs queued for transmission, the transmission will be tried again on the next BLE_L2CAP_EVT_CH_TX event.
+        }
 
-    if (err_code != NRF_SUCCESS && p_ots_l2cap->p_ots_oacp->p_ots->error_handler != NULL)
-    {
-            p_ots_l2cap->p_ots_oacp->p_ots->error_handler(err_code);
+        if (err_code != NRF_SUCCESS)
+        {
+            if (p_ots_l2cap->p_ots_oacp->p_ots->error_handler != NULL)
+            {
+                p_ots_l2cap->p_ots_oacp->p_ots->error_handler(err_code);
+            }
+            return;
+        }
+
+        p_ots_l2cap->queued_bytes += obj.len;
     }
 }
 
@@ -190,6 +202,7 @@ uint32_t ble_ots_l2cap_obj_send(ble_ots_l2cap_t * p_ots_l2cap, uint8_t * p_data,
     p_ots_l2cap->tx_transfer_buffer.p_data = p_data;
     p_ots_l2cap->tx_transfer_buffer.len    = data_len;
 
+    p_ots_l2cap->queued_bytes      = 0;
     p_ots_l2cap->transmitted_bytes = 0;
     p_ots_l2cap->transfer_len      = data_len;
 
@@ -136,6 +136,7 @@ static void ots_l2cap_evt_handler(ble_ots_l2cap_t * p_ots_l2cap, ble_ots_l2cap_e
             break;
         case BLE_OTS_L2CAP_EVT_CH_DISCONNECTED:
             NRF_LOG_INFO("BLE_OTS_L2CAP_EVT_CH_DISCONNECTED.");
+            p_ots_l2cap->p_ots_oacp->p_ots->p_current_object->is_locked = false;
             break;
         case BLE_OTS_L2CAP_EVT_SEND_COMPLETE:
             NRF_LOG_INFO("BLE_OTS_L2CAP_EVT_SEND_COMPLETE.");
@@ -295,7 +296,8 @@ static inline ble_ots_oacp_res_code_t oacp_read_proc(ble_ots_oacp_t * p_ots_oacp
         return BLE_OTS_OACP_RES_CHAN_UNAVAIL;
     }
 
-    if (length + offset > p_ots_oacp->p_ots->p_current_object->current_size)
+    if ((offset > p_ots_oacp->p_ots->p_current_object->current_size) ||
+        (length > p_ots_oacp->p_ots->p_current_object->current_size - offset))
     {
         return BLE_OTS_OACP_RES_INV_PARAM;
     }
@@ -315,12 +317,17 @@ static inline ble_ots_oacp_res_code_t oacp_read_proc(ble_ots_oacp_t * p_ots_oacp
     p_ots_oacp->p_ots->evt_handler(p_ots_oacp->p_ots, &ble_ots_evt);
     
     ret_code_t err_code = ble_ots_l2cap_obj_send(&p_ots_oacp->ots_l2cap,
-                                                 p_ots_oacp->p_ots->p_current_object->data,
-                                                 p_ots_oacp->p_ots->p_current_object->current_size);
+                                                 &p_ots_oacp->p_ots->p_current_object->data[offset],
+                                                 length);
     if (err_code != NRF_SUCCESS)
     {
         NRF_LOG_ERROR("ble_ots_l2cap_obj_send returned error 0x%x", err_code);
+        return BLE_OTS_OACP_RES_OPER_FAILED;
     }
+
+    // The SoftDevice reads the object data until the transfer completes.
+    p_ots_oacp->p_ots->p_current_object->is_locked = true;
+
     return BLE_OTS_OACP_RES_SUCCESS;
 }
 
@@ -653,6 +653,52 @@ uint16_t ble_advdata_search(uint8_t const * p_encoded_data,
 }
 
 
+ret_code_t ble_advdata_slot_find(uint8_t      const * p_encoded_data,
+                                 uint16_t             data_len,
+                                 uint8_t              ad_type,
+                                 ble_advdata_slot_t * p_slot)
+{
+    VERIFY_PARAM_NOT_NULL(p_encoded_data);
+    VERIFY_PARAM_NOT_NULL(p_slot);
+
+    uint16_t offset = 0;
+    uint16_t len    = ble_advdata_search(p_encoded_data, data_len, &offset, ad_type);
+
+    if (len == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    p_slot->offset = offset;
+    p_slot->len    = len;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ble_advdata_slot_write(uint8_t                  * p_encoded_data,
+                                  uint16_t                   data_len,
+                                  ble_advdata_slot_t const * p_slot,
+                                  uint16_t                   offset,
+                                  uint8_t            const * p_data,
+                                  uint16_t                   len)
+{
+    VERIFY_PARAM_NOT_NULL(p_encoded_data);
+    VERIFY_PARAM_NOT_NULL(p_slot);
+    VERIFY_PARAM_NOT_NULL(p_data);
+
+    if (   ((uint32_t)offset + len > p_slot->len)
+        || ((uint32_t)p_slot->offset + p_slot->len > data_len))
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+
+    memcpy(&p_encoded_data[p_slot->offset + offset], p_data, len);
+
+    return NRF_SUCCESS;
+}
+
+
 uint8_t * ble_advdata_parse(uint8_t  * p_encoded_data,
                             uint16_t   data_len,
                             uint8_t    ad_type)
@@ -164,6 +164,18 @@ typedef struct
     ble_gap_lesc_oob_data_t *    p_lesc_data;                         /**< LE Secure Connections OOB data. Included when different from NULL. @warning This field can be used only for NFC. For BLE advertising, set it to NULL.*/
 } ble_advdata_t;
 
+/**@brief Location of the data of one AD structure in encoded Advertising or Scan Response data.
+ *
+ * @details Found once with @ref ble_advdata_slot_find after the data has been encoded. The data
+ *          can then be updated in place with @ref ble_advdata_slot_write, without encoding the
+ *          whole payload again.
+ */
+typedef struct
+{
+    uint16_t                     offset;                              /**< Offset of the data (after the length and AD type octets) in the encoded data. */
+    uint16_t                     len;                                 /**< Length of the data. */
+} ble_advdata_slot_t;
+
 /**@brief Function for encoding data in the Advertising and Scan Response data format (AD structures).
  *
  * @details This function encodes data into the Advertising and Scan Response data format
@@ -228,6 +240,49 @@ uint16_t ble_advdata_search(uint8_t const * p_encoded_data,
                             uint16_t      * p_offset,
                             uint8_t         ad_type);
 
+
+/**@brief Function for finding the slot of the first AD structure of a given type in encoded data.
+ *
+ * @param[in]  p_encoded_data  Data buffer containing the encoded Advertising data.
+ * @param[in]  data_len        Length of the data buffer \p p_encoded_data.
+ * @param[in]  ad_type         Type of data to search for.
+ * @param[out] p_slot          Location of the data of the AD structure.
+ *
+ * @retval NRF_SUCCESS         If the AD structure was found.
+ * @retval NRF_ERROR_NULL      If \p p_encoded_data or \p p_slot was NULL.
+ * @retval NRF_ERROR_NOT_FOUND If no AD structure of type \p ad_type was found.
+ */
+ret_code_t ble_advdata_slot_find(uint8_t      const * p_encoded_data,
+                                 uint16_t             data_len,
+                                 uint8_t              ad_type,
+                                 ble_advdata_slot_t * p_slot);
+
+
+/**@brief Function for updating part of the data of an AD structure in place.
+ *
+ * @details The length and type of the AD structure are not changed, so the rest of the encoded
+ *          data stays valid.
+ *
+ * @param[in,out] p_encoded_data Data buffer containing the encoded Advertising data.
+ * @param[in]     data_len       Length of the data buffer \p p_encoded_data.
+ * @param[in]     p_slot         Slot found with @ref ble_advdata_slot_find.
+ * @param[in]     offset         Offset within the data of the AD structure. For Manufacturer
+ *                               Specific Data, the Company Identifier is at offset 0.
+ * @param[in]     p_data         New data.
+ * @param[in]     len            Length of \p p_data.
+ *
+ * @retval NRF_SUCCESS         If the data was updated.
+ * @retval NRF_ERROR_NULL      If a NULL pointer was provided.
+ * @retval NRF_ERROR_DATA_SIZE If the new data does not fit in the slot, or the slot does not fit
+ *                             in \p p_encoded_data.
+ */
+ret_code_t ble_advdata_slot_write(uint8_t                  * p_encoded_data,
+                                  uint16_t                   data_len,
+                                  ble_advdata_slot_t const * p_slot,
+                                  uint16_t                   offset,
+                                  uint8_t            const * p_data,
+                                  uint16_t                   len);
+
 /**@brief Function for getting specific data from encoded Advertising or Scan Response data.
  *
  * @details This function searches through encoded data e.g. the data produced by
@@ -52,6 +52,10 @@
 #define DEFAULT_FLAG_COLLECTION_COUNT 6                                /**< The number of flags kept for each connection, excluding user flags. */
 #define TOTAL_FLAG_COLLECTION_COUNT (DEFAULT_FLAG_COLLECTION_COUNT \
                                    + BLE_CONN_STATE_USER_FLAG_COUNT)   /**< The number of flags kept for each connection, including user flags. */
+#define CONN_FLAGS_MASK (0xFFFFFFFFUL >> (NRF_ATFLAGS_FLAGS_PER_ELEMENT \
+                                   - BLE_CONN_STATE_MAX_CONNECTIONS))  /**< Mask of the flags that correspond to a connection handle. */
+
+STATIC_ASSERT(BLE_CONN_STATE_MAX_CONNECTIONS <= NRF_ATFLAGS_FLAGS_PER_ELEMENT);
 
 /**@brief Structure containing all the flag collections maintained by the Connection State module.
  */
@@ -79,6 +83,8 @@ typedef struct
         ble_conn_state_flag_collections_t flags;                                   /**< Flag collections kept by the Connection State module. */
         nrf_atflags_t                     flag_array[TOTAL_FLAG_COLLECTION_COUNT]; /**< Flag collections as array to allow iterating over all flag collections. */
     };
+    uint8_t conn_count;         /**< Number of flags set in connected_flags. Only updated from @ref ble_evt_handler. */
+    uint8_t central_conn_count; /**< Number of flags set in both connected_flags and central_flags. Only updated from @ref ble_evt_handler. */
 } ble_conn_state_t;
 
 ANON_UNIONS_DISABLE;
@@ -95,20 +101,30 @@ void bcs_internal_state_reset(void)
 }
 
 
+/**@brief Function for getting the lowest connection handle in a set of flags.
+ *
+ * @param[in]  flags  Flags to search. Must not be 0.
+ *
+ * @return  The index of the least significant flag that is set.
+ */
+static uint32_t flag_first(nrf_atflags_t flags)
+{
+    // Using __RBIT so that __CLZ finds the least significant flag.
+    return __CLZ(__RBIT(flags));
+}
+
+
 ble_conn_state_conn_handle_list_t conn_handle_list_get(nrf_atflags_t flags)
 {
     ble_conn_state_conn_handle_list_t conn_handle_list;
     conn_handle_list.len = 0;
 
-    if (flags != 0)
+    flags &= CONN_FLAGS_MASK;
+
+    while (flags != 0)
     {
-        for (uint32_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
-        {
-            if (nrf_atflags_get(&flags, i))
-            {
-                conn_handle_list.conn_handles[conn_handle_list.len++] = i;
-            }
-        }
+        conn_handle_list.conn_handles[conn_handle_list.len++] = flag_first(flags);
+        flags &= flags - 1; // Clear the least significant flag.
     }
 
     return conn_handle_list;
@@ -117,24 +133,19 @@ ble_conn_state_conn_handle_list_t conn_handle_list_get(nrf_atflags_t flags)
 
 uint32_t active_flag_count(nrf_atflags_t flags)
 {
-    uint32_t set_flag_count = 0;
+    // Parallel bit count, since the Cortex-M4 has no population count instruction.
+    flags &= CONN_FLAGS_MASK;
+    flags  = flags - ((flags >> 1) & 0x55555555UL);
+    flags  = (flags & 0x33333333UL) + ((flags >> 2) & 0x33333333UL);
+    flags  = (flags + (flags >> 4)) & 0x0F0F0F0FUL;
 
-    for (uint32_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
-    {
-        if (nrf_atflags_get(&flags, i))
-        {
-            set_flag_count += 1;
-        }
-    }
-    return set_flag_count;
+    return (flags * 0x01010101UL) >> 24;
 }
 
 
 /**@brief Function for activating a connection record.
  *
- * @param p_record     The record to activate.
- * @param conn_handle  The connection handle to copy into the record.
- * @param role         The role of the connection.
+ * @param conn_handle  The connection handle of the record to activate.
  *
  * @return whether the record was activated successfully.
  */
@@ -144,7 +155,10 @@ static bool record_activate(uint16_t conn_handle)
     {
         return false;
     }
-    nrf_atflags_set(&m_bcs.flags.connected_flags, conn_handle);
+    if (!nrf_atflags_fetch_set(&m_bcs.flags.connected_flags, conn_handle))
+    {
+        m_bcs.conn_count++;
+    }
     nrf_atflags_set(&m_bcs.flags.valid_flags, conn_handle);
     return true;
 }
@@ -165,11 +179,22 @@ static void record_invalidate(uint16_t conn_handle)
 
 /**@brief Function for marking a connection as disconnected. See @ref BLE_CONN_STATUS_DISCONNECTED.
  *
- * @param p_record   The record of the connection to set as disconnected.
+ * @param conn_handle  The connection handle of the record to set as disconnected.
  */
 static void record_set_disconnected(uint16_t conn_handle)
 {
-    nrf_atflags_clear(&m_bcs.flags.connected_flags, conn_handle);
+    if (conn_handle >= BLE_CONN_STATE_MAX_CONNECTIONS)
+    {
+        return;
+    }
+    if (nrf_atflags_fetch_clear(&m_bcs.flags.connected_flags, conn_handle))
+    {
+        m_bcs.conn_count--;
+        if (nrf_atflags_get(&m_bcs.flags.central_flags, conn_handle))
+        {
+            m_bcs.central_conn_count--;
+        }
+    }
 }
 
 
@@ -243,7 +268,10 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             else if ((p_ble_evt->evt.gap_evt.params.connected.role == BLE_GAP_ROLE_CENTRAL))
             {
                 // Central
-                nrf_atflags_set(&m_bcs.flags.central_flags, conn_handle);
+                if (!nrf_atflags_fetch_set(&m_bcs.flags.central_flags, conn_handle))
+                {
+                    m_bcs.central_conn_count++;
+                }
             }
 #endif // BLE_GAP_ROLE_CENTRAL
             else
@@ -355,25 +383,19 @@ bool ble_conn_state_lesc(uint16_t conn_handle)
 
 uint32_t ble_conn_state_conn_count(void)
 {
-    return active_flag_count(m_bcs.flags.connected_flags);
+    return m_bcs.conn_count;
 }
 
 
 uint32_t ble_conn_state_central_conn_count(void)
 {
-    nrf_atflags_t central_conn_flags = m_bcs.flags.central_flags;
-    UNUSED_RETURN_VALUE(nrf_atomic_u32_and(&central_conn_flags, m_bcs.flags.connected_flags));
-
-    return active_flag_count(central_conn_flags);
+    return m_bcs.central_conn_count;
 }
 
 
 uint32_t ble_conn_state_peripheral_conn_count(void)
 {
-    nrf_atflags_t peripheral_conn_flags = ~m_bcs.flags.central_flags;
-    UNUSED_RETURN_VALUE(nrf_atomic_u32_and(&peripheral_conn_flags, m_bcs.flags.connected_flags));
-
-    return active_flag_count(peripheral_conn_flags);
+    return m_bcs.conn_count - m_bcs.central_conn_count;
 }
 
 
@@ -462,16 +484,13 @@ static uint32_t for_each_set_flag(nrf_atflags_t                  flags,
 
     uint32_t call_count = 0;
 
-    if (flags != 0)
+    flags &= CONN_FLAGS_MASK;
+
+    while (flags != 0)
     {
-        for (uint32_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
-        {
-            if (nrf_atflags_get(&flags, i))
-            {
-                user_function(i, p_context);
-                call_count += 1;
-            }
-        }
+        user_function(flag_first(flags), p_context);
+        flags &= flags - 1; // Clear the least significant flag.
+        call_count += 1;
     }
     return call_count;
 }
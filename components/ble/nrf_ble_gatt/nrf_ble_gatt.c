@@ -42,6 +42,7 @@
 #if NRF_MODULE_ENABLED(NRF_BLE_GATT)
 
 #include "nrf_ble_gatt.h"
+#include "ble_conn_state.h"
 
 #define NRF_LOG_MODULE_NAME nrf_ble_gatt
 #include "nrf_log.h"
@@ -52,6 +53,10 @@ NRF_LOG_MODULE_REGISTER();
 #define BLE_GAP_DATA_LENGTH_DEFAULT     27          //!< The stack's default data length.
 #define BLE_GAP_DATA_LENGTH_MAX         251         //!< Maximum data length.
 
+#define POLICY_STEP_ATT_MTU             (1 << 0)    //!< ATT_MTU exchange of the throughput profile is in progress.
+#define POLICY_STEP_DATA_LENGTH         (1 << 1)    //!< Data length update of the throughput profile is in progress.
+#define POLICY_STEP_PHY                 (1 << 2)    //!< PHY update of the throughput profile is in progress.
+
 
 STATIC_ASSERT(NRF_SDH_BLE_GAP_DATA_LENGTH < 252);
 
@@ -66,7 +71,14 @@ static void link_init(nrf_ble_gatt_link_t * p_link)
 #if !defined (S112) && !defined(S312) && !defined (S122)
     p_link->data_length_desired        = NRF_SDH_BLE_GAP_DATA_LENGTH;
     p_link->data_length_effective      = BLE_GAP_DATA_LENGTH_DEFAULT;
+    p_link->data_length_update_pending = false;
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
+    p_link->profile                    = NRF_BLE_GATT_PROFILE_DEFAULT;
+    p_link->policy_steps               = 0;
+    p_link->phy_update_pending         = false;
+    p_link->phy_update_retries         = 0;
+    p_link->tx_phy                     = BLE_GAP_PHY_1MBPS;
+    p_link->rx_phy                     = BLE_GAP_PHY_1MBPS;
 }
 
 /**@brief   Start a data length update request procedure on a given connection. */
@@ -112,41 +124,98 @@ static ret_code_t data_length_update(uint16_t conn_handle, uint16_t data_length)
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
 
 
-/**@brief Handle a connected event.
- *
- * Begins an ATT MTU exchange procedure, followed by a data length update request as necessary.
- *
- * @param[in]   p_gatt      GATT structure.
- * @param[in]   p_ble_evt   Event received from the BLE stack.
- */
-static void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p_ble_evt)
+/**@brief   Send the negotiated link parameters to the user. */
+static void link_params_evt_send(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
 {
-    uint16_t              conn_handle = p_ble_evt->evt.common_evt.conn_handle;
-    nrf_ble_gatt_link_t * p_link      = &p_gatt->links[conn_handle];
+    nrf_ble_gatt_link_t const * p_link = &p_gatt->links[conn_handle];
 
-    // Update the link desired settings to reflect the current global settings.
-#if !defined (S112) && !defined(S312) && !defined(S122)
-    p_link->data_length_desired = p_gatt->data_length;
+    NRF_LOG_DEBUG("Link parameters on connection 0x%x: ATT MTU %u, TX/RX PHY 0x%x/0x%x.",
+                  conn_handle, p_link->att_mtu_effective, p_link->tx_phy, p_link->rx_phy);
+
+    if (p_gatt->evt_handler != NULL)
+    {
+        nrf_ble_gatt_evt_t const evt =
+        {
+            .evt_id                                = NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED,
+            .conn_handle                           = conn_handle,
+            .params.link_params.att_mtu_effective  = p_link->att_mtu_effective,
+#if !defined (S112) && !defined(S312) && !defined (S122)
+            .params.link_params.data_length_effective = p_link->data_length_effective,
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
+            .params.link_params.tx_phy             = p_link->tx_phy,
+            .params.link_params.rx_phy             = p_link->rx_phy,
+        };
 
-    switch (p_ble_evt->evt.gap_evt.params.connected.role)
+        p_gatt->evt_handler(p_gatt, &evt);
+    }
+}
+
+
+static void policy_step_done(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle, uint8_t step);
+
+
+/**@brief   Start a PHY update to the 2 Mbps PHY on a given connection. */
+static void phy_update_start(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+
+    ble_gap_phys_t const phys =
     {
-#if !defined (S122)
-        case BLE_GAP_ROLE_PERIPH:
-            p_link->att_mtu_desired = p_gatt->att_mtu_desired_periph;
-            break;
-#endif // !defined (S122)
+        .tx_phys = BLE_GAP_PHY_2MBPS,
+        .rx_phys = BLE_GAP_PHY_2MBPS,
+    };
 
-#if !defined (S112) && !defined(S312) && !defined(S113)
-        case BLE_GAP_ROLE_CENTRAL:
-            p_link->att_mtu_desired = p_gatt->att_mtu_desired_central;
-            break;
-#endif // !defined (S112) && !defined(S312) && !defined(S113)
+    ret_code_t err_code = sd_ble_gap_phy_update(conn_handle, &phys);
 
-        default:
-            // Ignore.
-            break;
+    p_link->phy_update_pending = (err_code == NRF_ERROR_BUSY);
+
+    if ((err_code == NRF_SUCCESS) || (err_code == NRF_ERROR_BUSY))
+    {
+        NRF_LOG_DEBUG("Requesting 2 Mbps PHY on connection 0x%x%s.",
+                      conn_handle, (err_code == NRF_ERROR_BUSY) ? " (busy, will retry)" : "");
+        p_link->policy_steps |= POLICY_STEP_PHY;
+    }
+    else
+    {
+        NRF_LOG_ERROR("sd_ble_gap_phy_update() on connection 0x%x returned %s.",
+                      conn_handle, nrf_strerror_get(err_code));
+        policy_step_done(p_gatt, conn_handle, POLICY_STEP_PHY);
     }
+}
+
+
+/**@brief   Mark a procedure of the throughput profile as completed.
+ *
+ * @details Starts the PHY update once the data length update has completed, and sends the
+ *          negotiated link parameters to the user when no procedures are left.
+ */
+static void policy_step_done(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle, uint8_t step)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+
+    if ((p_link->policy_steps & step) == 0)
+    {
+        return;
+    }
+
+    p_link->policy_steps &= ~step;
+
+    if ((step == POLICY_STEP_DATA_LENGTH) && (p_link->profile == NRF_BLE_GATT_PROFILE_BULK))
+    {
+        phy_update_start(p_gatt, conn_handle);
+    }
+
+    if (p_link->policy_steps == 0)
+    {
+        link_params_evt_send(p_gatt, conn_handle);
+    }
+}
+
+
+/**@brief   Begin an ATT MTU exchange on a given connection if necessary. */
+static void att_mtu_exchange_start(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
 
 #if NRF_BLE_GATT_MTU_EXCHANGE_INITIATION_ENABLED
     // Begin an ATT MTU exchange if necessary.
@@ -162,10 +231,12 @@ static void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p_ble_ev
         if (err_code == NRF_SUCCESS)
         {
             p_link->att_mtu_exchange_requested = true;
+            p_link->policy_steps |= POLICY_STEP_ATT_MTU;
         }
         else if (err_code == NRF_ERROR_BUSY)
         {
             p_link->att_mtu_exchange_pending = true;
+            p_link->policy_steps |= POLICY_STEP_ATT_MTU;
             NRF_LOG_DEBUG("sd_ble_gattc_exchange_mtu_request()"
                           " on connection 0x%x returned busy, will retry.", conn_handle);
         }
@@ -175,15 +246,124 @@ static void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p_ble_ev
                           nrf_strerror_get(err_code));
         }
     }
+#else
+    UNUSED_PARAMETER(p_link);
 #endif // NRF_BLE_GATT_MTU_EXCHANGE_INITIATION_ENABLED
+}
+
 
 #if !defined (S112) && !defined(S312) && !defined (S122)
-    // Send a data length update request if necessary.
+/**@brief   Send a data length update request on a given connection if necessary. */
+static void data_length_start(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+
     if (p_link->data_length_desired > p_link->data_length_effective)
     {
-        (void) data_length_update(conn_handle, p_link->data_length_desired);
+        ret_code_t err_code = data_length_update(conn_handle, p_link->data_length_desired);
+
+        p_link->data_length_update_pending = (err_code == NRF_ERROR_BUSY);
+
+        if ((err_code == NRF_SUCCESS) || (err_code == NRF_ERROR_BUSY))
+        {
+            p_link->policy_steps |= POLICY_STEP_DATA_LENGTH;
+        }
+    }
+}
+#endif // !defined (S112) && !defined(S312) && !defined (S122)
+
+
+/**@brief   Start the procedures of the throughput profile of a given connection. */
+static void policy_start(nrf_ble_gatt_t * p_gatt, uint16_t conn_handle)
+{
+    nrf_ble_gatt_link_t * p_link = &p_gatt->links[conn_handle];
+
+    p_link->policy_steps       = 0;
+    p_link->phy_update_retries = 0;
+
+    if (p_link->profile == NRF_BLE_GATT_PROFILE_BULK)
+    {
+        p_link->att_mtu_desired     = NRF_SDH_BLE_GATT_MAX_MTU_SIZE;
+#if !defined (S112) && !defined(S312) && !defined (S122)
+        p_link->data_length_desired = NRF_SDH_BLE_GAP_DATA_LENGTH;
+#endif // !defined (S112) && !defined(S312) && !defined (S122)
     }
+
+    if (p_link->profile != NRF_BLE_GATT_PROFILE_LOW_POWER)
+    {
+        // The ATT_MTU can be exchanged only once per connection. Skip it if the exchange was
+        // already requested, or the peer has already raised the ATT_MTU.
+        if (   !p_link->att_mtu_exchange_requested
+            && !p_link->att_mtu_exchange_pending
+            && (p_link->att_mtu_effective == BLE_GATT_ATT_MTU_DEFAULT))
+        {
+            att_mtu_exchange_start(p_gatt, conn_handle);
+        }
+#if !defined (S112) && !defined(S312) && !defined (S122)
+        data_length_start(p_gatt, conn_handle);
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
+    }
+
+    if (p_link->profile == NRF_BLE_GATT_PROFILE_DEFAULT)
+    {
+        // Only the procedures are started, without tracking their completion.
+        p_link->policy_steps = 0;
+        return;
+    }
+
+    if (   (p_link->profile == NRF_BLE_GATT_PROFILE_BULK)
+        && ((p_link->policy_steps & POLICY_STEP_DATA_LENGTH) == 0))
+    {
+        // No data length update to wait for.
+        phy_update_start(p_gatt, conn_handle);
+    }
+
+    if (p_link->policy_steps == 0)
+    {
+        link_params_evt_send(p_gatt, conn_handle);
+    }
+}
+
+
+/**@brief Handle a connected event.
+ *
+ * Begins an ATT MTU exchange procedure, followed by a data length update request as necessary.
+ * With a throughput profile, a PHY update follows the data length update.
+ *
+ * @param[in]   p_gatt      GATT structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+static void on_connected_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p_ble_evt)
+{
+    uint16_t              conn_handle = p_ble_evt->evt.common_evt.conn_handle;
+    nrf_ble_gatt_link_t * p_link      = &p_gatt->links[conn_handle];
+
+    // Update the link desired settings to reflect the current global settings.
+#if !defined (S112) && !defined(S312) && !defined(S122)
+    p_link->data_length_desired = p_gatt->data_length;
+#endif // !defined (S112) && !defined(S312) && !defined (S122)
+    p_link->profile = p_gatt->profile;
+
+    switch (p_ble_evt->evt.gap_evt.params.connected.role)
+    {
+#if !defined (S122)
+        case BLE_GAP_ROLE_PERIPH:
+            p_link->att_mtu_desired = p_gatt->att_mtu_desired_periph;
+            break;
+#endif // !defined (S122)
+
+#if !defined (S112) && !defined(S312) && !defined(S113)
+        case BLE_GAP_ROLE_CENTRAL:
+            p_link->att_mtu_desired = p_gatt->att_mtu_desired_central;
+            break;
+#endif // !defined (S112) && !defined(S312) && !defined(S113)
+
+        default:
+            // Ignore.
+            break;
+    }
+
+    policy_start(p_gatt, conn_handle);
 }
 
 
@@ -234,6 +414,8 @@ static void on_exchange_mtu_rsp_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p
 
     p_link->att_mtu_exchange_requested = false;
     p_link->att_mtu_exchange_pending   = false;
+
+    policy_step_done(p_gatt, conn_handle, POLICY_STEP_ATT_MTU);
 }
 
 
@@ -287,6 +469,9 @@ static void on_exchange_mtu_request_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const
 
         p_gatt->evt_handler(p_gatt, &evt);
     }
+
+    // A pending request of our own is no longer needed.
+    policy_step_done(p_gatt, conn_handle, POLICY_STEP_ATT_MTU);
 }
 
 
@@ -332,6 +517,8 @@ static void on_data_length_update_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const *
 
         p_gatt->evt_handler(p_gatt, &evt);
     }
+
+    policy_step_done(p_gatt, conn_handle, POLICY_STEP_DATA_LENGTH);
 }
 
 
@@ -364,11 +551,63 @@ static void on_data_length_update_request_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t
 
     uint8_t const data_length_effective = MIN(p_link->data_length_desired, data_length_requested);
 
+    // The procedure started by the peer replaces a pending request of our own. Its completion is
+    // reported in a BLE_GAP_EVT_DATA_LENGTH_UPDATE event.
+    p_link->data_length_update_pending = false;
+
     (void) data_length_update(p_gap_evt->conn_handle, data_length_effective);
 }
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
 
 
+/**@brief   Handle a BLE_GAP_EVT_PHY_UPDATE event.
+ *
+ * @details Update the connection PHYs. A PHY update of the throughput profile that was rejected
+ *          by the peer is retried up to @ref NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT times, unless
+ *          the peer does not support it.
+ *
+ * @param[in]   p_gatt      GATT structure.
+ * @param[in]   p_ble_evt   Event received from the BLE stack.
+ */
+static void on_phy_update_evt(nrf_ble_gatt_t * p_gatt, ble_evt_t const * p_ble_evt)
+{
+    ble_gap_evt_t         const * p_gap_evt = &p_ble_evt->evt.gap_evt;
+    nrf_ble_gatt_link_t         * p_link    = &p_gatt->links[p_gap_evt->conn_handle];
+
+    if (p_gap_evt->params.phy_update.status == BLE_HCI_STATUS_CODE_SUCCESS)
+    {
+        p_link->tx_phy             = p_gap_evt->params.phy_update.tx_phy;
+        p_link->rx_phy             = p_gap_evt->params.phy_update.rx_phy;
+        p_link->phy_update_pending = false;
+
+        NRF_LOG_DEBUG("PHY updated to TX 0x%x, RX 0x%x on connection 0x%x.",
+                      p_link->tx_phy, p_link->rx_phy, p_gap_evt->conn_handle);
+
+        policy_step_done(p_gatt, p_gap_evt->conn_handle, POLICY_STEP_PHY);
+        return;
+    }
+
+    if ((p_link->policy_steps & POLICY_STEP_PHY) == 0)
+    {
+        return;
+    }
+
+    NRF_LOG_DEBUG("PHY update on connection 0x%x failed with status 0x%x.",
+                  p_gap_evt->conn_handle, p_gap_evt->params.phy_update.status);
+
+    if (   (p_link->phy_update_retries < NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT)
+        && (p_gap_evt->params.phy_update.status != BLE_HCI_UNSUPPORTED_REMOTE_FEATURE))
+    {
+        p_link->phy_update_retries++;
+        phy_update_start(p_gatt, p_gap_evt->conn_handle);
+    }
+    else
+    {
+        policy_step_done(p_gatt, p_gap_evt->conn_handle, POLICY_STEP_PHY);
+    }
+}
+
+
 ret_code_t nrf_ble_gatt_init(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_handler_t evt_handler)
 {
     VERIFY_PARAM_NOT_NULL(p_gatt);
@@ -377,6 +616,7 @@ ret_code_t nrf_ble_gatt_init(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_handler_t
     p_gatt->att_mtu_desired_periph  = NRF_SDH_BLE_GATT_MAX_MTU_SIZE;
     p_gatt->att_mtu_desired_central = NRF_SDH_BLE_GATT_MAX_MTU_SIZE;
     p_gatt->data_length             = NRF_SDH_BLE_GAP_DATA_LENGTH;
+    p_gatt->profile                 = NRF_BLE_GATT_PROFILE_DEFAULT;
 
     for (uint32_t i = 0; i < NRF_BLE_GATT_LINK_COUNT; i++)
     {
@@ -415,6 +655,47 @@ ret_code_t nrf_ble_gatt_att_mtu_central_set(nrf_ble_gatt_t * p_gatt, uint16_t de
 }
 
 
+ret_code_t nrf_ble_gatt_profile_set(nrf_ble_gatt_t         * p_gatt,
+                                    uint16_t                 conn_handle,
+                                    nrf_ble_gatt_profile_t   profile)
+{
+    VERIFY_PARAM_NOT_NULL(p_gatt);
+
+    if (profile > NRF_BLE_GATT_PROFILE_LOW_POWER)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (conn_handle == BLE_CONN_HANDLE_INVALID)
+    {
+        // Save value and use upon connection.
+        p_gatt->profile = profile;
+        return NRF_SUCCESS;
+    }
+
+    if (conn_handle >= NRF_BLE_GATT_LINK_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (ble_conn_state_status(conn_handle) != BLE_CONN_STATUS_CONNECTED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (p_gatt->links[conn_handle].policy_steps != 0)
+    {
+        // The procedures of the current profile have not completed yet.
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    p_gatt->links[conn_handle].profile = profile;
+    policy_start(p_gatt, conn_handle);
+
+    return NRF_SUCCESS;
+}
+
+
 uint16_t nrf_ble_gatt_eff_mtu_get(nrf_ble_gatt_t const * p_gatt, uint16_t conn_handle)
 {
     if ((p_gatt == NULL) || (conn_handle >= NRF_BLE_GATT_LINK_COUNT))
@@ -525,6 +806,10 @@ void nrf_ble_gatt_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
             break;
 #endif // !defined (S112) && !defined(S312) && !defined (S122)
 
+        case BLE_GAP_EVT_PHY_UPDATE:
+            on_phy_update_evt(p_gatt, p_ble_evt);
+            break;
+
         default:
             break;
     }
@@ -546,10 +831,38 @@ void nrf_ble_gatt_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
         }
         else if (err_code != NRF_ERROR_BUSY)
         {
+            p_gatt->links[conn_handle].att_mtu_exchange_pending = false;
+
             NRF_LOG_ERROR("sd_ble_gattc_exchange_mtu_request() returned %s.",
                           nrf_strerror_get(err_code));
+
+            policy_step_done(p_gatt, conn_handle, POLICY_STEP_ATT_MTU);
         }
     }
+
+#if !defined (S112) && !defined(S312) && !defined (S122)
+    if (p_gatt->links[conn_handle].data_length_update_pending)
+    {
+        ret_code_t err_code;
+
+        err_code = data_length_update(conn_handle, p_gatt->links[conn_handle].data_length_desired);
+
+        if (err_code != NRF_ERROR_BUSY)
+        {
+            p_gatt->links[conn_handle].data_length_update_pending = false;
+
+            if (err_code != NRF_SUCCESS)
+            {
+                policy_step_done(p_gatt, conn_handle, POLICY_STEP_DATA_LENGTH);
+            }
+        }
+    }
+#endif // !defined (S112) && !defined(S312) && !defined (S122)
+
+    if (p_gatt->links[conn_handle].phy_update_pending)
+    {
+        phy_update_start(p_gatt, conn_handle);
+    }
 }
 
 #endif //NRF_BLE_GATT_ENABLED
@@ -77,14 +77,44 @@ NRF_SDH_BLE_OBSERVER(_name ## _obs,
  */
 #define NRF_BLE_GATT_LINK_COUNT (NRF_SDH_BLE_PERIPHERAL_LINK_COUNT + NRF_SDH_BLE_CENTRAL_LINK_COUNT)
 
+/**@brief   Number of times a PHY update rejected by the peer is retried when a throughput profile
+ *          is used. See @ref nrf_ble_gatt_profile_set.
+ */
+#ifndef NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT
+#define NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT 2
+#endif
+
 
 /**@brief   GATT module event types. */
 typedef enum
 {
   NRF_BLE_GATT_EVT_ATT_MTU_UPDATED     = 0xA77,  //!< The ATT_MTU size was updated.
   NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED = 0xDA7A, //!< The data length was updated.
+  NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED = 0x1173, //!< The procedures of the throughput profile have completed. See @ref nrf_ble_gatt_profile_set.
 } nrf_ble_gatt_evt_id_t;
 
+/**@brief   Throughput profile of a connection.
+ *
+ * @details Selects which procedures the module starts after a connection is established.
+ */
+typedef enum
+{
+  NRF_BLE_GATT_PROFILE_DEFAULT,   //!< ATT_MTU exchange and data length update as configured. No PHY update and no @ref NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED event.
+  NRF_BLE_GATT_PROFILE_BULK,      //!< Largest ATT_MTU and data length supported by the SoftDevice configuration, then the 2 Mbps PHY.
+  NRF_BLE_GATT_PROFILE_LOW_POWER, //!< No procedures are started. Requests from the peer are still answered.
+} nrf_ble_gatt_profile_t;
+
+/**@brief   Negotiated link parameters, reported in @ref NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED. */
+typedef struct
+{
+    uint16_t att_mtu_effective;         //!< Effective ATT_MTU.
+#if !defined (S112) && !defined(S312)
+    uint8_t  data_length_effective;     //!< Effective data length.
+#endif // !defined (S112) && !defined(S312)
+    uint8_t  tx_phy;                    //!< TX PHY, see @ref BLE_GAP_PHYS.
+    uint8_t  rx_phy;                    //!< RX PHY, see @ref BLE_GAP_PHYS.
+} nrf_ble_gatt_link_params_t;
+
 /**@brief   GATT module event. */
 typedef struct
 {
@@ -96,6 +126,7 @@ typedef struct
 #if !defined (S112) && !defined(S312)
         uint8_t  data_length;           //!< Data length value.
 #endif // !defined (S112) && !defined(S312)
+        nrf_ble_gatt_link_params_t link_params; //!< Negotiated link parameters.
     } params;
 } nrf_ble_gatt_evt_t;
 
@@ -118,7 +149,14 @@ typedef struct
 #if !defined (S112) && !defined(S312)
     uint8_t  data_length_desired;           //!< Desired data length (in bytes).
     uint8_t  data_length_effective;         //!< Requested data length (in bytes).
+    bool     data_length_update_pending;    //!< Indicates that a data length update request is pending (the call to @ref sd_ble_gap_data_length_update returned @ref NRF_ERROR_BUSY).
 #endif // !defined (S112) && !defined(S312)
+    nrf_ble_gatt_profile_t profile;         //!< Throughput profile of the connection.
+    uint8_t  policy_steps;                  //!< Procedures of the throughput profile that have not completed yet.
+    bool     phy_update_pending;            //!< Indicates that a PHY update request is pending (the call to @ref sd_ble_gap_phy_update returned @ref NRF_ERROR_BUSY).
+    uint8_t  phy_update_retries;            //!< Number of PHY update requests that were rejected by the peer.
+    uint8_t  tx_phy;                        //!< Current TX PHY.
+    uint8_t  rx_phy;                        //!< Current RX PHY.
 } nrf_ble_gatt_link_t;
 
 
@@ -128,6 +166,7 @@ struct nrf_ble_gatt_s
     uint16_t                   att_mtu_desired_periph;          //!< Requested ATT_MTU size for the next peripheral connection that is established.
     uint16_t                   att_mtu_desired_central;         //!< Requested ATT_MTU size for the next central connection that is established.
     uint8_t                    data_length;                     //!< Data length to use for the next connection that is established.
+    nrf_ble_gatt_profile_t     profile;                         //!< Throughput profile to use for the next connection that is established.
     nrf_ble_gatt_link_t        links[NRF_BLE_GATT_LINK_COUNT];  //!< GATT related information for all active connections.
     nrf_ble_gatt_evt_handler_t evt_handler;                     //!< GATT event handler.
 };
@@ -211,6 +250,38 @@ ret_code_t nrf_ble_gatt_data_length_get(nrf_ble_gatt_t const * p_gatt,
                                         uint8_t              * p_data_length);
 #endif // !defined (S112) && !defined(S312)
 
+/**@brief   Function for setting the throughput profile.
+ *
+ * @details With a profile other than @ref NRF_BLE_GATT_PROFILE_DEFAULT, the module starts the
+ *          procedures of the profile in this order: ATT_MTU exchange and data length update,
+ *          then PHY update once the data length update has completed, since the SoftDevice runs
+ *          only one link layer procedure at a time. Requests that return @ref NRF_ERROR_BUSY are
+ *          retried, and a PHY update rejected by the peer is retried up to
+ *          @ref NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT times. When all procedures have completed,
+ *          @ref NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED is sent with the negotiated parameters.
+ *
+ *          If @p conn_handle is @ref BLE_CONN_HANDLE_INVALID, the profile is used for the
+ *          connections that are established next. If @p conn_handle is a handle to an existing
+ *          connection, the procedures are started on that connection. The ATT_MTU exchange is
+ *          skipped if it was already requested or the ATT_MTU was already raised on that
+ *          connection, since the ATT_MTU can be exchanged only once per connection.
+ *
+ * @param[in,out]   p_gatt      Pointer to the GATT structure.
+ * @param[in]       conn_handle Connection handle, or @ref BLE_CONN_HANDLE_INVALID.
+ * @param[in]       profile     Throughput profile.
+ *
+ * @retval NRF_SUCCESS              If the operation was successful.
+ * @retval NRF_ERROR_NULL           If @p p_gatt is NULL.
+ * @retval NRF_ERROR_INVALID_PARAM  If @p profile is invalid or @p conn_handle is larger than
+ *                                  @ref NRF_BLE_GATT_LINK_COUNT.
+ * @retval NRF_ERROR_INVALID_STATE  If @p conn_handle is not connected, or the procedures of the
+ *                                  current profile have not completed yet on that connection.
+ */
+ret_code_t nrf_ble_gatt_profile_set(nrf_ble_gatt_t         * p_gatt,
+                                    uint16_t                 conn_handle,
+                                    nrf_ble_gatt_profile_t   profile);
+
+
 /**@brief   Function for handling BLE stack events.
  *
  * @details This function handles events from the BLE stack that are of interest to the module.
@@ -130,6 +130,69 @@ static ret_code_t gatts_hvx_alloc(nrf_memobj_pool_t const * p_data_pool,
 }
 
 
+/**@brief Function checks the fragments of a @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF request.
+ *
+ * @param[in] p_hvx_ref    Pointer to request parameters.
+ *
+ * @retval    NRF_SUCCESS             If the fragments are valid.
+ * @retval    NRF_ERROR_INVALID_PARAM If the fragment count is 0 or above
+ *                                    @ref NRF_BLE_GQ_HVX_REF_MAX_FRAGS, a fragment has no memory
+ *                                    object, or the payload is longer than
+ *                                    @ref NRF_BLE_GQ_GATTS_HVX_MAX_DATA_LEN.
+ */
+static ret_code_t gatts_hvx_ref_validate(nrf_ble_gq_gatts_hvx_ref_t const * const p_hvx_ref)
+{
+    uint32_t len = 0;
+
+    if ((p_hvx_ref->frag_cnt == 0) || (p_hvx_ref->frag_cnt > NRF_BLE_GQ_HVX_REF_MAX_FRAGS))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // The sum is kept in 32 bits, so that it cannot wrap around.
+    for (uint8_t i = 0; i < p_hvx_ref->frag_cnt; i++)
+    {
+        if (p_hvx_ref->frags[i].p_mem_obj == NULL)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        len += p_hvx_ref->frags[i].len;
+    }
+
+    if (len > NRF_BLE_GQ_GATTS_HVX_MAX_DATA_LEN)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function takes references to memory objects holding data associated with
+ *        @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF request.
+ *
+ * @param[in] p_data_pool  Pointer to general memory pool. Not used.
+ * @param[in] p_req        Pointer to GATTS hvx request.
+ *
+ * @retval    NRF_SUCCESS  If references to all fragments were taken.
+ */
+static ret_code_t gatts_hvx_ref_alloc(nrf_memobj_pool_t const * p_data_pool,
+                                      nrf_ble_gq_req_t  * const p_req)
+{
+    nrf_ble_gq_gatts_hvx_ref_t * p_hvx_ref = &p_req->params.gatts_hvx_ref;
+
+    UNUSED_PARAMETER(p_data_pool);
+
+    // Fragment count and payload length were validated by nrf_ble_gq_item_add().
+    for (uint8_t i = 0; i < p_hvx_ref->frag_cnt; i++)
+    {
+        nrf_memobj_get(p_hvx_ref->frags[i].p_mem_obj);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
 /**@brief Array of memory allocators for different types of @ref nrf_ble_gq_req_t. */
 static const req_data_alloc_t m_req_data_alloc[NRF_BLE_GQ_REQ_NUM] =
 {
@@ -138,10 +201,212 @@ static const req_data_alloc_t m_req_data_alloc[NRF_BLE_GQ_REQ_NUM] =
     [NRF_BLE_GQ_REQ_SRV_DISCOVERY]  = NULL,
     [NRF_BLE_GQ_REQ_CHAR_DISCOVERY] = NULL,
     [NRF_BLE_GQ_REQ_DESC_DISCOVERY] = NULL,
-    [NRF_BLE_GQ_REQ_GATTS_HVX]      = gatts_hvx_alloc
+    [NRF_BLE_GQ_REQ_GATTS_HVX]      = gatts_hvx_alloc,
+    [NRF_BLE_GQ_REQ_GATTS_HVX_REF]  = gatts_hvx_ref_alloc,
+    [NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID] = NULL
 };
 
 
+/**@brief Function releases memory associated with a buffered request.
+ *
+ * @param[in] p_req  Pointer to GATT request.
+ */
+static void req_data_free(nrf_ble_gq_req_t const * const p_req)
+{
+    if (p_req->type == NRF_BLE_GQ_REQ_GATTS_HVX_REF)
+    {
+        for (uint8_t i = 0; i < p_req->params.gatts_hvx_ref.frag_cnt; i++)
+        {
+            nrf_memobj_put(p_req->params.gatts_hvx_ref.frags[i].p_mem_obj);
+        }
+        NRF_LOG_DEBUG("Released %d memory object references.",
+                      p_req->params.gatts_hvx_ref.frag_cnt);
+    }
+    else if (m_req_data_alloc[p_req->type] != NULL)
+    {
+        nrf_memobj_free(p_req->p_mem_obj);
+        NRF_LOG_DEBUG("Pointer to freed memory block: %p.", p_req->p_mem_obj);
+    }
+}
+
+
+/**@brief Function sends a notification or indication with payload held in memory objects.
+ *
+ * @details If the payload is a single region of a memory object, it is passed to the SoftDevice
+ *          in place. Otherwise, fragments are gathered into a stack buffer.
+ *
+ * @param[in] conn_handle  Connection handle.
+ * @param[in] p_hvx_ref    Pointer to request parameters.
+ *
+ * @return    Error code returned by SoftDevice or by parameter validation.
+ */
+static ret_code_t gatts_hvx_ref_send(uint16_t                                conn_handle,
+                                     nrf_ble_gq_gatts_hvx_ref_t const * const p_hvx_ref)
+{
+    uint8_t                hvx_data[NRF_BLE_GQ_GATTS_HVX_MAX_DATA_LEN];
+    ble_gatts_hvx_params_t hvx_params;
+    nrf_memobj_span_t      span;
+    ret_code_t             err_code;
+    uint16_t               len = 0;
+    uint16_t               hvx_len;
+
+    // Requests are validated by nrf_ble_gq_item_add() before they are sent or queued. The check
+    // is repeated because the fragments are gathered into hvx_data.
+    err_code = gatts_hvx_ref_validate(p_hvx_ref);
+    VERIFY_SUCCESS(err_code);
+
+    for (uint8_t i = 0; i < p_hvx_ref->frag_cnt; i++)
+    {
+        len += p_hvx_ref->frags[i].len;
+    }
+
+    hvx_params.handle = p_hvx_ref->handle;
+    hvx_params.type   = p_hvx_ref->type;
+    hvx_params.offset = p_hvx_ref->offset;
+    hvx_params.p_data = hvx_data;
+    hvx_params.p_len  = &hvx_len;
+
+    if ((p_hvx_ref->frag_cnt == 1) &&
+        (nrf_memobj_spans_get(p_hvx_ref->frags[0].p_mem_obj,
+                              p_hvx_ref->frags[0].offset,
+                              len,
+                              &span,
+                              1) == 1) &&
+        (span.len == len))
+    {
+        // Payload is contiguous, no copy is needed.
+        hvx_params.p_data = span.p_data;
+    }
+    else
+    {
+        uint16_t          data_offset = 0;
+        nrf_memobj_iter_t iter;
+
+        for (uint8_t i = 0; i < p_hvx_ref->frag_cnt; i++)
+        {
+            nrf_memobj_iter_init(&iter,
+                                 p_hvx_ref->frags[i].p_mem_obj,
+                                 p_hvx_ref->frags[i].offset,
+                                 p_hvx_ref->frags[i].len);
+
+            while (nrf_memobj_iter_next(&iter, &span))
+            {
+                memcpy(&hvx_data[data_offset], span.p_data, span.len);
+                data_offset += span.len;
+            }
+        }
+        len = data_offset;
+    }
+
+    hvx_len = len;
+
+    NRF_LOG_DEBUG("GATTS HVX by reference (%d fragments)", p_hvx_ref->frag_cnt);
+    err_code = sd_ble_gatts_hvx(conn_handle, &hvx_params);
+
+    if ((err_code == NRF_SUCCESS) &&
+        (len != hvx_len))
+    {
+        err_code = NRF_ERROR_DATA_SIZE;
+    }
+
+    return err_code;
+}
+
+
+/**@brief Function checks if the SoftDevice could not take the request at the moment.
+ *
+ * @details @ref NRF_ERROR_BUSY means that another GATT procedure is in progress.
+ *          @ref NRF_ERROR_RESOURCES means that the SoftDevice TX queue is full. In both cases,
+ *          a BLE event that triggers queue processing follows, so the request is retried then.
+ *
+ * @param[in] err_code Error code returned by SoftDevice.
+ *
+ * @retval    true   If the request should be retried later.
+ * @retval    false  If the request is completed.
+ */
+__STATIC_INLINE bool is_retry_needed(ret_code_t err_code)
+{
+    return (err_code == NRF_ERROR_BUSY) || (err_code == NRF_ERROR_RESOURCES);
+}
+
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+/**@brief Function checks if a request is a notification.
+ *
+ * @param[in] p_req  Pointer to GATT request.
+ *
+ * @retval    true   If the request is a notification.
+ * @retval    false  Otherwise.
+ */
+static bool is_notification(nrf_ble_gq_req_t const * const p_req)
+{
+    switch (p_req->type)
+    {
+        case NRF_BLE_GQ_REQ_GATTS_HVX:
+            return (p_req->params.gatts_hvx.type == BLE_GATT_HVX_NOTIFICATION);
+
+        case NRF_BLE_GQ_REQ_GATTS_HVX_REF:
+            return (p_req->params.gatts_hvx_ref.type == BLE_GATT_HVX_NOTIFICATION);
+
+        default:
+            return false;
+    }
+}
+
+
+/**@brief Function checks if a notification can be passed to the SoftDevice.
+ *
+ * @param[in] p_burst  Pointer to the burst state of the connection.
+ *
+ * @retval    true   If the SoftDevice may have a free notification buffer.
+ * @retval    false  If all buffers are known to be in use.
+ */
+__STATIC_INLINE bool hvn_credit_available(nrf_ble_gq_hvx_burst_t const * const p_burst)
+{
+    return !p_burst->credits_known || (p_burst->credits > 0);
+}
+
+
+/**@brief Function updates TX credits after a notification was passed to the SoftDevice.
+ *
+ * @param[in] p_burst   Pointer to the burst state of the connection.
+ * @param[in] err_code  Error code returned by SoftDevice.
+ */
+static void hvn_credit_update(nrf_ble_gq_hvx_burst_t * const p_burst, ret_code_t err_code)
+{
+    if (err_code == NRF_ERROR_RESOURCES)
+    {
+        // The queue is full, so the number of free buffers is now known exactly.
+        p_burst->credits       = 0;
+        p_burst->credits_known = true;
+        p_burst->stats.resources_cnt++;
+    }
+    else if ((err_code == NRF_SUCCESS) && (p_burst->credits > 0))
+    {
+        p_burst->credits--;
+    }
+}
+
+
+/**@brief Function handles @ref BLE_GATTS_EVT_HVN_TX_COMPLETE event.
+ *
+ * @param[in] p_burst  Pointer to the burst state of the connection.
+ * @param[in] count    Number of notifications transmitted.
+ */
+static void hvn_tx_complete_handle(nrf_ble_gq_hvx_burst_t * const p_burst, uint8_t count)
+{
+    if (p_burst->credits_known)
+    {
+        p_burst->credits = (uint8_t)MIN((uint16_t)p_burst->credits + count, UINT8_MAX);
+    }
+
+    p_burst->stats.hvn_tx_cnt += count;
+    p_burst->stats.tx_complete_cnt++;
+    p_burst->stats.max_burst = MAX(p_burst->stats.max_burst, count);
+}
+#endif // NRF_BLE_GQ_HVX_BURST_ENABLED
+
+
 /**@brief Function handles error codes returned by GATT requests.
  *
  * @param[in] p_req       Pointer to GATT request.
@@ -170,12 +435,23 @@ __STATIC_INLINE void request_err_code_handle(nrf_ble_gq_req_t const * const p_re
 }
 
 
-/**@brief Function processes subsequent requests from the BGQ instance queue.
+/**@brief Function processes the request at the head of the BGQ instance queue.
  *
- * @param[in] p_queue      Pointer to the queue instance.
- * @param[in] conn_handle  Connection handle.
+ * @param[in]  p_queue      Pointer to the queue instance.
+ * @param[in]  conn_handle  Connection handle.
+ * @param[in]  p_burst      Pointer to the burst state of the connection. NULL if burst sending is
+ *                          disabled.
+ * @param[out] p_req        Processed request.
+ *
+ * @retval     NRF_SUCCESS         If the request was taken from the queue.
+ * @retval     NRF_ERROR_NOT_FOUND If the queue is empty.
+ * @retval     err_code            Error code of the SoftDevice. The request was taken from the
+ *                                 queue, unless the request should be retried later.
  */
-static void queue_process(nrf_queue_t const * const p_queue, uint16_t conn_handle)
+static ret_code_t queue_head_process(nrf_queue_t      const * const p_queue,
+                                     uint16_t                       conn_handle,
+                                     nrf_ble_gq_hvx_burst_t * const p_burst,
+                                     nrf_ble_gq_req_t       * const p_req)
 {
     ret_code_t       err_code;
     nrf_ble_gq_req_t ble_req;
@@ -183,7 +459,23 @@ static void queue_process(nrf_queue_t const * const p_queue, uint16_t conn_handl
     NRF_LOG_DEBUG("Processing the request queue...");
 
     err_code = nrf_queue_peek(p_queue, &ble_req);
-    if (err_code == NRF_SUCCESS) // Queue is not empty
+    if (err_code != NRF_SUCCESS) // Queue is empty
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    // Do not bother the SoftDevice if all its notification buffers are in use.
+    if ((p_burst != NULL) &&
+        is_notification(&ble_req) &&
+        !hvn_credit_available(p_burst))
+    {
+        err_code = NRF_ERROR_RESOURCES;
+    }
+    else
+#else
+    UNUSED_PARAMETER(p_burst);
+#endif
     {
         switch (ble_req.type)
         {
@@ -224,6 +516,14 @@ static void queue_process(nrf_queue_t const * const p_queue, uint16_t conn_handl
                                                                  &ble_req.params.gattc_char_disc);
             } break;
 
+            case NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID:
+            {
+                NRF_LOG_DEBUG("GATTC Read By UUID Request");
+                err_code = sd_ble_gattc_char_value_by_uuid_read(conn_handle,
+                                                                &ble_req.params.gattc_read_by_uuid.uuid,
+                                                                &ble_req.params.gattc_read_by_uuid.handle_range);
+            } break;
+
             case NRF_BLE_GQ_REQ_DESC_DISCOVERY:
             {
                 NRF_LOG_DEBUG("GATTC Characteristic Descriptor Discovery Request")
@@ -262,12 +562,23 @@ static void queue_process(nrf_queue_t const * const p_queue, uint16_t conn_handl
                 }
             } break;
 
+            case NRF_BLE_GQ_REQ_GATTS_HVX_REF:
+                err_code = gatts_hvx_ref_send(conn_handle, &ble_req.params.gatts_hvx_ref);
+                break;
+
             default:
                 NRF_LOG_WARNING("Unimplemented GATT Request");
                 break;
         }
 
-        if (err_code == NRF_ERROR_BUSY) // Softdevice is processing another GATT request.
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+        if ((p_burst != NULL) && is_notification(&ble_req))
+        {
+            hvn_credit_update(p_burst, err_code);
+        }
+#endif
+
+        if (is_retry_needed(err_code)) // Softdevice is processing another GATT request or its queue is full.
         {
             NRF_LOG_DEBUG("SD is currently busy. The GATT request procedure will be attempted \
                           again later.");
@@ -275,16 +586,61 @@ static void queue_process(nrf_queue_t const * const p_queue, uint16_t conn_handl
         else
         {
             // Remove last request descriptor from the queue and free data associated with it.
-            if (m_req_data_alloc[ble_req.type] != NULL)
-            {
-                nrf_memobj_free(ble_req.p_mem_obj);
-                NRF_LOG_DEBUG("Pointer to freed memory block: %p.", ble_req.p_mem_obj);
-            }
+            req_data_free(&ble_req);
             UNUSED_RETURN_VALUE(nrf_queue_pop(p_queue, &ble_req));
 
             request_err_code_handle(&ble_req, conn_handle, err_code);
         }
     }
+
+    *p_req = ble_req;
+    return err_code;
+}
+
+
+/**@brief Function processes subsequent requests from the BGQ instance queue.
+ *
+ * @details Without burst sending, one request is passed to the SoftDevice, and the next one is
+ *          processed on a later BLE event. With burst sending, consecutive notifications at the
+ *          head of the queue are passed to the SoftDevice until it has no free buffers.
+ *
+ * @param[in] p_gatt_queue Pointer to the BGQ instance.
+ * @param[in] conn_id      ID of the connection within the BGQ instance.
+ * @param[in] conn_handle  Connection handle.
+ */
+static void queue_process(nrf_ble_gq_t const * const p_gatt_queue,
+                          uint16_t                   conn_id,
+                          uint16_t                   conn_handle)
+{
+    nrf_queue_t const * p_queue = &p_gatt_queue->p_req_queue[conn_id];
+    nrf_ble_gq_req_t    ble_req;
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    nrf_ble_gq_hvx_burst_t * p_burst = &p_gatt_queue->p_hvx_burst[conn_id];
+    ret_code_t               err_code;
+    uint8_t                  hvn_cnt = 0;
+
+    for (;;)
+    {
+        err_code = queue_head_process(p_queue, conn_handle, p_burst, &ble_req);
+
+        if ((err_code == NRF_ERROR_NOT_FOUND) ||
+            is_retry_needed(err_code)         ||
+            !is_notification(&ble_req))
+        {
+            break;
+        }
+
+        hvn_cnt++;
+    }
+
+    if (hvn_cnt > 1)
+    {
+        NRF_LOG_DEBUG("Burst of %d notifications on connection handle %d.", hvn_cnt, conn_handle);
+    }
+#else
+    UNUSED_RETURN_VALUE(queue_head_process(p_queue, conn_handle, NULL, &ble_req));
+#endif
 }
 
 
@@ -313,11 +669,7 @@ static void queues_purge(nrf_ble_gq_t const * const p_gatt_queue)
         while (err_code == NRF_SUCCESS)
         {
             // Free data associated with this request if there is any.
-            if (m_req_data_alloc[ble_req.type] != NULL)
-            {
-                nrf_memobj_free(ble_req.p_mem_obj);
-                NRF_LOG_DEBUG("Pointer to freed memory block: %p.", ble_req.p_mem_obj);
-            }
+            req_data_free(&ble_req);
 
             err_code = nrf_queue_pop(p_queue, &ble_req);
         }
@@ -331,14 +683,22 @@ static void queues_purge(nrf_ble_gq_t const * const p_gatt_queue)
  *
  * @param[in] p_req        Pointer to GATT request.
  * @param[in] conn_handle  Connection handle.
+ * @param[in] p_burst      Pointer to the burst state of the connection. NULL if burst sending is
+ *                         disabled.
  *
  * @retval  true   If request is accepted by Softdevice.
  * @retval  false  If Softdevice is busy and the request should be queued.
  */
-static bool request_process(nrf_ble_gq_req_t const * const p_req, uint16_t conn_handle)
+static bool request_process(nrf_ble_gq_req_t const * const p_req,
+                            uint16_t                       conn_handle,
+                            nrf_ble_gq_hvx_burst_t * const p_burst)
 {
     ret_code_t err_code = NRF_SUCCESS;
 
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 0)
+    UNUSED_PARAMETER(p_burst);
+#endif
+
     switch (p_req->type)
     {
         case NRF_BLE_GQ_REQ_GATTC_READ:
@@ -367,6 +727,13 @@ static bool request_process(nrf_ble_gq_req_t const * const p_req, uint16_t conn_
                                                              &p_req->params.gattc_char_disc);
             break;
 
+        case NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID:
+            NRF_LOG_DEBUG("GATTC Read By UUID Request");
+            err_code = sd_ble_gattc_char_value_by_uuid_read(conn_handle,
+                                                            &p_req->params.gattc_read_by_uuid.uuid,
+                                                            &p_req->params.gattc_read_by_uuid.handle_range);
+            break;
+
         case NRF_BLE_GQ_REQ_DESC_DISCOVERY:
             NRF_LOG_DEBUG("GATTC Characteristic Descriptor Request");
             err_code = sd_ble_gattc_descriptors_discover(conn_handle,
@@ -390,12 +757,23 @@ static bool request_process(nrf_ble_gq_req_t const * const p_req, uint16_t conn_
 
         } break;
 
+        case NRF_BLE_GQ_REQ_GATTS_HVX_REF:
+            err_code = gatts_hvx_ref_send(conn_handle, &p_req->params.gatts_hvx_ref);
+            break;
+
         default:
             NRF_LOG_WARNING("Unimplemented GATT Request");
             break;
     }
 
-    if (err_code == NRF_ERROR_BUSY) // Softdevice is processing another GATT request.
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    if ((p_burst != NULL) && is_notification(p_req))
+    {
+        hvn_credit_update(p_burst, err_code);
+    }
+#endif
+
+    if (is_retry_needed(err_code)) // Softdevice is processing another GATT request or its queue is full.
     {
         NRF_LOG_DEBUG("SD is currently busy. The GATT request procedure will be attempted \
                       again later.");
@@ -495,10 +873,22 @@ ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t const * const p_gatt_queue,
         return NRF_ERROR_INVALID_PARAM;
     }
 
+    if (p_req->type == NRF_BLE_GQ_REQ_GATTS_HVX_REF)
+    {
+        err_code = gatts_hvx_ref_validate(&p_req->params.gatts_hvx_ref);
+        VERIFY_SUCCESS(err_code);
+    }
+
     // Try processing a request without buffering.
     if (nrf_queue_is_empty(&p_gatt_queue->p_req_queue[conn_id]))
     {
-        bool req_processed = request_process(p_req, conn_handle);
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+        bool req_processed = request_process(p_req,
+                                             conn_handle,
+                                             &p_gatt_queue->p_hvx_burst[conn_id]);
+#else
+        bool req_processed = request_process(p_req, conn_handle, NULL);
+#endif
         if (req_processed)
         {
             return err_code;
@@ -515,14 +905,13 @@ ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t const * const p_gatt_queue,
     }
 
     err_code = nrf_queue_push(&p_gatt_queue->p_req_queue[conn_id], p_req);
-    if ((err_code != NRF_SUCCESS) && (m_req_data_alloc[p_req->type] != NULL))
+    if (err_code != NRF_SUCCESS)
     {
-        nrf_memobj_free(p_req->p_mem_obj);
-        NRF_LOG_DEBUG("Pointer to freed memory block: %p.", p_req->p_mem_obj);
+        req_data_free(p_req);
     }
 
     // Check if Softdevice is still busy.
-    queue_process(&p_gatt_queue->p_req_queue[conn_id], conn_handle);
+    queue_process(p_gatt_queue, conn_id, conn_handle);
     return err_code;
 }
 
@@ -551,11 +940,39 @@ ret_code_t nrf_ble_gq_conn_handle_register(nrf_ble_gq_t * const p_gatt_queue, ui
 
         err_code = conn_handle_register(p_gatt_queue, conn_handle);
         VERIFY_SUCCESS(err_code);
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+        conn_id = conn_handle_id_find(p_gatt_queue, conn_handle);
+        memset(&p_gatt_queue->p_hvx_burst[conn_id], 0, sizeof(p_gatt_queue->p_hvx_burst[conn_id]));
+#endif
     }
     return err_code;
 }
 
 
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+ret_code_t nrf_ble_gq_hvx_stats_get(nrf_ble_gq_t     const * const p_gatt_queue,
+                                    uint16_t                       conn_handle,
+                                    nrf_ble_gq_hvx_stats_t * const p_stats)
+{
+    uint16_t conn_id;
+
+    VERIFY_PARAM_NOT_NULL(p_gatt_queue);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    conn_id = conn_handle_id_find(p_gatt_queue, conn_handle);
+    if (conn_id == p_gatt_queue->max_conns)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    *p_stats = p_gatt_queue->p_hvx_burst[conn_id].stats;
+
+    return NRF_SUCCESS;
+}
+#endif // NRF_BLE_GQ_HVX_BURST_ENABLED
+
+
 void nrf_ble_gq_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
 {
     nrf_ble_gq_t * p_gatt_queue = (nrf_ble_gq_t *) p_context;
@@ -603,7 +1020,14 @@ void nrf_ble_gq_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
     }
     else
     {
-        queue_process(&p_gatt_queue->p_req_queue[conn_id], conn_handle);
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+        if (p_ble_evt->header.evt_id == BLE_GATTS_EVT_HVN_TX_COMPLETE)
+        {
+            hvn_tx_complete_handle(&p_gatt_queue->p_hvx_burst[conn_id],
+                                   p_ble_evt->evt.gatts_evt.params.hvn_tx_complete.count);
+        }
+#endif
+        queue_process(p_gatt_queue, conn_id, conn_handle);
     }
 }
 
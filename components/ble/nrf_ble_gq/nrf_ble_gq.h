@@ -100,13 +100,15 @@ extern "C" {
     NRF_QUEUE_DEF(uint16_t, CONCAT_2(_name, purge_queue), _max_connections,                            \
                   NRF_QUEUE_MODE_NO_OVERFLOW);                                                         \
     NRF_MEMOBJ_POOL_DEF(CONCAT_2(_name, pool), _pool_elem_size, _pool_elem_count);                     \
+    NRF_BLE_GQ_HVX_BURST_ARR_DEF(_name, _max_connections)                                              \
     static nrf_ble_gq_t _name =                                                                        \
     {                                                                                                  \
         .max_conns      = (_max_connections),                                                          \
         .p_conn_handles = CONCAT_2(_name, conn_handles_arr),                                           \
         .p_req_queue    = CONCAT_2(_name, req_queue),                                                  \
         .p_purge_queue  = &CONCAT_2(_name, purge_queue),                                               \
-        .p_data_pool    = &CONCAT_2(_name, pool)                                                       \
+        .p_data_pool    = &CONCAT_2(_name, pool),                                                      \
+        NRF_BLE_GQ_HVX_BURST_INIT(_name)                                                               \
     };                                                                                                 \
     NRF_SDH_BLE_OBSERVER(_name ## _obs,                                                                \
                          NRF_BLE_GQ_BLE_OBSERVER_PRIO,                                                 \
@@ -116,6 +118,41 @@ extern "C" {
     static nrf_ble_gq_t _name;
 #endif // !(defined(__LINT__))
 
+/**@brief Maximal number of memory object fragments in a @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF request. */
+#ifndef NRF_BLE_GQ_HVX_REF_MAX_FRAGS
+#define NRF_BLE_GQ_HVX_REF_MAX_FRAGS 2
+#endif
+
+/**@brief Enable burst sending of queued notifications.
+ *
+ * @details When enabled, the BGQ instance tracks the free notification buffers of the SoftDevice
+ *          (TX credits) for each connection. A queued notification is no longer sent one per
+ *          completion event: as many queued notifications as there are credits are passed to the
+ *          SoftDevice at once. Credits are learned from @ref NRF_ERROR_RESOURCES, which means that
+ *          the SoftDevice queue is full, and from the counts of @ref BLE_GATTS_EVT_HVN_TX_COMPLETE.
+ *          Use @ref nrf_ble_gq_hvx_stats_get to see how many notifications are sent per
+ *          connection event.
+ */
+#ifndef NRF_BLE_GQ_HVX_BURST_ENABLED
+#define NRF_BLE_GQ_HVX_BURST_ENABLED 0
+#endif
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+/**@brief Helping macro used to define the burst state array for nrf_ble_gq_t instance.
+ *        Used in @ref NRF_BLE_GQ_CUSTOM_DEF.
+ */
+#define NRF_BLE_GQ_HVX_BURST_ARR_DEF(_name, _max_connections) \
+    static nrf_ble_gq_hvx_burst_t CONCAT_2(_name, hvx_burst_arr)[_max_connections];
+
+/**@brief Helping macro used to initialize the burst state of nrf_ble_gq_t instance.
+ *        Used in @ref NRF_BLE_GQ_CUSTOM_DEF.
+ */
+#define NRF_BLE_GQ_HVX_BURST_INIT(_name) .p_hvx_burst = CONCAT_2(_name, hvx_burst_arr),
+#else
+#define NRF_BLE_GQ_HVX_BURST_ARR_DEF(_name, _max_connections)
+#define NRF_BLE_GQ_HVX_BURST_INIT(_name)
+#endif
+
 /**@brief Helping macro used to properly initialize connection handle array for nrf_ble_gq_t instance.
  *        Used in @ref NRF_BLE_GQ_CUSTOM_DEF.
  */
@@ -130,6 +167,8 @@ typedef enum
     NRF_BLE_GQ_REQ_CHAR_DISCOVERY, /**< GATTC Characteristic Discovery Request. See @ref nrf_ble_gq_gattc_char_disc_t and @ref sd_ble_gattc_characteristics_discover. */
     NRF_BLE_GQ_REQ_DESC_DISCOVERY, /**< GATTC Characteristic Descriptor Discovery Request. See @ref nrf_ble_gq_gattc_desc_disc_t and @ref sd_ble_gattc_descriptors_discover*/
     NRF_BLE_GQ_REQ_GATTS_HVX,      /**< GATTS Handle Value Notification or Indication. See @ref nrf_ble_gq_gatts_hvx_t and @ref ble_gatts_hvx_params_t */
+    NRF_BLE_GQ_REQ_GATTS_HVX_REF,  /**< GATTS Handle Value Notification or Indication with payload held by reference in memory objects. See @ref nrf_ble_gq_gatts_hvx_ref_t */
+    NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID, /**< GATTC Read Using Characteristic UUID Request. See @ref nrf_ble_gq_gattc_read_by_uuid_t and @ref sd_ble_gattc_char_value_by_uuid_read */
     NRF_BLE_GQ_REQ_NUM             /**< Total number of different GATT Request types */
 } nrf_ble_gq_req_type_t;
 
@@ -145,6 +184,13 @@ typedef struct
     uint16_t offset; /**< Offset into the Attribute Value to be read. */
 } nrf_ble_gq_gattc_read_t;
 
+/**@brief Structure used to describe @ref NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID request type. */
+typedef struct
+{
+    ble_uuid_t               uuid;         /**< Characteristic UUID to read. */
+    ble_gattc_handle_range_t handle_range; /**< Handle range to search for the characteristic. */
+} nrf_ble_gq_gattc_read_by_uuid_t;
+
 /**@brief Structure used to describe @ref NRF_BLE_GQ_REQ_GATTC_WRITE request type. */
 typedef ble_gattc_write_params_t nrf_ble_gq_gattc_write_t;
 
@@ -164,6 +210,35 @@ typedef ble_gattc_handle_range_t nrf_ble_gq_gattc_desc_disc_t;
 /**@brief Structure used to describe @ref NRF_BLE_GQ_REQ_GATTS_HVX request type. */
 typedef ble_gatts_hvx_params_t nrf_ble_gq_gatts_hvx_t;
 
+/**@brief Fragment of a notification or indication payload held in a memory object. */
+typedef struct
+{
+    nrf_memobj_t * p_mem_obj; /**< Memory object holding the fragment. */
+    uint16_t       offset;    /**< Offset of the fragment within the memory object. */
+    uint16_t       len;       /**< Length of the fragment. */
+} nrf_ble_gq_memobj_frag_t;
+
+/**@brief Structure used to describe @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF request type.
+ *
+ * @details The payload is the concatenation of the fragments. It is not copied into the
+ *          data pool of the BGQ instance. If the request has to be buffered, the BGQ instance
+ *          takes a reference to each memory object with @ref nrf_memobj_get and releases it with
+ *          @ref nrf_memobj_put once the SoftDevice has taken the notification or indication, or
+ *          when the request is dropped. The caller can therefore release its own references
+ *          right after @ref nrf_ble_gq_item_add returns.
+ *
+ *          A payload made of a single fragment that lies within one chunk of its memory object is
+ *          passed to the SoftDevice in place. Other payloads are gathered on the stack.
+ */
+typedef struct
+{
+    uint16_t                 handle;                              /**< Characteristic Value Handle. */
+    uint8_t                  type;                                /**< Indication or Notification, see @ref BLE_GATT_HVX_TYPES. */
+    uint8_t                  frag_cnt;                            /**< Number of fragments. */
+    uint16_t                 offset;                              /**< Offset within the attribute value. */
+    nrf_ble_gq_memobj_frag_t frags[NRF_BLE_GQ_HVX_REF_MAX_FRAGS]; /**< Payload fragments. */
+} nrf_ble_gq_gatts_hvx_ref_t;
+
 /**@brief Structure used to handle SoftDevice error. */
 typedef struct
 {
@@ -186,9 +261,28 @@ typedef struct
         nrf_ble_gq_gattc_char_disc_t     gattc_char_disc; /**< GATTC characteristic discovery parameters. Filled when nrf_ble_gq_req_t::type is @ref NRF_BLE_GQ_REQ_CHAR_DISCOVERY. */
         nrf_ble_gq_gattc_desc_disc_t     gattc_desc_disc; /**< GATTC characteristic descriptor discovery parameters. Filled when nrf_ble_gq_req_t::type is NRF_BLE_GQ_REQ_DESC_DISCOVERY. */
         nrf_ble_gq_gatts_hvx_t           gatts_hvx;       /**< GATTS Handle Value Notification or Indication Parameters. Filled when nrf_ble_gq_req_t::type is @ref NRF_BLE_GQ_REQ_GATTS_HVX. */
+        nrf_ble_gq_gatts_hvx_ref_t       gatts_hvx_ref;   /**< GATTS Handle Value Notification or Indication Parameters with payload by reference. Filled when nrf_ble_gq_req_t::type is @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF. */
+        nrf_ble_gq_gattc_read_by_uuid_t  gattc_read_by_uuid; /**< GATTC read by UUID parameters. Filled when nrf_ble_gq_req_t::type is @ref NRF_BLE_GQ_REQ_GATTC_READ_BY_UUID. */
     } params;
 } nrf_ble_gq_req_t;
 
+/**@brief Notification statistics of a connection. */
+typedef struct
+{
+    uint32_t hvn_tx_cnt;      /**< Number of notifications reported as transmitted by @ref BLE_GATTS_EVT_HVN_TX_COMPLETE. */
+    uint32_t tx_complete_cnt; /**< Number of @ref BLE_GATTS_EVT_HVN_TX_COMPLETE events. The SoftDevice reports at most one per connection event. */
+    uint32_t resources_cnt;   /**< Number of times the SoftDevice notification queue was full. */
+    uint8_t  max_burst;       /**< Largest number of notifications reported in a single event. */
+} nrf_ble_gq_hvx_stats_t;
+
+/**@brief Burst state of a connection. Used when @ref NRF_BLE_GQ_HVX_BURST_ENABLED is set. */
+typedef struct
+{
+    uint8_t                credits;       /**< Free notification buffers in the SoftDevice. Valid only if @p credits_known is true. */
+    bool                   credits_known; /**< False until the SoftDevice queue has been found full once. Until then, notifications are sent until @ref NRF_ERROR_RESOURCES. */
+    nrf_ble_gq_hvx_stats_t stats;         /**< Notification statistics. */
+} nrf_ble_gq_hvx_burst_t;
+
 /**@brief Descriptor for the BLE GATT Queue instance. */
 typedef struct
 {
@@ -197,6 +291,9 @@ typedef struct
     nrf_queue_t const * const p_req_queue;    /**< Pointer to array of queue instances used to hold nrf_ble_gq_req_t instances.*/
     nrf_queue_t const * const p_purge_queue;  /**< Pointer to the queue instance used to hold indexes of queues to purge.*/
     nrf_memobj_pool_t const * p_data_pool;    /**< Memory pool used to obtain nrf_memobj_t instances.*/
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    nrf_ble_gq_hvx_burst_t  * p_hvx_burst;    /**< Pointer to array with burst state of registered connections. */
+#endif
 } nrf_ble_gq_t;
 
 
@@ -214,8 +311,10 @@ typedef struct
  * @retval    NRF_SUCCESS             If the request was added successfully.
  * @retval    NRF_ERROR_NULL          Any parameter was NULL.
  * @retval    NRF_ERROR_NO_MEM        There was no room in the queue or in the data pool.
- * @retval    NRF_ERROR_INVALID_PARAM If \p conn_handle is not registered or type of request -
- *                                    \p p_req is not valid.
+ * @retval    NRF_ERROR_INVALID_PARAM If \p conn_handle is not registered, type of request -
+ *                                    \p p_req is not valid, or the fragment count or payload
+ *                                    length of a @ref NRF_BLE_GQ_REQ_GATTS_HVX_REF request is
+ *                                    out of range.
  * @retval    err_code				  Other request specific error codes may be returned.
  */
 ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t const * const p_gatt_queue,
@@ -239,6 +338,27 @@ ret_code_t nrf_ble_gq_item_add(nrf_ble_gq_t const * const p_gatt_queue,
 ret_code_t nrf_ble_gq_conn_handle_register(nrf_ble_gq_t * const p_gatt_queue, uint16_t conn_handle);
 
 
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1) || defined(__SDK_DOXYGEN__)
+/**@brief Function for getting the notification statistics of a connection.
+ *
+ * @details The average number of notifications sent per connection event is
+ *          nrf_ble_gq_hvx_stats_t::hvn_tx_cnt divided by nrf_ble_gq_hvx_stats_t::tx_complete_cnt.
+ *          Statistics are reset when the connection handle is registered.
+ *
+ * @param[in]  p_gatt_queue  Pointer to the BGQ instance.
+ * @param[in]  conn_handle   Connection handle.
+ * @param[out] p_stats       Statistics.
+ *
+ * @retval    NRF_SUCCESS             If the statistics were copied.
+ * @retval    NRF_ERROR_NULL          Any parameter was NULL.
+ * @retval    NRF_ERROR_INVALID_PARAM If \p conn_handle is not registered.
+ */
+ret_code_t nrf_ble_gq_hvx_stats_get(nrf_ble_gq_t     const * const p_gatt_queue,
+                                    uint16_t                       conn_handle,
+                                    nrf_ble_gq_hvx_stats_t * const p_stats);
+#endif
+
+
 /**@brief     Function for handling BLE events from the SoftDevice.
  *
  * @details   This function handles the BLE events received from the SoftDevice. If a BLE
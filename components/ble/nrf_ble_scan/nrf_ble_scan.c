@@ -571,6 +571,570 @@ static ret_code_t nrf_ble_scan_appearance_filter_add(nrf_ble_scan_t * const p_sc
 #endif // NRF_BLE_SCAN_APPEARANCE_CNT
 
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+#define CLS_UUID16_SIZE  2  /**< Size of a 16-bit UUID. */
+#define CLS_UUID128_SIZE 16 /**< Size of a 128-bit UUID. */
+
+/**@brief Offsets of the AD structures used by the classifier.
+ *
+ * @details Filled by a single pass over the advertising data. Length 0 means that the AD structure
+ *          was not found or is malformed.
+ */
+typedef struct
+{
+    uint16_t name_off;       /**< Complete local name. */
+    uint8_t  name_len;
+    uint16_t short_name_off; /**< Shortened local name. */
+    uint8_t  short_name_len;
+    uint16_t uuid16_off;     /**< 16-bit UUID list. */
+    uint8_t  uuid16_len;
+    uint16_t uuid128_off;    /**< 128-bit UUID list. */
+    uint8_t  uuid128_len;
+    uint16_t appearance_off; /**< Appearance. */
+    uint8_t  appearance_len;
+} cls_ad_table_t;
+
+
+/**@brief Function for hashing a key of the classifier.
+ *
+ * @details 32-bit FNV-1a folded to 16 bits. The filter type is the seed, so that equal keys of
+ *          different types land in different slots.
+ */
+static uint16_t cls_hash(uint8_t type, uint8_t const * p_key, uint16_t len)
+{
+    uint32_t hash = 2166136261UL ^ type;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        hash ^= p_key[i];
+        hash *= 16777619UL;
+    }
+
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+
+/**@brief Function for getting the filter mode bit of a filter type.
+ */
+static uint8_t cls_type_mask(uint8_t type)
+{
+    switch (type)
+    {
+        case SCAN_NAME_FILTER:       return NRF_BLE_SCAN_NAME_FILTER;
+        case SCAN_SHORT_NAME_FILTER: return NRF_BLE_SCAN_SHORT_NAME_FILTER;
+        case SCAN_ADDR_FILTER:       return NRF_BLE_SCAN_ADDR_FILTER;
+        case SCAN_UUID_FILTER:       return NRF_BLE_SCAN_UUID_FILTER;
+        case SCAN_APPEARANCE_FILTER: return NRF_BLE_SCAN_APPEARANCE_FILTER;
+        default:                     return 0;
+    }
+}
+
+
+/**@brief Function for finding a filter in the classifier.
+ *
+ * @param[in] p_cls   Classifier.
+ * @param[in] type    Filter type.
+ * @param[in] hash    Hash of the key.
+ * @param[in] p_key   Key.
+ * @param[in] len     Length of the key.
+ * @param[in] min_len Minimum length of the short name. 0 for other filter types.
+ *
+ * @return Pointer to the slot holding the filter, or to the empty slot where it can be added.
+ */
+static nrf_ble_scan_cls_entry_t * cls_slot_find(nrf_ble_scan_classifier_t const * p_cls,
+                                                uint8_t                           type,
+                                                uint16_t                          hash,
+                                                uint8_t const                   * p_key,
+                                                uint8_t                           len,
+                                                uint8_t                           min_len)
+{
+    uint16_t const             mask    = p_cls->slot_cnt - 1;
+    nrf_ble_scan_cls_entry_t * p_entry = &p_cls->p_entries[hash & mask];
+
+    // Linear probing. The table always has an empty slot, so the loop terminates.
+    while (p_entry->p_key != NULL)
+    {
+        if (   (p_entry->hash == hash)
+            && (p_entry->type == type)
+            && (p_entry->len == len)
+            && (p_entry->min_len == min_len)
+            && (memcmp(p_entry->p_key, p_key, len) == 0))
+        {
+            break;
+        }
+
+        p_entry = &p_cls->p_entries[(p_entry - p_cls->p_entries + 1) & mask];
+    }
+
+    return p_entry;
+}
+
+
+/**@brief Function for finding a key of an advertising report in the classifier.
+ *
+ * @return Pointer to the matching filter, or NULL if there is none.
+ */
+static nrf_ble_scan_cls_entry_t * cls_lookup(nrf_ble_scan_classifier_t const * p_cls,
+                                             uint8_t                           type,
+                                             uint8_t const                   * p_key,
+                                             uint8_t                           len)
+{
+    nrf_ble_scan_cls_entry_t * p_entry;
+
+    p_entry = cls_slot_find(p_cls, type, cls_hash(type, p_key, len), p_key, len, 0);
+
+    return (p_entry->p_key != NULL) ? p_entry : NULL;
+}
+
+
+/**@brief Function for adding a filter to the classifier.
+ *
+ * @param[in,out] p_cls    Classifier.
+ * @param[in]     type     Filter type.
+ * @param[in]     p_key    Key. Copied to the key pool.
+ * @param[in]     len      Length of the key.
+ * @param[in]     hash_len Number of key bytes to hash. Shorter than @p len only for short names.
+ * @param[in]     min_len  Minimum length of the short name. 0 for other filter types.
+ *
+ * @retval NRF_SUCCESS       If the filter is added or if it was already added before.
+ * @retval NRF_ERROR_NO_MEM  If the hash table or the key pool is full.
+ */
+static ret_code_t cls_filter_add(nrf_ble_scan_classifier_t * p_cls,
+                                 uint8_t                     type,
+                                 uint8_t const             * p_key,
+                                 uint8_t                     len,
+                                 uint8_t                     hash_len,
+                                 uint8_t                     min_len)
+{
+    uint16_t const             hash    = cls_hash(type, p_key, hash_len);
+    nrf_ble_scan_cls_entry_t * p_entry = cls_slot_find(p_cls, type, hash, p_key, len, min_len);
+
+    // Check for duplicated filter.
+    if (p_entry->p_key != NULL)
+    {
+        return NRF_SUCCESS;
+    }
+
+    // Keep at least one slot empty.
+    if (   (p_cls->filter_cnt + 1 >= p_cls->slot_cnt)
+        || (p_cls->pool_used + len > p_cls->pool_size))
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memcpy(&p_cls->p_pool[p_cls->pool_used], p_key, len);
+
+    p_entry->p_key   = &p_cls->p_pool[p_cls->pool_used];
+    p_entry->hash    = hash;
+    p_entry->len     = len;
+    p_entry->type    = type;
+    p_entry->min_len = min_len;
+    p_entry->mark    = 0;
+
+    p_cls->pool_used += len;
+    p_cls->filter_cnt++;
+    p_cls->type_mask |= cls_type_mask(type);
+
+    if (type == SCAN_UUID_FILTER)
+    {
+        p_cls->uuid_cnt++;
+    }
+    else if (type == SCAN_SHORT_NAME_FILTER)
+    {
+        p_cls->short_len_mask |= (1UL << min_len);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for adding a filter of any type to the classifier.
+ *
+ * @details Keys are converted to the format in which they appear in the advertising report, so
+ *          that matching needs no conversion. UUIDs are encoded with @ref sd_ble_uuid_encode.
+ */
+static ret_code_t cls_filter_set(nrf_ble_scan_classifier_t * p_cls,
+                                 nrf_ble_scan_filter_type_t  type,
+                                 void const                * p_data)
+{
+    switch (type)
+    {
+        case SCAN_NAME_FILTER:
+        {
+            size_t name_len = strlen((char const *)p_data);
+
+            if ((name_len == 0) || (name_len > UINT8_MAX))
+            {
+                return NRF_ERROR_DATA_SIZE;
+            }
+
+            return cls_filter_add(p_cls, type, p_data, name_len, name_len, 0);
+        }
+
+        case SCAN_SHORT_NAME_FILTER:
+        {
+            nrf_ble_scan_short_name_t const * p_short_name = p_data;
+            size_t name_len;
+
+            VERIFY_PARAM_NOT_NULL(p_short_name->p_short_name);
+            name_len = strlen(p_short_name->p_short_name);
+
+            // Minimum lengths are kept in a 32-bit mask.
+            if (   (name_len == 0)
+                || (name_len > UINT8_MAX)
+                || (p_short_name->short_name_min_len > 31))
+            {
+                return NRF_ERROR_DATA_SIZE;
+            }
+
+            // The advertised name must be shorter than the filter, so this filter never matches.
+            // It is accepted, as by the filters without the classifier.
+            if (p_short_name->short_name_min_len >= name_len)
+            {
+                return NRF_SUCCESS;
+            }
+
+            return cls_filter_add(p_cls,
+                                  type,
+                                  (uint8_t const *)p_short_name->p_short_name,
+                                  name_len,
+                                  p_short_name->short_name_min_len,
+                                  p_short_name->short_name_min_len);
+        }
+
+        case SCAN_ADDR_FILTER:
+            return cls_filter_add(p_cls, type, p_data, BLE_GAP_ADDR_LEN, BLE_GAP_ADDR_LEN, 0);
+
+        case SCAN_UUID_FILTER:
+        {
+            ret_code_t err_code;
+            uint8_t    raw_uuid[CLS_UUID128_SIZE];
+            uint8_t    raw_uuid_len = sizeof(raw_uuid);
+
+            err_code = sd_ble_uuid_encode(p_data, &raw_uuid_len, raw_uuid);
+            VERIFY_SUCCESS(err_code);
+
+            if ((raw_uuid_len != CLS_UUID16_SIZE) && (raw_uuid_len != CLS_UUID128_SIZE))
+            {
+                return NRF_ERROR_INVALID_PARAM;
+            }
+
+            return cls_filter_add(p_cls, type, raw_uuid, raw_uuid_len, raw_uuid_len, 0);
+        }
+
+        case SCAN_APPEARANCE_FILTER:
+        {
+            uint8_t appearance[sizeof(uint16_t)];
+
+            UNUSED_RETURN_VALUE(uint16_encode(*(uint16_t const *)p_data, appearance));
+
+            return cls_filter_add(p_cls, type, appearance, sizeof(appearance), sizeof(appearance), 0);
+        }
+
+        default:
+            return NRF_ERROR_INVALID_PARAM;
+    }
+}
+
+
+/**@brief Function for removing all filters from the classifier.
+ */
+static void cls_filters_clear(nrf_ble_scan_classifier_t * p_cls)
+{
+    memset(p_cls->p_entries, 0, p_cls->slot_cnt * sizeof(p_cls->p_entries[0]));
+
+    p_cls->pool_used      = 0;
+    p_cls->filter_cnt     = 0;
+    p_cls->uuid_cnt       = 0;
+    p_cls->short_len_mask = 0;
+    p_cls->type_mask      = 0;
+    p_cls->report_cnt     = 0;
+}
+
+
+/**@brief Function for building the table of AD structures of an advertising report.
+ *
+ * @details The first AD structure of each type is used, like in @ref ble_advdata_search.
+ *          For UUIDs, the complete list takes precedence over the incomplete one.
+ */
+static void cls_ad_table_build(uint8_t const * p_data, uint16_t data_len, cls_ad_table_t * p_table)
+{
+    uint16_t uuid16_more_off  = 0;
+    uint8_t  uuid16_more_len  = 0;
+    uint16_t uuid128_more_off = 0;
+    uint8_t  uuid128_more_len = 0;
+
+    memset(p_table, 0, sizeof(*p_table));
+
+    for (uint16_t i = 0; (i + 1) < data_len; i += p_data[i] + 1)
+    {
+        uint16_t * p_off;
+        uint8_t  * p_len;
+        uint8_t    len = p_data[i];
+
+        switch (p_data[i + 1])
+        {
+            case BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME:
+                p_off = &p_table->name_off;
+                p_len = &p_table->name_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME:
+                p_off = &p_table->short_name_off;
+                p_len = &p_table->short_name_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE:
+                p_off = &p_table->uuid16_off;
+                p_len = &p_table->uuid16_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE:
+                p_off = &uuid16_more_off;
+                p_len = &uuid16_more_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE:
+                p_off = &p_table->uuid128_off;
+                p_len = &p_table->uuid128_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_MORE_AVAILABLE:
+                p_off = &uuid128_more_off;
+                p_len = &uuid128_more_len;
+                break;
+
+            case BLE_GAP_AD_TYPE_APPEARANCE:
+                p_off = &p_table->appearance_off;
+                p_len = &p_table->appearance_len;
+                break;
+
+            default:
+                continue;
+        }
+
+        // Only the first AD structure of a type counts. A malformed one hides the later ones.
+        if (*p_off == 0)
+        {
+            *p_off = i + 2;
+
+            if ((len > 1) && ((i + 1 + len) <= data_len))
+            {
+                *p_len = len - 1;
+            }
+        }
+    }
+
+    if (p_table->uuid16_len == 0)
+    {
+        p_table->uuid16_off = uuid16_more_off;
+        p_table->uuid16_len = uuid16_more_len;
+    }
+
+    if (p_table->uuid128_len == 0)
+    {
+        p_table->uuid128_off = uuid128_more_off;
+        p_table->uuid128_len = uuid128_more_len;
+    }
+}
+
+
+/**@brief Function for matching the advertised short name against the short name filters.
+ */
+static bool cls_short_name_match(nrf_ble_scan_classifier_t const * p_cls,
+                                 uint8_t const                   * p_name,
+                                 uint8_t                           name_len)
+{
+    uint16_t const mask        = p_cls->slot_cnt - 1;
+    uint8_t const  max_min_len = MIN(name_len, 31);
+
+    // Each distinct minimum length is a separate hash of the advertised name prefix.
+    for (uint8_t min_len = 0; min_len <= max_min_len; min_len++)
+    {
+        if ((p_cls->short_len_mask & (1UL << min_len)) == 0)
+        {
+            continue;
+        }
+
+        uint16_t const             hash    = cls_hash(SCAN_SHORT_NAME_FILTER, p_name, min_len);
+        nrf_ble_scan_cls_entry_t * p_entry = &p_cls->p_entries[hash & mask];
+
+        for (; p_entry->p_key != NULL; p_entry = &p_cls->p_entries[(p_entry - p_cls->p_entries + 1) & mask])
+        {
+            if (   (p_entry->hash == hash)
+                && (p_entry->type == SCAN_SHORT_NAME_FILTER)
+                && (p_entry->min_len == min_len)
+                && (name_len < p_entry->len)
+                && (memcmp(p_entry->p_key, p_name, name_len) == 0))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/**@brief Function for matching the advertised UUIDs against the UUID filters.
+ *
+ * @param[in,out] p_cls     Classifier.
+ * @param[in]     p_list    UUID list from the advertising report.
+ * @param[in]     list_len  Length of the UUID list.
+ * @param[in]     uuid_size Size of one UUID.
+ * @param[in]     match_all If true, stop only when all UUID filters are matched.
+ * @param[in,out] p_cnt     Number of distinct UUID filters matched.
+ */
+static void cls_uuid_match(nrf_ble_scan_classifier_t * p_cls,
+                           uint8_t const             * p_list,
+                           uint16_t                    list_len,
+                           uint8_t                     uuid_size,
+                           bool                        match_all,
+                           uint16_t                  * p_cnt)
+{
+    for (uint16_t off = 0; (off + uuid_size) <= list_len; off += uuid_size)
+    {
+        nrf_ble_scan_cls_entry_t * p_entry =
+            cls_lookup(p_cls, SCAN_UUID_FILTER, &p_list[off], uuid_size);
+
+        // Count every filter once, even if the UUID is repeated in the report.
+        if ((p_entry != NULL) && (p_entry->mark != p_cls->report_cnt))
+        {
+            p_entry->mark = p_cls->report_cnt;
+            (*p_cnt)++;
+
+            if (!match_all || (*p_cnt == p_cls->uuid_cnt))
+            {
+                return;
+            }
+        }
+    }
+}
+
+
+/**@brief Function for classifying an advertising report.
+ *
+ * @details The advertising data is parsed once, and then every enabled filter type is matched
+ *          with hash table lookups.
+ *
+ * @param[in,out] p_cls        Classifier.
+ * @param[in]     p_adv_report Advertising report.
+ * @param[in]     match_all    Filter mode. If true, all UUID filters must be matched.
+ *
+ * @return Matched filter types, see @ref NRF_BLE_SCAN_FILTER_MODE.
+ */
+static uint8_t cls_classify(nrf_ble_scan_classifier_t      * p_cls,
+                            ble_gap_evt_adv_report_t const * p_adv_report,
+                            bool                             match_all)
+{
+    uint8_t const   mode   = p_cls->mode & p_cls->type_mask;
+    uint8_t const * p_data = p_adv_report->data.p_data;
+    uint8_t         match  = 0;
+    cls_ad_table_t  table;
+
+    if (mode == 0)
+    {
+        return 0;
+    }
+
+    if (   (mode & NRF_BLE_SCAN_ADDR_FILTER)
+        && (cls_lookup(p_cls, SCAN_ADDR_FILTER, p_adv_report->peer_addr.addr, BLE_GAP_ADDR_LEN) != NULL))
+    {
+        match |= NRF_BLE_SCAN_ADDR_FILTER;
+    }
+
+    if ((mode & ~NRF_BLE_SCAN_ADDR_FILTER) == 0)
+    {
+        return match;
+    }
+
+    cls_ad_table_build(p_data, p_adv_report->data.len, &table);
+
+    if (   (mode & NRF_BLE_SCAN_NAME_FILTER)
+        && (table.name_len != 0)
+        && (cls_lookup(p_cls, SCAN_NAME_FILTER, &p_data[table.name_off], table.name_len) != NULL))
+    {
+        match |= NRF_BLE_SCAN_NAME_FILTER;
+    }
+
+    if (   (mode & NRF_BLE_SCAN_SHORT_NAME_FILTER)
+        && (table.short_name_len != 0)
+        && cls_short_name_match(p_cls, &p_data[table.short_name_off], table.short_name_len))
+    {
+        match |= NRF_BLE_SCAN_SHORT_NAME_FILTER;
+    }
+
+    if (   (mode & NRF_BLE_SCAN_APPEARANCE_FILTER)
+        && (table.appearance_len >= sizeof(uint16_t))
+        && (cls_lookup(p_cls,
+                       SCAN_APPEARANCE_FILTER,
+                       &p_data[table.appearance_off],
+                       sizeof(uint16_t)) != NULL))
+    {
+        match |= NRF_BLE_SCAN_APPEARANCE_FILTER;
+    }
+
+    if (mode & NRF_BLE_SCAN_UUID_FILTER)
+    {
+        uint16_t uuid_match_cnt = 0;
+
+        // Start a new round of marks. Clear the marks when the counter wraps around.
+        if (++p_cls->report_cnt == 0)
+        {
+            for (uint16_t i = 0; i < p_cls->slot_cnt; i++)
+            {
+                p_cls->p_entries[i].mark = 0;
+            }
+            p_cls->report_cnt = 1;
+        }
+
+        cls_uuid_match(p_cls,
+                       &p_data[table.uuid16_off],
+                       table.uuid16_len,
+                       CLS_UUID16_SIZE,
+                       match_all,
+                       &uuid_match_cnt);
+
+        if (match_all || (uuid_match_cnt == 0))
+        {
+            cls_uuid_match(p_cls,
+                           &p_data[table.uuid128_off],
+                           table.uuid128_len,
+                           CLS_UUID128_SIZE,
+                           match_all,
+                           &uuid_match_cnt);
+        }
+
+        if (match_all ? (uuid_match_cnt == p_cls->uuid_cnt) : (uuid_match_cnt > 0))
+        {
+            match |= NRF_BLE_SCAN_UUID_FILTER;
+        }
+    }
+
+    return match;
+}
+
+
+ret_code_t nrf_ble_scan_classifier_attach(nrf_ble_scan_t            * const p_scan_ctx,
+                                          nrf_ble_scan_classifier_t * const p_classifier)
+{
+    VERIFY_PARAM_NOT_NULL(p_scan_ctx);
+
+    if (p_classifier != NULL)
+    {
+        cls_filters_clear(p_classifier);
+        p_classifier->mode = 0;
+    }
+
+    p_scan_ctx->p_classifier = p_classifier;
+
+    return NRF_SUCCESS;
+}
+
+
+#endif // NRF_BLE_SCAN_CLASSIFIER_ENABLED
+
+
 ret_code_t nrf_ble_scan_filter_set(nrf_ble_scan_t     * const p_scan_ctx,
                                    nrf_ble_scan_filter_type_t type,
                                    void const               * p_data)
@@ -578,6 +1142,13 @@ ret_code_t nrf_ble_scan_filter_set(nrf_ble_scan_t     * const p_scan_ctx,
     VERIFY_PARAM_NOT_NULL(p_scan_ctx);
     VERIFY_PARAM_NOT_NULL(p_data);
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    if (p_scan_ctx->p_classifier != NULL)
+    {
+        return cls_filter_set(p_scan_ctx->p_classifier, type, p_data);
+    }
+#endif
+
     switch (type)
     {
 #if (NRF_BLE_SCAN_NAME_CNT > 0)
@@ -628,6 +1199,14 @@ ret_code_t nrf_ble_scan_filter_set(nrf_ble_scan_t     * const p_scan_ctx,
 
 ret_code_t nrf_ble_scan_all_filter_remove(nrf_ble_scan_t * const p_scan_ctx)
 {
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    if (p_scan_ctx->p_classifier != NULL)
+    {
+        cls_filters_clear(p_scan_ctx->p_classifier);
+        return NRF_SUCCESS;
+    }
+#endif
+
 #if (NRF_BLE_SCAN_NAME_CNT > 0)
     nrf_ble_scan_name_filter_t * p_name_filter = &p_scan_ctx->scan_filters.name_filter;
     memset(p_name_filter->target_name, 0, sizeof(p_name_filter->target_name));
@@ -688,6 +1267,16 @@ ret_code_t nrf_ble_scan_filters_enable(nrf_ble_scan_t * const p_scan_ctx,
 
     nrf_ble_scan_filters_t * p_filters = &p_scan_ctx->scan_filters;
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    if (p_scan_ctx->p_classifier != NULL)
+    {
+        p_scan_ctx->p_classifier->mode = mode & NRF_BLE_SCAN_ALL_FILTER;
+        p_filters->all_filters_mode    = match_all;
+
+        return NRF_SUCCESS;
+    }
+#endif
+
     // Turn on the filters of your choice.
 #if (NRF_BLE_SCAN_ADDRESS_CNT > 0)
     if (mode & NRF_BLE_SCAN_ADDR_FILTER)
@@ -735,12 +1324,25 @@ ret_code_t nrf_ble_scan_filters_disable(nrf_ble_scan_t * const p_scan_ctx)
 {
     VERIFY_PARAM_NOT_NULL(p_scan_ctx);
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    if (p_scan_ctx->p_classifier != NULL)
+    {
+        p_scan_ctx->p_classifier->mode = 0;
+    }
+#endif
+
     // Disable all filters.
 #if (NRF_BLE_SCAN_NAME_CNT > 0)
     bool * p_name_filter_enabled = &p_scan_ctx->scan_filters.name_filter.name_filter_enabled;
     *p_name_filter_enabled = false;
 #endif
 
+#if (NRF_BLE_SCAN_SHORT_NAME_CNT > 0)
+    bool * p_short_name_filter_enabled =
+        &p_scan_ctx->scan_filters.short_name_filter.short_name_filter_enabled;
+    *p_short_name_filter_enabled = false;
+#endif
+
 #if (NRF_BLE_SCAN_ADDRESS_CNT > 0)
     bool * p_addr_filter_enabled = &p_scan_ctx->scan_filters.addr_filter.addr_filter_enabled;
     *p_addr_filter_enabled = false;
@@ -812,108 +1414,137 @@ static void nrf_ble_scan_on_adv_report(nrf_ble_scan_t           const * const p_
     bool const all_filter_mode   = p_scan_ctx->scan_filters.all_filters_mode;
     bool       is_filter_matched = false;
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    if (p_scan_ctx->p_classifier != NULL)
+    {
+        nrf_ble_scan_filter_match * p_match = &scan_evt.params.filter_match.filter_match;
+        uint8_t const               mode    = p_scan_ctx->p_classifier->mode;
+        uint8_t const               match   = cls_classify(p_scan_ctx->p_classifier,
+                                                           p_adv_report,
+                                                           all_filter_mode);
+
+        for (uint8_t bits = mode; bits != 0; bits &= (bits - 1))
+        {
+            filter_cnt++;
+        }
+        for (uint8_t bits = match; bits != 0; bits &= (bits - 1))
+        {
+            filter_match_cnt++;
+        }
+
+        p_match->name_filter_match       = ((match & NRF_BLE_SCAN_NAME_FILTER) != 0);
+        p_match->address_filter_match    = ((match & NRF_BLE_SCAN_ADDR_FILTER) != 0);
+        p_match->uuid_filter_match       = ((match & NRF_BLE_SCAN_UUID_FILTER) != 0);
+        p_match->appearance_filter_match = ((match & NRF_BLE_SCAN_APPEARANCE_FILTER) != 0);
+        p_match->short_name_filter_match = ((match & NRF_BLE_SCAN_SHORT_NAME_FILTER) != 0);
+        is_filter_matched                = (match != 0);
+    }
+    else
+#endif // NRF_BLE_SCAN_CLASSIFIER_ENABLED
+    {
 #if (NRF_BLE_SCAN_ADDRESS_CNT > 0)
-    bool const addr_filter_enabled = p_scan_ctx->scan_filters.addr_filter.addr_filter_enabled;
+        bool const addr_filter_enabled = p_scan_ctx->scan_filters.addr_filter.addr_filter_enabled;
 #endif
 
 #if (NRF_BLE_SCAN_NAME_CNT > 0)
-    bool const name_filter_enabled = p_scan_ctx->scan_filters.name_filter.name_filter_enabled;
+        bool const name_filter_enabled = p_scan_ctx->scan_filters.name_filter.name_filter_enabled;
 #endif
 
 #if (NRF_BLE_SCAN_SHORT_NAME_CNT > 0)
-    bool const short_name_filter_enabled =
-        p_scan_ctx->scan_filters.short_name_filter.short_name_filter_enabled;
+        bool const short_name_filter_enabled =
+            p_scan_ctx->scan_filters.short_name_filter.short_name_filter_enabled;
 #endif
 
 #if (NRF_BLE_SCAN_UUID_CNT > 0)
-    bool const uuid_filter_enabled = p_scan_ctx->scan_filters.uuid_filter.uuid_filter_enabled;
+        bool const uuid_filter_enabled = p_scan_ctx->scan_filters.uuid_filter.uuid_filter_enabled;
 #endif
 
 #if (NRF_BLE_SCAN_APPEARANCE_CNT > 0)
-    bool const appearance_filter_enabled =
-        p_scan_ctx->scan_filters.appearance_filter.appearance_filter_enabled;
+        bool const appearance_filter_enabled =
+            p_scan_ctx->scan_filters.appearance_filter.appearance_filter_enabled;
 #endif
 
 
 #if (NRF_BLE_SCAN_ADDRESS_CNT > 0)
-    // Check the address filter.
-    if (addr_filter_enabled)
-    {
-        // Number of active filters.
-        filter_cnt++;
-        if (adv_addr_compare(p_adv_report, p_scan_ctx))
+        // Check the address filter.
+        if (addr_filter_enabled)
         {
-            // Number of filters matched.
-            filter_match_cnt++;
-            // Information about the filters matched.
-            scan_evt.params.filter_match.filter_match.address_filter_match = true;
-            is_filter_matched = true;
+            // Number of active filters.
+            filter_cnt++;
+            if (adv_addr_compare(p_adv_report, p_scan_ctx))
+            {
+                // Number of filters matched.
+                filter_match_cnt++;
+                // Information about the filters matched.
+                scan_evt.params.filter_match.filter_match.address_filter_match = true;
+                is_filter_matched = true;
+            }
         }
-    }
 #endif
 
 #if (NRF_BLE_SCAN_NAME_CNT > 0)
-    // Check the name filter.
-    if (name_filter_enabled)
-    {
-        filter_cnt++;
-        if (adv_name_compare(p_adv_report, p_scan_ctx))
+        // Check the name filter.
+        if (name_filter_enabled)
         {
-            filter_match_cnt++;
+            filter_cnt++;
+            if (adv_name_compare(p_adv_report, p_scan_ctx))
+            {
+                filter_match_cnt++;
 
-            // Information about the filters matched.
-            scan_evt.params.filter_match.filter_match.name_filter_match = true;
-            is_filter_matched = true;
+                // Information about the filters matched.
+                scan_evt.params.filter_match.filter_match.name_filter_match = true;
+                is_filter_matched = true;
+            }
         }
-    }
 #endif
 
 #if (NRF_BLE_SCAN_SHORT_NAME_CNT > 0)
-    if (short_name_filter_enabled)
-    {
-        filter_cnt++;
-        if (adv_short_name_compare(p_adv_report, p_scan_ctx))
+        if (short_name_filter_enabled)
         {
-            filter_match_cnt++;
+            filter_cnt++;
+            if (adv_short_name_compare(p_adv_report, p_scan_ctx))
+            {
+                filter_match_cnt++;
 
-            // Information about the filters matched.
-            scan_evt.params.filter_match.filter_match.short_name_filter_match = true;
-            is_filter_matched = true;
+                // Information about the filters matched.
+                scan_evt.params.filter_match.filter_match.short_name_filter_match = true;
+                is_filter_matched = true;
+            }
         }
-    }
 #endif
 
 #if (NRF_BLE_SCAN_UUID_CNT > 0)
-    // Check the UUID filter.
-    if (uuid_filter_enabled)
-    {
-        filter_cnt++;
-        if (adv_uuid_compare(p_adv_report, p_scan_ctx))
+        // Check the UUID filter.
+        if (uuid_filter_enabled)
         {
-            filter_match_cnt++;
-            // Information about the filters matched.
-            scan_evt.params.filter_match.filter_match.uuid_filter_match = true;
-            is_filter_matched = true;
+            filter_cnt++;
+            if (adv_uuid_compare(p_adv_report, p_scan_ctx))
+            {
+                filter_match_cnt++;
+                // Information about the filters matched.
+                scan_evt.params.filter_match.filter_match.uuid_filter_match = true;
+                is_filter_matched = true;
+            }
         }
-    }
 #endif
 
 #if (NRF_BLE_SCAN_APPEARANCE_CNT > 0)
-    // Check the appearance filter.
-    if (appearance_filter_enabled)
-    {
-        filter_cnt++;
-        if (adv_appearance_compare(p_adv_report, p_scan_ctx))
+        // Check the appearance filter.
+        if (appearance_filter_enabled)
         {
-            filter_match_cnt++;
-            // Information about the filters matched.
-            scan_evt.params.filter_match.filter_match.appearance_filter_match = true;
-            is_filter_matched = true;
+            filter_cnt++;
+            if (adv_appearance_compare(p_adv_report, p_scan_ctx))
+            {
+                filter_match_cnt++;
+                // Information about the filters matched.
+                scan_evt.params.filter_match.filter_match.appearance_filter_match = true;
+                is_filter_matched = true;
+            }
         }
-    }
 
-    scan_evt.scan_evt_id = NRF_BLE_SCAN_EVT_NOT_FOUND;
+        scan_evt.scan_evt_id = NRF_BLE_SCAN_EVT_NOT_FOUND;
 #endif
+    }
 
     scan_evt.params.filter_match.p_adv_report = p_adv_report;
 
@@ -1053,6 +1684,9 @@ ret_code_t nrf_ble_scan_init(nrf_ble_scan_t            * const p_scan_ctx,
     // Disable all scanning filters.
     memset(&p_scan_ctx->scan_filters, 0, sizeof(p_scan_ctx->scan_filters));
 #endif
+#if (NRF_BLE_SCAN_FILTER_ENABLE == 1) && (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    p_scan_ctx->p_classifier = NULL;
+#endif
 
     // If the pointer to the initialization structure exist, use it to scan the configuration.
     if (p_init != NULL)
@@ -71,6 +71,10 @@
 extern "C" {
 #endif
 
+#ifndef NRF_BLE_SCAN_CLASSIFIER_ENABLED
+#define NRF_BLE_SCAN_CLASSIFIER_ENABLED 0 /**< Enable the single-pass advertising report classifier. */
+#endif
+
 
 /**@defgroup NRF_BLE_SCAN_FILTER_MODE Filter modes
  * @{ */
@@ -284,6 +288,67 @@ typedef struct
     bool all_filters_mode;                              /**< Filter mode. If true, all set filters must be matched to generate an event.*/
 } nrf_ble_scan_filters_t;
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+
+/**@brief Entry of the classifier hash table.
+ */
+typedef struct
+{
+    uint8_t const * p_key;   /**< Key bytes (address, raw UUID, appearance or name) stored in the key pool. NULL if the slot is empty. */
+    uint16_t        hash;    /**< Hash of the key. */
+    uint8_t         len;     /**< Length of the key. */
+    uint8_t         type;    /**< Filter type, see @ref nrf_ble_scan_filter_type_t. */
+    uint8_t         min_len; /**< Minimum length of the short name. Used only by short name filters. */
+    uint8_t         mark;    /**< Number of the last report that matched this entry. Used to count UUID matches. */
+} nrf_ble_scan_cls_entry_t;
+
+/**@brief Classifier of advertising reports.
+ *
+ * @details When a classifier is attached to the Scanning Module with
+ *          @ref nrf_ble_scan_classifier_attach, each advertising report is parsed once and all
+ *          filters are matched through a single hash table. The number of filters is then limited
+ *          only by the size of the table and of the key pool, and not by NRF_BLE_SCAN_*_CNT.
+ *          Use @ref NRF_BLE_SCAN_CLASSIFIER_DEF to define an instance.
+ */
+typedef struct
+{
+    nrf_ble_scan_cls_entry_t * p_entries;       /**< Hash table. */
+    uint8_t                  * p_pool;          /**< Pool for the keys of the filters. */
+    uint16_t                   slot_cnt;        /**< Number of hash table slots. Must be a power of two. */
+    uint16_t                   pool_size;       /**< Size of the key pool. */
+    uint16_t                   pool_used;       /**< Bytes used in the key pool. */
+    uint16_t                   filter_cnt;      /**< Number of filters in the hash table. */
+    uint16_t                   uuid_cnt;        /**< Number of UUID filters. */
+    uint32_t                   short_len_mask;  /**< Bit n is set if a short name filter has minimum length n. */
+    uint8_t                    type_mask;       /**< Filter types with at least one filter, see @ref NRF_BLE_SCAN_FILTER_MODE. */
+    uint8_t                    mode;            /**< Enabled filters, see @ref NRF_BLE_SCAN_FILTER_MODE. */
+    uint8_t                    report_cnt;      /**< Number of classified reports. Used to mark matched entries. */
+} nrf_ble_scan_classifier_t;
+
+/**@brief Macro for defining a classifier instance.
+ *
+ * @param _name      Name of the instance.
+ * @param _slot_cnt  Number of hash table slots. Must be a power of two and should be at least
+ *                   twice the number of filters.
+ * @param _pool_size Size of the pool for the filter keys, in bytes. Each filter needs the length
+ *                   of its key: 6 bytes for an address, 2 or 16 for a UUID, 2 for an appearance
+ *                   and the length of the name for name filters.
+ * @hideinitializer
+ */
+#define NRF_BLE_SCAN_CLASSIFIER_DEF(_name, _slot_cnt, _pool_size)                   \
+    STATIC_ASSERT(IS_POWER_OF_TWO(_slot_cnt));                                      \
+    static nrf_ble_scan_cls_entry_t CONCAT_2(_name, _entries)[_slot_cnt];           \
+    static uint8_t                  CONCAT_2(_name, _pool)[_pool_size];             \
+    static nrf_ble_scan_classifier_t _name =                                        \
+    {                                                                               \
+        .p_entries = CONCAT_2(_name, _entries),                                     \
+        .p_pool    = CONCAT_2(_name, _pool),                                        \
+        .slot_cnt  = (_slot_cnt),                                                   \
+        .pool_size = (_pool_size),                                                  \
+    }
+
+#endif // NRF_BLE_SCAN_CLASSIFIER_ENABLED
+
 #endif // NRF_BLE_SCAN_FILTER_ENABLE
 
 /**@brief Scan module instance. Options for the different scanning modes.
@@ -295,6 +360,9 @@ typedef struct
 {
 #if (NRF_BLE_SCAN_FILTER_ENABLE == 1)
     nrf_ble_scan_filters_t scan_filters;                              /**< Filter data. */
+#endif
+#if (NRF_BLE_SCAN_FILTER_ENABLE == 1) && (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+    nrf_ble_scan_classifier_t * p_classifier;                         /**< Classifier used instead of @p scan_filters. NULL if not attached. */
 #endif
     bool                       connect_if_match;                      /**< If set to true, the module automatically connects after a filter match or successful identification of a device from the whitelist. */
     ble_gap_conn_params_t      conn_params;                           /**< Connection parameters. */
@@ -443,6 +511,29 @@ ret_code_t nrf_ble_scan_filter_set(nrf_ble_scan_t     * const p_scan_ctx,
 ret_code_t nrf_ble_scan_all_filter_remove(nrf_ble_scan_t * const p_scan_ctx);
 
 
+#if (NRF_BLE_SCAN_CLASSIFIER_ENABLED == 1)
+/**@brief Function for attaching a classifier to the Scanning Module.
+ *
+ * @details After this call, @ref nrf_ble_scan_filter_set, @ref nrf_ble_scan_filters_enable,
+ *          @ref nrf_ble_scan_filters_disable and @ref nrf_ble_scan_all_filter_remove operate on
+ *          the classifier, and advertising reports are matched by the classifier. Filters already
+ *          set in the module are not moved to the classifier. Name filters are not limited by
+ *          @ref NRF_BLE_SCAN_NAME_MAX_LEN, but by the size of the advertising data.
+ *          @ref nrf_ble_scan_filter_get does not report the filters of the classifier.
+ *          Call this function after @ref nrf_ble_scan_init.
+ *
+ * @param[in,out] p_scan_ctx   Pointer to the Scanning Module instance.
+ * @param[in]     p_classifier Classifier defined with @ref NRF_BLE_SCAN_CLASSIFIER_DEF.
+ *                             NULL detaches the classifier.
+ *
+ * @retval NRF_SUCCESS    If the classifier is attached or detached.
+ * @retval NRF_ERROR_NULL If a NULL pointer is passed as the Scanning Module instance.
+ */
+ret_code_t nrf_ble_scan_classifier_attach(nrf_ble_scan_t            * const p_scan_ctx,
+                                          nrf_ble_scan_classifier_t * const p_classifier);
+#endif // NRF_BLE_SCAN_CLASSIFIER_ENABLED
+
+
 #endif // NRF_BLE_SCAN_FILTER_ENABLE
 
 
@@ -550,6 +550,18 @@ void gcm_im_evt_handler(pm_evt_t * p_event)
  */
 void gcm_pdb_evt_handler(pm_evt_t * p_event)
 {
+#if PM_LOCAL_DB_DIGEST_ENABLED
+    if (   (   (p_event->evt_id == PM_EVT_PEER_DATA_UPDATE_SUCCEEDED)
+            && (p_event->params.peer_data_update_succeeded.data_id == PM_PEER_DATA_ID_GATT_LOCAL))
+        || (   (p_event->evt_id == PM_EVT_PEER_DATA_UPDATE_FAILED)
+            && (p_event->params.peer_data_update_failed.data_id == PM_PEER_DATA_ID_GATT_LOCAL))
+        || (p_event->evt_id == PM_EVT_PEER_DELETE_SUCCEEDED))
+    {
+        // The stored local database has changed, or did not change as expected.
+        gscm_local_db_digest_clear(p_event->peer_id);
+    }
+#endif
+
     if (   p_event->evt_id == PM_EVT_PEER_DATA_UPDATE_SUCCEEDED
         && p_event->params.peer_data_update_succeeded.action == PM_PEER_DATA_OP_UPDATE)
     {
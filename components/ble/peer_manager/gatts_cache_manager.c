@@ -49,6 +49,10 @@
 #include "peer_database.h"
 #include "peer_data_storage.h"
 #include "id_manager.h"
+#if PM_LOCAL_DB_DIGEST_ENABLED
+#include "ble_conn_state.h"
+#include "crc16.h"
+#endif
 
 #define NRF_LOG_MODULE_NAME peer_manager_gscm
 #if PM_LOG_ENABLED
@@ -86,6 +90,19 @@ static pm_evt_handler_internal_t m_evt_handlers[] =
 
 static bool               m_module_initialized;
 static pm_peer_id_t       m_current_sc_store_peer_id;
+static pm_local_db_write_stats_t m_write_stats;
+
+#if PM_LOCAL_DB_DIGEST_ENABLED
+/**@brief Digest of the system attributes of a peer that are in flash or queued for flash. */
+typedef struct
+{
+    pm_peer_id_t peer_id; /**< Peer the digest belongs to. @ref PM_PEER_ID_INVALID if unused. */
+    uint16_t     len;     /**< Length of the system attributes. */
+    uint16_t     crc;     /**< CRC-16 of the system attributes. */
+} local_db_digest_t;
+
+static local_db_digest_t  m_local_db_digests[BLE_CONN_STATE_MAX_CONNECTIONS]; /**< One digest per connection. */
+#endif
 
 
 /**@brief Function for resetting the module variable(s) of the GSCM module.
@@ -95,6 +112,15 @@ static void internal_state_reset()
     m_module_initialized       = false;
     m_current_sc_store_peer_id = PM_PEER_ID_INVALID;
 
+    memset(&m_write_stats, 0, sizeof(m_write_stats));
+
+#if PM_LOCAL_DB_DIGEST_ENABLED
+    for (uint32_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
+    {
+        m_local_db_digests[i].peer_id = PM_PEER_ID_INVALID;
+    }
+#endif
+
     // If PM_SERVICE_CHANGED_ENABLED is 0, this variable is unused.
     UNUSED_VARIABLE(m_current_sc_store_peer_id);
 }
@@ -185,6 +211,26 @@ void gscm_pdb_evt_handler(pm_evt_t * p_event)
 #endif
 
 
+#if PM_LOCAL_DB_DIGEST_ENABLED
+/**@brief Function for getting the digest of the stored system attributes of a connection.
+ *
+ * @param[in]  conn_handle  The connection.
+ *
+ * @return The digest of the connection, or NULL if the connection handle is invalid.
+ */
+static local_db_digest_t * local_db_digest_get(uint16_t conn_handle)
+{
+    uint16_t conn_idx = ble_conn_state_conn_idx(conn_handle);
+
+    if (conn_idx >= BLE_CONN_STATE_MAX_CONNECTIONS)
+    {
+        return NULL;
+    }
+    return &m_local_db_digests[conn_idx];
+}
+#endif
+
+
 ret_code_t gscm_init()
 {
     NRF_PM_DEBUG_CHECK(!m_module_initialized);
@@ -229,29 +275,77 @@ ret_code_t gscm_local_db_cache_update(uint16_t conn_handle)
                 if (err_code == NRF_SUCCESS)
                 {
                     pm_peer_data_flash_t curr_peer_data;
+                    bool                 db_changed = true;
 
-                    err_code = pdb_peer_data_ptr_get(peer_id,
-                                                PM_PEER_DATA_ID_GATT_LOCAL,
-                                                &curr_peer_data);
+#if PM_LOCAL_DB_DIGEST_ENABLED
+                    local_db_digest_t * p_digest = local_db_digest_get(conn_handle);
+                    uint16_t            crc      = crc16_compute(p_local_gatt_db->data,
+                                                                 p_local_gatt_db->len,
+                                                                 NULL);
 
-                    if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_NOT_FOUND))
+                    if ((p_digest != NULL) && (p_digest->peer_id == peer_id))
                     {
-                        NRF_LOG_ERROR("pdb_peer_data_ptr_get() returned %s for conn_handle: %d",
-                                        nrf_strerror_get(err_code),
-                                        conn_handle);
-                        return NRF_ERROR_INTERNAL;
+                        // The digest is of the newest data, found in flash or queued for flash.
+                        // Flash may still hold older data, which must not be compared with,
+                        // or a change back to it would be lost when the queued write lands.
+                        db_changed = (p_digest->len != p_local_gatt_db->len)
+                                  || (p_digest->crc != crc);
+
+                        if (!db_changed)
+                        {
+                            m_write_stats.digest_skipped++;
+                        }
                     }
+                    else
+#endif
+                    {
+                        err_code = pdb_peer_data_ptr_get(peer_id,
+                                                    PM_PEER_DATA_ID_GATT_LOCAL,
+                                                    &curr_peer_data);
+
+                        if ((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_NOT_FOUND))
+                        {
+                            NRF_LOG_ERROR("pdb_peer_data_ptr_get() returned %s for conn_handle: %d",
+                                            nrf_strerror_get(err_code),
+                                            conn_handle);
+                            return NRF_ERROR_INTERNAL;
+                        }
 
-                    if((err_code == NRF_ERROR_NOT_FOUND)
-                        || (p_local_gatt_db->len != curr_peer_data.p_local_gatt_db->len)
-                        || (memcmp(p_local_gatt_db->data, curr_peer_data.p_local_gatt_db->data,
-                                    p_local_gatt_db->len) != 0))
+                        db_changed = (err_code == NRF_ERROR_NOT_FOUND)
+                            || (p_local_gatt_db->len != curr_peer_data.p_local_gatt_db->len)
+                            || (memcmp(p_local_gatt_db->data, curr_peer_data.p_local_gatt_db->data,
+                                        p_local_gatt_db->len) != 0);
+                    }
+
+#if PM_LOCAL_DB_DIGEST_ENABLED
+                    if (p_digest != NULL)
+                    {
+                        // Remember the data if it is up to date in flash or about to be stored.
+                        p_digest->peer_id = peer_id;
+                        p_digest->len     = p_local_gatt_db->len;
+                        p_digest->crc     = crc;
+                    }
+#endif
+
+                    if (db_changed)
                     {
                         err_code = pdb_write_buf_store(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, peer_id);
+
+                        if (err_code == NRF_SUCCESS)
+                        {
+                            m_write_stats.written++;
+                        }
+#if PM_LOCAL_DB_DIGEST_ENABLED
+                        else if (p_digest != NULL)
+                        {
+                            p_digest->peer_id = PM_PEER_ID_INVALID;
+                        }
+#endif
                     }
                     else
                     {
                         NRF_LOG_DEBUG("Local db is already up to date, skipping write.");
+                        m_write_stats.skipped++;
                         ret_code_t err_code_release = pdb_write_buf_release(peer_id, PM_PEER_DATA_ID_GATT_LOCAL);
                         if (err_code_release == NRF_SUCCESS)
                         {
@@ -303,6 +397,31 @@ ret_code_t gscm_local_db_cache_update(uint16_t conn_handle)
 }
 
 
+#if PM_LOCAL_DB_DIGEST_ENABLED
+void gscm_local_db_digest_clear(pm_peer_id_t peer_id)
+{
+    NRF_PM_DEBUG_CHECK(m_module_initialized);
+
+    for (uint32_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
+    {
+        if (m_local_db_digests[i].peer_id == peer_id)
+        {
+            m_local_db_digests[i].peer_id = PM_PEER_ID_INVALID;
+        }
+    }
+}
+#endif
+
+
+void gscm_local_db_write_stats_get(pm_local_db_write_stats_t * p_stats)
+{
+    NRF_PM_DEBUG_CHECK(m_module_initialized);
+    NRF_PM_DEBUG_CHECK(p_stats != NULL);
+
+    *p_stats = m_write_stats;
+}
+
+
 ret_code_t gscm_local_db_cache_apply(uint16_t conn_handle)
 {
     NRF_PM_DEBUG_CHECK(m_module_initialized);
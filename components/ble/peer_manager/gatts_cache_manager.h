@@ -90,6 +90,24 @@ ret_code_t gscm_init(void);
 ret_code_t gscm_local_db_cache_update(uint16_t conn_handle);
 
 
+/**@brief Function for forgetting what was last stored of a peer's local GATT database.
+ *
+ * @details Call this when the peer's local GATT database data in flash changes or fails to change,
+ *          so that the next update compares with flash instead of the remembered digest. Only
+ *          available when @ref PM_LOCAL_DB_DIGEST_ENABLED is set.
+ *
+ * @param[in]  peer_id  The peer.
+ */
+void gscm_local_db_digest_clear(pm_peer_id_t peer_id);
+
+
+/**@brief Function for getting the number of written and skipped local GATT database updates.
+ *
+ * @param[out] p_stats  The statistics.
+ */
+void gscm_local_db_write_stats_get(pm_local_db_write_stats_t * p_stats);
+
+
 /**@brief Function for applying stored local GATT database data to the SoftDevice. Values are
  *        retrieved from persistent storage and given to the SoftDevice.
  *
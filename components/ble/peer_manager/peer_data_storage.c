@@ -89,6 +89,23 @@ static volatile bool m_peer_delete_deferred = false;
 // A token used for Flash Data Storage searches.
 static fds_find_token_t m_fds_ftok;
 
+#if PM_RAM_CACHE_ENABLED
+// An entry in the cache of record locations.
+typedef struct
+{
+    fds_record_desc_t desc;     // Descriptor of the record. Only valid if found is true.
+    uint32_t          last_use; // Value of m_cache_tick when the entry was last used. 0 if unused.
+    pm_peer_id_t      peer_id;
+    uint8_t           data_id;  // pm_peer_data_id_t
+    bool              found;    // Whether the record exists in flash.
+} pds_cache_entry_t;
+
+// Cache of where the records of recently used peers are in flash.
+static pds_cache_entry_t    m_cache[PM_RAM_CACHE_SIZE];
+static uint32_t             m_cache_tick;
+static pm_ram_cache_stats_t m_cache_stats;
+#endif
+
 
 // Function for dispatching events to all registered event handlers.
 static void pds_evt_send(pm_evt_t * p_event)
@@ -224,6 +241,111 @@ static void peer_data_delete_process()
 }
 
 
+#if PM_RAM_CACHE_ENABLED
+// Function for getting a new value for the last_use field of a cache entry.
+static uint32_t cache_tick_next(void)
+{
+    m_cache_tick++;
+
+    if (m_cache_tick == 0)
+    {
+        // Wrapped around. Start over, so that all entries keep a nonzero age.
+        for (uint32_t i = 0; i < PM_RAM_CACHE_SIZE; i++)
+        {
+            if (m_cache[i].last_use != 0)
+            {
+                m_cache[i].last_use = 1;
+            }
+        }
+        m_cache_tick = 2;
+    }
+
+    return m_cache_tick;
+}
+
+
+// Function for finding the cache entry of a piece of peer data.
+static pds_cache_entry_t * cache_entry_find(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    for (uint32_t i = 0; i < PM_RAM_CACHE_SIZE; i++)
+    {
+        if (   (m_cache[i].last_use != 0)
+            && (m_cache[i].peer_id  == peer_id)
+            && (m_cache[i].data_id  == data_id))
+        {
+            return &m_cache[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for storing the location of a piece of peer data in the cache.
+ *
+ * @details Reuses the entry of the same peer data if there is one, otherwise replaces the least
+ *          recently used entry.
+ *
+ * @param[in]  peer_id  The peer the data belongs to.
+ * @param[in]  data_id  The type of data.
+ * @param[in]  p_desc   Descriptor of the record, or NULL if the record does not exist.
+ */
+static void cache_entry_put(pm_peer_id_t              peer_id,
+                            pm_peer_data_id_t         data_id,
+                            fds_record_desc_t const * p_desc)
+{
+    pds_cache_entry_t * p_entry = cache_entry_find(peer_id, data_id);
+
+    if (p_entry == NULL)
+    {
+        p_entry = &m_cache[0];
+        for (uint32_t i = 1; (i < PM_RAM_CACHE_SIZE) && (p_entry->last_use != 0); i++)
+        {
+            if (m_cache[i].last_use < p_entry->last_use)
+            {
+                p_entry = &m_cache[i];
+            }
+        }
+    }
+
+    p_entry->peer_id  = peer_id;
+    p_entry->data_id  = (uint8_t)data_id;
+    p_entry->found    = (p_desc != NULL);
+    p_entry->last_use = cache_tick_next();
+
+    if (p_desc != NULL)
+    {
+        p_entry->desc                = *p_desc;
+        p_entry->desc.record_is_open = false;
+    }
+}
+
+
+// Function for removing a piece of peer data from the cache.
+static void cache_entry_invalidate(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    pds_cache_entry_t * p_entry = cache_entry_find(peer_id, data_id);
+
+    if (p_entry != NULL)
+    {
+        p_entry->last_use = 0;
+    }
+}
+
+
+// Function for removing all data of a peer from the cache.
+static void cache_peer_invalidate(pm_peer_id_t peer_id)
+{
+    for (uint32_t i = 0; i < PM_RAM_CACHE_SIZE; i++)
+    {
+        if (m_cache[i].peer_id == peer_id)
+        {
+            m_cache[i].last_use = 0;
+        }
+    }
+}
+#endif // PM_RAM_CACHE_ENABLED
+
+
 static ret_code_t peer_data_find(pm_peer_id_t              peer_id,
                                  pm_peer_data_id_t         data_id,
                                  fds_record_desc_t * const p_desc)
@@ -235,6 +357,27 @@ static ret_code_t peer_data_find(pm_peer_id_t              peer_id,
     NRF_PM_DEBUG_CHECK(peer_data_id_is_valid(data_id));
     NRF_PM_DEBUG_CHECK(p_desc != NULL);
 
+#if PM_RAM_CACHE_ENABLED
+    pds_cache_entry_t * p_entry = cache_entry_find(peer_id, data_id);
+
+    if (p_entry != NULL)
+    {
+        m_cache_stats.hits++;
+        p_entry->last_use = cache_tick_next();
+
+        if (!p_entry->found)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+
+        // FDS checks the descriptor before use, and searches by record ID if it is stale.
+        *p_desc = p_entry->desc;
+        return NRF_SUCCESS;
+    }
+
+    m_cache_stats.misses++;
+#endif
+
     memset(&ftok, 0x00, sizeof(fds_find_token_t));
 
     uint16_t file_id    = peer_id_to_file_id(peer_id);
@@ -242,6 +385,10 @@ static ret_code_t peer_data_find(pm_peer_id_t              peer_id,
 
     ret = fds_record_find(file_id, record_key, p_desc, &ftok);
 
+#if PM_RAM_CACHE_ENABLED
+    cache_entry_put(peer_id, data_id, (ret == NRF_SUCCESS) ? p_desc : NULL);
+#endif
+
     if (ret != NRF_SUCCESS)
     {
         return NRF_ERROR_NOT_FOUND;
@@ -265,9 +412,11 @@ static void peer_ids_load()
     {
         pm_peer_id_t peer_id;
 
-        // It is safe to ignore the return value since the descriptor was
-        // just obtained and also 'record' is different from NULL.
-        (void)fds_record_open(&record_desc, &record);
+        // Skip records that cannot be opened, for example because their CRC check failed.
+        if (fds_record_open(&record_desc, &record) != NRF_SUCCESS)
+        {
+            continue;
+        }
         peer_id = file_id_to_peer_id(record.p_header->file_id);
         (void)fds_record_close(&record_desc);
 
@@ -298,6 +447,12 @@ static void fds_evt_handler(fds_evt_t const * const p_fds_evt)
                                                                         : PM_PEER_DATA_OP_UPDATE;
                 pds_evt.params.peer_data_update_succeeded.token = p_fds_evt->write.record_id;
 
+#if PM_RAM_CACHE_ENABLED
+                // The record has moved or is gone, look it up again next time.
+                cache_entry_invalidate(pds_evt.peer_id,
+                                       pds_evt.params.peer_data_update_succeeded.data_id);
+#endif
+
                 if (p_fds_evt->result == NRF_SUCCESS)
                 {
                     pds_evt.evt_id = PM_EVT_PEER_DATA_UPDATE_SUCCEEDED;
@@ -321,6 +476,9 @@ static void fds_evt_handler(fds_evt_t const * const p_fds_evt)
                 {
                     pds_evt.evt_id = PM_EVT_PEER_DELETE_SUCCEEDED;
                     peer_id_free(pds_evt.peer_id);
+#if PM_RAM_CACHE_ENABLED
+                    cache_peer_invalidate(pds_evt.peer_id);
+#endif
                 }
                 else
                 {
@@ -417,6 +575,9 @@ ret_code_t pds_peer_data_read(pm_peer_id_t                    peer_id,
 
     if (ret != NRF_SUCCESS)
     {
+#if PM_RAM_CACHE_ENABLED
+        cache_entry_invalidate(peer_id, data_id);
+#endif
         return NRF_ERROR_NOT_FOUND;
     }
 
@@ -448,6 +609,11 @@ ret_code_t pds_peer_data_read(pm_peer_id_t                    peer_id,
     // Shouldn't fail unless the record was already closed, in which case it can be ignored.
     (void)fds_record_close(&rec_desc);
 
+#if PM_RAM_CACHE_ENABLED
+    // Opening the record refreshes the descriptor if it was stale, e.g. after garbage collection.
+    cache_entry_put(peer_id, data_id, &rec_desc);
+#endif
+
     return NRF_SUCCESS;
 }
 
@@ -537,6 +703,9 @@ ret_code_t pds_peer_data_store(pm_peer_id_t                 peer_id,
     switch (ret)
     {
         case NRF_SUCCESS:
+#if PM_RAM_CACHE_ENABLED
+            cache_entry_invalidate(peer_id, p_peer_data->data_id);
+#endif
             if (p_store_token != NULL)
             {
                 // Update the store token.
@@ -586,6 +755,9 @@ ret_code_t pds_peer_data_delete(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
     switch (ret)
     {
         case NRF_SUCCESS:
+#if PM_RAM_CACHE_ENABLED
+            cache_entry_invalidate(peer_id, data_id);
+#endif
             return NRF_SUCCESS;
 
         case FDS_ERR_NO_SPACE_IN_QUEUES:
@@ -615,6 +787,9 @@ ret_code_t pds_peer_id_free(pm_peer_id_t peer_id)
     VERIFY_PEER_ID_IN_RANGE(peer_id);
 
     (void)peer_id_delete(peer_id);
+#if PM_RAM_CACHE_ENABLED
+    cache_peer_invalidate(peer_id);
+#endif
     peer_data_delete_process();
 
     return NRF_SUCCESS;
@@ -654,4 +829,13 @@ uint32_t pds_peer_count_get(void)
     NRF_PM_DEBUG_CHECK(m_module_initialized);
     return peer_id_n_ids();
 }
+
+
+#if PM_RAM_CACHE_ENABLED
+void pds_ram_cache_stats_get(pm_ram_cache_stats_t * p_stats)
+{
+    NRF_PM_DEBUG_CHECK(p_stats != NULL);
+    *p_stats = m_cache_stats;
+}
+#endif
 #endif // NRF_MODULE_ENABLED(PEER_MANAGER)
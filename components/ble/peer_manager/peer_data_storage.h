@@ -239,6 +239,15 @@ pm_peer_id_t pds_next_deleted_peer_id_get(pm_peer_id_t prev_peer_id);
 uint32_t pds_peer_count_get(void);
 
 
+/**@brief Function for getting the hit and miss counters of the cache of peer data locations.
+ *
+ * @note Only available when @ref PM_RAM_CACHE_ENABLED is set.
+ *
+ * @param[out] p_stats  The cache statistics.
+ */
+void pds_ram_cache_stats_get(pm_ram_cache_stats_t * p_stats);
+
+
 /** @}
  * @endcond
  */
@@ -647,6 +647,30 @@ uint32_t pm_peer_count(void)
 }
 
 
+ret_code_t pm_ram_cache_stats_get(pm_ram_cache_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+#if PM_RAM_CACHE_ENABLED
+    pds_ram_cache_stats_get(p_stats);
+    return NRF_SUCCESS;
+#else
+    return NRF_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
+ret_code_t pm_local_db_write_stats_get(pm_local_db_write_stats_t * p_stats)
+{
+    VERIFY_MODULE_INITIALIZED();
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    gscm_local_db_write_stats_get(p_stats);
+    return NRF_SUCCESS;
+}
+
+
 pm_peer_id_t pm_next_peer_id_get(pm_peer_id_t prev_peer_id)
 {
     pm_peer_id_t next_peer_id = prev_peer_id;
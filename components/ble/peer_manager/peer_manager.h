@@ -557,6 +557,38 @@ pm_peer_id_t pm_next_peer_id_get(pm_peer_id_t prev_peer_id);
 uint32_t pm_peer_count(void);
 
 
+/**@brief Function for getting the statistics of the RAM cache of peer data locations.
+ *
+ * @details With @ref PM_RAM_CACHE_ENABLED, the Peer Manager remembers where in flash the data of
+ *          recently used peers is, so that restoring bonding data and system attributes on
+ *          reconnection does not search through flash. Writes go straight to flash as before.
+ *
+ * @param[out] p_stats  Number of cache hits and misses since the Peer Manager was initialized.
+ *
+ * @retval NRF_SUCCESS              If the statistics were retrieved successfully.
+ * @retval NRF_ERROR_NULL           If @p p_stats was NULL.
+ * @retval NRF_ERROR_INVALID_STATE  If the Peer Manager is not initialized.
+ * @retval NRF_ERROR_NOT_SUPPORTED  If @ref PM_RAM_CACHE_ENABLED is not set.
+ */
+ret_code_t pm_ram_cache_stats_get(pm_ram_cache_stats_t * p_stats);
+
+
+/**@brief Function for getting how many local GATT database updates were written or skipped.
+ *
+ * @details The local GATT database (system attributes such as CCCD values) of a bonded peer is
+ *          stored when a CCCD is written and after bonding. Updates that do not change the stored
+ *          data are skipped. With @ref PM_LOCAL_DB_DIGEST_ENABLED, most of them are detected
+ *          without reading flash.
+ *
+ * @param[out] p_stats  Number of written and skipped updates since the Peer Manager was initialized.
+ *
+ * @retval NRF_SUCCESS              If the statistics were retrieved successfully.
+ * @retval NRF_ERROR_NULL           If @p p_stats was NULL.
+ * @retval NRF_ERROR_INVALID_STATE  If the Peer Manager is not initialized.
+ */
+ret_code_t pm_local_db_write_stats_get(pm_local_db_write_stats_t * p_stats);
+
+
 
 
 /**@anchor PM_PEER_DATA_FUNCTIONS
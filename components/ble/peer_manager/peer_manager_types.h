@@ -212,6 +212,25 @@ typedef struct
 } pm_conn_sec_status_t;
 
 
+/**@brief Statistics of the RAM cache of peer data locations. See @ref PM_RAM_CACHE_ENABLED.
+ */
+typedef struct
+{
+    uint32_t hits;   /**< @brief Number of peer data lookups that were answered from the cache. */
+    uint32_t misses; /**< @brief Number of peer data lookups that had to search flash. */
+} pm_ram_cache_stats_t;
+
+
+/**@brief Statistics of the local GATT database updates of bonded peers.
+ */
+typedef struct
+{
+    uint32_t written;        /**< @brief Number of updates that were queued for writing to flash. */
+    uint32_t skipped;        /**< @brief Number of updates that were skipped because the data was already stored. */
+    uint32_t digest_skipped; /**< @brief Number of the skipped updates that were detected with the digest, without reading flash. See @ref PM_LOCAL_DB_DIGEST_ENABLED. */
+} pm_local_db_write_stats_t;
+
+
 /**@brief Types of events that can come from the @ref peer_manager module.
  */
 typedef enum
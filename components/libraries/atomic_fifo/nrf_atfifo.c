@@ -187,3 +187,109 @@ bool nrf_atfifo_item_free(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p
     NRF_LOG_INST_DEBUG(p_fifo->p_log, "Free (interrupted)");
     return false;
 }
+
+
+void * nrf_atfifo_items_alloc(nrf_atfifo_t * const    p_fifo,
+                              size_t                * p_count,
+                              nrf_atfifo_item_put_t * p_context)
+{
+    uint16_t count = (uint16_t)MIN(*p_count, UINT16_MAX);
+
+    if (nrf_atfifo_wspace_req_n(p_fifo, &(p_context->last_tail), &count, true))
+    {
+        void * p_item = ((uint8_t*)(p_fifo->p_buf)) + p_context->last_tail.pos.wr;
+        *p_count = count;
+        NRF_LOG_INST_DEBUG(p_fifo->p_log, "Allocated %d elements (0x%08X).", count, p_item);
+        return p_item;
+    }
+    *p_count = 0;
+    NRF_LOG_INST_WARNING(p_fifo->p_log, "Allocation failed - no space.");
+    return NULL;
+}
+
+
+void * nrf_atfifo_items_get(nrf_atfifo_t * const    p_fifo,
+                            size_t                * p_count,
+                            nrf_atfifo_item_get_t * p_context)
+{
+    uint16_t count = (uint16_t)MIN(*p_count, UINT16_MAX);
+
+    if (nrf_atfifo_rspace_req_n(p_fifo, &(p_context->last_head), &count, true))
+    {
+        void * p_item = ((uint8_t*)(p_fifo->p_buf)) + p_context->last_head.pos.rd;
+        *p_count = count;
+        NRF_LOG_INST_DEBUG(p_fifo->p_log, "Get %d elements: 0x%08X", count, p_item);
+        return p_item;
+    }
+    *p_count = 0;
+    NRF_LOG_INST_WARNING(p_fifo->p_log, "Get failed - no item in the FIFO.");
+    return NULL;
+}
+
+
+ret_code_t nrf_atfifo_alloc_put_n(nrf_atfifo_t * const p_fifo,
+                                  void const         * p_items,
+                                  size_t             * p_count,
+                                  bool * const         p_visible)
+{
+    nrf_atfifo_item_put_t context;
+    uint16_t count = (uint16_t)MIN(*p_count, UINT16_MAX);
+    bool visible;
+
+    if (!nrf_atfifo_wspace_req_n(p_fifo, &context.last_tail, &count, false))
+    {
+        *p_count = 0;
+        NRF_LOG_INST_WARNING(p_fifo->p_log, "Copying in elements (0x%08X) failed - no space.", p_items);
+        return NRF_ERROR_NO_MEM;
+    }
+
+    size_t wr    = context.last_tail.pos.wr;
+    size_t size  = (size_t)count * p_fifo->item_size;
+    size_t trail = MIN(size, p_fifo->buf_size - wr);
+
+    memcpy((uint8_t *)p_fifo->p_buf + wr, p_items, trail);
+    memcpy(p_fifo->p_buf, (uint8_t const *)p_items + trail, size - trail);
+
+    visible = nrf_atfifo_item_put(p_fifo, &context);
+    if (NULL != p_visible)
+    {
+        *p_visible = visible;
+    }
+    *p_count = count;
+    NRF_LOG_INST_DEBUG(p_fifo->p_log, "%d elements (0x%08X) copied in.", count, p_items);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_atfifo_get_free_n(nrf_atfifo_t * const p_fifo,
+                                 void               * p_items,
+                                 size_t             * p_count,
+                                 bool               * p_released)
+{
+    nrf_atfifo_item_get_t context;
+    uint16_t count = (uint16_t)MIN(*p_count, UINT16_MAX);
+    bool released;
+
+    if (!nrf_atfifo_rspace_req_n(p_fifo, &context.last_head, &count, false))
+    {
+        *p_count = 0;
+        NRF_LOG_INST_WARNING(p_fifo->p_log, "Copying out failed - no item in the FIFO.");
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    size_t rd    = context.last_head.pos.rd;
+    size_t size  = (size_t)count * p_fifo->item_size;
+    size_t trail = MIN(size, p_fifo->buf_size - rd);
+
+    memcpy(p_items, (uint8_t const *)p_fifo->p_buf + rd, trail);
+    memcpy((uint8_t *)p_items + trail, p_fifo->p_buf, size - trail);
+
+    released = nrf_atfifo_item_free(p_fifo, &context);
+    if (NULL != p_released)
+    {
+        *p_released = released;
+    }
+    *p_count = count;
+    NRF_LOG_INST_DEBUG(p_fifo->p_log, "%d elements (0x%08X) copied out.", count, p_items);
+    return NRF_SUCCESS;
+}
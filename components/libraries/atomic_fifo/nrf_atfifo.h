@@ -414,6 +414,83 @@ void * nrf_atfifo_item_get(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t *
  */
 bool nrf_atfifo_item_free(nrf_atfifo_t * const p_fifo, nrf_atfifo_item_get_t * p_context);
 
+/**
+ * @brief Function for opening the FIFO for writing a batch of items.
+ *
+ * Works like @ref nrf_atfifo_item_alloc, but reserves up to @c *p_count consecutive items with
+ * a single atomic update. The reserved items are contiguous in memory, so fewer items than
+ * requested are reserved when the FIFO is almost full or the reservation would wrap around
+ * the end of the buffer. The operation is closed with @ref nrf_atfifo_item_put, which
+ * commits all the reserved items at once.
+ *
+ * @param[in,out] p_fifo    FIFO object.
+ * @param[in,out] p_count   Number of items requested. Number of items reserved.
+ * @param[out]    p_context Operation context, required by @ref nrf_atfifo_item_put.
+ *
+ * @return Pointer to the space where the first item can be stored. Next items follow it
+ *         every @c item_size bytes. NULL if there is no space in the buffer.
+ */
+void * nrf_atfifo_items_alloc(nrf_atfifo_t * const    p_fifo,
+                              size_t                * p_count,
+                              nrf_atfifo_item_put_t * p_context);
+
+/**
+ * @brief Function for opening the FIFO for reading a batch of items.
+ *
+ * Works like @ref nrf_atfifo_item_get, but takes up to @c *p_count consecutive items with
+ * a single atomic update. The items are contiguous in memory, so fewer items than requested
+ * are returned when the rest of the data wraps around the end of the buffer. The operation
+ * is closed with @ref nrf_atfifo_item_free, which releases all the items at once.
+ *
+ * @param[in,out] p_fifo    FIFO object.
+ * @param[in,out] p_count   Number of items requested. Number of items taken.
+ * @param[out]    p_context Operation context, required by @ref nrf_atfifo_item_free.
+ *
+ * @return Pointer to the first item or NULL if there is no data in the FIFO.
+ */
+void * nrf_atfifo_items_get(nrf_atfifo_t * const    p_fifo,
+                            size_t                * p_count,
+                            nrf_atfifo_item_get_t * p_context);
+
+/**
+ * @brief Function for atomically putting a batch of items into the FIFO.
+ *
+ * Space for all the copied items is reserved with a single atomic update, also when it wraps
+ * around the end of the buffer.
+ *
+ * @param[in,out] p_fifo    FIFO object.
+ * @param[in]     p_items   Items to copy, stored one after another every @c item_size bytes.
+ * @param[in,out] p_count   Number of items to copy. Number of items copied.
+ * @param[out]    p_visible See value returned by @ref nrf_atfifo_item_put.
+ *                          It may be NULL if the caller does not require the current operation status.
+ *
+ * @retval NRF_SUCCESS      If at least one item has been added to the FIFO.
+ * @retval NRF_ERROR_NO_MEM If the FIFO is full.
+ */
+ret_code_t nrf_atfifo_alloc_put_n(nrf_atfifo_t * const p_fifo,
+                                  void const         * p_items,
+                                  size_t             * p_count,
+                                  bool * const         p_visible);
+
+/**
+ * @brief Function for getting a batch of items from the FIFO.
+ *
+ * The items are taken with a single atomic update, also when they wrap around the end of
+ * the buffer.
+ *
+ * @param[in,out] p_fifo     FIFO object.
+ * @param[out]    p_items    Buffer for the items, filled one after another every @c item_size bytes.
+ * @param[in,out] p_count    Number of items to get. Number of items copied.
+ * @param[out]    p_released See the values returned by @ref nrf_atfifo_item_free.
+ *
+ * @retval NRF_SUCCESS         At least one item was copied from the FIFO memory.
+ * @retval NRF_ERROR_NOT_FOUND No data in the FIFO.
+ */
+ret_code_t nrf_atfifo_get_free_n(nrf_atfifo_t * const p_fifo,
+                                 void               * p_items,
+                                 size_t             * p_count,
+                                 bool               * p_released);
+
 
 /** @} */
 
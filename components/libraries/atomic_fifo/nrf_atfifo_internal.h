@@ -154,6 +154,46 @@ static void nrf_atfifo_rspace_close(nrf_atfifo_t * const p_fifo);
  */
 static bool nrf_atfifo_space_clear(nrf_atfifo_t * const p_fifo);
 
+/**
+ * @brief Atomically reserve space for a batch of new writes.
+ *
+ * This function works like @ref nrf_atfifo_wspace_req, but reserves up to @c *p_count items
+ * in a single exclusive access sequence. The reservation is closed with @ref nrf_atfifo_wspace_close.
+ *
+ * @param[in,out] p_fifo     FIFO object.
+ * @param[out]    p_old_tail Tail position tag before new space is reserved.
+ * @param[in,out] p_count    Number of items requested. Number of items reserved.
+ * @param[in]     contiguous If true, the reservation ends at the end of the buffer memory
+ *                           at the latest. If false, it may wrap around.
+ *
+ * @retval true  At least one item reserved.
+ * @retval false Memory full.
+ */
+static bool nrf_atfifo_wspace_req_n(nrf_atfifo_t * const  p_fifo,
+                                    nrf_atfifo_postag_t * p_old_tail,
+                                    uint16_t            * p_count,
+                                    bool                  contiguous);
+
+/**
+ * @brief Atomically get a part of a buffer to read a batch of items.
+ *
+ * This function works like @ref nrf_atfifo_rspace_req, but takes up to @c *p_count items
+ * in a single exclusive access sequence. The read is closed with @ref nrf_atfifo_rspace_close.
+ *
+ * @param[in,out] p_fifo     FIFO object.
+ * @param[out]    p_old_head Head position tag before the data buffer is read.
+ * @param[in,out] p_count    Number of items requested. Number of items taken.
+ * @param[in]     contiguous If true, the items end at the end of the buffer memory
+ *                           at the latest. If false, they may wrap around.
+ *
+ * @retval true  At least one item taken.
+ * @retval false No data in the buffer.
+ */
+static bool nrf_atfifo_rspace_req_n(nrf_atfifo_t * const  p_fifo,
+                                    nrf_atfifo_postag_t * p_old_head,
+                                    uint16_t            * p_count,
+                                    bool                  contiguous);
+
 
 /* ---------------------------------------------------------------------------
  * Implementation starts here
@@ -347,7 +387,7 @@ nrf_atfifo_space_clear_head_test_skip
     bx      lr
 }
 
-#elif defined ( __ICCARM__ ) || defined ( __GNUC__ )
+#elif defined ( __ICCARM__ ) || (defined ( __GNUC__ ) && defined ( __arm__ ))
 
 bool nrf_atfifo_wspace_req(nrf_atfifo_t * const p_fifo, nrf_atfifo_postag_t * const p_old_tail)
 {
@@ -570,8 +610,231 @@ bool nrf_atfifo_space_clear(nrf_atfifo_t * const p_fifo)
     return ret;
 }
 
+#elif defined ( __GNUC__ )
+
+/* Builds for other architectures, such as host tests, use the CMSIS exclusive access intrinsics,
+ * which the platform has to provide.
+ */
+
+bool nrf_atfifo_wspace_req(nrf_atfifo_t * const p_fifo, nrf_atfifo_postag_t * const p_old_tail)
+{
+    uint32_t old_tail;
+    uint32_t new_wr;
+
+    do
+    {
+        old_tail = __LDREXW(&p_fifo->tail.tag);
+
+        new_wr = (old_tail & 0xFFFF) + p_fifo->item_size;
+        if (new_wr >= p_fifo->buf_size)
+        {
+            new_wr -= p_fifo->buf_size;
+        }
+
+        if (new_wr == p_fifo->head.pos.wr)
+        {
+            __CLREX();
+            p_old_tail->tag = old_tail;
+            return false;
+        }
+    } while (__STREXW((old_tail & 0xFFFF0000) | new_wr, &p_fifo->tail.tag) != 0);
+
+    p_old_tail->tag = old_tail;
+    return true;
+}
+
+
+void nrf_atfifo_wspace_close(nrf_atfifo_t * const p_fifo)
+{
+    uint32_t tail;
+
+    do
+    {
+        tail = __LDREXW(&p_fifo->tail.tag);
+    } while (__STREXW((tail & 0xFFFF) | (tail << 16), &p_fifo->tail.tag) != 0);
+}
+
+
+bool nrf_atfifo_rspace_req(nrf_atfifo_t * const p_fifo, nrf_atfifo_postag_t * const p_old_head)
+{
+    uint32_t old_head;
+    uint32_t new_rd;
+
+    do
+    {
+        old_head = __LDREXW(&p_fifo->head.tag);
+
+        new_rd = old_head >> 16;
+        if (new_rd == p_fifo->tail.pos.rd)
+        {
+            __CLREX();
+            p_old_head->tag = old_head;
+            return false;
+        }
+
+        new_rd += p_fifo->item_size;
+        if (new_rd >= p_fifo->buf_size)
+        {
+            new_rd -= p_fifo->buf_size;
+        }
+    } while (__STREXW((old_head & 0xFFFF) | (new_rd << 16), &p_fifo->head.tag) != 0);
+
+    p_old_head->tag = old_head;
+    return true;
+}
+
+
+void nrf_atfifo_rspace_close(nrf_atfifo_t * const p_fifo)
+{
+    uint32_t head;
+
+    do
+    {
+        head = __LDREXW(&p_fifo->head.tag);
+    } while (__STREXW((head & 0xFFFF0000) | (head >> 16), &p_fifo->head.tag) != 0);
+}
+
+
+bool nrf_atfifo_space_clear(nrf_atfifo_t * const p_fifo)
+{
+    bool     ret;
+    uint32_t old_head;
+    uint32_t new_head;
+
+    do
+    {
+        old_head = __LDREXW(&p_fifo->head.tag);
+
+        uint32_t const tail_rd = p_fifo->tail.pos.rd;
+
+        ret = false;
+        if ((old_head & 0xFFFF) != (old_head >> 16))
+        {
+            /* A read is pending, release the data up to it. */
+            new_head = (old_head & 0xFFFF) | (tail_rd << 16);
+        }
+        else
+        {
+            uint32_t const tail = p_fifo->tail.tag;
+
+            new_head = tail_rd | (tail_rd << 16);
+            ret      = ((tail & 0xFFFF) == (tail >> 16));
+        }
+    } while (__STREXW(new_head, &p_fifo->head.tag) != 0);
+
+    return ret;
+}
+
 #else
 #error Unsupported compiler
 #endif
 
+/* Batch operations use the CMSIS exclusive access intrinsics, which are available for all
+ * supported compilers. Positions are byte offsets, as in the single item functions above.
+ */
+
+bool nrf_atfifo_wspace_req_n(nrf_atfifo_t * const  p_fifo,
+                             nrf_atfifo_postag_t * p_old_tail,
+                             uint16_t            * p_count,
+                             bool                  contiguous)
+{
+    uint32_t old_tail;
+    uint32_t new_wr;
+    uint16_t count;
+
+    do
+    {
+        old_tail = __LDREXW(&p_fifo->tail.tag);
+
+        uint32_t wr      = old_tail & 0xFFFF;
+        uint32_t head_wr = p_fifo->head.pos.wr;
+        uint32_t space;
+
+        /* One item is always left empty, so that a full FIFO can be told apart from an empty one. */
+        if (head_wr > wr)
+        {
+            space = head_wr - wr - p_fifo->item_size;
+        }
+        else if (contiguous)
+        {
+            space = p_fifo->buf_size - wr - ((head_wr == 0) ? p_fifo->item_size : 0);
+        }
+        else
+        {
+            space = p_fifo->buf_size - wr + head_wr - p_fifo->item_size;
+        }
+
+        count = MIN(*p_count, space / p_fifo->item_size);
+        if (count == 0)
+        {
+            __CLREX();
+            p_old_tail->tag = old_tail;
+            *p_count        = 0;
+            return false;
+        }
+
+        new_wr = wr + (uint32_t)count * p_fifo->item_size;
+        if (new_wr >= p_fifo->buf_size)
+        {
+            new_wr -= p_fifo->buf_size;
+        }
+    } while (__STREXW((old_tail & 0xFFFF0000) | new_wr, &p_fifo->tail.tag) != 0);
+
+    p_old_tail->tag = old_tail;
+    *p_count        = count;
+    return true;
+}
+
+
+bool nrf_atfifo_rspace_req_n(nrf_atfifo_t * const  p_fifo,
+                             nrf_atfifo_postag_t * p_old_head,
+                             uint16_t            * p_count,
+                             bool                  contiguous)
+{
+    uint32_t old_head;
+    uint32_t new_rd;
+    uint16_t count;
+
+    do
+    {
+        old_head = __LDREXW(&p_fifo->head.tag);
+
+        uint32_t rd      = old_head >> 16;
+        uint32_t tail_rd = p_fifo->tail.pos.rd;
+        uint32_t available;
+
+        if (tail_rd >= rd)
+        {
+            available = tail_rd - rd;
+        }
+        else if (contiguous)
+        {
+            available = p_fifo->buf_size - rd;
+        }
+        else
+        {
+            available = p_fifo->buf_size - rd + tail_rd;
+        }
+
+        count = MIN(*p_count, available / p_fifo->item_size);
+        if (count == 0)
+        {
+            __CLREX();
+            p_old_head->tag = old_head;
+            *p_count        = 0;
+            return false;
+        }
+
+        new_rd = rd + (uint32_t)count * p_fifo->item_size;
+        if (new_rd >= p_fifo->buf_size)
+        {
+            new_rd -= p_fifo->buf_size;
+        }
+    } while (__STREXW((old_head & 0xFFFF) | (new_rd << 16), &p_fifo->head.tag) != 0);
+
+    p_old_head->tag = old_head;
+    *p_count        = count;
+    return true;
+}
+
 #endif /* NRF_ATFIFO_INTERNAL_H__ */
@@ -0,0 +1,410 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+#if NRF_MODULE_ENABLED(NRF_SLAB)
+
+#include <string.h>
+#include "nrf_slab.h"
+#include "app_util_platform.h"
+
+#define FREE_HEAD_IDX_MASK  0x000000FFUL    /**< Free list head bits holding index + 1 of the first element (0 if empty).*/
+#define FREE_HEAD_TAG_INC   0x00000100UL    /**< Increment of the free list head tag, protecting against ABA.*/
+
+#if NRF_BALLOC_CONFIG_DEBUG_ENABLED
+#define ELEMENT_OFFSET(_p_pool) \
+    (sizeof(uint32_t) * NRF_BALLOC_DEBUG_HEAD_GUARD_WORDS_GET((_p_pool)->debug_flags))
+#else
+#define ELEMENT_OFFSET(_p_pool) 0
+#endif
+
+/**@brief  Convert block index to an element pointer.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   idx         Index of the block.
+ *
+ * @return      Pointer to the element.
+ */
+static void * slab_idx2element(nrf_balloc_t const * p_pool, uint32_t idx)
+{
+    return (uint8_t *)(p_pool->p_memory_begin) + (idx * p_pool->block_size) + ELEMENT_OFFSET(p_pool);
+}
+
+/**@brief  Convert element pointer to a block index.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool.
+ * @param[in]   p_element   Pointer to the element.
+ *
+ * @return      Index of the block.
+ */
+static uint32_t slab_element2idx(nrf_balloc_t const * p_pool, void const * p_element)
+{
+    return ((size_t)(p_element) - (size_t)(p_pool->p_memory_begin)) / p_pool->block_size;
+}
+
+/**@brief  Find the size class that serves requests of a given size.
+ *
+ * @param[in]   p_slab  Pointer to the instance.
+ * @param[in]   size    Requested size.
+ *
+ * @return      Index of the smallest class able to hold @p size bytes. May be out of range.
+ */
+static uint32_t slab_size_class_get(nrf_slab_t const * p_slab, size_t size)
+{
+    uint32_t min_log2 = 31 - __CLZ(NRF_BALLOC_ELEMENT_SIZE(p_slab->pp_pools[0]));
+
+    if (size <= (1UL << min_log2))
+    {
+        return 0;
+    }
+    if (size > UINT16_MAX)
+    {
+        return p_slab->class_count;
+    }
+    return (32 - __CLZ((uint32_t)size - 1)) - min_log2;
+}
+
+/**@brief  Find the size class that owns an element.
+ *
+ * @param[in]   p_slab      Pointer to the instance.
+ * @param[in]   p_element   Pointer to the element.
+ *
+ * @return      Index of the class, or class count if the element does not belong to the instance.
+ */
+static uint32_t slab_owner_class_get(nrf_slab_t const * p_slab, void const * p_element)
+{
+    uint32_t cls;
+
+    for (cls = 0; cls < p_slab->class_count; cls++)
+    {
+        nrf_balloc_t const * p_pool = p_slab->pp_pools[cls];
+        uint32_t pool_size          = p_pool->p_stack_limit - p_pool->p_stack_base;
+        uint8_t const * p_begin     = p_pool->p_memory_begin;
+
+        if (((uint8_t const *)p_element >= p_begin) &&
+            ((uint8_t const *)p_element <  p_begin + (pool_size * p_pool->block_size)))
+        {
+            break;
+        }
+    }
+
+    return cls;
+}
+
+/**@brief  Take an element from the free list of a class.
+ *
+ * @details Free elements hold the index + 1 of the next free element in their first word. The
+ *          value read from an element that has been taken by another context in the meantime is
+ *          discarded, because the tag of the head has changed and the exchange fails.
+ *
+ * @param[in]   p_pool  Pointer to the memory pool of the class.
+ * @param[in]   p_cb    Pointer to the control block of the class.
+ *
+ * @return      Pointer to the element or NULL if the free list is empty.
+ */
+static void * slab_free_list_pop(nrf_balloc_t const * p_pool, nrf_slab_class_cb_t * p_cb)
+{
+    uint32_t head = p_cb->free_head;
+    uint32_t next;
+    void   * p_element;
+
+    do
+    {
+        if ((head & FREE_HEAD_IDX_MASK) == 0)
+        {
+            return NULL;
+        }
+        p_element = slab_idx2element(p_pool, (head & FREE_HEAD_IDX_MASK) - 1);
+        next      = *(uint32_t volatile *)p_element & FREE_HEAD_IDX_MASK;
+    } while (!nrf_atomic_u32_cmp_exch(&p_cb->free_head,
+                                      &head,
+                                      ((head & ~FREE_HEAD_IDX_MASK) + FREE_HEAD_TAG_INC) | next));
+
+    return p_element;
+}
+
+/**@brief  Put an element on the free list of a class.
+ *
+ * @param[in]   p_pool      Pointer to the memory pool of the class.
+ * @param[in]   p_cb        Pointer to the control block of the class.
+ * @param[in]   p_element   Pointer to the element.
+ */
+static void slab_free_list_push(nrf_balloc_t const * p_pool,
+                                nrf_slab_class_cb_t * p_cb,
+                                void                * p_element)
+{
+    uint32_t idx  = slab_element2idx(p_pool, p_element) + 1;
+    uint32_t head = p_cb->free_head;
+
+    do
+    {
+        *(uint32_t volatile *)p_element = head & FREE_HEAD_IDX_MASK;
+    } while (!nrf_atomic_u32_cmp_exch(&p_cb->free_head,
+                                      &head,
+                                      ((head & ~FREE_HEAD_IDX_MASK) + FREE_HEAD_TAG_INC) | idx));
+}
+
+ret_code_t nrf_slab_init(nrf_slab_t const * p_slab)
+{
+    ret_code_t err_code;
+    uint32_t   min_size;
+
+    VERIFY_PARAM_NOT_NULL(p_slab);
+
+    if (p_slab->class_count == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    min_size = NRF_BALLOC_ELEMENT_SIZE(p_slab->pp_pools[0]);
+    if ((min_size & (min_size - 1)) != 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t cls = 0; cls < p_slab->class_count; cls++)
+    {
+        nrf_balloc_t const * p_pool = p_slab->pp_pools[cls];
+
+        if (NRF_BALLOC_ELEMENT_SIZE(p_pool) != (min_size << cls))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+
+        err_code = nrf_balloc_init(p_pool);
+        VERIFY_SUCCESS(err_code);
+
+        memset(&p_slab->p_cb[cls], 0, sizeof(p_slab->p_cb[cls]));
+    }
+
+    return NRF_SUCCESS;
+}
+
+void * nrf_slab_alloc(nrf_slab_t const * p_slab, size_t size)
+{
+    ASSERT(p_slab != NULL);
+
+    for (uint32_t cls = slab_size_class_get(p_slab, size); cls < p_slab->class_count; cls++)
+    {
+        nrf_balloc_t const  * p_pool = p_slab->pp_pools[cls];
+        nrf_slab_class_cb_t * p_cb   = &p_slab->p_cb[cls];
+
+        void * p_element = slab_free_list_pop(p_pool, p_cb);
+        if (p_element == NULL)
+        {
+            // Free list is empty. Draw a block that has never been used from the pool.
+            p_element = nrf_balloc_alloc(p_pool);
+        }
+
+        if (p_element != NULL)
+        {
+            uint32_t in_use  = nrf_atomic_u32_add(&p_cb->in_use, 1);
+            uint32_t max_use = p_cb->max_in_use;
+
+            while ((in_use > max_use) &&
+                   !nrf_atomic_u32_cmp_exch(&p_cb->max_in_use, &max_use, in_use))
+            {
+                // Retry with the updated watermark.
+            }
+
+            return p_element;
+        }
+
+        // Class is exhausted, spill to the next larger one.
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_add(&p_cb->failures, 1));
+    }
+
+    return NULL;
+}
+
+void nrf_slab_free(nrf_slab_t const * p_slab, void * p_element)
+{
+    ASSERT(p_slab != NULL);
+
+    if (p_element == NULL)
+    {
+        return;
+    }
+
+    uint32_t cls = slab_owner_class_get(p_slab, p_element);
+    if (cls >= p_slab->class_count)
+    {
+        ASSERT(false);
+        return;
+    }
+
+    slab_free_list_push(p_slab->pp_pools[cls], &p_slab->p_cb[cls], p_element);
+    UNUSED_RETURN_VALUE(nrf_atomic_u32_sub(&p_slab->p_cb[cls].in_use, 1));
+}
+
+size_t nrf_slab_element_size_get(nrf_slab_t const * p_slab, void const * p_element)
+{
+    ASSERT(p_slab != NULL);
+
+    uint32_t cls = slab_owner_class_get(p_slab, p_element);
+    if (cls >= p_slab->class_count)
+    {
+        return 0;
+    }
+
+    return NRF_BALLOC_ELEMENT_SIZE(p_slab->pp_pools[cls]);
+}
+
+ret_code_t nrf_slab_class_stats_get(nrf_slab_t const *      p_slab,
+                                    uint8_t                 class_idx,
+                                    nrf_slab_class_stats_t * p_stats,
+                                    bool                    reset)
+{
+    ASSERT(p_slab != NULL);
+    VERIFY_PARAM_NOT_NULL(p_stats);
+
+    if (class_idx >= p_slab->class_count)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    nrf_balloc_t const  * p_pool = p_slab->pp_pools[class_idx];
+    nrf_slab_class_cb_t * p_cb   = &p_slab->p_cb[class_idx];
+
+    p_stats->element_size = NRF_BALLOC_ELEMENT_SIZE(p_pool);
+    p_stats->pool_size    = p_pool->p_stack_limit - p_pool->p_stack_base;
+    p_stats->in_use       = p_cb->in_use;
+    p_stats->max_in_use   = p_cb->max_in_use;
+    p_stats->failures     = p_cb->failures;
+
+    if (reset)
+    {
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_store(&p_cb->max_in_use, p_cb->in_use));
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_store(&p_cb->failures, 0));
+    }
+
+    return NRF_SUCCESS;
+}
+
+#if NRF_SLAB_MALLOC_ENABLED
+
+NRF_BALLOC_DEF(m_slab_malloc_16,  16,  NRF_SLAB_MALLOC_16_COUNT);
+NRF_BALLOC_DEF(m_slab_malloc_32,  32,  NRF_SLAB_MALLOC_32_COUNT);
+NRF_BALLOC_DEF(m_slab_malloc_64,  64,  NRF_SLAB_MALLOC_64_COUNT);
+NRF_BALLOC_DEF(m_slab_malloc_128, 128, NRF_SLAB_MALLOC_128_COUNT);
+NRF_BALLOC_DEF(m_slab_malloc_256, 256, NRF_SLAB_MALLOC_256_COUNT);
+
+NRF_SLAB_DEF(m_slab_malloc, &m_slab_malloc_16,
+                            &m_slab_malloc_32,
+                            &m_slab_malloc_64,
+                            &m_slab_malloc_128,
+                            &m_slab_malloc_256);
+
+static volatile bool m_slab_malloc_initialized;
+
+nrf_slab_t const * nrf_slab_malloc_instance_get(void)
+{
+    if (!m_slab_malloc_initialized)
+    {
+        CRITICAL_REGION_ENTER();
+        if (!m_slab_malloc_initialized)
+        {
+            ret_code_t err_code = nrf_slab_init(&m_slab_malloc);
+            APP_ERROR_CHECK(err_code);
+            m_slab_malloc_initialized = true;
+        }
+        CRITICAL_REGION_EXIT();
+    }
+
+    return &m_slab_malloc;
+}
+
+void * nrf_slab_malloc(size_t size)
+{
+    return nrf_slab_alloc(nrf_slab_malloc_instance_get(), size);
+}
+
+void nrf_slab_malloc_free(void * p_element)
+{
+    nrf_slab_free(nrf_slab_malloc_instance_get(), p_element);
+}
+
+void * nrf_slab_calloc(size_t count, size_t size)
+{
+    // Reject requests whose total size does not fit in size_t.
+    if ((size != 0) && (count > (SIZE_MAX / size)))
+    {
+        return NULL;
+    }
+
+    void * p_element = nrf_slab_malloc(count * size);
+    if (p_element != NULL)
+    {
+        memset(p_element, 0, count * size);
+    }
+
+    return p_element;
+}
+
+void * nrf_slab_realloc(void * p_element, size_t size)
+{
+    if (p_element == NULL)
+    {
+        return nrf_slab_malloc(size);
+    }
+    if (size == 0)
+    {
+        nrf_slab_malloc_free(p_element);
+        return NULL;
+    }
+
+    size_t old_size = nrf_slab_element_size_get(nrf_slab_malloc_instance_get(), p_element);
+    if (size <= old_size)
+    {
+        return p_element;
+    }
+
+    void * p_new = nrf_slab_malloc(size);
+    if (p_new != NULL)
+    {
+        memcpy(p_new, p_element, old_size);
+        nrf_slab_malloc_free(p_element);
+    }
+
+    return p_new;
+}
+
+#endif // NRF_SLAB_MALLOC_ENABLED
+
+#endif // NRF_MODULE_ENABLED(NRF_SLAB)
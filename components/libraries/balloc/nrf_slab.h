@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/**
+ * @defgroup nrf_slab Multi-size-class slab allocator
+ * @{
+ * @ingroup nrf_balloc
+ * @brief Allocator serving variable-size requests from a set of @ref nrf_balloc pools.
+ *
+ * @details Every pool of a slab instance forms one size class. Element sizes of consecutive
+ *          classes must double (for example 16, 32, 64 and 128 bytes), which allows a request
+ *          to be mapped to its class with a single count-leading-zeros instruction. If the
+ *          matching class is exhausted, the request is served from the next larger class.
+ *
+ *          Freed elements are not returned to the underlying pool. They are kept in a per-class
+ *          lock-free free list instead, so once a block has been drawn from the pool, allocating
+ *          and freeing it again only costs a few @ref nrf_atomic compare-and-exchange operations
+ *          and never disables interrupts. The pool itself (and its critical region) is only
+ *          touched when the free list of a class is empty.
+ *
+ * @note    Pools assigned to a slab instance must not be used directly with
+ *          @ref nrf_balloc_alloc or @ref nrf_balloc_free.
+ */
+
+#ifndef NRF_SLAB_H__
+#define NRF_SLAB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdk_errors.h"
+#include "nrf_balloc.h"
+#include "nrf_atomic.h"
+
+/**@brief Size class control block. */
+typedef struct
+{
+    nrf_atomic_u32_t free_head;         //!< Head of the free list: tag (bits 8-31) and index + 1 of the first element (bits 0-7).
+    nrf_atomic_u32_t in_use;            //!< Number of elements currently allocated from the class.
+    nrf_atomic_u32_t max_in_use;        //!< High watermark of @ref nrf_slab_class_cb_t::in_use.
+    nrf_atomic_u32_t failures;          //!< Number of requests that found the class exhausted.
+} nrf_slab_class_cb_t;
+
+/**@brief Slab allocator instance. */
+typedef struct
+{
+    nrf_balloc_t const * const * pp_pools;      //!< Pools ordered by element size, one per size class.
+    nrf_slab_class_cb_t        * p_cb;          //!< Control blocks, one per size class.
+    uint8_t                      class_count;   //!< Number of size classes.
+} nrf_slab_t;
+
+/**@brief Size class statistics. */
+typedef struct
+{
+    uint16_t element_size;              //!< Size of a single element in the class.
+    uint8_t  pool_size;                 //!< Number of elements in the class.
+    uint8_t  in_use;                    //!< Number of elements currently allocated.
+    uint8_t  max_in_use;                //!< Maximum number of elements allocated at the same time.
+    uint32_t failures;                  //!< Number of requests that found the class exhausted.
+} nrf_slab_class_stats_t;
+
+/**@brief Create a slab allocator instance.
+ *
+ * @details Pools must be created with @ref NRF_BALLOC_DEF beforehand and passed in order of
+ *          increasing element size. Example:
+ *
+ * @code
+ * NRF_BALLOC_DEF(m_pool_16, 16, 8);
+ * NRF_BALLOC_DEF(m_pool_32, 32, 4);
+ * NRF_BALLOC_DEF(m_pool_64, 64, 2);
+ * NRF_SLAB_DEF(m_slab, &m_pool_16, &m_pool_32, &m_pool_64);
+ * @endcode
+ *
+ * @param[in]   _name   Name of the instance.
+ * @param[in]   ...     Pointers to the pools, one per size class.
+ */
+#define NRF_SLAB_DEF(_name, ...)                                                                \
+    static nrf_balloc_t const * const CONCAT_2(_name, _nrf_slab_pools)[] = { __VA_ARGS__ };    \
+    static nrf_slab_class_cb_t CONCAT_2(_name, _nrf_slab_cb)[NUM_VA_ARGS(__VA_ARGS__)];         \
+    static const nrf_slab_t _name =                                                             \
+    {                                                                                           \
+        .pp_pools    = CONCAT_2(_name, _nrf_slab_pools),                                        \
+        .p_cb        = CONCAT_2(_name, _nrf_slab_cb),                                           \
+        .class_count = NUM_VA_ARGS(__VA_ARGS__),                                                \
+    }
+
+/**@brief Function for initializing a slab allocator instance.
+ *
+ * @details Initializes all underlying pools.
+ *
+ * @param[in]   p_slab  Pointer to the instance.
+ *
+ * @retval  NRF_SUCCESS             If the instance was initialized.
+ * @retval  NRF_ERROR_NULL          If @p p_slab is NULL.
+ * @retval  NRF_ERROR_INVALID_PARAM If element sizes of the pools are not consecutive powers of two.
+ */
+ret_code_t nrf_slab_init(nrf_slab_t const * p_slab);
+
+/**@brief Function for allocating an element.
+ *
+ * @note    This module guarantees that the returned memory is aligned to 4.
+ *
+ * @param[in]   p_slab  Pointer to the instance.
+ * @param[in]   size    Requested size in bytes.
+ *
+ * @return  Allocated element or NULL if no class large enough has a free element.
+ */
+void * nrf_slab_alloc(nrf_slab_t const * p_slab, size_t size);
+
+/**@brief Function for freeing an element.
+ *
+ * @param[in]   p_slab      Pointer to the instance.
+ * @param[in]   p_element   Element to be freed. NULL is ignored.
+ */
+void nrf_slab_free(nrf_slab_t const * p_slab, void * p_element);
+
+/**@brief Function for getting the usable size of an allocated element.
+ *
+ * @param[in]   p_slab      Pointer to the instance.
+ * @param[in]   p_element   Allocated element.
+ *
+ * @return  Size of the element, or 0 if it does not belong to the instance.
+ */
+size_t nrf_slab_element_size_get(nrf_slab_t const * p_slab, void const * p_element);
+
+/**@brief Function for getting statistics of a size class.
+ *
+ * @param[in]   p_slab      Pointer to the instance.
+ * @param[in]   class_idx   Index of the size class.
+ * @param[out]  p_stats     Statistics.
+ * @param[in]   reset       True to reset the high watermark and the failure counter after reading.
+ *
+ * @retval  NRF_SUCCESS             If statistics were read.
+ * @retval  NRF_ERROR_INVALID_PARAM If @p class_idx is out of range.
+ */
+ret_code_t nrf_slab_class_stats_get(nrf_slab_t const *      p_slab,
+                                    uint8_t                 class_idx,
+                                    nrf_slab_class_stats_t * p_stats,
+                                    bool                    reset);
+
+#if NRF_SLAB_MALLOC_ENABLED || defined(__SDK_DOXYGEN__)
+/**@brief Function for getting the instance backing the heap functions of the module.
+ *
+ * @details When @ref NRF_SLAB_MALLOC_ENABLED is set, the module provides @ref nrf_slab_malloc,
+ *          @ref nrf_slab_calloc, @ref nrf_slab_realloc and @ref nrf_slab_malloc_free served from
+ *          this instance. It is initialized on first use.
+ *
+ * @return  Pointer to the instance.
+ */
+nrf_slab_t const * nrf_slab_malloc_instance_get(void);
+
+/**@brief Function for allocating memory, like @c malloc.
+ *
+ * @param[in]   size    Requested size in bytes.
+ *
+ * @return  Allocated memory or NULL if no size class large enough has a free element.
+ */
+void * nrf_slab_malloc(size_t size);
+
+/**@brief Function for allocating zero-initialized memory for an array, like @c calloc.
+ *
+ * @param[in]   count   Number of elements.
+ * @param[in]   size    Size of an element in bytes.
+ *
+ * @return  Allocated memory or NULL if the total size overflows or no size class large enough has
+ *          a free element.
+ */
+void * nrf_slab_calloc(size_t count, size_t size);
+
+/**@brief Function for resizing memory allocated with the heap functions of the module, like
+ *        @c realloc.
+ *
+ * @param[in]   p_element   Memory to be resized, or NULL to allocate.
+ * @param[in]   size        New size in bytes, or 0 to free.
+ *
+ * @return  Resized memory, or NULL if it could not be allocated. The original memory is then left
+ *          untouched.
+ */
+void * nrf_slab_realloc(void * p_element, size_t size);
+
+/**@brief Function for freeing memory allocated with the heap functions of the module, like
+ *        @c free.
+ *
+ * @param[in]   p_element   Memory to be freed. NULL is ignored.
+ */
+void nrf_slab_malloc_free(void * p_element);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_SLAB_H__
+/** @} */
@@ -56,6 +56,14 @@
 extern "C" {
 #endif
 
+/**@brief CRC-16 implementations selectable with CRC16_CONFIG_ALGORITHM.
+ *
+ * All implementations give identical results. Faster ones use more flash for lookup tables.
+ */
+#define CRC16_ALGORITHM_SHIFT         0 /**< Shifts and XORs per byte, no table. */
+#define CRC16_ALGORITHM_BYTE_TABLE    1 /**< Byte at a time, 512-byte table. */
+#define CRC16_ALGORITHM_SLICING_BY_4  2 /**< 4 bytes at a time, 2 kB of tables. */
+
 /**@brief Function for calculating CRC-16 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
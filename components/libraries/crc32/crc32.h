@@ -55,6 +55,16 @@
 extern "C" {
 #endif
 
+/**@brief CRC-32 implementations selectable with CRC32_CONFIG_ALGORITHM.
+ *
+ * All implementations give identical results. Faster ones use more flash for lookup tables.
+ */
+#define CRC32_ALGORITHM_BITWISE       0 /**< Bit at a time, no table. */
+#define CRC32_ALGORITHM_NIBBLE_TABLE  1 /**< 4 bits at a time, 64-byte table. */
+#define CRC32_ALGORITHM_BYTE_TABLE    2 /**< Byte at a time, 1 kB table. */
+#define CRC32_ALGORITHM_SLICING_BY_4  3 /**< 4 bytes at a time, 4 kB of tables. */
+#define CRC32_ALGORITHM_SLICING_BY_8  4 /**< 8 bytes at a time, 8 kB of tables. */
+
 /**@brief Function for calculating CRC-32 in blocks.
  *
  * Feed each consecutive data block into this function, along with the current value of p_crc as
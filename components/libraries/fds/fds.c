@@ -54,6 +54,8 @@
 #include "nrf_fstorage_sd.h"
 #elif (FDS_BACKEND == NRF_FSTORAGE_NVMC)
 #include "nrf_fstorage_nvmc.h"
+#elif (FDS_BACKEND == NRF_FSTORAGE_FILE)
+#include "nrf_fstorage_file.h"
 #else
 #error Invalid FDS backend.
 #endif
@@ -1658,6 +1660,10 @@ ret_code_t fds_register(fds_cb_t cb)
 
 static uint32_t flash_end_addr(void)
 {
+#if (FDS_BACKEND == NRF_FSTORAGE_FILE)
+    // The file is mapped by nrf_fstorage_init(), use the end of the mapping.
+    uint32_t end_addr = nrf_fstorage_file_flash_end_get();
+#else
     uint32_t const bootloader_addr = BOOTLOADER_ADDRESS;
     uint32_t const page_sz         = NRF_FICR->CODEPAGESIZE;
 
@@ -1671,6 +1677,7 @@ static uint32_t flash_end_addr(void)
 #endif
 
     uint32_t end_addr = (bootloader_addr != 0xFFFFFFFF) ? bootloader_addr : (code_sz * page_sz);
+#endif
 
     return end_addr - (FDS_PHY_PAGES_RESERVED * FDS_PHY_PAGE_SIZE * sizeof(uint32_t));
 }
@@ -1686,12 +1693,21 @@ static void flash_bounds_set(void)
 
 static ret_code_t flash_subsystem_init(void)
 {
-    flash_bounds_set();
-
     #if   (FDS_BACKEND == NRF_FSTORAGE_SD)
+        flash_bounds_set();
         return nrf_fstorage_init(&m_fs, &nrf_fstorage_sd, NULL);
     #elif (FDS_BACKEND == NRF_FSTORAGE_NVMC)
+        flash_bounds_set();
         return nrf_fstorage_init(&m_fs, &nrf_fstorage_nvmc, NULL);
+    #elif (FDS_BACKEND == NRF_FSTORAGE_FILE)
+        STATIC_ASSERT(NRF_FSTORAGE_FILE_PAGE_SIZE == FDS_PHY_PAGE_SIZE * sizeof(uint32_t));
+        // The flash addresses are known once the file is mapped.
+        ret_code_t const ret = nrf_fstorage_init(&m_fs, &nrf_fstorage_file, NULL);
+        if (ret == NRF_SUCCESS)
+        {
+            flash_bounds_set();
+        }
+        return ret;
     #else
         #error Invalid FDS_BACKEND.
     #endif
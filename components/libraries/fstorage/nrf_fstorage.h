@@ -49,9 +49,10 @@
  *
  * @brief   Flash abstraction library that provides basic read, write, and erase operations.
  *
- * @details The fstorage library can be implemented in different ways. Two implementations are provided:
+ * @details The fstorage library can be implemented in different ways. Three implementations are provided:
  * - The @ref nrf_fstorage_sd implements flash access through the SoftDevice.
  * - The @ref nrf_fstorage_nvmc implements flash access through the non-volatile memory controller.
+ * - The @ref nrf_fstorage_file emulates flash with a memory-mapped file, for host builds.
  *
  * You can select the implementation that should be used independently for each instance of fstorage.
  */
@@ -0,0 +1,491 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "sdk_common.h"
+
+#if NRF_MODULE_ENABLED(NRF_FSTORAGE)
+
+#include "nrf_fstorage_file.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "nrf_atomic.h"
+
+
+/* Flash addresses are the addresses of the mapping, and flash users such as FDS store them in 32-bit
+ * variables. On 64-bit hosts, place the mapping in the low part of the address space so they fit. */
+#if defined(MAP_32BIT)
+#define FILE_MMAP_FLAGS     (MAP_SHARED | MAP_32BIT)
+#else
+#define FILE_MMAP_FLAGS     (MAP_SHARED)
+#endif
+
+#define FLASH_ERASED_WORD   (0xFFFFFFFF)
+
+
+static nrf_fstorage_info_t m_flash_info =
+{
+    .erase_unit   = NRF_FSTORAGE_FILE_PAGE_SIZE,
+    .program_unit = 4,
+    .rmap         = true,
+    .wmap         = true,
+};
+
+
+/* State of the emulated flash, shared by all instances. */
+static struct
+{
+    int                       fd;               //!< File descriptor of the backing file.
+    uint8_t                 * p_flash;          //!< Start of the mapping.
+    uint32_t                  flash_size;       //!< Size of the mapping.
+    uint32_t                  write_latency_us; //!< Modeled time to program one word.
+    uint32_t                  erase_latency_us; //!< Modeled time to erase one page.
+    uint32_t                * p_erase_cnt;      //!< Erase cycles of each page.
+    uint32_t                  users;            //!< Number of initialized instances.
+    nrf_fstorage_file_stats_t stats;            //!< Operation counters.
+} m_file =
+{
+    .fd = -1,
+};
+
+
+ /* An operation initiated by fstorage is ongoing. */
+static nrf_atomic_flag_t m_flash_operation_ongoing;
+
+
+/* Send event to the event handler. */
+static void event_send(nrf_fstorage_t        const * p_fs,
+                       nrf_fstorage_evt_id_t         evt_id,
+                       void const *                  p_src,
+                       uint32_t                      addr,
+                       uint32_t                      len,
+                       void                        * p_param)
+{
+    if (p_fs->evt_handler == NULL)
+    {
+        /* Nothing to do. */
+        return;
+    }
+
+    nrf_fstorage_evt_t evt =
+    {
+        .result  = NRF_SUCCESS,
+        .id      = evt_id,
+        .addr    = addr,
+        .p_src   = p_src,
+        .len     = len,
+        .p_param = p_param,
+    };
+
+    p_fs->evt_handler(&evt);
+}
+
+
+/* Account for, and model, the time taken by a flash operation. */
+static void busy_wait(uint64_t time_us)
+{
+    m_file.stats.busy_time_us += time_us;
+
+    if (time_us != 0)
+    {
+        struct timespec ts =
+        {
+            .tv_sec  = (time_t)(time_us / 1000000),
+            .tv_nsec = (long)((time_us % 1000000) * 1000),
+        };
+
+        while (nanosleep(&ts, &ts) != 0)
+        {
+            /* Interrupted by a signal, sleep for the remaining time. */
+        }
+    }
+}
+
+
+/* Start address of the emulated flash, that is the address of the mapping. */
+static uint32_t flash_start(void)
+{
+    return (uint32_t)(uintptr_t)m_file.p_flash;
+}
+
+
+/* Check that an address is within the emulated flash. */
+static bool addr_is_valid(uint32_t addr)
+{
+    return (m_file.p_flash != NULL) && (addr >= flash_start()) && (addr - flash_start() < m_file.flash_size);
+}
+
+
+/* Check that an access is word-aligned and within the emulated flash. */
+static bool access_is_valid(uint32_t addr, uint32_t len)
+{
+    if ((addr & 0x3) || (len == 0) || !addr_is_valid(addr))
+    {
+        return false;
+    }
+
+    return (len <= m_file.flash_size - (addr - flash_start()));
+}
+
+
+static ret_code_t flash_map(nrf_fstorage_file_cfg_t const * p_cfg)
+{
+    struct stat st;
+
+    if ((p_cfg->flash_size == 0) || (p_cfg->flash_size % m_flash_info.erase_unit))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_file.fd = open(p_cfg->p_path, O_RDWR | O_CREAT, 0644);
+    if (m_file.fd < 0)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+
+    if ((fstat(m_file.fd, &st) != 0) ||
+        ((st.st_size < (off_t)p_cfg->flash_size) && (ftruncate(m_file.fd, p_cfg->flash_size) != 0)))
+    {
+        (void) close(m_file.fd);
+        m_file.fd = -1;
+        return NRF_ERROR_INTERNAL;
+    }
+
+    void * p_map = mmap(NULL, p_cfg->flash_size, PROT_READ | PROT_WRITE, FILE_MMAP_FLAGS, m_file.fd, 0);
+    m_file.p_erase_cnt = calloc(p_cfg->flash_size / m_flash_info.erase_unit, sizeof(uint32_t));
+
+    /* The whole mapping must be addressable with 32-bit flash addresses. */
+    if (   (p_map == MAP_FAILED)
+        || (m_file.p_erase_cnt == NULL)
+        || ((uintptr_t)p_map > (uintptr_t)(UINT32_MAX - p_cfg->flash_size)))
+    {
+        if (p_map != MAP_FAILED)
+        {
+            (void) munmap(p_map, p_cfg->flash_size);
+        }
+        free(m_file.p_erase_cnt);
+        m_file.p_erase_cnt = NULL;
+        (void) close(m_file.fd);
+        m_file.fd = -1;
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_file.p_flash          = p_map;
+    m_file.flash_size       = p_cfg->flash_size;
+    m_file.write_latency_us = p_cfg->write_latency_us;
+    m_file.erase_latency_us = p_cfg->erase_latency_us;
+
+    /* Flash that was not backed by the file yet is in the erased state. */
+    if (st.st_size < (off_t)p_cfg->flash_size)
+    {
+        memset(m_file.p_flash + st.st_size, 0xFF, p_cfg->flash_size - st.st_size);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+static void flash_unmap(void)
+{
+    (void) msync(m_file.p_flash, m_file.flash_size, MS_SYNC);
+    (void) munmap(m_file.p_flash, m_file.flash_size);
+    (void) close(m_file.fd);
+    free(m_file.p_erase_cnt);
+
+    m_file.p_flash     = NULL;
+    m_file.p_erase_cnt = NULL;
+    m_file.flash_size  = 0;
+    m_file.fd          = -1;
+}
+
+
+static ret_code_t init(nrf_fstorage_t * p_fs, void * p_param)
+{
+    static nrf_fstorage_file_cfg_t const default_cfg =
+    {
+        .p_path           = NRF_FSTORAGE_FILE_PATH,
+        .flash_size       = NRF_FSTORAGE_FILE_FLASH_SIZE,
+        .write_latency_us = NRF_FSTORAGE_FILE_WRITE_LATENCY_US,
+        .erase_latency_us = NRF_FSTORAGE_FILE_ERASE_LATENCY_US,
+    };
+
+    if (m_file.users == 0)
+    {
+        nrf_fstorage_file_cfg_t const * p_cfg = (p_param != NULL) ? p_param : &default_cfg;
+
+        ret_code_t rc = flash_map(p_cfg);
+        if (rc != NRF_SUCCESS)
+        {
+            return rc;
+        }
+    }
+
+    m_file.users++;
+    p_fs->p_flash_info = &m_flash_info;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t uninit(nrf_fstorage_t * p_fs, void * p_param)
+{
+    UNUSED_PARAMETER(p_fs);
+    UNUSED_PARAMETER(p_param);
+
+    if (m_file.users == 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (--m_file.users == 0)
+    {
+        flash_unmap();
+    }
+
+    (void) nrf_atomic_flag_clear(&m_flash_operation_ongoing);
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_read(nrf_fstorage_t const * p_fs, uint32_t src, void * p_dest, uint32_t len)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    if (!access_is_valid(src, len))
+    {
+        m_file.stats.rejected_cnt++;
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    memcpy(p_dest, (uint8_t const *)(uintptr_t)src, len);
+
+    m_file.stats.read_cnt++;
+    m_file.stats.bytes_read += len;
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_write(nrf_fstorage_t const * p_fs,
+                              uint32_t               dest,
+                              void           const * p_src,
+                              uint32_t               len,
+                              void                 * p_param)
+{
+    if (!access_is_valid(dest, len) || (len % m_flash_info.program_unit))
+    {
+        m_file.stats.rejected_cnt++;
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (nrf_atomic_flag_set_fetch(&m_flash_operation_ongoing))
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    uint32_t   const   words   = len / m_flash_info.program_unit;
+    uint32_t         * p_flash = (uint32_t *)(uintptr_t)dest;
+    uint8_t    const * p_data  = p_src;
+
+    for (uint32_t i = 0; i < words; i++)
+    {
+        uint32_t word;
+
+        /* The source buffer is not required to be word-aligned on the host. */
+        memcpy(&word, p_data + (i * sizeof(word)), sizeof(word));
+
+        /* Programming can only clear bits. */
+        if (word & ~p_flash[i])
+        {
+            m_file.stats.bit_set_violations++;
+        }
+
+        p_flash[i] &= word;
+    }
+
+    m_file.stats.write_cnt++;
+    m_file.stats.words_written += words;
+    busy_wait((uint64_t)words * m_file.write_latency_us);
+
+    /* Clear the flag before sending the event, to allow API calls in the event context. */
+    (void) nrf_atomic_flag_clear(&m_flash_operation_ongoing);
+
+    event_send(p_fs, NRF_FSTORAGE_EVT_WRITE_RESULT, p_src, dest, len, p_param);
+
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_erase(nrf_fstorage_t const * p_fs,
+                              uint32_t               page_addr,
+                              uint32_t               len,
+                              void                 * p_param)
+{
+    if (   ((page_addr - flash_start()) % m_flash_info.erase_unit)
+        || (len > (m_file.flash_size / m_flash_info.erase_unit))
+        || !access_is_valid(page_addr, len * m_flash_info.erase_unit))
+    {
+        m_file.stats.rejected_cnt++;
+        return NRF_ERROR_INVALID_ADDR;
+    }
+
+    if (nrf_atomic_flag_set_fetch(&m_flash_operation_ongoing))
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    for (uint32_t progress = 0; progress < len; progress++)
+    {
+        uint32_t const addr = page_addr + (progress * m_flash_info.erase_unit);
+
+        memset((uint8_t *)(uintptr_t)addr, (uint8_t)FLASH_ERASED_WORD, m_flash_info.erase_unit);
+        m_file.p_erase_cnt[(addr - flash_start()) / m_flash_info.erase_unit]++;
+    }
+
+    m_file.stats.erase_cnt++;
+    m_file.stats.pages_erased += len;
+    busy_wait((uint64_t)len * m_file.erase_latency_us);
+
+    /* Clear the flag before sending the event, to allow API calls in the event context. */
+    (void) nrf_atomic_flag_clear(&m_flash_operation_ongoing);
+
+    event_send(p_fs, NRF_FSTORAGE_EVT_ERASE_RESULT, NULL, page_addr, len, p_param);
+
+    return NRF_SUCCESS;
+}
+
+
+static uint8_t const * rmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    if (!addr_is_valid(addr))
+    {
+        return NULL;
+    }
+
+    return (uint8_t *)(uintptr_t)addr;
+}
+
+
+static uint8_t * wmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    /* Writes through this pointer bypass the NOR flash checks and counters. */
+    if (!addr_is_valid(addr))
+    {
+        return NULL;
+    }
+
+    return (uint8_t *)(uintptr_t)addr;
+}
+
+
+static bool is_busy(nrf_fstorage_t const * p_fs)
+{
+    UNUSED_PARAMETER(p_fs);
+
+    return m_flash_operation_ongoing;
+}
+
+
+void nrf_fstorage_file_stats_get(nrf_fstorage_file_stats_t * p_stats)
+{
+    *p_stats = m_file.stats;
+}
+
+
+void nrf_fstorage_file_stats_reset(void)
+{
+    memset(&m_file.stats, 0, sizeof(m_file.stats));
+
+    if (m_file.p_erase_cnt != NULL)
+    {
+        memset(m_file.p_erase_cnt, 0,
+               (m_file.flash_size / m_flash_info.erase_unit) * sizeof(uint32_t));
+    }
+}
+
+
+uint32_t nrf_fstorage_file_page_erase_cnt_get(uint32_t page_addr)
+{
+    if ((m_file.p_erase_cnt == NULL) || !addr_is_valid(page_addr))
+    {
+        return 0;
+    }
+
+    return m_file.p_erase_cnt[(page_addr - flash_start()) / m_flash_info.erase_unit];
+}
+
+
+uint32_t nrf_fstorage_file_flash_start_get(void)
+{
+    return (m_file.p_flash != NULL) ? flash_start() : 0;
+}
+
+
+uint32_t nrf_fstorage_file_flash_end_get(void)
+{
+    return (m_file.p_flash != NULL) ? (flash_start() + m_file.flash_size) : 0;
+}
+
+
+/* The exported API. */
+nrf_fstorage_api_t nrf_fstorage_file =
+{
+    .init    = init,
+    .uninit  = uninit,
+    .read    = flash_read,
+    .write   = flash_write,
+    .erase   = flash_erase,
+    .rmap    = rmap,
+    .wmap    = wmap,
+    .is_busy = is_busy
+};
+
+
+#endif // NRF_FSTORAGE_ENABLED
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup nrf_fstorage_file File implementation
+ * @ingroup nrf_fstorage
+ * @{
+ *
+ * @brief API implementation of fstorage that emulates flash with a memory-mapped file.
+ *
+ * @details This implementation is intended for host (x86 Linux) builds, where it allows
+ *          flash users such as FDS or the Peer Manager to run and be benchmarked without
+ *          the NVMC. The emulated flash is backed by a single file, shared by all fstorage
+ *          instances that use this implementation. The file is memory-mapped and, as on the
+ *          device, flash addresses are the addresses of the mapping, so that flash users can
+ *          dereference them. The addresses are only known once the file is mapped: set the
+ *          @c start_addr and @c end_addr of an instance after @ref nrf_fstorage_init, within
+ *          the range returned by @ref nrf_fstorage_file_flash_start_get and
+ *          @ref nrf_fstorage_file_flash_end_get. NOR flash semantics are enforced:
+ *          writes can only clear bits, erase works on whole pages, and all accesses must be
+ *          word-aligned. Write and erase latency are modeled by sleeping for a configurable
+ *          amount of time, and every operation is counted, including the number of times each
+ *          page has been erased.
+ */
+
+#ifndef NRF_FSTORAGE_FILE_H__
+#define NRF_FSTORAGE_FILE_H__
+
+#include <stdint.h>
+#include "nrf_fstorage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**@brief   Configuration of the file implementation.
+ *
+ * @details A pointer to this structure can be passed as the @c p_param argument of
+ *          @ref nrf_fstorage_init. If @c NULL is passed, the default values from
+ *          @c sdk_config.h are used. The configuration is applied by the first instance that is
+ *          initialized and is ignored for subsequent instances.
+ */
+typedef struct
+{
+    char const * p_path;            //!< Path of the file that backs the flash. Created if it does not exist.
+    uint32_t     flash_size;        //!< Size of the emulated flash (in bytes). Must be a multiple of the page size.
+    uint32_t     write_latency_us;  //!< Time it takes to program one word (in microseconds).
+    uint32_t     erase_latency_us;  //!< Time it takes to erase one page (in microseconds).
+} nrf_fstorage_file_cfg_t;
+
+
+/**@brief   Operation counters of the file implementation. */
+typedef struct
+{
+    uint32_t read_cnt;              //!< Number of read operations.
+    uint32_t write_cnt;             //!< Number of write operations.
+    uint32_t erase_cnt;             //!< Number of erase operations.
+    uint32_t rejected_cnt;          //!< Number of operations rejected because of alignment or bounds.
+    uint64_t bytes_read;            //!< Number of bytes read.
+    uint64_t words_written;         //!< Number of words programmed.
+    uint64_t pages_erased;          //!< Number of pages erased.
+    uint32_t bit_set_violations;    //!< Number of written words that attempted to change a bit from 0 to 1.
+    uint64_t busy_time_us;          //!< Total modeled time spent writing and erasing (in microseconds).
+} nrf_fstorage_file_stats_t;
+
+
+/**@brief   API implementation that emulates flash with a memory-mapped file.
+ *
+ * @details An fstorage instance with this API implementation can be initialized by providing
+ *          this structure as a parameter to @ref nrf_fstorage_init.
+ *          The structure is defined in @c nrf_fstorage_file.c.
+ */
+extern nrf_fstorage_api_t nrf_fstorage_file;
+
+
+/**@brief   Function for retrieving the operation counters.
+ *
+ * @param[out]  p_stats     Structure to fill in.
+ */
+void nrf_fstorage_file_stats_get(nrf_fstorage_file_stats_t * p_stats);
+
+
+/**@brief   Function for resetting the operation counters, including per-page erase counters. */
+void nrf_fstorage_file_stats_reset(void);
+
+
+/**@brief   Function for retrieving the start address of the emulated flash.
+ *
+ * @return  Address of the first byte of the emulated flash, or zero if no instance is initialized.
+ */
+uint32_t nrf_fstorage_file_flash_start_get(void);
+
+
+/**@brief   Function for retrieving the end address of the emulated flash.
+ *
+ * @return  Address following the last byte of the emulated flash, or zero if no instance is
+ *          initialized.
+ */
+uint32_t nrf_fstorage_file_flash_end_get(void);
+
+
+/**@brief   Function for retrieving how many times a page has been erased.
+ *
+ * @param[in]   page_addr   Address of the page.
+ *
+ * @return  Number of erase cycles of the page, or zero if the address is outside the emulated flash.
+ */
+uint32_t nrf_fstorage_file_page_erase_cnt_get(uint32_t page_addr);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NRF_FSTORAGE_FILE_H__
+/** @} */
@@ -57,6 +57,17 @@
 extern "C" {
 #endif
 
+#ifndef NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+/**
+ * @brief Compact mode of the flash logger backend.
+ *
+ * In compact mode, entries are stored in a compressed binary form (string ID and packed
+ * arguments), each page starts with a header indexing its first entry by sequence number and
+ * timestamp, and the area is reused circularly: when it is full, the oldest page is erased.
+ */
+#define NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED 0
+#endif
+
 /** @brief Flashlog logger backend API. */
 extern const nrf_log_backend_api_t nrf_log_backend_flashlog_api;
 
@@ -111,6 +122,42 @@ ret_code_t nrf_log_backend_flash_next_entry_get(uint32_t *          p_token,
                                                nrf_log_header_t * * pp_header,
                                                uint8_t * *          pp_data);
 
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED || defined(__SDK_DOXYGEN__)
+/**
+ * @brief Function for getting a token for reading the last entries stored in flash.
+ *
+ * Only page headers and the entries of the page holding the first requested entry are read.
+ * The token is then used with @ref nrf_log_backend_flash_next_entry_get.
+ *
+ * @note Available in compact mode only. In this mode, @ref nrf_log_backend_flash_next_entry_get
+ *       decodes entries into a static buffer, valid until the next call.
+ *
+ * @param[in]  count   Number of newest entries to read. If fewer entries are stored,
+ *                     reading starts from the oldest one.
+ * @param[out] p_token Token for @ref nrf_log_backend_flash_next_entry_get.
+ *
+ * @retval NRF_SUCCESS         Token set.
+ * @retval NRF_ERROR_NOT_FOUND Flash log is empty.
+ */
+ret_code_t nrf_log_backend_flash_last_entries_token_get(uint32_t count, uint32_t * p_token);
+
+/**
+ * @brief Function for getting a token for reading the entries logged since a given time.
+ *
+ * Only page headers and the entries of the page holding the first matching entry are read.
+ * Timestamps are assumed not to wrap around while the logs are stored.
+ *
+ * @note Available in compact mode only.
+ *
+ * @param[in]  timestamp Timestamp of the first entry to read.
+ * @param[out] p_token   Token for @ref nrf_log_backend_flash_next_entry_get.
+ *
+ * @retval NRF_SUCCESS         Token set.
+ * @retval NRF_ERROR_NOT_FOUND Flash log is empty.
+ */
+ret_code_t nrf_log_backend_flash_since_token_get(uint32_t timestamp, uint32_t * p_token);
+#endif
+
 /**
  * @brief Function for erasing flash area dedicated for the flash logger backend.
  */
@@ -216,6 +216,39 @@ nrf_log_severity_t nrf_log_module_filter_get(uint32_t backend_id,
                                              bool     is_ordered_idx,
                                              bool     dynamic);
 
+#if NRF_LOG_RATE_LIMIT_ENABLED || defined(__SDK_DOXYGEN__)
+/**
+ * @brief Function for configuring the rate limit of logs in the module.
+ *
+ * Logs are limited by a token bucket which is refilled with @p rate tokens per second and
+ * holds up to @p burst tokens. Logs over the limit are dropped before they take any space in
+ * the log buffer and are reported periodically in a summary line.
+ *
+ * @param module_id Module ID.
+ * @param rate      Sustained rate in logs per second. 0 disables the rate limit.
+ * @param burst     Number of logs that can be accepted in a burst.
+ *
+ * @retval NRF_SUCCESS             Rate limit configured.
+ * @retval NRF_ERROR_INVALID_PARAM Invalid module ID, or rate and burst not supported by the
+ *                                 timestamp frequency.
+ * @retval NRF_ERROR_INVALID_STATE No timestamp function was provided to @ref nrf_log_init.
+ */
+ret_code_t nrf_log_module_rate_limit_set(uint32_t module_id, uint16_t rate, uint16_t burst);
+
+/**
+ * @brief Function for configuring 1-in-N sampling of logs in the module.
+ *
+ * Sampling is applied before the rate limit.
+ *
+ * @param module_id Module ID.
+ * @param n         Only every N-th log is accepted. 0 or 1 disables sampling.
+ *
+ * @retval NRF_SUCCESS             Sampling configured.
+ * @retval NRF_ERROR_INVALID_PARAM Invalid module ID.
+ */
+ret_code_t nrf_log_module_sampling_set(uint32_t module_id, uint16_t n);
+#endif
+
 /**
  * @brief Function stores current filtering configuration into non-volatile memory using @ref fds module.
  *
@@ -41,6 +41,7 @@
 #define NRF_LOG_TYPES_H
 
 #include <stdint.h>
+#include "sdk_config.h"
 
 /**
  * @brief Logger severity levels.
@@ -64,6 +65,16 @@ typedef struct
 {
     uint16_t     order_idx;     ///< Ordered index of the module (used for auto-completion).
     uint16_t     filter;        ///< Current highest severity level accepted (redundant to @ref nrf_log_module_filter_data_t::filter_lvls, used for optimization)
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint32_t     rl_interval;   ///< Timestamp ticks needed to earn one token (0 if rate limit is disabled).
+    uint32_t     rl_credit;     ///< Available credit in timestamp ticks (tokens multiplied by @p rl_interval).
+    uint32_t     rl_timestamp;  ///< Timestamp of the last credit update.
+    uint16_t     rl_rate;       ///< Configured rate in logs per second.
+    uint16_t     rl_burst;      ///< Capacity of the token bucket in logs.
+    uint16_t     sample_n;      ///< Only every N-th log is accepted (0 or 1 if sampling is disabled).
+    uint16_t     sample_cnt;    ///< Logs seen since the last accepted one.
+    uint16_t     suppressed;    ///< Logs suppressed since the last summary (saturated).
+#endif
 } nrf_log_module_dynamic_data_t;
 
 /**
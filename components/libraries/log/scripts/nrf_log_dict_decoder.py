@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021, Nordic Semiconductor ASA
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+#    list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form, except as embedded into a Nordic
+#    Semiconductor ASA integrated circuit in a product or a software update for
+#    such product, must reproduce the above copyright notice, this list of
+#    conditions and the following disclaimer in the documentation and/or other
+#    materials provided with the distribution.
+#
+# 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# 4. This software, with or without modification, must only be used with a
+#    Nordic Semiconductor ASA integrated circuit.
+#
+# 5. Any software provided in binary form under this license must not be reverse
+#    engineered, decompiled, modified and/or disassembled.
+#
+# THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+# OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+"""Decoder for nrf_log dictionary frames (NRF_LOG_DICTIONARY_ENABLED).
+
+The target sends the addresses of the format strings and module names instead of the
+strings themselves. This script looks the strings up in the ELF file of the application
+and prints the logs in the same format as nrf_log_str_formatter.
+
+Usage:
+    nrf_log_dict_decoder.py app.elf /dev/ttyACM0
+    nrf_log_dict_decoder.py app.elf capture.bin --freq 32768
+
+The serial port must be configured beforehand (for example with stty).
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+
+HEADER_TYPE_STD = 1
+HEADER_TYPE_HEXDUMP = 2
+
+DESC_TYPE_MSK = 0x03
+DESC_SEVERITY_POS = 2
+DESC_SEVERITY_MSK = 0x07
+DESC_DROPPED_MSK = 0x20
+
+SEVERITY_INFO_RAW = 5
+SEVERITY_NAMES = [None, 'error', 'warning', 'info', 'debug']
+
+HEXDUMP_BYTES_IN_LINE = 8
+
+MIN_PAYLOAD_LEN = 9
+MAX_PAYLOAD_LEN = 2048
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|L|q|j|z|t)?([diouxXcsfeEgGp%])')
+
+
+# Offset of e_shoff, offset of e_shentsize and layout of the section header for ELFCLASS32 and
+# ELFCLASS64. The 64-bit layout is used by the host tests, see tests/host.
+ELF_LAYOUT = {
+    1: ('<I', 0x20, 0x2E, '<IIIIII'),
+    2: ('<Q', 0x28, 0x3A, '<IIQQQQ'),
+}
+
+
+class Elf(object):
+    """Read-only view of the allocated sections of a little endian ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF' or data[4] not in ELF_LAYOUT or data[5] != 1:
+            raise ValueError('{}: not a little endian ELF file'.format(path))
+        shoff_fmt, shoff_pos, shentsize_pos, section_fmt = ELF_LAYOUT[data[4]]
+        shoff, = struct.unpack_from(shoff_fmt, data, shoff_pos)
+        shentsize, shnum = struct.unpack_from('<HH', data, shentsize_pos)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = \
+                struct.unpack_from(section_fmt, data, shoff + i * shentsize)
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for (start, content) in self.sections:
+            if start <= addr < start + len(content):
+                end = content.find(b'\0', addr - start)
+                if end < 0:
+                    end = len(content)
+                return content[addr - start:end].decode('latin-1')
+        return None
+
+
+def signed32(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def format_string(fmt, args):
+    """Format a printf-style string with 32-bit arguments (strings already decoded)."""
+    args = list(args)
+    out = []
+    pos = 0
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, _, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        if width == '*':
+            width = str(signed32(args.pop(0)) if args else 0)
+        if precision == '*':
+            precision = str(signed32(args.pop(0)) if args else 0)
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+        value = args.pop(0) if args else 0
+        if conv == 's':
+            out.append((spec + 's') % value)
+        elif conv in 'di':
+            out.append((spec + 'd') % signed32(value))
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(value & 0xFF))
+        elif conv == 'p':
+            out.append('0x%08x' % value)
+        elif conv in 'eEfgG':
+            # nrf_log does not pass floats directly, see NRF_LOG_FLOAT.
+            out.append((spec + conv) % struct.unpack('<f', struct.pack('<I', value))[0])
+        else:
+            out.append((spec + conv) % value)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def timestamp_str(timestamp, freq):
+    if freq is None:
+        return '[%08u] ' % timestamp
+    seconds, reminder = divmod(timestamp, freq)
+    hours, seconds = divmod(seconds, 3600)
+    mins, seconds = divmod(seconds, 60)
+    us = (reminder * 1000000) // freq
+    return '[%02d:%02d:%02d.%03d,%03d] ' % (hours, mins, seconds, us // 1000, us % 1000)
+
+
+def decode_frame(elf, payload, freq):
+    desc = payload[0]
+    entry_type = desc & DESC_TYPE_MSK
+    severity = (desc >> DESC_SEVERITY_POS) & DESC_SEVERITY_MSK
+    timestamp, module_addr = struct.unpack_from('<II', payload, 1)
+    offset = 9
+    lines = []
+
+    if desc & DESC_DROPPED_MSK:
+        dropped, = struct.unpack_from('<H', payload, offset)
+        offset += 2
+        lines.append('Logs dropped (%d)\r\n' % dropped)
+
+    module = elf.string(module_addr) or ('<0x%08x>' % module_addr)
+    prefix = ''
+    if severity != SEVERITY_INFO_RAW:
+        name = SEVERITY_NAMES[severity] if severity < len(SEVERITY_NAMES) else None
+        prefix = timestamp_str(timestamp, freq) + '<%s> %s: ' % (name, module)
+
+    if entry_type == HEADER_TYPE_STD:
+        fmt_addr, nargs = struct.unpack_from('<IB', payload, offset)
+        offset += 5
+        fmt = elf.string(fmt_addr)
+        if fmt is None:
+            fmt = '<unknown string 0x%08x>' % fmt_addr
+        str_args = set()
+        index = 0
+        for m in CONVERSION.finditer(fmt):
+            if m.group(5) == '%':
+                continue
+            index += (m.group(2) == '*') + (m.group(3) == '*')
+            if m.group(5) == 's':
+                str_args.add(index)
+            index += 1
+        args = []
+        for i in range(nargs):
+            if i in str_args:
+                length = payload[offset]
+                args.append(payload[offset + 1:offset + 1 + length].decode('latin-1'))
+                offset += 1 + length
+            else:
+                args.append(struct.unpack_from('<I', payload, offset)[0])
+                offset += 4
+        text = format_string(fmt, args)
+        lines.append(prefix + text + ('\r\n' if severity != SEVERITY_INFO_RAW else ''))
+    elif entry_type == HEADER_TYPE_HEXDUMP:
+        data = payload[offset:]
+        for i in range(0, max(len(data), 1), HEXDUMP_BYTES_IN_LINE):
+            chunk = data[i:i + HEXDUMP_BYTES_IN_LINE]
+            hex_part = ''.join(' %02x' % b for b in chunk)
+            chr_part = ''.join(chr(b) if 0x20 <= b <= 0x7E else '.' for b in chunk)
+            lines.append(prefix + '%-*s|%-*s\r\n' % (3 * HEXDUMP_BYTES_IN_LINE, hex_part,
+                                                      HEXDUMP_BYTES_IN_LINE, chr_part))
+    return ''.join(lines)
+
+
+def frames(stream):
+    """Yield frame payloads from a byte stream, resynchronizing on errors."""
+    buf = bytearray()
+    eof = False
+    while not eof or buf:
+        if not eof:
+            chunk = stream.read1(256) if hasattr(stream, 'read1') else stream.read(256)
+            eof = not chunk
+            buf.extend(chunk)
+        while True:
+            start = buf.find(bytes([SYNC]))
+            if start < 0:
+                del buf[:]
+                break
+            del buf[:start]
+            if len(buf) >= 3:
+                length, = struct.unpack_from('<H', buf, 1)
+            else:
+                length = 0
+            if len(buf) < 3 or (length <= MAX_PAYLOAD_LEN and len(buf) < 3 + length + 1):
+                if eof:
+                    # Incomplete frame at the end of the input, look for another one.
+                    del buf[:1]
+                    continue
+                break
+            payload = bytes(buf[3:3 + length])
+            checksum = 0
+            for b in payload:
+                checksum ^= b
+            if MIN_PAYLOAD_LEN <= length <= MAX_PAYLOAD_LEN and checksum == buf[3 + length]:
+                del buf[:3 + length + 1]
+                yield payload
+            else:
+                del buf[:1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode nrf_log dictionary frames.')
+    parser.add_argument('elf', help='ELF file of the application')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='serial port or capture file (default: stdin)')
+    parser.add_argument('--freq', type=int, default=None,
+                        help='timestamp frequency in Hz; raw timestamps are printed if omitted')
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    stream = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb', buffering=0)
+    try:
+        for payload in frames(stream):
+            sys.stdout.write(decode_frame(elf, payload, args.freq))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if stream is not sys.stdin.buffer:
+            stream.close()
+
+
+if __name__ == '__main__':
+    main()
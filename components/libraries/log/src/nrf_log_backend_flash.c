@@ -47,6 +47,7 @@
 #include "nrf_queue.h"
 #include "app_error.h"
 #include <stdbool.h>
+#include <string.h>
 
 #if (NRF_LOG_BACKEND_FLASHLOG_ENABLED == 0) && (NRF_LOG_BACKEND_CRASHLOG_ENABLED == 0)
 #error "No flash backend enabled."
@@ -99,6 +100,60 @@ STATIC_ASSERT(NRF_LOG_BACKEND_FLASH_SER_BUFFER_SIZE >= STD_LOG_MSG_MAX_LEN);
 #define RUNTIME_START_ADDR ((NRF_LOG_BACKEND_FLASH_START_PAGE == 0) ? \
                (CODE_PAGE_SIZE*CEIL_DIV((uint32_t)CODE_END, CODE_PAGE_SIZE)) : FLASH_LOG_START_ADDR)
 #endif
+
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+/*
+ * Compact mode layout
+ *
+ * The area is used as a circular sequence of pages. Each used page starts with
+ * @ref compact_page_hdr_t, which is written together with the first entry of the page. The page
+ * header holds the sequence number of the page and the sequence number and timestamp of its first
+ * entry, so readers can find the page holding a given entry or time by reading page headers only.
+ * When the newest page is full, the next page (the oldest one) is erased and reused.
+ *
+ * Entries follow the page header, each padded to a word boundary:
+ * - length of the entry in bytes, 0xFF marks the end of data in the page,
+ * - descriptor: hexdump flag, severity and number of arguments,
+ * - module ID, timestamp relative to the page header and string ID (format string address) or
+ *   hexdump length, encoded as variable-length integers (7 bits per byte),
+ * - arguments as variable-length integers or raw hexdump data.
+ * The sequence number of an entry is implied by its position in the page.
+ */
+
+/** @brief Page header magic value. */
+#define COMPACT_PAGE_MAGIC          0x474C4643UL
+
+/** @brief Compact page header. */
+typedef struct
+{
+    uint32_t magic;           /**< @ref COMPACT_PAGE_MAGIC. */
+    uint32_t page_seq;        /**< Sequence number of the page, incremented for every page used. */
+    uint32_t first_seq;       /**< Sequence number of the first entry in the page. */
+    uint32_t first_timestamp; /**< Timestamp of the first entry in the page. */
+} compact_page_hdr_t;
+
+/** @brief Maximum length of an encoded entry. */
+#define COMPACT_ENTRY_MAX_LEN       252
+
+/** @brief Length byte value of erased flash, marks the end of data in a page. */
+#define COMPACT_ENTRY_END           0xFF
+
+/** @brief Descriptor flag for hexdump entries. */
+#define COMPACT_DESC_HEXDUMP        0x80
+
+/** @brief Worst case length of fixed entry fields (length, descriptor, module ID, timestamp, string ID or hexdump length). */
+#define COMPACT_ENTRY_FIXED_MAX_LEN (2 + 3 + 5 + 4)
+
+/** @brief Maximum hexdump data which can be stored in an entry. */
+#define COMPACT_HEXDUMP_MAX_LEN     (COMPACT_ENTRY_MAX_LEN - COMPACT_ENTRY_FIXED_MAX_LEN)
+
+/** @brief Value indicating that no page is in use. */
+#define COMPACT_PAGE_NONE           UINT32_MAX
+
+STATIC_ASSERT(NRF_LOG_BACKEND_PAGES >= 2);
+STATIC_ASSERT(CODE_PAGE_SIZE <= (1UL << 16));
+#endif // NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+
 static void fstorage_evt_handler(nrf_fstorage_evt_t * p_evt);
 
 /** @brief Message queue for run time flash log. */
@@ -149,6 +204,18 @@ static uint32_t                  m_curr_addr;                  /**< Address of f
 static size_t                    m_curr_len;                   /**< Length of current message being written. */
 static uint32_t                  m_dropped;                    /**< Number of dropped messages. */
 
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+static uint32_t m_compact_buf[CEIL_DIV(sizeof(compact_page_hdr_t) + COMPACT_ENTRY_MAX_LEN,
+                                       sizeof(uint32_t))];  /**< Buffer with the encoded entry (and page header). */
+static uint32_t m_read_buf[LOG_HEADER_LEN_WORDS +
+                           CEIL_DIV(COMPACT_HEXDUMP_MAX_LEN, sizeof(uint32_t))]; /**< Buffer for decoded entries. */
+static uint32_t m_page_idx;       /**< Index of the page currently written, @ref COMPACT_PAGE_NONE if the area is empty. */
+static uint32_t m_page_seq;       /**< Sequence number of the page currently written. */
+static uint32_t m_page_first_ts;  /**< Timestamp of the first entry in the page currently written. */
+static bool     m_page_hdr_pending; /**< True if the page header is written with the next entry. */
+static uint32_t m_entry_seq;      /**< Sequence number of the next entry. */
+#endif
+
 /** @brief Log message string injected when entering panic mode. */
 static const char crashlog_str[] =  "-----------CRASHLOG------------\r\n";
 
@@ -216,6 +283,7 @@ static bool msg_to_buf(nrf_log_entry_t * p_msg, uint8_t * p_buf, size_t * p_len)
     }
 }
 
+#if !NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
 /**
  * @brief Function for getting logger message stored in flash.
  *
@@ -255,6 +323,397 @@ static bool msg_from_buf(uint32_t *           p_buf,
     *p_len = LOG_HEADER_LEN + data_len;
     return true;
 }
+#endif
+
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+/**
+ * @brief Function for encoding a value as a variable-length integer.
+ *
+ * @param[out] p_buf Output buffer.
+ * @param[in]  value Value to encode.
+ *
+ * @return Pointer to the byte following the encoded value.
+ */
+static uint8_t * varint_put(uint8_t * p_buf, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *p_buf++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p_buf++ = (uint8_t)value;
+    return p_buf;
+}
+
+/**
+ * @brief Function for decoding a variable-length integer.
+ *
+ * @param[in, out] pp_buf Pointer to the encoded value, moved past it.
+ *
+ * @return Decoded value.
+ */
+static uint32_t varint_get(uint8_t const * * pp_buf)
+{
+    uint32_t value = 0;
+    uint32_t shift = 0;
+    uint8_t  byte;
+
+    do
+    {
+        byte   = *(*pp_buf)++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && (shift < 32));
+
+    return value;
+}
+
+/** @brief Function for getting the address of a page in the flash log area. */
+static uint32_t page_addr_get(uint32_t idx)
+{
+    return RUNTIME_START_ADDR + idx * CODE_PAGE_SIZE;
+}
+
+/**
+ * @brief Function for getting the header of a page.
+ *
+ * @return Pointer to the header or NULL if the page is not in use.
+ */
+static compact_page_hdr_t const * page_hdr_get(uint32_t idx)
+{
+    compact_page_hdr_t const * p_hdr = (compact_page_hdr_t const *)page_addr_get(idx);
+    return (p_hdr->magic == COMPACT_PAGE_MAGIC) ? p_hdr : NULL;
+}
+
+/**
+ * @brief Function for getting the page preceding a page in the log.
+ *
+ * @return Index of the previous page or @ref COMPACT_PAGE_NONE if the page is the oldest one.
+ */
+static uint32_t page_prev_get(uint32_t idx)
+{
+    uint32_t                   prev   = (idx + NRF_LOG_BACKEND_PAGES - 1) % NRF_LOG_BACKEND_PAGES;
+    compact_page_hdr_t const * p_hdr  = page_hdr_get(idx);
+    compact_page_hdr_t const * p_prev = page_hdr_get(prev);
+
+    return (p_hdr && p_prev && (p_prev->page_seq + 1 == p_hdr->page_seq)) ? prev : COMPACT_PAGE_NONE;
+}
+
+/**
+ * @brief Function for getting the page following a page in the log.
+ *
+ * @return Index of the next page or @ref COMPACT_PAGE_NONE if the page is the newest one.
+ */
+static uint32_t page_next_get(uint32_t idx)
+{
+    uint32_t                   next   = (idx + 1) % NRF_LOG_BACKEND_PAGES;
+    compact_page_hdr_t const * p_hdr  = page_hdr_get(idx);
+    compact_page_hdr_t const * p_next = page_hdr_get(next);
+
+    return (p_hdr && p_next && (p_hdr->page_seq + 1 == p_next->page_seq)) ? next : COMPACT_PAGE_NONE;
+}
+
+/** @brief Function for getting the newest page which holds entries. */
+static uint32_t page_newest_get(void)
+{
+    if (m_page_idx == COMPACT_PAGE_NONE)
+    {
+        return COMPACT_PAGE_NONE;
+    }
+    if (page_hdr_get(m_page_idx))
+    {
+        return m_page_idx;
+    }
+    /* The current page was just erased and its header is not written yet. */
+    uint32_t prev = (m_page_idx + NRF_LOG_BACKEND_PAGES - 1) % NRF_LOG_BACKEND_PAGES;
+    return page_hdr_get(prev) ? prev : COMPACT_PAGE_NONE;
+}
+
+/** @brief Function for getting the oldest page which holds entries. */
+static uint32_t page_oldest_get(void)
+{
+    uint32_t idx = page_newest_get();
+    uint32_t prev;
+
+    if (idx == COMPACT_PAGE_NONE)
+    {
+        return COMPACT_PAGE_NONE;
+    }
+    while ((prev = page_prev_get(idx)) != COMPACT_PAGE_NONE)
+    {
+        idx = prev;
+    }
+    return idx;
+}
+
+/**
+ * @brief Function for getting the length of an entry stored in a page.
+ *
+ * @param p_page Pointer to the page.
+ * @param offset Offset of the entry in the page.
+ *
+ * @return Length of the entry or 0 if there is no valid entry at the offset.
+ */
+static uint32_t entry_len_get(uint8_t const * p_page, uint32_t offset)
+{
+    if (offset >= CODE_PAGE_SIZE)
+    {
+        return 0;
+    }
+
+    uint32_t len = p_page[offset];
+    if ((len == COMPACT_ENTRY_END) || (len < sizeof(uint32_t)) || (len % sizeof(uint32_t)) ||
+        (offset + len > CODE_PAGE_SIZE))
+    {
+        return 0;
+    }
+    return len;
+}
+
+/**
+ * @brief Function for encoding a logger message.
+ *
+ * @param[in]  p_header Logger message header.
+ * @param[in]  p_data   Arguments or hexdump data.
+ * @param[in]  base_ts  Timestamp of the first entry in the page.
+ * @param[out] p_out    Output buffer of at least @ref COMPACT_ENTRY_MAX_LEN bytes.
+ *
+ * @return Length of the encoded entry.
+ */
+static uint32_t compact_entry_encode(nrf_log_header_t const * p_header,
+                                     uint8_t const *          p_data,
+                                     uint32_t                 base_ts,
+                                     uint8_t *                p_out)
+{
+    uint8_t * p_buf = &p_out[2];
+    uint8_t   desc;
+
+    p_buf = varint_put(p_buf, p_header->module_id);
+    p_buf = varint_put(p_buf, p_header->timestamp - base_ts);
+
+    if (p_header->base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        uint32_t len = MIN(p_header->base.hexdump.len, COMPACT_HEXDUMP_MAX_LEN);
+        len  = MIN(len, FLASH_LOG_MAX_PAYLOAD_SIZE);
+        desc = COMPACT_DESC_HEXDUMP | (uint8_t)(p_header->base.hexdump.severity << 4);
+
+        p_buf = varint_put(p_buf, len);
+        memcpy(p_buf, p_data, len);
+        p_buf += len;
+    }
+    else
+    {
+        desc = (uint8_t)((p_header->base.std.severity << 4) | p_header->base.std.nargs);
+
+        p_buf = varint_put(p_buf, p_header->base.std.addr);
+        for (uint32_t i = 0; i < p_header->base.std.nargs; i++)
+        {
+            uint32_t arg;
+            memcpy(&arg, &p_data[i * sizeof(uint32_t)], sizeof(arg));
+            p_buf = varint_put(p_buf, arg);
+        }
+    }
+
+    uint32_t len = (uint32_t)(p_buf - p_out);
+    uint32_t padded_len = CEIL_DIV(len, sizeof(uint32_t)) * sizeof(uint32_t);
+
+    memset(p_buf, 0, padded_len - len);
+    p_out[0] = (uint8_t)padded_len;
+    p_out[1] = desc;
+
+    return padded_len;
+}
+
+/**
+ * @brief Function for decoding an entry stored in flash.
+ *
+ * @param[in]  p_entry  Pointer to the entry.
+ * @param[in]  base_ts  Timestamp of the first entry in the page.
+ * @param[out] p_header Decoded logger message header.
+ * @param[out] p_data   Decoded arguments or hexdump data.
+ *
+ * @return True if the entry is valid, false otherwise.
+ */
+static bool compact_entry_decode(uint8_t const *    p_entry,
+                                 uint32_t           base_ts,
+                                 nrf_log_header_t * p_header,
+                                 uint8_t *          p_data)
+{
+    uint8_t const * p_buf = &p_entry[2];
+    uint8_t const * p_end = &p_entry[p_entry[0]];
+    uint8_t         desc  = p_entry[1];
+
+    memset(p_header, 0, sizeof(nrf_log_header_t));
+    p_header->module_id = (uint16_t)varint_get(&p_buf);
+    p_header->timestamp = base_ts + varint_get(&p_buf);
+
+    if (desc & COMPACT_DESC_HEXDUMP)
+    {
+        uint32_t len = varint_get(&p_buf);
+        if ((len > COMPACT_HEXDUMP_MAX_LEN) || (p_buf + len > p_end))
+        {
+            return false;
+        }
+        p_header->base.hexdump.type     = HEADER_TYPE_HEXDUMP;
+        p_header->base.hexdump.severity = (desc >> 4) & 0x7;
+        p_header->base.hexdump.len      = len;
+        memcpy(p_data, p_buf, len);
+    }
+    else
+    {
+        uint32_t nargs = desc & 0x0F;
+        if (nargs > NRF_LOG_MAX_NUM_OF_ARGS)
+        {
+            return false;
+        }
+        p_header->base.std.type     = HEADER_TYPE_STD;
+        p_header->base.std.severity = (desc >> 4) & 0x7;
+        p_header->base.std.nargs    = nargs;
+        p_header->base.std.addr     = varint_get(&p_buf);
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            uint32_t arg = varint_get(&p_buf);
+            memcpy(&p_data[i * sizeof(uint32_t)], &arg, sizeof(arg));
+        }
+    }
+
+    return (p_buf <= p_end);
+}
+
+/**
+ * @brief Function for moving writing to the next page.
+ *
+ * The page is erased if needed. Since fstorage executes operations in order, the page header and
+ * the entry can be written right after the erase is requested.
+ *
+ * @return True on success, false if the erase could not be scheduled.
+ */
+static bool compact_page_advance(void)
+{
+    uint32_t idx = (m_page_idx == COMPACT_PAGE_NONE) ? 0 : (m_page_idx + 1) % NRF_LOG_BACKEND_PAGES;
+
+    if (*(uint32_t const *)page_addr_get(idx) != UINT32_MAX)
+    {
+        if (nrf_fstorage_erase(&m_log_flash_fstorage, page_addr_get(idx), 1, NULL) != NRF_SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    m_page_seq         = (m_page_idx == COMPACT_PAGE_NONE) ? 0 : m_page_seq + 1;
+    m_page_idx         = idx;
+    m_curr_addr        = page_addr_get(idx);
+    m_page_hdr_pending = true;
+
+    return true;
+}
+
+/**
+ * @brief Function for preparing a serialized logger message for writing in compact mode.
+ *
+ * @param[in]  p_raw Message serialized by @ref msg_to_buf.
+ * @param[out] p_len Length of data to write at @ref m_curr_addr.
+ *
+ * @return Pointer to data to write or NULL if the message must be dropped.
+ */
+static uint32_t * compact_msg_prepare(uint32_t const * p_raw, size_t * p_len)
+{
+    nrf_log_header_t const * p_header = (nrf_log_header_t const *)p_raw;
+    uint8_t const *          p_data   = (uint8_t const *)&p_raw[LOG_HEADER_LEN_WORDS];
+    uint8_t *                p_entry  = (uint8_t *)m_compact_buf + sizeof(compact_page_hdr_t);
+    uint32_t                 len;
+
+    if (m_page_idx == COMPACT_PAGE_NONE)
+    {
+        if (!compact_page_advance())
+        {
+            return NULL;
+        }
+    }
+    else if (!m_page_hdr_pending)
+    {
+        len = compact_entry_encode(p_header, p_data, m_page_first_ts, p_entry);
+        if (m_curr_addr + len <= page_addr_get(m_page_idx) + CODE_PAGE_SIZE)
+        {
+            *p_len = len;
+            return (uint32_t *)p_entry;
+        }
+        if (!compact_page_advance())
+        {
+            return NULL;
+        }
+    }
+
+    /* First entry in the page, written together with the page header. */
+    compact_page_hdr_t * p_hdr = (compact_page_hdr_t *)m_compact_buf;
+
+    m_page_first_ts        = p_header->timestamp;
+    p_hdr->magic           = COMPACT_PAGE_MAGIC;
+    p_hdr->page_seq        = m_page_seq;
+    p_hdr->first_seq       = m_entry_seq;
+    p_hdr->first_timestamp = m_page_first_ts;
+
+    len    = compact_entry_encode(p_header, p_data, m_page_first_ts, p_entry);
+    *p_len = sizeof(compact_page_hdr_t) + len;
+    return m_compact_buf;
+}
+
+/**
+ * @brief Function for restoring the writing position from the page headers stored in flash.
+ */
+static void compact_state_restore(void)
+{
+    m_page_idx         = COMPACT_PAGE_NONE;
+    m_page_seq         = 0;
+    m_page_hdr_pending = false;
+    m_entry_seq        = 0;
+
+    for (uint32_t i = 0; i < NRF_LOG_BACKEND_PAGES; i++)
+    {
+        compact_page_hdr_t const * p_hdr = page_hdr_get(i);
+        if (p_hdr && ((m_page_idx == COMPACT_PAGE_NONE) || ((int32_t)(p_hdr->page_seq - m_page_seq) > 0)))
+        {
+            m_page_idx = i;
+            m_page_seq = p_hdr->page_seq;
+        }
+    }
+
+    if (m_page_idx == COMPACT_PAGE_NONE)
+    {
+        m_curr_addr = RUNTIME_START_ADDR;
+        return;
+    }
+
+    compact_page_hdr_t const * p_hdr    = page_hdr_get(m_page_idx);
+    uint8_t const *            p_page   = (uint8_t const *)p_hdr;
+    uint32_t                   offset   = sizeof(compact_page_hdr_t);
+    uint32_t                   count    = 0;
+    uint32_t                   len;
+
+    while ((len = entry_len_get(p_page, offset)) != 0)
+    {
+        offset += len;
+        count++;
+    }
+
+    m_curr_addr     = page_addr_get(m_page_idx) + offset;
+    m_page_first_ts = p_hdr->first_timestamp;
+    m_entry_seq     = p_hdr->first_seq + count;
+}
+#endif // NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+
+/**
+ * @brief Function for updating the write position after data was written to flash.
+ */
+static void write_done(void)
+{
+    m_curr_addr += m_curr_len;
+    m_curr_len   = 0;
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    m_page_hdr_pending = false;
+    m_entry_seq++;
+#endif
+}
 
 /**
  * @brief Function for processing log message queue.
@@ -276,6 +735,7 @@ static void log_msg_queue_process(nrf_queue_t const * p_queue, bool fstorage_blo
     while (nrf_queue_pop(p_queue, &p_msg) == NRF_SUCCESS)
     {
         ret_code_t err_code;
+        uint32_t * p_buf = m_flash_buf;
 
         m_curr_len = sizeof(m_flash_buf);
         if (!msg_to_buf(p_msg, (uint8_t *)m_flash_buf, &m_curr_len))
@@ -284,13 +744,24 @@ static void log_msg_queue_process(nrf_queue_t const * p_queue, bool fstorage_blo
             continue;
         }
 
-        err_code = nrf_fstorage_write(&m_log_flash_fstorage, m_curr_addr, m_flash_buf, m_curr_len, p_msg);
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+        p_buf = compact_msg_prepare(m_flash_buf, &m_curr_len);
+        if (p_buf == NULL)
+        {
+            // Page erase could not be scheduled. Drop entry.
+            nrf_memobj_put(p_msg);
+            m_dropped++;
+            continue;
+        }
+#endif
+
+        err_code = nrf_fstorage_write(&m_log_flash_fstorage, m_curr_addr, p_buf, m_curr_len, p_msg);
 
         if (err_code == NRF_SUCCESS)
         {
             if (fstorage_blocking)
             {
-                m_curr_addr += m_curr_len;
+                write_done();
 
                 nrf_memobj_put(p_msg);
             }
@@ -345,8 +816,7 @@ static void fstorage_evt_handler(nrf_fstorage_evt_t * p_evt)
             {
                 if (p_evt->result == NRF_SUCCESS)
                 {
-                    m_curr_addr += m_curr_len;
-                    m_curr_len = 0;
+                    write_done();
                     log_msg_queue_process(mp_flashlog_queue, false);
                 }
                 else
@@ -470,8 +940,17 @@ static void crashlog_marker_inject(void)
     m_flash_buf[0] = crashlog_marker_hdr.base.raw;
     m_flash_buf[1] = crashlog_marker_hdr.module_id;
     m_flash_buf[2] = crashlog_marker_hdr.timestamp;
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    uint32_t * p_buf = compact_msg_prepare(m_flash_buf, &m_curr_len);
+    if ((p_buf != NULL) &&
+        (nrf_fstorage_write(&m_log_flash_fstorage, m_curr_addr, p_buf, m_curr_len, NULL) == NRF_SUCCESS))
+    {
+        write_done();
+    }
+#else
     (void)nrf_fstorage_write(&m_log_flash_fstorage, m_curr_addr, m_flash_buf, LOG_HEADER_LEN, NULL);
     m_curr_addr += LOG_HEADER_LEN;
+#endif
 }
 
 
@@ -496,6 +975,7 @@ void nrf_log_backend_crashlog_panic_set(nrf_log_backend_t const * p_backend)
     }
 }
 
+#if !NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
 /**
  * @brief Function for determining first empty location in area dedicated for flash logger backend.
  */
@@ -512,6 +992,7 @@ static uint32_t empty_addr_get(void)
 
     return token;
 }
+#endif
 
 
 ret_code_t nrf_log_backend_flash_init(nrf_fstorage_api_t const * p_fs_api)
@@ -531,13 +1012,174 @@ ret_code_t nrf_log_backend_flash_init(nrf_fstorage_api_t const * p_fs_api)
         return err_code;
     }
 
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    if (nrf_fstorage_rmap(&m_log_flash_fstorage, start_addr) == NULL)
+    {
+        //Compact mode needs to read page headers.
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    compact_state_restore();
+#else
     m_curr_addr = empty_addr_get();
+#endif
     m_state  = LOG_BACKEND_FLASH_ACTIVE;
 
     return err_code;
 }
 
 
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+ret_code_t nrf_log_backend_flash_next_entry_get(uint32_t *                p_token,
+                                                nrf_log_header_t * *      pp_header,
+                                                uint8_t * *               pp_data)
+{
+    uint32_t addr = *p_token;
+
+    if (nrf_fstorage_rmap(&m_log_flash_fstorage, RUNTIME_START_ADDR) == NULL)
+    {
+        //Supports only memories which can be mapped for reading.
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (addr == 0)
+    {
+        uint32_t idx = page_oldest_get();
+        if (idx == COMPACT_PAGE_NONE)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+        addr = page_addr_get(idx) + sizeof(compact_page_hdr_t);
+    }
+
+    for (;;)
+    {
+        /* Entries never start at offset 0 (page header), so a page aligned token is used for
+         * the end of the preceding page. */
+        uint32_t rel    = addr - RUNTIME_START_ADDR;
+        uint32_t idx    = rel / CODE_PAGE_SIZE;
+        uint32_t offset = rel % CODE_PAGE_SIZE;
+
+        if (offset == 0)
+        {
+            idx    = (idx + NRF_LOG_BACKEND_PAGES - 1) % NRF_LOG_BACKEND_PAGES;
+            offset = CODE_PAGE_SIZE;
+        }
+
+        compact_page_hdr_t const * p_hdr = page_hdr_get(idx);
+        if (p_hdr == NULL)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+
+        uint8_t const * p_page = (uint8_t const *)p_hdr;
+        uint32_t        len    = entry_len_get(p_page, offset);
+        if (len != 0)
+        {
+            nrf_log_header_t * p_header = (nrf_log_header_t *)m_read_buf;
+            uint8_t *          p_data   = (uint8_t *)&m_read_buf[LOG_HEADER_LEN_WORDS];
+
+            if (!compact_entry_decode(&p_page[offset], p_hdr->first_timestamp, p_header, p_data))
+            {
+                return NRF_ERROR_NOT_FOUND;
+            }
+            *pp_header = p_header;
+            *pp_data   = p_data;
+            *p_token   = page_addr_get(idx) + offset + len;
+            return NRF_SUCCESS;
+        }
+
+        idx = page_next_get(idx);
+        if (idx == COMPACT_PAGE_NONE)
+        {
+            return NRF_ERROR_NOT_FOUND;
+        }
+        addr = page_addr_get(idx) + sizeof(compact_page_hdr_t);
+    }
+}
+
+
+ret_code_t nrf_log_backend_flash_last_entries_token_get(uint32_t count, uint32_t * p_token)
+{
+    uint32_t idx = page_newest_get();
+    uint32_t prev;
+
+    if (idx == COMPACT_PAGE_NONE)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    /* Walk back over page headers to the page holding the first requested entry. */
+    compact_page_hdr_t const * p_hdr  = page_hdr_get(idx);
+    uint32_t                   target = m_entry_seq - MIN(count, (uint32_t)INT32_MAX);
+
+    while ((int32_t)(p_hdr->first_seq - target) > 0)
+    {
+        prev = page_prev_get(idx);
+        if (prev == COMPACT_PAGE_NONE)
+        {
+            target = p_hdr->first_seq;
+            break;
+        }
+        idx   = prev;
+        p_hdr = page_hdr_get(idx);
+    }
+
+    uint8_t const * p_page = (uint8_t const *)p_hdr;
+    uint32_t        offset = sizeof(compact_page_hdr_t);
+    uint32_t        len;
+
+    for (uint32_t skip = target - p_hdr->first_seq;
+         (skip > 0) && ((len = entry_len_get(p_page, offset)) != 0);
+         skip--)
+    {
+        offset += len;
+    }
+
+    *p_token = page_addr_get(idx) + offset;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t nrf_log_backend_flash_since_token_get(uint32_t timestamp, uint32_t * p_token)
+{
+    uint32_t idx = page_newest_get();
+    uint32_t prev;
+
+    if (idx == COMPACT_PAGE_NONE)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    /* Walk back over page headers to the last page which starts before the timestamp. */
+    compact_page_hdr_t const * p_hdr = page_hdr_get(idx);
+
+    while ((p_hdr->first_timestamp > timestamp) && ((prev = page_prev_get(idx)) != COMPACT_PAGE_NONE))
+    {
+        idx   = prev;
+        p_hdr = page_hdr_get(idx);
+    }
+
+    uint8_t const * p_page = (uint8_t const *)p_hdr;
+    uint32_t        offset = sizeof(compact_page_hdr_t);
+    uint32_t        len;
+
+    while ((len = entry_len_get(p_page, offset)) != 0)
+    {
+        uint8_t const * p_buf = &p_page[offset + 2];
+
+        UNUSED_RETURN_VALUE(varint_get(&p_buf)); // Module ID.
+        if (p_hdr->first_timestamp + varint_get(&p_buf) >= timestamp)
+        {
+            break;
+        }
+        offset += len;
+    }
+
+    *p_token = page_addr_get(idx) + offset;
+    return NRF_SUCCESS;
+}
+
+#else
 ret_code_t nrf_log_backend_flash_next_entry_get(uint32_t *                p_token,
                                                 nrf_log_header_t * *      pp_header,
                                                 uint8_t * *               pp_data)
@@ -563,6 +1205,7 @@ ret_code_t nrf_log_backend_flash_next_entry_get(uint32_t *                p_toke
         return NRF_ERROR_NOT_FOUND;
     }
 }
+#endif // NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
 
 
 ret_code_t nrf_log_backend_flash_erase(void)
@@ -573,6 +1216,12 @@ ret_code_t nrf_log_backend_flash_erase(void)
     err_code = nrf_fstorage_erase(&m_log_flash_fstorage, RUNTIME_START_ADDR, NRF_LOG_BACKEND_PAGES, NULL);
     
     m_curr_addr = RUNTIME_START_ADDR;
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    m_page_idx         = COMPACT_PAGE_NONE;
+    m_page_seq         = 0;
+    m_page_hdr_pending = false;
+    m_entry_seq        = 0;
+#endif
 
     return err_code;
 }
@@ -595,6 +1244,7 @@ const nrf_log_backend_api_t nrf_log_backend_crashlog_api = {
 
 #if NRF_LOG_BACKEND_FLASH_CLI_CMDS
 #include "nrf_cli.h"
+#include <stdlib.h>
 
 static uint8_t m_buffer[64];
 static nrf_cli_t const * mp_cli;
@@ -673,14 +1323,8 @@ static void entry_process(nrf_cli_t const * p_cli, nrf_log_header_t * p_header,
 }
 
 
-static void flashlog_read_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+static void entries_print(nrf_cli_t const * p_cli, uint32_t token)
 {
-    if (nrf_cli_help_requested(p_cli))
-    {
-        nrf_cli_help_print(p_cli, NULL, 0);
-    }
-
-    uint32_t           token  = 0;
     uint8_t *          p_data = NULL;
     bool               empty  = true;
     nrf_log_header_t * p_header;
@@ -705,6 +1349,60 @@ static void flashlog_read_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv
 }
 
 
+static void flashlog_read_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+    }
+
+    entries_print(p_cli, 0);
+}
+
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+static void flashlog_tail_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    uint32_t token;
+
+    if (nrf_cli_help_requested(p_cli) || (argc != 2))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    if (nrf_log_backend_flash_last_entries_token_get(strtoul(argv[1], NULL, 0), &token) == NRF_SUCCESS)
+    {
+        entries_print(p_cli, token);
+    }
+    else
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Flash log empty\r\n");
+    }
+}
+
+
+static void flashlog_since_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv)
+{
+    uint32_t token;
+
+    if (nrf_cli_help_requested(p_cli) || (argc != 2))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+    if (nrf_log_backend_flash_since_token_get(strtoul(argv[1], NULL, 0), &token) == NRF_SUCCESS)
+    {
+        entries_print(p_cli, token);
+    }
+    else
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Flash log empty\r\n");
+    }
+}
+#endif
+
+
 static void flashlog_status_cmd(nrf_cli_t const * p_cli, size_t argc, char ** argv)
 {
     if (nrf_cli_help_requested(p_cli))
@@ -715,10 +1413,28 @@ static void flashlog_status_cmd(nrf_cli_t const * p_cli, size_t argc, char ** ar
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "Flash log status:\r\n");
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Location (address: 0x%08X, length: %d)\r\n",
                                                                 RUNTIME_START_ADDR, FLASH_LOG_SIZE);
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    uint32_t oldest = page_oldest_get();
+    if (oldest == COMPACT_PAGE_NONE)
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Empty\r\n");
+    }
+    else
+    {
+        uint32_t first_seq = page_hdr_get(oldest)->first_seq;
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Current page: %d (%d of %d bytes used)\r\n",
+                                               m_page_idx,
+                                               m_curr_addr - page_addr_get(m_page_idx),
+                                               CODE_PAGE_SIZE);
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Stored entries: %d (sequence numbers %d to %d)\r\n",
+                                               m_entry_seq - first_seq, first_seq, m_entry_seq - 1);
+    }
+#else
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Current usage:%d%% (%d of %d bytes used)\r\n",
                                        100ul * (m_curr_addr - RUNTIME_START_ADDR)/FLASH_LOG_SIZE,
                                        m_curr_addr - RUNTIME_START_ADDR,
                                        FLASH_LOG_SIZE);
+#endif
     nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "\t\t- Dropped logs: %d\r\n", m_dropped);
 
 
@@ -730,6 +1446,10 @@ NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_flashlog_cmd)
     NRF_CLI_CMD(clear,   NULL, "Remove logs",      flashlog_clear_cmd),
     NRF_CLI_CMD(read,    NULL, "Read stored logs", flashlog_read_cmd),
     NRF_CLI_CMD(status,  NULL, "Flash log status", flashlog_status_cmd),
+#if NRF_LOG_BACKEND_FLASH_COMPACT_ENABLED
+    NRF_CLI_CMD(tail,    NULL, "Read last <count> logs", flashlog_tail_cmd),
+    NRF_CLI_CMD(since,   NULL, "Read logs since <timestamp>", flashlog_since_cmd),
+#endif
     NRF_CLI_SUBCMD_SET_END
 };
 
@@ -42,6 +42,254 @@
 #include "nrf_log_backend_serial.h"
 #include "nrf_log_str_formatter.h"
 #include "nrf_log_internal.h"
+#if NRF_LOG_DICTIONARY_ENABLED
+#include "nrf_log_ctrl.h"
+#include <string.h>
+
+#define DICT_DESC_TYPE_Pos      0       /**< Position of the entry type in the descriptor. */
+#define DICT_DESC_SEVERITY_Pos  2       /**< Position of the severity in the descriptor. */
+#define DICT_DESC_DROPPED_Msk   (1 << 5)/**< Set when the dropped counter follows the module name. */
+
+#define DICT_STR_MAX_LEN        UINT8_MAX /**< Maximum length of an inlined string argument. */
+
+/**@brief Output context of a dictionary frame. */
+typedef struct
+{
+    uint8_t *          p_buffer;    /**< Temporary buffer. */
+    uint32_t           length;      /**< Size of the temporary buffer. */
+    uint32_t           cnt;         /**< Number of bytes in the temporary buffer. */
+    uint8_t            checksum;    /**< XOR of all payload bytes written so far. */
+    nrf_fprintf_fwrite tx_func;     /**< Function for sending the buffer. */
+} dict_ctx_t;
+
+static void dict_flush(dict_ctx_t * p_ctx)
+{
+    if (p_ctx->cnt > 0)
+    {
+        p_ctx->tx_func(NULL, (char const *)p_ctx->p_buffer, p_ctx->cnt);
+        p_ctx->cnt = 0;
+    }
+}
+
+static void dict_write(dict_ctx_t * p_ctx, void const * p_data, uint32_t len)
+{
+    uint8_t const * p_byte = p_data;
+
+    while (len--)
+    {
+        if (p_ctx->cnt == p_ctx->length)
+        {
+            dict_flush(p_ctx);
+        }
+        p_ctx->checksum ^= *p_byte;
+        p_ctx->p_buffer[p_ctx->cnt++] = *p_byte++;
+    }
+}
+
+static void dict_write_u16(dict_ctx_t * p_ctx, uint16_t value)
+{
+    uint8_t data[2];
+
+    (void)uint16_encode(value, data);
+    dict_write(p_ctx, data, sizeof(data));
+}
+
+static void dict_write_u32(dict_ctx_t * p_ctx, uint32_t value)
+{
+    uint8_t data[4];
+
+    (void)uint32_encode(value, data);
+    dict_write(p_ctx, data, sizeof(data));
+}
+
+static uint8_t dict_str_len(uint32_t addr)
+{
+    size_t len = strlen((char const *)addr);
+
+    return (uint8_t)MIN(len, DICT_STR_MAX_LEN);
+}
+
+/**@brief Function for finding which arguments of a format string are strings.
+ *
+ * @details Strings may be located in RAM (see @ref NRF_LOG_PUSH), so they cannot be resolved by
+ *          the host and are sent inline. Other arguments are sent as raw 32-bit words.
+ *
+ * @param[in] p_str  Format string.
+ * @param[in] nargs  Number of arguments.
+ *
+ * @return Bit mask with bit n set if argument n is a string.
+ */
+static uint32_t dict_str_args_get(char const * p_str, uint32_t nargs)
+{
+    uint32_t mask = 0;
+    uint32_t arg  = 0;
+
+    while ((*p_str != '\0') && (arg < nargs))
+    {
+        if (*p_str++ != '%')
+        {
+            continue;
+        }
+        if (*p_str == '%')
+        {
+            p_str++;
+            continue;
+        }
+        // Skip flags, width, precision and length modifiers.
+        while ((*p_str != '\0') && (strchr("-+ #0123456789.*hlLqjzt", *p_str) != NULL))
+        {
+            if (*p_str == '*')
+            {
+                arg++;
+            }
+            p_str++;
+        }
+        if ((*p_str == 's') && (arg < nargs))
+        {
+            mask |= (1UL << arg);
+        }
+        if (*p_str != '\0')
+        {
+            p_str++;
+        }
+        arg++;
+    }
+
+    return mask;
+}
+
+/**@brief Function for sending a log entry as a dictionary frame.
+ *
+ * @details Frame layout (multi-byte fields are little endian):
+ *          - sync (1 byte): @ref NRF_LOG_DICT_SYNC.
+ *          - length (2 bytes): number of payload bytes.
+ *          - payload:
+ *            - descriptor (1 byte): entry type, severity and dropped flag.
+ *            - timestamp (4 bytes).
+ *            - module (4 bytes): address of the module name string.
+ *            - dropped (2 bytes): only if the dropped flag is set.
+ *            - For standard entries: address of the format string (4 bytes), number of
+ *              arguments (1 byte) and the arguments. String arguments are sent as a length byte
+ *              followed by the characters, other arguments as 4 bytes.
+ *            - For hexdump entries: the data.
+ *          - checksum (1 byte): XOR of the payload bytes.
+ *
+ *          String addresses are used as identifiers, so the host can look the strings up in the
+ *          ELF file of the application.
+ */
+static void dict_entry_put(nrf_log_entry_t * p_msg,
+                           uint8_t * p_buffer,
+                           uint32_t  length,
+                           nrf_fprintf_fwrite tx_func)
+{
+    dict_ctx_t ctx = {
+            .p_buffer = p_buffer,
+            .length   = length,
+            .cnt      = 0,
+            .checksum = 0,
+            .tx_func  = tx_func
+    };
+
+    nrf_log_header_t header;
+    size_t           memobj_offset = HEADER_SIZE*sizeof(uint32_t);
+    uint32_t         args[NRF_LOG_MAX_NUM_OF_ARGS];
+    uint32_t         nargs     = 0;
+    uint32_t         str_mask  = 0;
+    uint32_t         data_len;
+    uint8_t          desc;
+    uint8_t          sync = NRF_LOG_DICT_SYNC;
+
+    nrf_memobj_read(p_msg, &header, HEADER_SIZE*sizeof(uint32_t), 0);
+
+    desc     = (uint8_t)(header.base.generic.type << DICT_DESC_TYPE_Pos);
+    data_len = 1 + 4 + 4;
+    if (header.dropped)
+    {
+        desc     |= DICT_DESC_DROPPED_Msk;
+        data_len += 2;
+    }
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        char const * p_log_str = (char const *)((uint32_t)header.base.std.addr);
+
+        desc  |= (uint8_t)(header.base.std.severity << DICT_DESC_SEVERITY_Pos);
+        nargs  = header.base.std.nargs;
+        nrf_memobj_read(p_msg, args, nargs*sizeof(uint32_t), memobj_offset);
+
+        str_mask  = dict_str_args_get(p_log_str, nargs);
+        data_len += 4 + 1;
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            data_len += (str_mask & (1UL << i)) ?
+                        (1 + dict_str_len(args[i])) : 4;
+        }
+    }
+    else if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        desc     |= (uint8_t)(header.base.hexdump.severity << DICT_DESC_SEVERITY_Pos);
+        data_len += header.base.hexdump.len;
+    }
+    else
+    {
+        return;
+    }
+
+    dict_write(&ctx, &sync, sizeof(sync));
+    dict_write_u16(&ctx, (uint16_t)data_len);
+    ctx.checksum = 0;
+
+    dict_write(&ctx, &desc, sizeof(desc));
+    dict_write_u32(&ctx, header.timestamp);
+    dict_write_u32(&ctx, (uint32_t)nrf_log_module_name_get(header.module_id, false));
+    if (header.dropped)
+    {
+        dict_write_u16(&ctx, header.dropped);
+    }
+
+    if (header.base.generic.type == HEADER_TYPE_STD)
+    {
+        uint8_t nargs8 = (uint8_t)nargs;
+
+        dict_write_u32(&ctx, header.base.std.addr);
+        dict_write(&ctx, &nargs8, sizeof(nargs8));
+        for (uint32_t i = 0; i < nargs; i++)
+        {
+            if (str_mask & (1UL << i))
+            {
+                uint8_t str_len = dict_str_len(args[i]);
+
+                dict_write(&ctx, &str_len, sizeof(str_len));
+                dict_write(&ctx, (char const *)args[i], str_len);
+            }
+            else
+            {
+                dict_write_u32(&ctx, args[i]);
+            }
+        }
+    }
+    else
+    {
+        uint8_t  data_buf[8];
+        uint32_t chunk_len;
+
+        data_len = header.base.hexdump.len;
+        while (data_len > 0)
+        {
+            chunk_len = sizeof(data_buf) > data_len ? data_len : sizeof(data_buf);
+            nrf_memobj_read(p_msg, data_buf, chunk_len, memobj_offset);
+            memobj_offset += chunk_len;
+            data_len      -= chunk_len;
+            dict_write(&ctx, data_buf, chunk_len);
+        }
+    }
+
+    uint8_t checksum = ctx.checksum;
+
+    dict_write(&ctx, &checksum, sizeof(checksum));
+    dict_flush(&ctx);
+}
+#endif // NRF_LOG_DICTIONARY_ENABLED
 
 void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                nrf_log_entry_t * p_msg,
@@ -51,6 +299,9 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
 {
     nrf_memobj_get(p_msg);
 
+#if NRF_LOG_DICTIONARY_ENABLED
+    dict_entry_put(p_msg, p_buffer, length, tx_func);
+#else
     nrf_fprintf_ctx_t fprintf_ctx = {
             .p_io_buffer = (char *)p_buffer,
             .io_buffer_size = length,
@@ -110,6 +361,7 @@ void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                          &fprintf_ctx);
         } while (data_len > 0);
     }
+#endif // NRF_LOG_DICTIONARY_ENABLED
     nrf_memobj_put(p_msg);
     /*lint -restore*/
 }
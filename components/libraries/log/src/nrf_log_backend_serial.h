@@ -57,10 +57,14 @@
 extern "C" {
 #endif
 
+#define NRF_LOG_DICT_SYNC 0xA5 /**< First byte of every frame when @ref NRF_LOG_DICTIONARY_ENABLED is set. */
+
 /**
  * @brief A function for processing logger entry with simple serial interface as output.
  *
- *
+ * When @ref NRF_LOG_DICTIONARY_ENABLED is set, the entry is not formatted. A binary frame with
+ * the address of the format string and the raw arguments is sent instead. The frames are decoded
+ * on the host by scripts/nrf_log_dict_decoder.py, using the ELF file of the application.
  */
 void nrf_log_backend_serial_put(nrf_log_backend_t const * p_backend,
                                nrf_log_entry_t * p_msg,
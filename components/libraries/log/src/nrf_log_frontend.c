@@ -67,6 +67,10 @@ STATIC_ASSERT(IS_POWER_OF_TWO(NRF_LOG_BUFSIZE));
 #warning "NRF_LOG_BUFSIZE too small, significant number of logs may be lost."
 #endif
 
+#if NRF_LOG_RATE_LIMIT_ENABLED && !NRF_LOG_FILTERS_ENABLED
+#error "NRF_LOG_RATE_LIMIT_ENABLED requires NRF_LOG_FILTERS_ENABLED."
+#endif
+
 NRF_MEMOBJ_POOL_DEF(log_mempool, NRF_LOG_MSGPOOL_ELEMENT_SIZE, NRF_LOG_MSGPOOL_ELEMENT_COUNT);
 NRF_RINGBUF_DEF(m_log_push_ringbuf, NRF_LOG_STR_PUSH_BUFFER_SIZE);
 
@@ -102,6 +106,11 @@ typedef struct
     nrf_atomic_flag_t         log_skipping;
     nrf_atomic_flag_t         log_skipped;
     nrf_atomic_u32_t          log_dropped_cnt;
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint32_t                  timestamp_freq;  // Frequency of the timestamp, 0 if unknown
+    uint32_t                  rl_summary_ts;   // Timestamp of the last summary of suppressed logs
+    nrf_atomic_flag_t         rl_pending;      // Set when any log was suppressed since the last summary
+#endif
 } log_data_t;
 
 static log_data_t   m_log_data;
@@ -132,6 +141,13 @@ ret_code_t nrf_log_init(nrf_log_timestamp_func_t timestamp_func, uint32_t timest
         m_log_data.timestamp_func = timestamp_func;
     }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    // Rate limiting uses the timestamp function even if timestamps are not printed.
+    m_log_data.timestamp_func = timestamp_func;
+    m_log_data.timestamp_freq = (timestamp_func != NULL) ? timestamp_freq : 0;
+    m_log_data.rl_summary_ts  = (timestamp_func != NULL) ? timestamp_func() : 0;
+#endif
+
 #ifdef UNIT_TEST
     m_buffer_mask = NRF_LOG_BUF_WORDS - 1;
 #endif
@@ -178,6 +194,14 @@ ret_code_t nrf_log_init(nrf_log_timestamp_func_t timestamp_func, uint32_t timest
             nrf_log_module_filter_data_t * p_module_filter = NRF_LOG_FILTER_SECTION_VARS_GET(i);
             p_module_ddata->filter = 0;
             p_module_filter->filter_lvls = 0;
+#if NRF_LOG_RATE_LIMIT_ENABLED
+            p_module_ddata->rl_interval = 0;
+            p_module_ddata->rl_rate     = 0;
+            p_module_ddata->rl_burst    = 0;
+            p_module_ddata->sample_n    = 0;
+            p_module_ddata->sample_cnt  = 0;
+            p_module_ddata->suppressed  = 0;
+#endif
         }
     }
 
@@ -315,6 +339,137 @@ nrf_log_severity_t nrf_log_module_filter_get(uint32_t backend_id,
     }
     return severity;
 }
+
+#if NRF_LOG_RATE_LIMIT_ENABLED
+ret_code_t nrf_log_module_rate_limit_set(uint32_t module_id, uint16_t rate, uint16_t burst)
+{
+    uint32_t interval = 0;
+
+    if (module_id >= nrf_log_module_cnt_get())
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (rate != 0)
+    {
+        if ((m_log_data.timestamp_func == NULL) || (m_log_data.timestamp_freq == 0))
+        {
+            return NRF_ERROR_INVALID_STATE;
+        }
+
+        interval = m_log_data.timestamp_freq / rate;
+        if ((burst == 0) || (interval == 0) || (((uint64_t)interval * burst) > UINT32_MAX))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+    }
+
+    nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+
+    CRITICAL_REGION_ENTER();
+    p_module_data->rl_rate      = rate;
+    p_module_data->rl_burst     = burst;
+    p_module_data->rl_interval  = interval;
+    p_module_data->rl_credit    = interval * burst; // Start with a full bucket.
+    p_module_data->rl_timestamp = (interval != 0) ? m_log_data.timestamp_func() : 0;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_log_module_sampling_set(uint32_t module_id, uint16_t n)
+{
+    if (module_id >= nrf_log_module_cnt_get())
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+
+    CRITICAL_REGION_ENTER();
+    p_module_data->sample_n   = n;
+    p_module_data->sample_cnt = 0;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+/**
+ * @brief Function for checking if a log passes the sampling and the rate limit of its module.
+ *
+ * @details It is called before any space is allocated in the log buffer. Suppressed logs are
+ *          only counted, the counters are reported by @ref rate_limit_summary_process.
+ *
+ * @param severity_mid Severity and module ID of the log.
+ *
+ * @return True if the log is to be stored, false if it is suppressed.
+ */
+static bool rate_limit_pass(uint32_t severity_mid)
+{
+    uint32_t module_id = severity_mid >> NRF_LOG_MODULE_ID_POS;
+    nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+    bool pass = true;
+
+    if ((p_module_data->sample_n <= 1) && (p_module_data->rl_interval == 0))
+    {
+        return true;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (p_module_data->sample_n > 1)
+    {
+        if (++p_module_data->sample_cnt < p_module_data->sample_n)
+        {
+            pass = false;
+        }
+        else
+        {
+            p_module_data->sample_cnt = 0;
+        }
+    }
+
+    if (pass && (p_module_data->rl_interval != 0))
+    {
+        // Credit is kept in timestamp ticks. Each log costs rl_interval ticks and the bucket
+        // holds rl_burst logs. Timestamp wrap-around is seen as a long pause and refills the bucket.
+        uint32_t now      = m_log_data.timestamp_func();
+        uint32_t capacity = p_module_data->rl_interval * p_module_data->rl_burst;
+        uint32_t elapsed  = now - p_module_data->rl_timestamp;
+
+        p_module_data->rl_timestamp = now;
+        if (elapsed >= (capacity - p_module_data->rl_credit))
+        {
+            p_module_data->rl_credit = capacity;
+        }
+        else
+        {
+            p_module_data->rl_credit += elapsed;
+        }
+
+        if (p_module_data->rl_credit >= p_module_data->rl_interval)
+        {
+            p_module_data->rl_credit -= p_module_data->rl_interval;
+        }
+        else
+        {
+            pass = false;
+        }
+    }
+
+    if (!pass)
+    {
+        if (p_module_data->suppressed != UINT16_MAX)
+        {
+            p_module_data->suppressed++;
+        }
+        UNUSED_RETURN_VALUE(nrf_atomic_flag_set(&m_log_data.rl_pending));
+    }
+    CRITICAL_REGION_EXIT();
+
+    return pass;
+}
+#endif // NRF_LOG_RATE_LIMIT_ENABLED
+
 /**
  * Function examines current header and omits packets which are in progress.
  */
@@ -549,10 +704,10 @@ char const * nrf_log_push(char * const p_str)
     }
 }
 
-static inline void std_n(uint32_t           severity_mid,
-                         char const * const p_str,
-                         uint32_t const *   args,
-                         uint32_t           nargs)
+static inline void std_n_put(uint32_t           severity_mid,
+                             char const * const p_str,
+                             uint32_t const *   args,
+                             uint32_t           nargs)
 {
     uint32_t mask   = m_buffer_mask;
     uint32_t wr_idx;
@@ -589,6 +744,113 @@ static inline void std_n(uint32_t           severity_mid,
 
 }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+/**
+ * @brief Function for appending a string to the summary of suppressed logs.
+ *
+ * @return New length of the summary. The string is truncated if it does not fit.
+ */
+static size_t summary_append(char * p_buf, size_t len, size_t size, char const * p_str)
+{
+    while ((*p_str != '\0') && (len < (size - 1)))
+    {
+        p_buf[len++] = *p_str++;
+    }
+    p_buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Function for logging a single line with the numbers of logs suppressed in each module.
+ *
+ * @details The summary is logged when the summary interval has expired or, if there is no
+ *          timestamp function, when the log buffer is drained. The line itself bypasses the rate
+ *          limit of the logger module.
+ */
+static void rate_limit_summary_process(void)
+{
+    static char m_summary[NRF_LOG_STR_PUSH_BUFFER_SIZE];
+
+    if (m_log_data.rl_pending == 0)
+    {
+        return;
+    }
+
+    if (m_log_data.timestamp_freq != 0)
+    {
+        uint32_t now      = m_log_data.timestamp_func();
+        uint32_t interval = (uint32_t)(((uint64_t)NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS *
+                                        m_log_data.timestamp_freq) / 1000);
+        if ((now - m_log_data.rl_summary_ts) < interval)
+        {
+            return;
+        }
+        m_log_data.rl_summary_ts = now;
+    }
+    else if (m_log_data.rd_idx != m_log_data.wr_idx)
+    {
+        return;
+    }
+
+    // Cleared before logging, so that a nested flush in the non-deferred mode does not recurse.
+    if (nrf_atomic_flag_clear_fetch(&m_log_data.rl_pending) == 0)
+    {
+        return;
+    }
+
+    size_t   len = 0;
+    uint32_t i;
+    m_summary[0] = '\0';
+    for (i = 0; i < nrf_log_module_cnt_get(); i++)
+    {
+        nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(i);
+        uint16_t suppressed;
+
+        CRITICAL_REGION_ENTER();
+        suppressed = p_module_data->suppressed;
+        p_module_data->suppressed = 0;
+        CRITICAL_REGION_EXIT();
+
+        if (suppressed != 0)
+        {
+            char   num[6];
+            size_t pos = sizeof(num) - 1;
+            num[pos] = '\0';
+            do {
+                num[--pos] = (char)('0' + (suppressed % 10));
+                suppressed /= 10;
+            } while (suppressed != 0);
+
+            len = summary_append(m_summary, len, sizeof(m_summary), (len != 0) ? " " : "");
+            len = summary_append(m_summary, len, sizeof(m_summary), nrf_log_module_name_get(i, false));
+            len = summary_append(m_summary, len, sizeof(m_summary), "=");
+            len = summary_append(m_summary, len, sizeof(m_summary), &num[pos]);
+        }
+    }
+
+    if (len != 0)
+    {
+        uint32_t args[] = {(uint32_t)nrf_log_push(m_summary)};
+        std_n_put(LOG_SEVERITY_MOD_ID(NRF_LOG_SEVERITY_WARNING),
+                  "Suppressed logs: %s", args, ARRAY_SIZE(args));
+    }
+}
+#endif // NRF_LOG_RATE_LIMIT_ENABLED
+
+static inline void std_n(uint32_t           severity_mid,
+                         char const * const p_str,
+                         uint32_t const *   args,
+                         uint32_t           nargs)
+{
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    if (!rate_limit_pass(severity_mid))
+    {
+        return;
+    }
+#endif
+    std_n_put(severity_mid, p_str, args, nargs);
+}
+
 void nrf_log_frontend_std_0(uint32_t severity_mid, char const * const p_str)
 {
     std_n(severity_mid, p_str, NULL, 0);
@@ -670,6 +932,13 @@ void nrf_log_frontend_hexdump(uint32_t           severity_mid,
 {
     uint32_t mask   = m_buffer_mask;
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    if (!rate_limit_pass(severity_mid))
+    {
+        return;
+    }
+#endif
+
     uint32_t wr_idx;
     if (buf_prealloc(CEIL_DIV(length, sizeof(uint32_t)), &wr_idx, false))
     {
@@ -731,6 +1000,9 @@ bool buffer_is_empty(void)
 
 bool nrf_log_frontend_dequeue(void)
 {
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    rate_limit_summary_process();
+#endif
 
     if (buffer_is_empty())
     {
@@ -920,6 +1192,12 @@ bool nrf_log_frontend_dequeue(void)
         NRF_LOG_WARNING("Backends flushed");
     }
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    // Checked again once the buffer is drained, so that the caller does not go to sleep with a
+    // summary still to be logged.
+    rate_limit_summary_process();
+#endif
+
     return buffer_is_empty() ? false : true;
 }
 
@@ -1087,6 +1365,7 @@ ret_code_t nrf_log_config_load(void)
 
 #if NRF_LOG_CLI_CMDS && NRF_CLI_ENABLED
 #include "nrf_cli.h"
+#include <stdlib.h>
 
 typedef void (*nrf_log_cli_backend_cmd_t)(nrf_cli_t const *         p_cli,
                                           nrf_log_backend_t const * p_backend,
@@ -1562,6 +1841,146 @@ NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_log_config)
     NRF_CLI_SUBCMD_SET_END
 };
 
+#if NRF_LOG_RATE_LIMIT_ENABLED
+static bool u16_parse(char const * p_str, uint16_t * p_val)
+{
+    char *        p_end;
+    unsigned long val = strtoul(p_str, &p_end, 10);
+
+    if ((*p_str == '\0') || (*p_end != '\0') || (val > UINT16_MAX))
+    {
+        return false;
+    }
+    *p_val = (uint16_t)val;
+    return true;
+}
+
+static void rate_limit_status_print(nrf_cli_t const * p_cli)
+{
+    uint32_t modules_cnt = nrf_log_module_cnt_get();
+    uint32_t i;
+
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-40s | rate  | burst | sample | suppressed\r\n",
+                    "module_name");
+    nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL,
+                    "---------------------------------------------------------------------------\r\n");
+    for (i = 0; i < modules_cnt; i++)
+    {
+        uint32_t module_id = i;
+        UNUSED_RETURN_VALUE(module_idx_get(&module_id, true));
+        nrf_log_module_dynamic_data_t * p_module_data = NRF_LOG_DYNAMIC_SECTION_VARS_GET(module_id);
+
+        nrf_cli_fprintf(p_cli, NRF_CLI_NORMAL, "%-40s | %-5d | %-5d | %-6d | %d\r\n",
+                        nrf_log_module_name_get(module_id, false),
+                        p_module_data->rl_rate,
+                        p_module_data->rl_burst,
+                        p_module_data->sample_n,
+                        p_module_data->suppressed);
+    }
+}
+
+/**
+ * @brief Function for applying a rate limit or sampling to the modules given as arguments
+ *        (all modules if none given).
+ */
+static void rate_limit_modules_set(nrf_cli_t const * p_cli,
+                                   size_t            argc,
+                                   char * *          argv,
+                                   bool              sampling,
+                                   uint16_t          val0,
+                                   uint16_t          val1)
+{
+    uint32_t modules_cnt = (argc == 0) ? nrf_log_module_cnt_get() : argc;
+    uint32_t i;
+
+    for (i = 0; i < modules_cnt; i++)
+    {
+        uint32_t   module_id = i;
+        ret_code_t err_code;
+
+        if ((argc != 0) && (module_id_get(argv[i], &module_id) == false))
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Unknown module:%s\r\n", argv[i]);
+            continue;
+        }
+
+        err_code = sampling ? nrf_log_module_sampling_set(module_id, val0) :
+                              nrf_log_module_rate_limit_set(module_id, val0, val1);
+        if (err_code == NRF_ERROR_INVALID_STATE)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "No timestamp function provided.\r\n");
+            return;
+        }
+        else if (err_code != NRF_SUCCESS)
+        {
+            nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Invalid parameters for module: %s\r\n",
+                            nrf_log_module_name_get(module_id, false));
+        }
+        else
+        {
+            /* empty */
+        }
+    }
+}
+#endif // NRF_LOG_RATE_LIMIT_ENABLED
+
+static void log_rate_limit_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint16_t rate;
+    uint16_t burst;
+
+    if (argc == 1)
+    {
+        rate_limit_status_print(p_cli);
+        return;
+    }
+
+    if ((argc < 3) || !u16_parse(argv[1], &rate) || !u16_parse(argv[2], &burst))
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Bad parameters.\r\n");
+        return;
+    }
+
+    rate_limit_modules_set(p_cli, argc - 3, &argv[3], false, rate, burst);
+#else
+    UNUSED_PARAMETER(argc);
+    UNUSED_PARAMETER(argv);
+    nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Not supported.\r\n");
+#endif
+}
+
+static void log_sample_cmd(nrf_cli_t const * p_cli, size_t argc, char **argv)
+{
+    if (nrf_cli_help_requested(p_cli))
+    {
+        nrf_cli_help_print(p_cli, NULL, 0);
+        return;
+    }
+
+#if NRF_LOG_RATE_LIMIT_ENABLED
+    uint16_t n;
+
+    if ((argc < 2) || !u16_parse(argv[1], &n))
+    {
+        nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Bad parameters.\r\n");
+        return;
+    }
+
+    rate_limit_modules_set(p_cli, argc - 2, &argv[2], true, n, 0);
+#else
+    UNUSED_PARAMETER(argc);
+    UNUSED_PARAMETER(argv);
+    nrf_cli_fprintf(p_cli, NRF_CLI_ERROR, "Not supported.\r\n");
+#endif
+}
+
 NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_log_stat)
 {
     NRF_CLI_CMD(backend, &m_backend_name_dynamic, "Logger backends commands.", NULL),
@@ -1577,6 +1996,15 @@ NRF_CLI_CREATE_STATIC_SUBCMD_SET(m_sub_log_stat)
     NRF_CLI_CMD(go, NULL, "Resume logging", log_self_go),
     NRF_CLI_CMD(halt, NULL, "Halt logging", log_self_halt),
     NRF_CLI_CMD(list_backends, NULL, "Lists logger backends.", log_cmd_backends_list),
+    NRF_CLI_CMD(ratelimit, NULL,
+        "'log ratelimit <rate> <burst> <module_0> .. <module_n>' limits logs to <rate> per second "
+        "with bursts of up to <burst> logs in specified modules (all if no modules specified). "
+        "Rate 0 removes the limit. 'log ratelimit' prints the current settings.",
+        log_rate_limit_cmd),
+    NRF_CLI_CMD(sample, NULL,
+        "'log sample <n> <module_0> .. <module_n>' accepts only every n-th log in specified "
+        "modules (all if no modules specified). 0 or 1 disables sampling.",
+        log_sample_cmd),
     NRF_CLI_CMD(status, NULL, "Logger status", log_self_status),
     NRF_CLI_SUBCMD_SET_END
 };
@@ -430,7 +430,46 @@ NRF_LOG_MODULE_REGISTER();
 #define BLOCK_CAT_XXL                  6                                                            /**< Extra Extra Large category identifier. */
 
 #define BITMAP_SIZE                    32                                                           /**< Bitmap size for each word used to contain block information. */
-#define BLOCK_BITMAP_ARRAY_SIZE        CEIL_DIV(TOTAL_BLOCK_COUNT, BITMAP_SIZE)                     /**< Determines number of blocks needed for book keeping availability status of all blocks. */
+#define BITMAP_WORDS(COUNT)            CEIL_DIV((COUNT), BITMAP_SIZE)                               /**< Number of bitmap words needed for book keeping COUNT blocks. */
+
+/**@brief Bitmap word start index for each block category.
+ *
+ * @note   Each category starts on a word boundary, so that a bitmap word never holds blocks of two
+ *         different categories.
+ */
+#define XXSMALL_BITMAP_START           0
+#define XSMALL_BITMAP_START            (XXSMALL_BITMAP_START + BITMAP_WORDS(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT))
+#define SMALL_BITMAP_START             (XSMALL_BITMAP_START  + BITMAP_WORDS(MEMORY_MANAGER_XSMALL_BLOCK_COUNT))
+#define MEDIUM_BITMAP_START            (SMALL_BITMAP_START   + BITMAP_WORDS(MEMORY_MANAGER_SMALL_BLOCK_COUNT))
+#define LARGE_BITMAP_START             (MEDIUM_BITMAP_START  + BITMAP_WORDS(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT))
+#define XLARGE_BITMAP_START            (LARGE_BITMAP_START   + BITMAP_WORDS(MEMORY_MANAGER_LARGE_BLOCK_COUNT))
+#define XXLARGE_BITMAP_START           (XLARGE_BITMAP_START  + BITMAP_WORDS(MEMORY_MANAGER_XLARGE_BLOCK_COUNT))
+
+#define BLOCK_BITMAP_ARRAY_SIZE        (XXLARGE_BITMAP_START + BITMAP_WORDS(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT)) /**< Determines number of words needed for book keeping availability status of all blocks. */
+
+/**@brief Each category has one summary word with a bit per bitmap word. */
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_XXSMALL_BLOCK_COUNT) <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_XSMALL_BLOCK_COUNT)  <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_SMALL_BLOCK_COUNT)   <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_MEDIUM_BLOCK_COUNT)  <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_LARGE_BLOCK_COUNT)   <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_XLARGE_BLOCK_COUNT)  <= BITMAP_SIZE);
+STATIC_ASSERT(BITMAP_WORDS(MEMORY_MANAGER_XXLARGE_BLOCK_COUNT) <= BITMAP_SIZE);
+
+/**@brief Macro for checking if a configured category holds blocks larger than LIMIT bytes. */
+#define CAT_ABOVE(CAT, LIMIT)                                                                       \
+    ((CONCAT_3(MEMORY_MANAGER_, CAT, _BLOCK_COUNT) != 0) &&                                         \
+     (CONCAT_3(MEMORY_MANAGER_, CAT, _BLOCK_SIZE) > (LIMIT)))
+
+/**@brief First configured category holding blocks larger than LIMIT bytes, or BLOCK_CAT_COUNT. */
+#define SIZE_CLASS(LIMIT)                                                                           \
+    (CAT_ABOVE(XXSMALL, LIMIT) ? BLOCK_CAT_XXS    :                                                 \
+     CAT_ABOVE(XSMALL,  LIMIT) ? BLOCK_CAT_XS     :                                                 \
+     CAT_ABOVE(SMALL,   LIMIT) ? BLOCK_CAT_SMALL  :                                                 \
+     CAT_ABOVE(MEDIUM,  LIMIT) ? BLOCK_CAT_MEDIUM :                                                 \
+     CAT_ABOVE(LARGE,   LIMIT) ? BLOCK_CAT_LARGE  :                                                 \
+     CAT_ABOVE(XLARGE,  LIMIT) ? BLOCK_CAT_XL     :                                                 \
+     CAT_ABOVE(XXLARGE, LIMIT) ? BLOCK_CAT_XXL    : BLOCK_CAT_COUNT)
 
 
 /**@brief Lookup table for maximum memory size per block category. */
@@ -445,30 +484,6 @@ static const uint32_t m_block_size[BLOCK_CAT_COUNT] =
     MEMORY_MANAGER_XXLARGE_BLOCK_SIZE
 };
 
-/**@brief Lookup table for block start index for each block category. */
-static const uint32_t m_block_start[BLOCK_CAT_COUNT] =
-{
-    XXSMALL_BLOCK_START,
-    XSMALL_BLOCK_START,
-    SMALL_BLOCK_START,
-    MEDIUM_BLOCK_START,
-    LARGE_BLOCK_START,
-    XLARGE_BLOCK_START,
-    XXLARGE_BLOCK_START
-};
-
-/**@brief Lookup table for last block index for each block category. */
-static const uint32_t m_block_end[BLOCK_CAT_COUNT] =
-{
-    XXSMALL_BLOCK_END,
-    XSMALL_BLOCK_END,
-    SMALL_BLOCK_END,
-    MEDIUM_BLOCK_END,
-    LARGE_BLOCK_END,
-    XLARGE_BLOCK_END,
-    XXLARGE_BLOCK_END
-};
-
 /**@brief Lookup table for memory start range for each block category. */
 static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
 {
@@ -481,8 +496,77 @@ static const uint32_t m_block_mem_start[BLOCK_CAT_COUNT] =
     XXLARGE_MEMORY_START
 };
 
+/**@brief Lookup table for count of block available in each block category. */
+static const uint32_t m_block_count[BLOCK_CAT_COUNT] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
+};
+
+/**@brief Lookup table for bitmap word start index for each block category. */
+static const uint32_t m_block_bitmap_start[BLOCK_CAT_COUNT] =
+{
+    XXSMALL_BITMAP_START,
+    XSMALL_BITMAP_START,
+    SMALL_BITMAP_START,
+    MEDIUM_BITMAP_START,
+    LARGE_BITMAP_START,
+    XLARGE_BITMAP_START,
+    XXLARGE_BITMAP_START
+};
+
+/**@brief Size class index.
+ *
+ * @details Entry n is the first category that can hold a request of size in range
+ *          (2^(n-1), 2^n]. Categories after it only need to be checked when several categories
+ *          fall in the same range.
+ */
+static const uint8_t m_size_class[BITMAP_SIZE + 1] =
+{
+    SIZE_CLASS(0),
+    SIZE_CLASS(1UL << 0),
+    SIZE_CLASS(1UL << 1),
+    SIZE_CLASS(1UL << 2),
+    SIZE_CLASS(1UL << 3),
+    SIZE_CLASS(1UL << 4),
+    SIZE_CLASS(1UL << 5),
+    SIZE_CLASS(1UL << 6),
+    SIZE_CLASS(1UL << 7),
+    SIZE_CLASS(1UL << 8),
+    SIZE_CLASS(1UL << 9),
+    SIZE_CLASS(1UL << 10),
+    SIZE_CLASS(1UL << 11),
+    SIZE_CLASS(1UL << 12),
+    SIZE_CLASS(1UL << 13),
+    SIZE_CLASS(1UL << 14),
+    SIZE_CLASS(1UL << 15),
+    SIZE_CLASS(1UL << 16),
+    SIZE_CLASS(1UL << 17),
+    SIZE_CLASS(1UL << 18),
+    SIZE_CLASS(1UL << 19),
+    SIZE_CLASS(1UL << 20),
+    SIZE_CLASS(1UL << 21),
+    SIZE_CLASS(1UL << 22),
+    SIZE_CLASS(1UL << 23),
+    SIZE_CLASS(1UL << 24),
+    SIZE_CLASS(1UL << 25),
+    SIZE_CLASS(1UL << 26),
+    SIZE_CLASS(1UL << 27),
+    SIZE_CLASS(1UL << 28),
+    SIZE_CLASS(1UL << 29),
+    SIZE_CLASS(1UL << 30),
+    SIZE_CLASS(1UL << 31)
+};
+
 static uint8_t  m_memory[TOTAL_MEMORY_SIZE];                                                        /**< Memory managed by the module. */
 static uint32_t m_mem_pool[BLOCK_BITMAP_ARRAY_SIZE];                                                /**< Bitmap used for book-keeping availability of all blocks managed by the module.  */
+static uint32_t m_word_mask[BLOCK_CAT_COUNT];                                                       /**< Bit n set if bitmap word n of the category has a free block. */
+static uint32_t m_cat_mask;                                                                         /**< Bit n set if category n has a free block. */
 
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
 
@@ -501,7 +585,7 @@ static const char * m_block_desc_str[BLOCK_CAT_COUNT] =
     "XXLarge"
 };
 
-static const uint32_t m_min_size_default[BLOC_CAT_COUNT] =
+static const uint32_t m_min_size_default[BLOCK_CAT_COUNT] =
 {
     MEMORY_MANAGER_XXSMALL_BLOCK_SIZE,
     MEMORY_MANAGER_XSMALL_BLOCK_SIZE,
@@ -510,7 +594,7 @@ static const uint32_t m_min_size_default[BLOC_CAT_COUNT] =
     MEMORY_MANAGER_LARGE_BLOCK_SIZE,
     MEMORY_MANAGER_XLARGE_BLOCK_SIZE,
     MEMORY_MANAGER_XXLARGE_BLOCK_SIZE
-}
+};
 
 /**@brief Table for book keeping smallest size allocated in each block range. */
 static uint32_t m_min_size[BLOCK_CAT_COUNT];
@@ -524,23 +608,18 @@ static uint32_t m_peak_count[BLOCK_CAT_COUNT];
 /**@brief Table for keeping the current count in each block range. */
 static uint32_t m_cur_count[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to minimum size holder for block type being allocated. */
-static uint32_t * p_min_size;
+/**@brief Table for keeping the count of reservations requested for each block range but served
+ *        from a larger one, because no block of the requested range was free. */
+static uint32_t m_spill_count[BLOCK_CAT_COUNT];
 
-/**@brief Global pointing to maximum size holder for block type being allocated. */
-static uint32_t * p_max_size;
+/**@brief Sum of the requested sizes of all reservations. */
+static uint32_t m_requested_bytes;
 
-/**@brief Lookup table for count of block available in each block category. */
-static uint32_t m_block_count[BLOCK_CAT_COUNT] =
-{
-    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
-    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
-    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
-    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT
-};
+/**@brief Sum of the block sizes of all reservations. */
+static uint32_t m_reserved_bytes;
+
+/**@brief Count of failed reservations. */
+static uint32_t m_failed_count;
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
@@ -555,40 +634,46 @@ static bool     m_module_initialized = false;
  * @details Function to get X and Y co-ordinates for the block identified by index.
  *          Here, X determines relevant word for the block. Y determines the actual bit in the word.
  *
- * @param[in]  index Identifies the block.
- * @param[out] p_x   Points to the word that contains the bit representing the block.
- * @param[out] p_y   Contains the bitnumber in the the word 'X' relevant to the block.
+ * @param[in]  block_index Identifies the block within its category.
+ * @param[out] p_x         Points to the word that contains the bit representing the block.
+ * @param[out] p_y         Contains the bitnumber in the the word 'X' relevant to the block.
  */
 static __INLINE void get_block_coordinates(uint32_t block_index, uint32_t * p_x, uint32_t * p_y)
 {
     // Determine position of the block in the bitmap.
     // X determines relevant word for the block. Y determines the actual bit in the word.
-    const uint32_t x = block_index / BITMAP_SIZE;
-    const uint32_t y = (block_index - x * BITMAP_SIZE);
+    (*p_x) = block_index / BITMAP_SIZE;
+    (*p_y) = block_index % BITMAP_SIZE;
+}
+
 
-    (*p_x) = x;
-    (*p_y) = y;
+/**@brief Function to get the index of the least significant bit set in a non-zero word. */
+static __INLINE uint32_t first_set_bit(uint32_t word)
+{
+    return __CLZ(__RBIT(word));
 }
 
 
-/**@brief Function to get the category of the block of size 'size' or block number 'block_index'.*/
-static __INLINE uint32_t get_block_cat(uint32_t size, uint32_t block_index)
+/**@brief Function to get the smallest category that can hold a block of size 'size'.
+ *
+ * @return Category identifier, BLOCK_CAT_COUNT if no category can hold the size.
+ */
+static __INLINE uint32_t get_block_cat(uint32_t size)
 {
-    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    // Index of the smallest power of two not less than the size.
+    const uint32_t range     = (size > 1) ? (BITMAP_SIZE - __CLZ(size - 1)) : 0;
+    uint32_t       block_cat = m_size_class[range];
+
+    while ((block_cat < BLOCK_CAT_COUNT) && (size > m_block_size[block_cat]))
     {
-        if (((size != 0) && (size <= m_block_size[block_cat]) &&
-            (m_block_end[block_cat] != m_block_start[block_cat])) ||
-            (block_index < m_block_end[block_cat]))
-        {
-            return block_cat;
-        }
+        block_cat++;
     }
 
-    return 0;
+    return block_cat;
 }
 
 /**@brief Initializes the block by setting it to be free. */
-static void block_init (uint32_t block_index)
+static void block_init(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -597,36 +682,25 @@ static void block_init (uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
+    uint32_t * p_word = &m_mem_pool[m_block_bitmap_start[block_cat] + x];
+
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
     // Update current use statistics: lower current count in block
-    if (!IS_SET(m_mem_pool[x], y))
+    if (!IS_SET(*p_word, y))
     {
-        uint32_t block_cat = get_block_cat(0, block_index);
         m_cur_count[block_cat]--;
     }
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
 
     // Set bit related to the block to indicate that the block is free.
-    SET_BIT(m_mem_pool[x], y);
-}
-
-
-/**@brief Function to get the size of the block number 'block_index'. */
-static __INLINE uint32_t get_block_size(uint32_t block_index)
-{
-    const uint32_t block_cat = get_block_cat(0, block_index);
-
-#if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
-    p_min_size = &m_min_size[block_cat];
-    p_max_size = &m_max_size[block_cat];
-#endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
-
-    return m_block_size[block_cat];
+    SET_BIT(*p_word, y);
+    SET_BIT(m_word_mask[block_cat], x);
+    SET_BIT(m_cat_mask, block_cat);
 }
 
 
-/**@brief Function to free the block identified by block number 'block_index'. */
-static bool is_block_free(uint32_t block_index)
+/**@brief Function to check if the block identified by block number 'block_index' is free. */
+static bool is_block_free(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -635,12 +709,12 @@ static bool is_block_free(uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
-    return IS_SET(m_mem_pool[x], y);
+    return IS_SET(m_mem_pool[m_block_bitmap_start[block_cat] + x], y);
 }
 
 
 /**@brief Function to allocate the block identified by block number 'block_index'. */
-static void block_allocate(uint32_t block_index)
+static void block_allocate(uint32_t block_cat, uint32_t block_index)
 {
     uint32_t x;
     uint32_t y;
@@ -649,11 +723,23 @@ static void block_allocate(uint32_t block_index)
     // X determines relevant word for the block. Y determines the actual bit in the word.
     get_block_coordinates(block_index, &x, &y);
 
-    CLR_BIT(m_mem_pool[x], y);
+    uint32_t * p_word = &m_mem_pool[m_block_bitmap_start[block_cat] + x];
+
+    CLR_BIT(*p_word, y);
+
+    // Keep the summary bitmaps in sync, so that the search never visits a full word.
+    if ((*p_word) == 0)
+    {
+        CLR_BIT(m_word_mask[block_cat], x);
+
+        if (m_word_mask[block_cat] == 0)
+        {
+            CLR_BIT(m_cat_mask, block_cat);
+        }
+    }
 
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
     // Update statistics: Add to current count in block.
-    uint32_t block_cat = get_block_cat(0, block_index);
     m_cur_count[block_cat]++;
 
     // Report if the peak usage goes up in current block
@@ -674,20 +760,27 @@ uint32_t nrf_mem_init(void)
 
     MM_MUTEX_LOCK();
 
-    uint32_t block_index = 0;
+    uint32_t block_cat;
+    uint32_t block_index;
+
+    m_cat_mask = 0;
+    memset(m_word_mask, 0, sizeof(m_word_mask));
 
-    for (block_index = 0; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    for (block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
     {
-        block_init(block_index);
+        for (block_index = 0; block_index < m_block_count[block_cat]; block_index++)
+        {
+            block_init(block_cat, block_index);
+        }
     }
 
-    NRF_MEM_MANAGER_DIAGNOSE_RESET
+    NRF_MEM_MANAGER_DIAGNOSE_RESET;
 
 #if (MEM_MANAGER_DISABLE_API_PARAM_CHECK == 0)
     m_module_initialized = true;
 #endif // MEM_MANAGER_DISABLE_API_PARAM_CHECK
 
-    NRF_MEM_MANAGER_DIAGNOSE
+    NRF_MEM_MANAGER_DIAGNOSE;
 
     MM_MUTEX_UNLOCK();
 
@@ -711,40 +804,43 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
 
     MM_MUTEX_LOCK();
 
-    const uint32_t block_cat    = get_block_cat(requested_size, TOTAL_BLOCK_COUNT);
-    uint32_t       block_index  = m_block_start[block_cat];
-    uint32_t       memory_index = m_block_mem_start[block_cat];
-    uint32_t       err_code     = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
+    const uint32_t requested_cat = get_block_cat(requested_size);
+    uint32_t       err_code      = (NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE);
 
-    NRF_LOG_DEBUG("Start index for the pool = 0x%08lX, total block count 0x%08X",
-           block_index,
-           TOTAL_BLOCK_COUNT);
+    // Categories large enough for the request that still have a free block. As before, a larger
+    // category is used when all blocks of the requested one are in use.
+    const uint32_t cat_mask = m_cat_mask & ~((1UL << requested_cat) - 1);
 
-    for (; block_index < TOTAL_BLOCK_COUNT; block_index++)
+    if (cat_mask != 0)
     {
-        uint32_t block_size = get_block_size(block_index);
+        const uint32_t block_cat   = first_set_bit(cat_mask);
+        const uint32_t x           = first_set_bit(m_word_mask[block_cat]);
+        const uint32_t y           = first_set_bit(m_mem_pool[m_block_bitmap_start[block_cat] + x]);
+        const uint32_t block_index = x * BITMAP_SIZE + y;
+        const uint32_t block_size  = m_block_size[block_cat];
 
-        if (is_block_free(block_index) == true)
-        {
-            NRF_LOG_DEBUG("Reserving block 0x%08lX", block_index);
+        NRF_LOG_DEBUG("Reserving block %d of category %d", block_index, block_cat);
 
-            // Search succeeded, found free block.
-            err_code     = NRF_SUCCESS;
+        // Search succeeded, found free block.
+        err_code     = NRF_SUCCESS;
 
-            // Allocate block.
-            block_allocate(block_index);
+        // Allocate block.
+        block_allocate(block_cat, block_index);
 
-            (*pp_buffer) = &m_memory[memory_index];
-            (*p_size)    = block_size;
+        (*pp_buffer) = &m_memory[m_block_mem_start[block_cat] + block_index * block_size];
+        (*p_size)    = block_size;
 
-        #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
-            (*p_min_size) = MIN((*p_min_size), requested_size);
-            (*p_max_size) = MAX((*p_max_size), requested_size);
-        #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+    #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
+        m_min_size[block_cat] = MIN(m_min_size[block_cat], requested_size);
+        m_max_size[block_cat] = MAX(m_max_size[block_cat], requested_size);
 
-            break;
+        m_requested_bytes += requested_size;
+        m_reserved_bytes  += block_size;
+        if (block_cat != requested_cat)
+        {
+            m_spill_count[requested_cat]++;
         }
-        memory_index += block_size;
+    #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
     }
     if (err_code != NRF_SUCCESS)
     {
@@ -753,7 +849,11 @@ uint32_t nrf_mem_reserve(uint8_t ** pp_buffer, uint32_t * p_size)
                 (uint32_t)(*pp_buffer),
                 (*p_size));
 
-        NRF_MEM_MANAGER_DIAGNOSE
+    #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
+        m_failed_count++;
+    #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
+
+        NRF_MEM_MANAGER_DIAGNOSE;
     }
 
     MM_MUTEX_UNLOCK();
@@ -814,19 +914,32 @@ void nrf_free(void * p_mem)
 
     MM_MUTEX_LOCK();
 
-    uint32_t index;
-    uint32_t memory_index = 0;
+    uint8_t * p_byte = p_mem;
 
-    for (index = 0; index < TOTAL_BLOCK_COUNT; index++)
+    if ((p_byte >= &m_memory[0]) && (p_byte < &m_memory[TOTAL_MEMORY_SIZE]))
     {
-        if (&m_memory[memory_index] == p_mem)
+        const uint32_t memory_index = (uint32_t)(p_byte - &m_memory[0]);
+
+        // The block range is found with one comparison per category, no matter how many blocks
+        // are configured.
+        for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
         {
-            // Found a free block of memory, assign.
-            NRF_LOG_DEBUG("<< Freeing block %d.", index);
-            block_init(index);
-            break;
+            const uint32_t offset = memory_index - m_block_mem_start[block_cat];
+
+            if ((memory_index >= m_block_mem_start[block_cat]) &&
+                (offset < m_block_count[block_cat] * m_block_size[block_cat]))
+            {
+                if ((offset % m_block_size[block_cat]) == 0)
+                {
+                    // Found a free block of memory, assign.
+                    NRF_LOG_DEBUG("<< Freeing block %d of category %d.",
+                                  offset / m_block_size[block_cat],
+                                  block_cat);
+                    block_init(block_cat, offset / m_block_size[block_cat]);
+                }
+                break;
+            }
         }
-        memory_index += get_block_size(index);
     }
 
     MM_MUTEX_UNLOCK();
@@ -856,14 +969,14 @@ void * nrf_realloc(void * p_mem, uint32_t size)
 void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 {
     #define PRINT_COLUMN_WIDTH      13
-    #define PRINT_BUFFER_SIZE       100
+    #define PRINT_BUFFER_SIZE       120
     #define ASCII_VALUE_FOR_SPACE   32
 
     char           print_buffer[PRINT_BUFFER_SIZE];
-    const uint32_t total_count   = (m_block_start[block_cat] + m_block_count[block_cat]);
+    const uint32_t total_count   = m_block_count[block_cat];
     uint32_t       in_use        = 0;
     uint32_t       num_of_blocks = 0;
-    uint32_t       index         = m_block_start[block_cat];
+    uint32_t       index         = 0;
     uint32_t       column_number;
 
     // No statistic provided in case block category is not included.
@@ -873,7 +986,7 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 
         for (; index < total_count; index++)
         {
-            if (is_block_free(index) == false)
+            if (is_block_free(block_cat, index) == false)
             {
                 num_of_blocks++;
                 in_use += m_block_size[block_cat];
@@ -920,7 +1033,13 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
         snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
                  PRINT_COLUMN_WIDTH,
                  "| %d",
-                 (int)m_max_count[block_cat]);
+                 (int)m_peak_count[block_cat]);
+
+        column_number++;
+        snprintf(&print_buffer[column_number * PRINT_COLUMN_WIDTH],
+                 PRINT_COLUMN_WIDTH,
+                 "| %d",
+                 (int)m_spill_count[block_cat]);
 
         column_number++;
         const uint32_t column_end = (column_number * PRINT_COLUMN_WIDTH);
@@ -941,14 +1060,40 @@ void print_block_info(uint32_t block_cat, uint32_t * p_mem_in_use)
 }
 
 
+void nrf_mem_frag_stats_get(nrf_mem_frag_stats_t * p_stats)
+{
+    MM_MUTEX_LOCK();
+
+    p_stats->requested_bytes = m_requested_bytes;
+    p_stats->reserved_bytes  = m_reserved_bytes;
+    p_stats->failed          = m_failed_count;
+    p_stats->spilled         = 0;
+    p_stats->free_bytes      = 0;
+
+    for (uint32_t block_cat = 0; block_cat < BLOCK_CAT_COUNT; block_cat++)
+    {
+        p_stats->spilled    += m_spill_count[block_cat];
+        p_stats->free_bytes += (m_block_count[block_cat] - m_cur_count[block_cat]) *
+                               m_block_size[block_cat];
+    }
+
+    // The most significant category with a free block holds the largest free block.
+    p_stats->largest_free = (m_cat_mask != 0) ?
+                            m_block_size[BITMAP_SIZE - 1 - __CLZ(m_cat_mask)] : 0;
+
+    MM_MUTEX_UNLOCK();
+}
+
+
 void nrf_mem_diagnose(void)
 {
-    uint32_t in_use = 0;
+    uint32_t             in_use = 0;
+    nrf_mem_frag_stats_t stats;
 
     NRF_LOG_INFO("");
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
-    NRF_LOG_INFO("| Block      | Size       | Total      | In Use     | Min Alloc  | Max Alloc  |");
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("| Block      | Size       | Total      | In Use     | Min Alloc  | Max Alloc  | Peak       | Spilled    |");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+");
 
     print_block_info(BLOCK_CAT_XXS, &in_use);
     print_block_info(BLOCK_CAT_XS, &in_use);
@@ -958,10 +1103,17 @@ void nrf_mem_diagnose(void)
     print_block_info(BLOCK_CAT_XL, &in_use);
     print_block_info(BLOCK_CAT_XXL, &in_use);
 
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+");
     NRF_LOG_INFO("| Total      | %d      | %d        | %d",
             TOTAL_MEMORY_SIZE, TOTAL_BLOCK_COUNT,in_use);
-    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+");
+    NRF_LOG_INFO("+------------+------------+------------+------------+------------+------------+------------+------------+");
+
+    nrf_mem_frag_stats_get(&stats);
+
+    NRF_LOG_INFO("Requested %d bytes, reserved %d bytes, %d failed reservations.",
+                 stats.requested_bytes, stats.reserved_bytes, stats.failed);
+    NRF_LOG_INFO("Free %d bytes, largest free block %d bytes.",
+                 stats.free_bytes, stats.largest_free);
 }
 
 
@@ -969,8 +1121,13 @@ void nrf_mem_diagnose_reset(void)
 {
     memcpy(&m_min_size, &m_min_size_default, sizeof(m_min_size));
     memset(&m_max_size, 0, sizeof(m_max_size));
-    memset(&m_peak_count, 0, sizeof(m_max_count));
+    memset(&m_peak_count, 0, sizeof(m_peak_count));
     memset(&m_cur_count, 0, sizeof(m_cur_count));
+    memset(&m_spill_count, 0, sizeof(m_spill_count));
+
+    m_requested_bytes = 0;
+    m_reserved_bytes  = 0;
+    m_failed_count    = 0;
 }
 
 #endif // MEM_MANAGER_ENABLE_DIAGNOSTICS
@@ -153,6 +153,28 @@ void * nrf_realloc(void *p_buffer, uint32_t size);
 
 #if defined(MEM_MANAGER_ENABLE_DIAGNOSTICS) && (MEM_MANAGER_ENABLE_DIAGNOSTICS == 1)
 
+/**@brief Fragmentation statistics of the memory manager. */
+typedef struct
+{
+    uint32_t requested_bytes;   /**< Sum of the requested sizes of all reservations since the last reset. */
+    uint32_t reserved_bytes;    /**< Sum of the block sizes of all reservations since the last reset.
+                                     The difference to requested_bytes is internal fragmentation. */
+    uint32_t spilled;           /**< Reservations served from a larger block category, because all
+                                     blocks of the best fitting category were in use. */
+    uint32_t failed;            /**< Reservations that failed since the last reset. */
+    uint32_t free_bytes;        /**< Memory in free blocks. */
+    uint32_t largest_free;      /**< Size of the largest free block. Requests larger than this fail
+                                     even if free_bytes is larger. */
+} nrf_mem_frag_stats_t;
+
+
+/**@brief Function to get fragmentation statistics.
+ *
+ * @param[out] p_stats   Fragmentation statistics.
+ */
+void nrf_mem_frag_stats_get(nrf_mem_frag_stats_t * p_stats);
+
+
 /**@brief Function to print statistics related to memory blocks managed by memory manager.
  *
  * @details This API prints information with respects to each block function, including size, total
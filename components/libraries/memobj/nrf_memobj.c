@@ -172,13 +172,12 @@ void nrf_memobj_put(nrf_memobj_t * p_obj)
     }
 }
 
-static void memobj_op(nrf_memobj_t * p_obj,
-                      void *         p_data,
-                      size_t *       p_len,
-                      size_t         offset,
-                      bool read)
+void nrf_memobj_iter_init(nrf_memobj_iter_t * p_iter,
+                          nrf_memobj_t *      p_obj,
+                          size_t              offset,
+                          size_t              len)
 {
-
+    ASSERT(p_iter);
     ASSERT(p_obj);
 
     memobj_head_t * p_head       = (memobj_head_t *)p_obj;
@@ -186,8 +185,6 @@ static void memobj_op(nrf_memobj_t * p_obj,
     size_t          obj_capacity;
     size_t          chunk_size;
     size_t          chunk_idx;
-    size_t          chunk_offset;
-    size_t          len;
 
     obj_capacity = (p_head->head_header.data.fields.chunk_size *
                     p_head->head_header.data.fields.chunk_cnt) -
@@ -195,13 +192,8 @@ static void memobj_op(nrf_memobj_t * p_obj,
 
     ASSERT(offset < obj_capacity);
 
-    chunk_size   = p_head->head_header.data.fields.chunk_size;
-    chunk_idx    = (offset + sizeof(memobj_head_header_fields_t)) / chunk_size;
-    chunk_offset = (offset + sizeof(memobj_head_header_fields_t)) % chunk_size;
-    len          = ((*p_len + offset) > obj_capacity) ? obj_capacity - offset : *p_len;
-
-    //Return number of available bytes
-    *p_len = len;
+    chunk_size = p_head->head_header.data.fields.chunk_size;
+    chunk_idx  = (offset + sizeof(memobj_head_header_fields_t)) / chunk_size;
 
     //Move to the first chunk to be used
     while (chunk_idx > 0)
@@ -210,31 +202,87 @@ static void memobj_op(nrf_memobj_t * p_obj,
         chunk_idx--;
     }
 
-    size_t user_mem_offset  = 0;
-    size_t curr_cpy_size    = chunk_size - chunk_offset;
-    curr_cpy_size = curr_cpy_size > len ? len : curr_cpy_size;
+    p_iter->p_chunk    = p_curr_chunk;
+    p_iter->chunk_size = chunk_size;
+    p_iter->chunk_off  = (offset + sizeof(memobj_head_header_fields_t)) % chunk_size;
+    p_iter->remaining  = ((len + offset) > obj_capacity) ? obj_capacity - offset : len;
+}
+
+bool nrf_memobj_iter_next(nrf_memobj_iter_t * p_iter, nrf_memobj_span_t * p_span)
+{
+    ASSERT(p_iter);
+    ASSERT(p_span);
+
+    if (p_iter->remaining == 0)
+    {
+        return false;
+    }
+
+    memobj_elem_t * p_curr_chunk = (memobj_elem_t *)p_iter->p_chunk;
+    size_t          span_len     = p_iter->chunk_size - p_iter->chunk_off;
+
+    span_len = (span_len > p_iter->remaining) ? p_iter->remaining : span_len;
+
+    p_span->p_data = &p_curr_chunk->data[p_iter->chunk_off];
+    p_span->len    = span_len;
+
+    p_iter->remaining -= span_len;
+    p_iter->chunk_off  = 0;
+    p_iter->p_chunk    = p_curr_chunk->header.p_next;
+
+    return true;
+}
+
+static void memobj_op(nrf_memobj_t * p_obj,
+                      void *         p_data,
+                      size_t *       p_len,
+                      size_t         offset,
+                      bool read)
+{
+    nrf_memobj_iter_t iter;
+    nrf_memobj_span_t span;
+    size_t            user_mem_offset = 0;
 
-    while (len)
+    nrf_memobj_iter_init(&iter, p_obj, offset, *p_len);
+
+    //Return number of available bytes
+    *p_len = iter.remaining;
+
+    while (nrf_memobj_iter_next(&iter, &span))
     {
         void * p_user_mem = &((uint8_t *)p_data)[user_mem_offset];
-        void * p_obj_mem  = &p_curr_chunk->data[chunk_offset];
         if (read)
         {
-            memcpy(p_user_mem, p_obj_mem, curr_cpy_size);
+            memcpy(p_user_mem, span.p_data, span.len);
         }
         else
         {
-            memcpy(p_obj_mem, p_user_mem, curr_cpy_size);
+            memcpy(span.p_data, p_user_mem, span.len);
         }
 
-        chunk_offset     = 0;
-        p_curr_chunk     = p_curr_chunk->header.p_next;
-        len             -= curr_cpy_size;
-        user_mem_offset += curr_cpy_size;
-        curr_cpy_size    = (chunk_size > len) ? len : chunk_size;
+        user_mem_offset += span.len;
     }
 }
 
+size_t nrf_memobj_spans_get(nrf_memobj_t *      p_obj,
+                            size_t              offset,
+                            size_t              len,
+                            nrf_memobj_span_t * p_spans,
+                            size_t              max_spans)
+{
+    nrf_memobj_iter_t iter;
+    size_t            count = 0;
+
+    nrf_memobj_iter_init(&iter, p_obj, offset, len);
+
+    while ((count < max_spans) && nrf_memobj_iter_next(&iter, &p_spans[count]))
+    {
+        count++;
+    }
+
+    return count;
+}
+
 void nrf_memobj_write(nrf_memobj_t * p_obj,
                       void *         p_data,
                       size_t         len,
@@ -49,6 +49,7 @@
 */
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include "sdk_errors.h"
 #include "nrf_balloc.h"
 
@@ -78,7 +79,7 @@ extern "C" {
 @endverbatim
  *
  */
-#define NRF_MEMOBJ_STD_HEADER_SIZE sizeof(uint32_t)
+#define NRF_MEMOBJ_STD_HEADER_SIZE sizeof(void *)
 
 /**
  * @brief Macro for creating an nrf_memobj pool.
@@ -104,6 +105,28 @@ typedef nrf_balloc_t nrf_memobj_pool_t;
  */
 typedef void * nrf_memobj_t;
 
+/**
+ * @brief Contiguous region of memory object data.
+ */
+typedef struct
+{
+    void * p_data; ///< Pointer to the data inside a chunk.
+    size_t len;    ///< Number of bytes available at @p p_data.
+} nrf_memobj_span_t;
+
+/**
+ * @brief Iterator over the chunks of a memory object.
+ *
+ * @note Fields are internal and must not be accessed directly.
+ */
+typedef struct
+{
+    void * p_chunk;    ///< Current chunk.
+    size_t chunk_size; ///< Size of the data part of a chunk.
+    size_t chunk_off;  ///< Offset of the next byte in the current chunk.
+    size_t remaining;  ///< Number of bytes left to be visited.
+} nrf_memobj_iter_t;
+
 /**
  * @brief Function for initializing the memobj pool instance.
  *
@@ -194,6 +217,51 @@ void nrf_memobj_read(nrf_memobj_t * p_obj,
                      size_t         len,
                      size_t         offset);
 
+/**
+ * @brief Function for starting an iteration over the data of the memory object.
+ *
+ * The iterator visits the data in place, chunk by chunk, so that it can be handed over to a
+ * consumer without intermediate copies. Use @ref nrf_memobj_iter_next to get subsequent regions.
+ *
+ * @param[out] p_iter Pointer to the iterator.
+ * @param[in]  p_obj  Pointer to memory object.
+ * @param[in]  offset Offset of the first byte to be visited.
+ * @param[in]  len    Number of bytes to be visited. Limited to the object capacity.
+ */
+void nrf_memobj_iter_init(nrf_memobj_iter_t * p_iter,
+                          nrf_memobj_t *      p_obj,
+                          size_t              offset,
+                          size_t              len);
+
+/**
+ * @brief Function for getting the next contiguous region of the memory object.
+ *
+ * @param[in,out] p_iter Pointer to the iterator.
+ * @param[out]    p_span Region description. Not modified if the function returns false.
+ *
+ * @retval true  If @p p_span was filled.
+ * @retval false If all requested data has been visited.
+ */
+bool nrf_memobj_iter_next(nrf_memobj_iter_t * p_iter, nrf_memobj_span_t * p_span);
+
+/**
+ * @brief Function for getting a scatter-gather list describing data of the memory object.
+ *
+ * @param[in]  p_obj     Pointer to memory object.
+ * @param[in]  offset    Offset of the first byte.
+ * @param[in]  len       Number of bytes.
+ * @param[out] p_spans   Array to be filled with regions.
+ * @param[in]  max_spans Size of @p p_spans.
+ *
+ * @return Number of regions written to @p p_spans. If it equals @p max_spans, the list may be
+ *         incomplete.
+ */
+size_t nrf_memobj_spans_get(nrf_memobj_t *      p_obj,
+                            size_t              offset,
+                            size_t              len,
+                            nrf_memobj_span_t * p_spans,
+                            size_t              max_spans);
+
 #ifdef __cplusplus
 }
 #endif
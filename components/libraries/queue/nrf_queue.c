@@ -147,6 +147,20 @@ __STATIC_INLINE size_t queue_utilization_get(nrf_queue_t const * p_queue)
         (circullar_buffer_size_get(p_queue) - front + back);
 }
 
+/**@brief Check if the oldest elements can be overwritten to make room for new ones.
+ *
+ * Elements handed out by @ref nrf_queue_spans_peek are accessed in place, so they are never
+ * overwritten.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ *
+ * @return      True if the queue is in overflow mode and no elements are peeked.
+ */
+__STATIC_INLINE bool queue_overflow_allowed(nrf_queue_t const * p_queue)
+{
+    return (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW) && (p_queue->p_cb->peeked == 0);
+}
+
 bool nrf_queue_is_full(nrf_queue_t const * p_queue)
 {
     ASSERT(p_queue != NULL);
@@ -166,7 +180,7 @@ ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element)
     CRITICAL_REGION_ENTER();
     bool is_full = nrf_queue_is_full(p_queue);
 
-    if (!is_full || (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW))
+    if ((p_queue->p_cb->reserved == 0) && (!is_full || queue_overflow_allowed(p_queue)))
     {
         // Get write position.
         size_t write_pos = p_queue->p_cb->back;
@@ -310,7 +324,7 @@ static size_t continous_items_get(nrf_queue_t const * p_queue, bool write)
 static void queue_write(nrf_queue_t const * p_queue, void const * p_data, uint32_t element_count)
 {
     size_t prev_available = nrf_queue_available_get(p_queue);
-    size_t continuous     = continous_items_get(p_queue, true);
+    size_t continuous     = circullar_buffer_size_get(p_queue) - p_queue->p_cb->back;
     void * p_write_ptr    = (void *)((size_t)p_queue->p_buffer
                           + p_queue->p_cb->back * p_queue->element_size);
 
@@ -337,11 +351,12 @@ static void queue_write(nrf_queue_t const * p_queue, void const * p_data, uint32
                elements_left * p_queue->element_size);
 
         p_queue->p_cb->back = elements_left;
-        if (prev_available < element_count)
-        {
-            // Overwrite the oldest elements.
-            p_queue->p_cb->front = nrf_queue_next_idx(p_queue, p_queue->p_cb->back);
-        }
+    }
+
+    if (prev_available < element_count)
+    {
+        // Overwrite the oldest elements.
+        p_queue->p_cb->front = nrf_queue_next_idx(p_queue, p_queue->p_cb->back);
     }
 
     // Update utilization.
@@ -369,8 +384,8 @@ ret_code_t nrf_queue_write(nrf_queue_t const * p_queue,
 
     CRITICAL_REGION_ENTER();
 
-    if ((nrf_queue_available_get(p_queue) >= element_count)
-     || (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW))
+    if ((p_queue->p_cb->reserved == 0)
+     && ((nrf_queue_available_get(p_queue) >= element_count) || queue_overflow_allowed(p_queue)))
     {
         queue_write(p_queue, p_data, element_count);
     }
@@ -403,7 +418,11 @@ size_t nrf_queue_in(nrf_queue_t const * p_queue,
 
     CRITICAL_REGION_ENTER();
 
-    if (p_queue->mode == NRF_QUEUE_MODE_OVERFLOW)
+    if (p_queue->p_cb->reserved != 0)
+    {
+        element_count = 0;
+    }
+    else if (queue_overflow_allowed(p_queue))
     {
         element_count = MIN(element_count, p_queue->size);
     }
@@ -413,7 +432,10 @@ size_t nrf_queue_in(nrf_queue_t const * p_queue,
         element_count    = MIN(element_count, available);
     }
 
-    queue_write(p_queue, p_data, element_count);
+    if (element_count > 0)
+    {
+        queue_write(p_queue, p_data, element_count);
+    }
 
     CRITICAL_REGION_EXIT();
 
@@ -523,6 +545,198 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
     return element_count;
 }
 
+/**@brief Advance an index by a number of elements, wrapping around the end of the buffer.
+ *
+ * @param[in]   p_queue     Pointer to the queue instance.
+ * @param[in]   idx         Current index.
+ * @param[in]   count       Number of elements. Must not exceed the buffer size.
+ *
+ * @return      Advanced index.
+ */
+__STATIC_INLINE size_t queue_idx_advance(nrf_queue_t const * p_queue, size_t idx, size_t count)
+{
+    idx += count;
+    return (idx < circullar_buffer_size_get(p_queue)) ? idx : (idx - circullar_buffer_size_get(p_queue));
+}
+
+/**@brief Describe a region of the queue storage with up to two spans.
+ *
+ * @param[in]   p_queue             Pointer to the queue instance.
+ * @param[in]   start               Index of the first element of the region.
+ * @param[in]   continuous          Number of elements available before the buffer wraps.
+ * @param[in]   element_count       Number of elements in the region.
+ * @param[out]  p_spans             Spans to be filled.
+ */
+static void queue_spans_fill(nrf_queue_t const * p_queue,
+                             size_t              start,
+                             size_t              continuous,
+                             size_t              element_count,
+                             nrf_queue_span_t  * p_spans)
+{
+    size_t first_count = MIN(element_count, continuous);
+
+    p_spans[0].p_data = (void *)((size_t)p_queue->p_buffer + start * p_queue->element_size);
+    p_spans[0].count  = first_count;
+    p_spans[1].p_data = p_queue->p_buffer;
+    p_spans[1].count  = element_count - first_count;
+}
+
+size_t nrf_queue_spans_reserve(nrf_queue_t const * p_queue,
+                               size_t              element_count,
+                               nrf_queue_span_t  * p_spans)
+{
+    ASSERT(p_queue != NULL);
+    ASSERT(p_spans != NULL);
+
+    size_t req_element_count = element_count;
+
+    CRITICAL_REGION_ENTER();
+
+    if (p_queue->p_cb->reserved != 0)
+    {
+        // Only one reservation can be outstanding.
+        element_count = 0;
+    }
+    else
+    {
+        size_t available = p_queue->size - queue_utilization_get(p_queue);
+
+        if (queue_overflow_allowed(p_queue))
+        {
+            element_count = MIN(element_count, p_queue->size);
+            if (element_count > available)
+            {
+                // Drop the oldest elements.
+                NRF_LOG_INST_WARNING(p_queue->p_log, "Queue full. Overwriting oldest elements.");
+                p_queue->p_cb->front = queue_idx_advance(p_queue,
+                                                         p_queue->p_cb->front,
+                                                         element_count - available);
+            }
+        }
+        else
+        {
+            element_count = MIN(element_count, available);
+        }
+
+        p_queue->p_cb->reserved = element_count;
+    }
+
+    queue_spans_fill(p_queue,
+                     p_queue->p_cb->back,
+                     continous_items_get(p_queue, true),
+                     element_count,
+                     p_spans);
+
+    CRITICAL_REGION_EXIT();
+
+    NRF_LOG_INST_DEBUG(p_queue->p_log, "Reserved %d elements, requested :%d",
+                                       element_count, req_element_count);
+    return element_count;
+}
+
+void nrf_queue_spans_commit(nrf_queue_t const * p_queue, size_t element_count)
+{
+    ASSERT(p_queue != NULL);
+
+    CRITICAL_REGION_ENTER();
+
+    ASSERT(element_count <= p_queue->p_cb->reserved);
+
+    p_queue->p_cb->back     = queue_idx_advance(p_queue, p_queue->p_cb->back, element_count);
+    p_queue->p_cb->reserved = 0;
+
+    // Update utilization.
+    size_t utilization = queue_utilization_get(p_queue);
+    if (p_queue->p_cb->max_utilization < utilization)
+    {
+        p_queue->p_cb->max_utilization = utilization;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    NRF_LOG_INST_DEBUG(p_queue->p_log, "Committed %d elements", element_count);
+}
+
+size_t nrf_queue_spans_peek(nrf_queue_t const * p_queue,
+                            size_t              element_count,
+                            nrf_queue_span_t  * p_spans)
+{
+    ASSERT(p_queue != NULL);
+    ASSERT(p_spans != NULL);
+
+    size_t req_element_count = element_count;
+
+    CRITICAL_REGION_ENTER();
+
+    element_count = MIN(element_count, queue_utilization_get(p_queue));
+
+    queue_spans_fill(p_queue,
+                     p_queue->p_cb->front,
+                     continous_items_get(p_queue, false),
+                     element_count,
+                     p_spans);
+
+    p_queue->p_cb->peeked       = element_count;
+    p_queue->p_cb->peeked_front = p_queue->p_cb->front;
+
+    CRITICAL_REGION_EXIT();
+
+    NRF_LOG_INST_DEBUG(p_queue->p_log, "Peeked %d elements, requested :%d",
+                                       element_count, req_element_count);
+    return element_count;
+}
+
+ret_code_t nrf_queue_spans_consume(nrf_queue_t const * p_queue, size_t element_count)
+{
+    ret_code_t err_code = NRF_SUCCESS;
+
+    ASSERT(p_queue != NULL);
+
+    CRITICAL_REGION_ENTER();
+
+    if ((element_count > 0)
+     && ((p_queue->p_cb->peeked == 0) || (p_queue->p_cb->front != p_queue->p_cb->peeked_front)))
+    {
+        // Nothing is peeked, or peeked elements were taken by another read operation.
+        err_code = NRF_ERROR_INVALID_STATE;
+    }
+    else if (element_count > p_queue->p_cb->peeked)
+    {
+        err_code = NRF_ERROR_INVALID_PARAM;
+    }
+    else
+    {
+        p_queue->p_cb->front = queue_idx_advance(p_queue, p_queue->p_cb->front, element_count);
+    }
+    p_queue->p_cb->peeked = 0;
+
+    CRITICAL_REGION_EXIT();
+
+    if (err_code == NRF_SUCCESS)
+    {
+        NRF_LOG_INST_DEBUG(p_queue->p_log, "Consumed %d elements", element_count);
+    }
+    else
+    {
+        NRF_LOG_INST_WARNING(p_queue->p_log, "Consuming %d elements failed", element_count);
+    }
+    return err_code;
+}
+
+void * nrf_queue_element_reserve(nrf_queue_t const * p_queue)
+{
+    nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+
+    return (nrf_queue_spans_reserve(p_queue, 1, spans) == 1) ? spans[0].p_data : NULL;
+}
+
+void * nrf_queue_element_peek(nrf_queue_t const * p_queue)
+{
+    nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+
+    return (nrf_queue_spans_peek(p_queue, 1, spans) == 1) ? spans[0].p_data : NULL;
+}
+
 void nrf_queue_reset(nrf_queue_t const * p_queue)
 {
     ASSERT(p_queue != NULL);
@@ -71,6 +71,9 @@ typedef struct
     volatile size_t front;          //!< Queue front index.
     volatile size_t back;           //!< Queue back index.
     size_t max_utilization;         //!< Maximum utilization of the queue.
+    size_t reserved;                //!< Number of elements reserved by @ref nrf_queue_spans_reserve.
+    size_t peeked;                  //!< Number of elements handed out by @ref nrf_queue_spans_peek.
+    size_t peeked_front;            //!< Front index at the time of @ref nrf_queue_spans_peek.
 } nrf_queue_cb_t;
 
 /**@brief Supported queue modes. */
@@ -80,6 +83,16 @@ typedef enum
     NRF_QUEUE_MODE_NO_OVERFLOW,     //!< If the queue is full, new element will not be accepted.
 } nrf_queue_mode_t;
 
+/**@brief Contiguous region of queue storage. */
+typedef struct
+{
+    void * p_data;                  //!< Pointer to the first element of the region.
+    size_t count;                   //!< Number of elements in the region.
+} nrf_queue_span_t;
+
+/**@brief Maximum number of spans describing a region of the queue. */
+#define NRF_QUEUE_SPANS_MAX 2
+
 /**@brief Instance of the queue. */
 typedef struct
 {
@@ -323,7 +336,8 @@ typedef struct
  * @param[in]   p_element           Pointer to the element that will be stored in the queue.
  *
  * @return      NRF_SUCCESS         If an element has been successfully added.
- * @return      NRF_ERROR_NO_MEM    If the queue is full (only in @ref NRF_QUEUE_MODE_NO_OVERFLOW).
+ * @return      NRF_ERROR_NO_MEM    If the queue is full (only in @ref NRF_QUEUE_MODE_NO_OVERFLOW,
+ *                                  or while elements are reserved or peeked).
  */
 ret_code_t nrf_queue_push(nrf_queue_t const * p_queue, void const * p_element);
 
@@ -410,6 +424,95 @@ size_t nrf_queue_out(nrf_queue_t const * p_queue,
                     void               * p_data,
                     size_t               element_count);
 
+/**@brief Function for reserving space for elements in the queue.
+ *
+ * @details The reserved space is handed out as up to two contiguous spans of the queue storage.
+ *          The producer fills them in place and makes the elements visible to consumers with
+ *          @ref nrf_queue_spans_commit. Only one reservation can be outstanding at a time. Until
+ *          it is committed, other write operations on the queue fail as if it was full.
+ *
+ *          In @ref NRF_QUEUE_MODE_OVERFLOW, the oldest elements are dropped to make room. Elements
+ *          handed out by @ref nrf_queue_spans_peek are never dropped. While they are held, the
+ *          queue behaves as in @ref NRF_QUEUE_MODE_NO_OVERFLOW.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Number of elements to reserve.
+ * @param[out]  p_spans             Array of @ref NRF_QUEUE_SPANS_MAX spans to be filled. Unused
+ *                                  spans have zero count.
+ *
+ * @return      The number of reserved elements. It may be lower than requested.
+ */
+size_t nrf_queue_spans_reserve(nrf_queue_t const * p_queue,
+                               size_t              element_count,
+                               nrf_queue_span_t  * p_spans);
+
+/**@brief Function for committing elements written to reserved space.
+ *
+ * @details Elements are committed in order, starting from the first reserved span. The rest
+ *          of the reservation is released.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Number of elements to commit. Cannot exceed the number of
+ *                                  reserved elements.
+ */
+void nrf_queue_spans_commit(nrf_queue_t const * p_queue, size_t element_count);
+
+/**@brief Function for accessing elements at the front of the queue in place.
+ *
+ * @details Elements stay in the queue until they are released with
+ *          @ref nrf_queue_spans_consume. Calling this function again replaces the previous
+ *          peek. Only one consumer can use this function at a time. Other read operations
+ *          must not be used on the queue while elements are held. If they are,
+ *          @ref nrf_queue_spans_consume fails.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count       Maximal number of elements to access.
+ * @param[out]  p_spans             Array of @ref NRF_QUEUE_SPANS_MAX spans to be filled. Unused
+ *                                  spans have zero count.
+ *
+ * @return      The number of elements described by the spans.
+ */
+size_t nrf_queue_spans_peek(nrf_queue_t const * p_queue,
+                            size_t              element_count,
+                            nrf_queue_span_t  * p_spans);
+
+/**@brief Function for removing peeked elements from the front of the queue.
+ *
+ * @details The peek is released also if the function fails.
+ *
+ * @param[in]   p_queue                 Pointer to the nrf_queue_t instance.
+ * @param[in]   element_count           Number of elements to remove.
+ *
+ * @return      NRF_SUCCESS             If the elements have been removed.
+ * @return      NRF_ERROR_INVALID_PARAM If more elements than peeked were to be removed.
+ * @return      NRF_ERROR_INVALID_STATE If no elements are peeked, or if the front of the queue has
+ *                                      moved since the peek because elements were read or the
+ *                                      queue was reset. No elements were removed.
+ */
+ret_code_t nrf_queue_spans_consume(nrf_queue_t const * p_queue, size_t element_count);
+
+/**@brief Function for reserving a single element in the queue.
+ *
+ * @details The element is committed with @ref nrf_queue_spans_commit. See
+ *          @ref nrf_queue_spans_reserve.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ *
+ * @return      Pointer to the element or NULL if there is no room.
+ */
+void * nrf_queue_element_reserve(nrf_queue_t const * p_queue);
+
+/**@brief Function for accessing the element at the front of the queue in place.
+ *
+ * @details The element is removed with @ref nrf_queue_spans_consume. See
+ *          @ref nrf_queue_spans_peek.
+ *
+ * @param[in]   p_queue             Pointer to the nrf_queue_t instance.
+ *
+ * @return      Pointer to the element or NULL if the queue is empty.
+ */
+void * nrf_queue_element_peek(nrf_queue_t const * p_queue);
+
 /**@brief Function for checking if the queue is full.
  *
  * @param[in]   p_queue     Pointer to the queue instance.
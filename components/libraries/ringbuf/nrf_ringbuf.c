@@ -52,6 +52,10 @@ void nrf_ringbuf_init(nrf_ringbuf_t const * p_ringbuf)
     p_ringbuf->p_cb->tmp_wr_idx = 0;
     p_ringbuf->p_cb->rd_flag   = 0;
     p_ringbuf->p_cb->wr_flag   = 0;
+    if (p_ringbuf->p_ready)
+    {
+        memset(p_ringbuf->p_ready, 0, ((p_ringbuf->bufsize_mask + 32) / 32) * sizeof(uint32_t));
+    }
 }
 
 ret_code_t nrf_ringbuf_alloc(nrf_ringbuf_t const * p_ringbuf, uint8_t * * pp_data, size_t * p_length, bool start)
@@ -237,3 +241,181 @@ ret_code_t nrf_ringbuf_free(nrf_ringbuf_t const * p_ringbuf, size_t length)
 
     return NRF_SUCCESS;
 }
+
+/* In multi-producer mode, each byte of the buffer has a commit marker bit. A byte at free-running
+ * index idx is committed when its bit is 1 on even passes over the buffer ((idx & size) == 0) and
+ * 0 on odd passes. Committing toggles the bits, so markers never have to be cleared. A byte can
+ * only be reserved again after the consumer has freed it, which in turn requires the previous
+ * pass to have been committed, so a stale marker always has the opposite value.
+ */
+
+/**
+ * @brief Function for getting the number of consecutive committed bytes starting at idx.
+ *
+ * The result is limited to the current marker word and to the end of the buffer memory.
+ */
+static uint32_t mp_ready_run_get(nrf_ringbuf_t const * p_ringbuf, uint32_t idx)
+{
+    uint32_t masked_idx = idx & p_ringbuf->bufsize_mask;
+    uint32_t bit        = masked_idx & 31;
+    uint32_t word       = p_ringbuf->p_ready[masked_idx / 32];
+    uint32_t limit      = MIN(32 - bit, p_ringbuf->bufsize_mask + 1 - masked_idx);
+
+    if (idx & (p_ringbuf->bufsize_mask + 1))
+    {
+        word = ~word;
+    }
+
+    /* Committed bytes are now 1. Count trailing ones from the starting bit. */
+    word = ~(word >> bit);
+    if (word == 0)
+    {
+        return limit;
+    }
+    uint32_t run = __CLZ(__RBIT(word));
+    return MIN(run, limit);
+}
+
+/**
+ * @brief Function for toggling commit markers of a range which does not wrap.
+ */
+static void mp_ready_toggle(nrf_ringbuf_t const * p_ringbuf, uint32_t masked_idx, uint32_t length)
+{
+    while (length > 0)
+    {
+        uint32_t bit   = masked_idx & 31;
+        uint32_t count = MIN(32 - bit, length);
+        uint32_t mask  = (count == 32) ? 0xFFFFFFFF : (((1UL << count) - 1) << bit);
+
+        UNUSED_RETURN_VALUE(nrf_atomic_u32_xor(&p_ringbuf->p_ready[masked_idx / 32], mask));
+        masked_idx += count;
+        length     -= count;
+    }
+}
+
+/**
+ * @brief Function for publishing all consecutively committed data to the consumer.
+ *
+ * Any producer can move the write index. A producer that loses the race retries from the new
+ * write index, so data committed out of order is published by whichever commit completes the
+ * sequence.
+ */
+static void mp_wr_idx_advance(nrf_ringbuf_t const * p_ringbuf)
+{
+    nrf_atomic_u32_t * p_wr_idx = (nrf_atomic_u32_t *)&p_ringbuf->p_cb->wr_idx;
+    uint32_t           wr_idx   = *p_wr_idx;
+
+    for (;;)
+    {
+        uint32_t reserved = *(volatile uint32_t *)&p_ringbuf->p_cb->tmp_wr_idx;
+        uint32_t idx      = wr_idx;
+
+        while (idx != reserved)
+        {
+            uint32_t run = mp_ready_run_get(p_ringbuf, idx);
+            if (run == 0)
+            {
+                break;
+            }
+            idx += MIN(run, reserved - idx);
+        }
+
+        if (idx == wr_idx)
+        {
+            return;
+        }
+
+        if (nrf_atomic_u32_cmp_exch(p_wr_idx, &wr_idx, idx))
+        {
+            /* Bytes committed while scanning are picked up in the next iteration. */
+            wr_idx = idx;
+        }
+    }
+}
+
+ret_code_t nrf_ringbuf_mp_alloc(nrf_ringbuf_t const * p_ringbuf, uint8_t * * pp_data, size_t * p_length)
+{
+    ASSERT(pp_data);
+    ASSERT(p_length);
+    ASSERT(p_ringbuf->p_ready);
+
+    nrf_atomic_u32_t * p_tmp_wr_idx = (nrf_atomic_u32_t *)&p_ringbuf->p_cb->tmp_wr_idx;
+    uint32_t           tmp_wr_idx   = *p_tmp_wr_idx;
+    uint32_t           length;
+
+    do
+    {
+        uint32_t masked_wr_idx = tmp_wr_idx & p_ringbuf->bufsize_mask;
+        uint32_t free_space    = p_ringbuf->bufsize_mask + 1 -
+                                 (tmp_wr_idx - *(volatile uint32_t *)&p_ringbuf->p_cb->rd_idx);
+        uint32_t trail         = p_ringbuf->bufsize_mask + 1 - masked_wr_idx;
+
+        length = MIN(*p_length, MIN(free_space, trail));
+        if (length == 0)
+        {
+            *p_length = 0;
+            return NRF_SUCCESS;
+        }
+    } while (!nrf_atomic_u32_cmp_exch(p_tmp_wr_idx, &tmp_wr_idx, tmp_wr_idx + length));
+
+    *p_length = length;
+    *pp_data  = &p_ringbuf->p_buffer[tmp_wr_idx & p_ringbuf->bufsize_mask];
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ringbuf_mp_put(nrf_ringbuf_t const * p_ringbuf, uint8_t * p_data, size_t length)
+{
+    ASSERT(p_ringbuf->p_ready);
+
+    uint32_t masked_idx = (uint32_t)(p_data - p_ringbuf->p_buffer);
+    if ((p_data < p_ringbuf->p_buffer) ||
+        (masked_idx + length > p_ringbuf->bufsize_mask + 1))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (length == 0)
+    {
+        return NRF_SUCCESS;
+    }
+
+    /* Data must be visible before the markers. Toggling marks the bytes as committed on both
+     * even and odd passes. */
+    __DMB();
+    mp_ready_toggle(p_ringbuf, masked_idx, length);
+
+    mp_wr_idx_advance(p_ringbuf);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_ringbuf_mp_cpy_put(nrf_ringbuf_t const * p_ringbuf,
+                                  uint8_t const * p_data,
+                                  size_t * p_length)
+{
+    ASSERT(p_data);
+    ASSERT(p_length);
+
+    size_t copied = 0;
+
+    for (uint32_t i = 0; (i < 2) && (copied < *p_length); i++)
+    {
+        uint8_t * p_buf;
+        size_t    length = *p_length - copied;
+
+        UNUSED_RETURN_VALUE(nrf_ringbuf_mp_alloc(p_ringbuf, &p_buf, &length));
+        if (length == 0)
+        {
+            break;
+        }
+
+        memcpy(p_buf, &p_data[copied], length);
+        UNUSED_RETURN_VALUE(nrf_ringbuf_mp_put(p_ringbuf, p_buf, length));
+        copied += length;
+    }
+
+    *p_length = copied;
+
+    return NRF_SUCCESS;
+}
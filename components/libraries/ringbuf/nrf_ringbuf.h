@@ -75,6 +75,8 @@ typedef struct
     uint8_t           * p_buffer;     //!< Pointer to the memory used by the ring buffer.
     uint32_t            bufsize_mask; //!< Buffer size mask (buffer size must be a power of 2).
     nrf_ringbuf_cb_t  * p_cb;         //!< Pointer to the instance control block.
+    uint32_t          * p_ready;      //!< Per-byte commit markers, used only in multi-producer mode
+                                      //!< (NULL for instances defined with @ref NRF_RINGBUF_DEF).
 } nrf_ringbuf_t;
 
 /**
@@ -93,6 +95,31 @@ typedef struct
             .p_cb         = &CONCAT_2(_name,_cb),                             \
     }
 
+/**
+ * @brief Macro for defining a multi-producer ring buffer instance.
+ *
+ * Instances defined with this macro can be written concurrently from several contexts
+ * (for example, interrupts of different priorities) with @ref nrf_ringbuf_mp_alloc,
+ * @ref nrf_ringbuf_mp_put and @ref nrf_ringbuf_mp_cpy_put. Reading is done by a single consumer
+ * with the regular @ref nrf_ringbuf_get and @ref nrf_ringbuf_free functions.
+ *
+ * In addition to the buffer, one bit per byte of buffer is allocated to mark committed data.
+ *
+ * @param _name Instance name.
+ * @param _size Size of the ring buffer (must be a power of 2).
+ * */
+#define NRF_RINGBUF_MP_DEF(_name, _size)                                      \
+    STATIC_ASSERT(IS_POWER_OF_TWO(_size));                                    \
+    static uint8_t CONCAT_2(_name,_buf)[_size];                               \
+    static uint32_t CONCAT_2(_name,_ready)[((_size) + 31) / 32];              \
+    static nrf_ringbuf_cb_t CONCAT_2(_name,_cb);                              \
+    static const nrf_ringbuf_t _name = {                                      \
+            .p_buffer = CONCAT_2(_name,_buf),                                 \
+            .bufsize_mask = _size - 1,                                        \
+            .p_cb         = &CONCAT_2(_name,_cb),                             \
+            .p_ready      = CONCAT_2(_name,_ready),                           \
+    }
+
 /**
  * @brief Function for initializing a ring buffer instance.
  *
@@ -150,6 +177,61 @@ ret_code_t nrf_ringbuf_cpy_put(nrf_ringbuf_t const * p_ringbuf,
                                uint8_t const* p_data,
                                size_t * p_length);
 
+/**
+ * @brief Function for allocating memory from a multi-producer ring buffer.
+ *
+ * This function reserves a contiguous part of the ring buffer without locking. It can be called
+ * concurrently from any number of contexts, including interrupts that preempt each other. The
+ * requested amount or a smaller amount is reserved, limited by the free space and by the end of
+ * the buffer memory.
+ *
+ * Every reservation must be committed with @ref nrf_ringbuf_mp_put. Reservations may be committed
+ * in any order. Data becomes available to the consumer in reservation order, as soon as all earlier
+ * reservations have been committed.
+ *
+ * @note Only instances defined with @ref NRF_RINGBUF_MP_DEF can be used. Multi-producer functions
+ *       must not be mixed with @ref nrf_ringbuf_alloc, @ref nrf_ringbuf_put and
+ *       @ref nrf_ringbuf_cpy_put on the same instance.
+ *
+ * @param[in] p_ringbuf      Pointer to the ring buffer instance.
+ * @param[out] pp_data       Pointer to the pointer to the allocated buffer.
+ * @param[in, out] p_length  Pointer to length. Length is set to the requested amount and filled
+ *                           by the function with actually allocated amount (0 if full).
+ *
+ * @retval NRF_SUCCESS       Successful allocation (can be smaller amount than requested).
+ */
+ret_code_t nrf_ringbuf_mp_alloc(nrf_ringbuf_t const * p_ringbuf, uint8_t * * pp_data, size_t * p_length);
+
+/**
+ * @brief Function for committing data allocated from a multi-producer ring buffer.
+ *
+ * The whole buffer returned by @ref nrf_ringbuf_mp_alloc must be committed at once.
+ *
+ * @param[in] p_ringbuf      Pointer to the ring buffer instance.
+ * @param[in] p_data         Pointer to the buffer returned by @ref nrf_ringbuf_mp_alloc.
+ * @param[in] length         Length returned by @ref nrf_ringbuf_mp_alloc.
+ *
+ * @retval NRF_SUCCESS             Data committed.
+ * @retval NRF_ERROR_INVALID_PARAM Buffer does not belong to the ring buffer.
+ */
+ret_code_t nrf_ringbuf_mp_put(nrf_ringbuf_t const * p_ringbuf, uint8_t * p_data, size_t length);
+
+/**
+ * @brief Function for copying data into a multi-producer ring buffer.
+ *
+ * Data is copied in at most two reservations, so data from concurrent producers can be
+ * interleaved with it when the copy wraps around the end of the buffer memory.
+ *
+ * @param[in] p_ringbuf       Pointer to the ring buffer instance.
+ * @param[in] p_data          Pointer to the input buffer.
+ * @param[in, out] p_length   Amount of bytes to copy. Amount of bytes copied.
+ *
+ * @return  NRF_SUCCESS on successful put or error.
+ */
+ret_code_t nrf_ringbuf_mp_cpy_put(nrf_ringbuf_t const * p_ringbuf,
+                                  uint8_t const * p_data,
+                                  size_t * p_length);
+
 
 /**
  * Function for getting data from the ring buffer.
@@ -46,6 +46,270 @@
 #include "nrf_soc.h"
 #include "nrf_assert.h"
 #include "app_util_platform.h"
+#if APP_SCHEDULER_WITH_PRIORITIES
+#include "nrf_atomic.h"
+#endif
+
+#if APP_SCHEDULER_WITH_PAUSE
+static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the difference between pausing
+                                                     and resuming the scheduler. */
+#endif
+
+#if APP_SCHEDULER_WITH_PRIORITIES
+/**@brief Structure for holding a scheduled event header. */
+typedef struct
+{
+    app_sched_event_handler_t handler;          /**< Pointer to event handler to receive the event. */
+    uint16_t                  event_data_size;  /**< Size of event data. */
+    volatile uint8_t          ready;            /**< Set by the producer once the entry is filled. */
+#if APP_SCHEDULER_WITH_PROFILER
+    uint32_t                  timestamp;        /**< Time at which the event was scheduled. */
+#endif
+} event_header_t;
+
+STATIC_ASSERT(sizeof(event_header_t) <= APP_SCHED_EVENT_HEADER_SIZE);
+STATIC_ASSERT(APP_SCHED_DEFAULT_PRIORITY < APP_SCHED_PRIORITY_LEVELS);
+
+/**@brief Structure for holding the queue of one priority level.
+ *
+ * @details Producers reserve an entry by moving @p end_index forward with a compare-and-exchange,
+ *          fill it in and then set its @p ready flag. The only consumer is @ref app_sched_execute,
+ *          which is the only place where @p start_index is moved forward.
+ */
+typedef struct
+{
+    event_header_t   * p_headers;           /**< Array for holding the queue event headers. */
+    uint8_t          * p_data;              /**< Array for holding the queue event data. */
+    nrf_atomic_u32_t   start_index;         /**< Index of queue entry at the start of the queue. */
+    nrf_atomic_u32_t   end_index;           /**< Index of queue entry at the end of the queue. */
+    uint16_t           starve_cnt;          /**< Number of events of higher priority executed while
+                                                 this queue was waiting. */
+#if APP_SCHEDULER_WITH_PROFILER
+    nrf_atomic_u32_t   max_utilization;     /**< Maximum observed queue utilization. */
+    uint32_t           executed;            /**< Number of executed events. */
+    uint32_t           starved;             /**< Number of events executed by the starvation guard. */
+    uint32_t           max_latency;         /**< Maximum observed queue latency. */
+    uint64_t           total_latency;       /**< Sum of the queue latency of all executed events. */
+#endif
+} sched_queue_t;
+
+static sched_queue_t m_queues[APP_SCHED_PRIORITY_LEVELS];   /**< Queues, highest priority first. */
+static uint16_t      m_queue_event_size;                    /**< Maximum event size in queue. */
+static uint16_t      m_queue_size;                          /**< Number of queue entries. */
+
+#if APP_SCHEDULER_WITH_PROFILER
+static app_sched_timestamp_func_t m_timestamp_func;         /**< Time source for latency statistics. */
+#endif
+
+/**@brief Function for incrementing a queue index, and handle wrap-around.
+ *
+ * @param[in]   index   Old index.
+ *
+ * @return      New (incremented) index.
+ */
+static __INLINE uint32_t next_index(uint32_t index)
+{
+    return (index < m_queue_size) ? (index + 1) : 0;
+}
+
+
+/**@brief Function for getting the number of entries in use in a queue.
+ *
+ * @param[in]   start   Index of queue entry at the start of the queue.
+ * @param[in]   end     Index of queue entry at the end of the queue.
+ *
+ * @return      Number of entries in use.
+ */
+static __INLINE uint16_t queue_utilization(uint32_t start, uint32_t end)
+{
+    return (end >= start) ? (end - start) : (m_queue_size + 1 - start + end);
+}
+
+
+/**@brief Function for checking if the entry at the start of a queue is ready for execution.
+ *
+ * @details An entry may be reserved but not yet filled only while the producer that reserved it
+ *          is preempted, so a reserved entry is never skipped, only delayed.
+ */
+static __INLINE bool queue_ready(sched_queue_t const * p_queue)
+{
+    uint32_t start = p_queue->start_index;
+
+    return (start != p_queue->end_index) && p_queue->p_headers[start].ready;
+}
+
+
+uint32_t app_sched_init(uint16_t event_size, uint16_t queue_size, void * p_event_buffer)
+{
+    event_header_t * p_headers = p_event_buffer;
+    uint8_t        * p_data    = (uint8_t *)&p_headers[(queue_size + 1) * APP_SCHED_PRIORITY_LEVELS];
+
+    // Check that buffer is correctly aligned
+    if (!is_word_aligned(p_event_buffer))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // Initialize event scheduler
+    m_queue_event_size = event_size;
+    m_queue_size       = queue_size;
+
+    memset(m_queues, 0, sizeof(m_queues));
+    memset(p_headers, 0, (queue_size + 1) * APP_SCHED_PRIORITY_LEVELS * sizeof(event_header_t));
+
+    for (uint32_t i = 0; i < APP_SCHED_PRIORITY_LEVELS; i++)
+    {
+        m_queues[i].p_headers = &p_headers[i * (queue_size + 1)];
+        m_queues[i].p_data    = &p_data[i * (queue_size + 1) * event_size];
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint16_t app_sched_queue_space_get()
+{
+    sched_queue_t * p_queue = &m_queues[APP_SCHED_DEFAULT_PRIORITY];
+
+    return m_queue_size - queue_utilization(p_queue->start_index, p_queue->end_index);
+}
+
+
+#if APP_SCHEDULER_WITH_PROFILER
+static void queue_utilization_check(sched_queue_t * p_queue, uint32_t end)
+{
+    uint32_t utilization = queue_utilization(p_queue->start_index, end);
+    uint32_t max         = p_queue->max_utilization;
+
+    // Producers do not disable interrupts, so the maximum is updated with compare-and-exchange.
+    while (utilization > max)
+    {
+        if (nrf_atomic_u32_cmp_exch(&p_queue->max_utilization, &max, utilization))
+        {
+            break;
+        }
+    }
+}
+
+uint16_t app_sched_queue_utilization_get(void)
+{
+    uint16_t max = 0;
+
+    for (uint32_t i = 0; i < APP_SCHED_PRIORITY_LEVELS; i++)
+    {
+        max = MAX(max, m_queues[i].max_utilization);
+    }
+
+    return max;
+}
+
+void app_sched_timestamp_func_set(app_sched_timestamp_func_t timestamp_func)
+{
+    m_timestamp_func = timestamp_func;
+}
+
+uint32_t app_sched_prio_stats_get(uint8_t priority, app_sched_prio_stats_t * p_stats, bool reset)
+{
+    if (priority >= APP_SCHED_PRIORITY_LEVELS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    sched_queue_t * p_queue = &m_queues[priority];
+
+    p_stats->max_utilization = p_queue->max_utilization;
+    p_stats->executed        = p_queue->executed;
+    p_stats->starved         = p_queue->starved;
+    p_stats->max_latency     = p_queue->max_latency;
+    p_stats->avg_latency     = (p_queue->executed > 0) ?
+                               (uint32_t)(p_queue->total_latency / p_queue->executed) : 0;
+
+    if (reset)
+    {
+        (void)nrf_atomic_u32_store(&p_queue->max_utilization, 0);
+        p_queue->executed      = 0;
+        p_queue->starved       = 0;
+        p_queue->max_latency   = 0;
+        p_queue->total_latency = 0;
+    }
+
+    return NRF_SUCCESS;
+}
+#endif // APP_SCHEDULER_WITH_PROFILER
+
+
+uint32_t app_sched_event_put_prio(void const              * p_event_data,
+                                  uint16_t                  event_data_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority)
+{
+    if (priority >= APP_SCHED_PRIORITY_LEVELS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    if (event_data_size > m_queue_event_size)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    sched_queue_t * p_queue = &m_queues[priority];
+    uint32_t        event_index = p_queue->end_index;
+    uint32_t        end_index;
+
+    // Reserve an entry. The index cannot return to its old value while this context is
+    // preempted, because the consumer runs in the main loop and the queue cannot wrap past it.
+    do
+    {
+        end_index = next_index(event_index);
+        if (end_index == p_queue->start_index)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+    } while (!nrf_atomic_u32_cmp_exch(&p_queue->end_index, &event_index, end_index));
+
+#if APP_SCHEDULER_WITH_PROFILER
+    queue_utilization_check(p_queue, end_index);
+#endif
+
+    event_header_t * p_header = &p_queue->p_headers[event_index];
+
+#if APP_SCHEDULER_WITH_PROFILER
+    p_header->timestamp = (m_timestamp_func != NULL) ? m_timestamp_func() : 0;
+#endif
+
+    p_header->handler = handler;
+    if ((p_event_data != NULL) && (event_data_size > 0))
+    {
+        memcpy(&p_queue->p_data[event_index * m_queue_event_size],
+               p_event_data,
+               event_data_size);
+        p_header->event_data_size = event_data_size;
+    }
+    else
+    {
+        p_header->event_data_size = 0;
+    }
+
+    // Publish the entry only after it has been completely written.
+    __DMB();
+    p_header->ready = 1;
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t app_sched_event_put(void const              * p_event_data,
+                             uint16_t                  event_data_size,
+                             app_sched_event_handler_t handler)
+{
+    return app_sched_event_put_prio(p_event_data,
+                                    event_data_size,
+                                    handler,
+                                    APP_SCHED_DEFAULT_PRIORITY);
+}
+
+#else
 
 /**@brief Structure for holding a scheduled event header. */
 typedef struct
@@ -67,11 +331,6 @@ static uint16_t         m_queue_size;           /**< Number of queue entries. */
 static uint16_t m_max_queue_utilization;    /**< Maximum observed queue utilization. */
 #endif
 
-#if APP_SCHEDULER_WITH_PAUSE
-static uint32_t m_scheduler_paused_counter = 0; /**< Counter storing the difference between pausing
-                                                     and resuming the scheduler. */
-#endif
-
 /**@brief Function for incrementing a queue index, and handle wrap-around.
  *
  * @param[in]   index   Old index.
@@ -219,6 +478,8 @@ uint32_t app_sched_event_put(void const              * p_event_data,
     return err_code;
 }
 
+#endif // APP_SCHEDULER_WITH_PRIORITIES
+
 
 #if APP_SCHEDULER_WITH_PAUSE
 void app_sched_pause(void)
@@ -260,6 +521,97 @@ static __INLINE bool is_app_sched_paused(void)
 }
 
 
+#if APP_SCHEDULER_WITH_PRIORITIES
+/**@brief Function for selecting the queue from which the next event is executed.
+ *
+ * @details The queue with the highest priority is selected, unless a lower-priority queue has
+ *          waited for @ref APP_SCHEDULER_STARVATION_LIMIT events. In that case the highest
+ *          priority queue among the starved ones is selected.
+ *
+ * @return      Pointer to the selected queue, or NULL if there is nothing to execute.
+ */
+static sched_queue_t * queue_select(void)
+{
+    sched_queue_t * p_selected = NULL;
+
+    for (uint32_t i = 0; i < APP_SCHED_PRIORITY_LEVELS; i++)
+    {
+        sched_queue_t * p_queue = &m_queues[i];
+
+        if (!queue_ready(p_queue))
+        {
+            continue;
+        }
+
+        if (p_selected == NULL)
+        {
+            p_selected = p_queue;
+
+            // Starved levels below are only promoted over a level that is not starved itself.
+            if (p_queue->starve_cnt >= APP_SCHEDULER_STARVATION_LIMIT)
+            {
+                break;
+            }
+        }
+        else if (p_queue->starve_cnt >= APP_SCHEDULER_STARVATION_LIMIT)
+        {
+        #if APP_SCHEDULER_WITH_PROFILER
+            p_queue->starved++;
+        #endif
+            p_selected = p_queue;
+            break;
+        }
+    }
+
+    return p_selected;
+}
+
+
+void app_sched_execute(void)
+{
+    sched_queue_t * p_queue;
+
+    while (!is_app_sched_paused() && ((p_queue = queue_select()) != NULL))
+    {
+        uint32_t         event_index = p_queue->start_index;
+        event_header_t * p_header    = &p_queue->p_headers[event_index];
+
+    #if APP_SCHEDULER_WITH_PROFILER
+        if (m_timestamp_func != NULL)
+        {
+            uint32_t latency = m_timestamp_func() - p_header->timestamp;
+
+            p_queue->max_latency    = MAX(p_queue->max_latency, latency);
+            p_queue->total_latency += latency;
+        }
+        p_queue->executed++;
+    #endif
+
+        p_header->handler(&p_queue->p_data[event_index * m_queue_event_size],
+                          p_header->event_data_size);
+
+        // Every lower-priority queue that is still waiting gets one step closer to the
+        // starvation guard.
+        p_queue->starve_cnt = 0;
+        for (sched_queue_t * p_lower = p_queue + 1;
+             p_lower < &m_queues[APP_SCHED_PRIORITY_LEVELS];
+             p_lower++)
+        {
+            if (queue_ready(p_lower) && (p_lower->starve_cnt < UINT16_MAX))
+            {
+                p_lower->starve_cnt++;
+            }
+        }
+
+        // Event processed, now it is safe to release the entry and move the queue start index,
+        // so the queue entry occupied by this event can be used to store a next one.
+        p_header->ready = 0;
+        __DMB();
+        (void)nrf_atomic_u32_store(&p_queue->start_index, next_index(event_index));
+    }
+}
+
+#else
 void app_sched_execute(void)
 {
     while (!is_app_sched_paused() && !APP_SCHED_QUEUE_EMPTY())
@@ -285,4 +637,5 @@ void app_sched_execute(void)
         m_queue_start_index = next_index(m_queue_start_index);
     }
 }
+#endif // APP_SCHEDULER_WITH_PRIORITIES
 #endif //NRF_MODULE_ENABLED(APP_SCHEDULER)
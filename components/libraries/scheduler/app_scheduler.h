@@ -79,6 +79,7 @@
 
 #include "sdk_config.h"
 #include <stdint.h>
+#include <stdbool.h>
 #include "app_error.h"
 #include "app_util.h"
 
@@ -86,22 +87,57 @@
 extern "C" {
 #endif
 
+/* The header holds a function pointer. Targets with 64-bit pointers must define a larger size. */
+#ifndef APP_SCHED_EVENT_HEADER_SIZE
+#if APP_SCHEDULER_WITH_PRIORITIES && APP_SCHEDULER_WITH_PROFILER
+#define APP_SCHED_EVENT_HEADER_SIZE 12      /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+#else
 #define APP_SCHED_EVENT_HEADER_SIZE 8       /**< Size of app_scheduler.event_header_t (only for use inside APP_SCHED_BUF_SIZE()). */
+#endif
+#endif
+
+#if APP_SCHEDULER_WITH_PRIORITIES
+#define APP_SCHED_PRIORITY_LEVELS  APP_SCHEDULER_PRIORITY_LEVELS   /**< Number of priority levels. */
+#define APP_SCHED_DEFAULT_PRIORITY APP_SCHEDULER_DEFAULT_PRIORITY  /**< Priority used by @ref app_sched_event_put. */
+#else
+#define APP_SCHED_PRIORITY_LEVELS  1
+#define APP_SCHED_DEFAULT_PRIORITY 0
+#endif
 
 /**@brief Compute number of bytes required to hold the scheduler buffer.
  *
  * @param[in] EVENT_SIZE   Maximum size of events to be passed through the scheduler.
  * @param[in] QUEUE_SIZE   Number of entries in scheduler queue (i.e. the maximum number of events
- *                         that can be scheduled for execution).
+ *                         that can be scheduled for execution). When
+ *                         @ref APP_SCHEDULER_WITH_PRIORITIES is enabled, each priority level has
+ *                         a queue of this size.
  *
  * @return    Required scheduler buffer size (in bytes).
  */
 #define APP_SCHED_BUF_SIZE(EVENT_SIZE, QUEUE_SIZE)                                                 \
-            (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1))
+            (((EVENT_SIZE) + APP_SCHED_EVENT_HEADER_SIZE) * ((QUEUE_SIZE) + 1) *                   \
+             APP_SCHED_PRIORITY_LEVELS)
 
 /**@brief Scheduler event handler type. */
 typedef void (*app_sched_event_handler_t)(void * p_event_data, uint16_t event_size);
 
+/**@brief Scheduler timestamp function type.
+ *
+ * @details The returned value must be a free-running counter that wraps around at 2^32.
+ */
+typedef uint32_t (*app_sched_timestamp_func_t)(void);
+
+/**@brief Per-priority queue statistics. */
+typedef struct
+{
+    uint16_t max_utilization;   /**< Maximum number of events in the queue observed so far. */
+    uint32_t executed;          /**< Number of executed events. */
+    uint32_t starved;           /**< Number of events executed ahead of higher-priority events by
+                                     the starvation guard. */
+    uint32_t max_latency;       /**< Maximum time from scheduling to execution, in timestamp ticks. */
+    uint32_t avg_latency;       /**< Average time from scheduling to execution, in timestamp ticks. */
+} app_sched_prio_stats_t;
+
 /**@brief Macro for initializing the event scheduler.
  *
  * @details It will also handle dimensioning and allocation of the memory buffer required by the
@@ -164,22 +200,70 @@ uint32_t app_sched_event_put(void const *              p_event_data,
                              uint16_t                  event_size,
                              app_sched_event_handler_t handler);
 
+/**@brief Function for scheduling an event with a given priority.
+ *
+ * @details Puts an event into the event queue of the given priority. The queue entry is reserved
+ *          with an atomic compare-and-exchange, so interrupts are never disabled and this function
+ *          can be called from any interrupt priority.
+ *
+ * @note @ref APP_SCHEDULER_WITH_PRIORITIES must be enabled to use this functionality.
+ *
+ * @param[in]   p_event_data   Pointer to event data to be scheduled.
+ * @param[in]   event_size     Size of event data to be scheduled.
+ * @param[in]   handler        Event handler to receive the event.
+ * @param[in]   priority       Event priority. 0 is the highest priority.
+ *
+ * @retval      NRF_SUCCESS                 The event was scheduled.
+ * @retval      NRF_ERROR_INVALID_PARAM     Invalid priority.
+ * @retval      NRF_ERROR_INVALID_LENGTH    Event data too large.
+ * @retval      NRF_ERROR_NO_MEM            The queue of the given priority is full.
+ */
+uint32_t app_sched_event_put_prio(void const *              p_event_data,
+                                  uint16_t                  event_size,
+                                  app_sched_event_handler_t handler,
+                                  uint8_t                   priority);
+
 /**@brief Function for getting the maximum observed queue utilization.
  *
  * Function for tuning the module and determining QUEUE_SIZE value and thus module RAM usage.
  *
  * @note @ref APP_SCHEDULER_WITH_PROFILER must be enabled to use this functionality.
  *
- * @return Maximum number of events in queue observed so far.
+ * @return Maximum number of events in queue observed so far. When
+ *         @ref APP_SCHEDULER_WITH_PRIORITIES is enabled, the maximum over all priority levels.
  */
 uint16_t app_sched_queue_utilization_get(void);
 
+/**@brief Function for setting the time source used for the queue latency statistics.
+ *
+ * @note @ref APP_SCHEDULER_WITH_PRIORITIES and @ref APP_SCHEDULER_WITH_PROFILER must be enabled
+ *       to use this functionality.
+ *
+ * @param[in]   timestamp_func   Timestamp function. NULL disables latency measurement.
+ */
+void app_sched_timestamp_func_set(app_sched_timestamp_func_t timestamp_func);
+
+/**@brief Function for getting the statistics of one priority level.
+ *
+ * @note @ref APP_SCHEDULER_WITH_PRIORITIES and @ref APP_SCHEDULER_WITH_PROFILER must be enabled
+ *       to use this functionality.
+ *
+ * @param[in]   priority   Priority level.
+ * @param[out]  p_stats    Statistics.
+ * @param[in]   reset      True to reset the statistics after reading them.
+ *
+ * @retval      NRF_SUCCESS               Statistics were read.
+ * @retval      NRF_ERROR_INVALID_PARAM   Invalid priority.
+ */
+uint32_t app_sched_prio_stats_get(uint8_t priority, app_sched_prio_stats_t * p_stats, bool reset);
+
 /**@brief Function for getting the current amount of free space in the queue.
  *
  * @details The real amount of free space may be less if entries are being added from an interrupt.
  *          To get the sxact value, this function should be called from the critical section.
  *
- * @return Amount of free space in the queue.
+ * @return Amount of free space in the queue. When @ref APP_SCHEDULER_WITH_PRIORITIES is enabled,
+ *         the free space in the queue of the default priority.
  */
 uint16_t app_sched_queue_space_get(void);
 
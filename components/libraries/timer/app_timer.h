@@ -73,8 +73,10 @@
 #include "nordic_common.h"
 #ifdef APP_TIMER_V2
 #include "nrf_log_instance.h"
+#if !APP_TIMER_CONFIG_USE_HEAP
 #include "nrf_sortlist.h"
 #endif
+#endif
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -133,14 +135,32 @@ extern "C" {
 typedef void (*app_timer_timeout_handler_t)(void * p_context);
 
 #ifdef APP_TIMER_V2
+#if APP_TIMER_CONFIG_USE_HEAP
+/**
+ * @brief Pairing heap node used to queue active timers.
+ */
+typedef struct app_timer_heap_item_s
+{
+    struct app_timer_heap_item_s * p_child; /**< Leftmost child. */
+    struct app_timer_heap_item_s * p_next;  /**< Right sibling. */
+    struct app_timer_heap_item_s * p_prev;  /**< Left sibling, or parent for the leftmost child. NULL if not in the heap. */
+} app_timer_heap_item_t;
+#endif
+
 /**
  * @brief app_timer control block
  */
 typedef struct
 {
+#if APP_TIMER_CONFIG_USE_HEAP
+    app_timer_heap_item_t       heap_item;     /**< Token used by the timer heap. */
+#else
     nrf_sortlist_item_t         list_item;     /**< Token used by sortlist. */
+#endif
     uint64_t                    end_val;       /**< RTC counter value when timer expires or @ref APP_TIMER_IDLE_VAL. */
     uint32_t                    repeat_period; /**< Repeat period (0 if single shot mode). */
+    uint32_t                    slack;         /**< Number of ticks the expiry may be deferred to coalesce it with other timers. */
+    uint32_t                    slack_offset;  /**< Number of ticks end_val was deferred by from the nominal expiry. */
     app_timer_timeout_handler_t handler;       /**< User handler. */
     void *                      p_context;     /**< User context. */
     NRF_LOG_INSTANCE_PTR_DECLARE(p_log)        /**< Pointer to instance of the logger object (Conditionally compiled). */
@@ -295,6 +315,44 @@ uint32_t app_timer_cnt_diff_compute(uint32_t   ticks_to,
  */
 uint8_t app_timer_op_queue_utilization_get(void);
 
+#ifdef APP_TIMER_V2
+/**@brief Timer wakeup statistics. */
+typedef struct
+{
+    uint32_t wakeups;     /**< Number of RTC compare interrupts that expired timers. */
+    uint32_t expirations; /**< Number of timer expirations. Higher than @p wakeups when expiries are coalesced. */
+    uint32_t period_ms;   /**< Length of the measurement period (in milliseconds). */
+} app_timer_wakeup_stats_t;
+
+/**@brief Function for setting the slack of a timer.
+ *
+ * The slack is the number of ticks by which the expiry of the timer may be deferred. Expiries
+ * are deferred to the most aligned tick within the allowed window, so that timers whose windows
+ * overlap expire at the same tick and are served in a single wakeup. Repeated timers do not drift:
+ * each period is computed from the nominal expiry.
+ *
+ * @note The slack takes effect the next time the timer is started or repeats. It is reset to 0
+ *       by @ref app_timer_create.
+ *
+ * @param[in]  timer_id                  Timer identifier.
+ * @param[in]  slack_ticks               Tolerance (in ticks). 0 for an exact expiry (default).
+ *
+ * @retval     NRF_SUCCESS               If the slack was set.
+ */
+ret_code_t app_timer_slack_set(app_timer_id_t timer_id, uint32_t slack_ticks);
+
+/**@brief Function for getting the timer wakeup statistics.
+ *
+ * The number of wakeups per second is @p wakeups * 1000 / @p period_ms.
+ *
+ * @note APP_TIMER_WITH_PROFILER must be enabled to use this functionality.
+ *
+ * @param[out] p_stats  Statistics gathered since initialization or the last reset.
+ * @param[in]  reset    True to start a new measurement period.
+ */
+void app_timer_wakeup_stats_get(app_timer_wakeup_stats_t * p_stats, bool reset);
+#endif // APP_TIMER_V2
+
 /**
  * @brief Function for pausing RTC activity which drives app_timer.
  *
@@ -39,7 +39,9 @@
  */
 #include "app_timer.h"
 #include "nrf_atfifo.h"
+#if !APP_TIMER_CONFIG_USE_HEAP
 #include "nrf_sortlist.h"
+#endif
 #include "nrf_delay.h"
 #if APP_TIMER_WITH_PROFILER
 #include "app_util_platform.h"
@@ -77,6 +79,9 @@ static drv_rtc_t m_rtc_inst = DRV_RTC_INSTANCE(1);
 #if APP_TIMER_WITH_PROFILER
 static uint8_t m_max_user_op_queue_utilization;     /**< Maximum observed timer user operations queue utilization. */
 static uint8_t m_current_user_op_queue_utilization; /**< Currently observed timer user operations queue utilization. */
+static uint32_t m_wakeup_cnt;                       /**< Number of compare interrupts that expired timers. */
+static uint32_t m_expiration_cnt;                   /**< Number of timer expirations. */
+static uint64_t m_wakeup_stats_start;               /**< Timestamp of the start of the measurement period. */
 #endif /* APP_TIMER_WITH_PROFILER */
 
 /**
@@ -106,9 +111,13 @@ static uint64_t m_stamp64;
 /* Request FIFO instance. */
 NRF_ATFIFO_DEF(m_req_fifo, timer_req_t, APP_TIMER_CONFIG_OP_QUEUE_SIZE);
 
+#if APP_TIMER_CONFIG_USE_HEAP
+static app_timer_heap_item_t * m_heap_root; /**< Root of the pairing heap used for storing queued timers. */
+#else
 /* Sortlist instance. */
 static bool compare_func(nrf_sortlist_item_t * p_item0, nrf_sortlist_item_t *p_item1);
 NRF_SORTLIST_DEF(m_app_timer_sortlist, compare_func); /**< Sortlist used for storing queued timers. */
+#endif
 
 /**
  * @brief Return current 64 bit timestamp
@@ -127,6 +136,161 @@ static uint64_t get_now(void)
 
     return now;
 }
+
+#if APP_TIMER_CONFIG_USE_HEAP
+static inline uint64_t heap_item_end_val(app_timer_heap_item_t const * p_item)
+{
+    app_timer_t const * p_timer = CONTAINER_OF(p_item, app_timer_t, heap_item);
+    return p_timer->end_val;
+}
+
+/**
+ * @brief Function for linking two heaps. The root with the later timeout becomes the leftmost child
+ *        of the other one.
+ *
+ * @return Root of the resulting heap. Its sibling and parent links are cleared.
+ */
+static app_timer_heap_item_t * heap_meld(app_timer_heap_item_t * p_a, app_timer_heap_item_t * p_b)
+{
+    if (p_a == NULL)
+    {
+        return p_b;
+    }
+    if (p_b == NULL)
+    {
+        return p_a;
+    }
+
+    if (heap_item_end_val(p_b) < heap_item_end_val(p_a))
+    {
+        app_timer_heap_item_t * p_tmp = p_a;
+        p_a = p_b;
+        p_b = p_tmp;
+    }
+
+    p_b->p_prev = p_a;
+    p_b->p_next = p_a->p_child;
+    if (p_a->p_child)
+    {
+        p_a->p_child->p_prev = p_b;
+    }
+    p_a->p_child = p_b;
+    p_a->p_next  = NULL;
+    p_a->p_prev  = NULL;
+
+    return p_a;
+}
+
+/**
+ * @brief Function for merging a list of sibling heaps into one heap (two-pass pairing).
+ */
+static app_timer_heap_item_t * heap_merge_pairs(app_timer_heap_item_t * p_first)
+{
+    app_timer_heap_item_t * p_pairs = NULL;
+    app_timer_heap_item_t * p_root  = NULL;
+
+    /* First pass: meld siblings in pairs from left to right, stacking the results. */
+    while (p_first)
+    {
+        app_timer_heap_item_t * p_a = p_first;
+        app_timer_heap_item_t * p_b = p_a->p_next;
+        app_timer_heap_item_t * p_m;
+
+        p_first = p_b ? p_b->p_next : NULL;
+        p_a->p_next = NULL;
+        p_a->p_prev = NULL;
+        if (p_b)
+        {
+            p_b->p_next = NULL;
+            p_b->p_prev = NULL;
+        }
+
+        p_m = heap_meld(p_a, p_b);
+        p_m->p_next = p_pairs;
+        p_pairs     = p_m;
+    }
+
+    /* Second pass: meld the pairs from right to left. */
+    while (p_pairs)
+    {
+        app_timer_heap_item_t * p_m = p_pairs;
+
+        p_pairs     = p_m->p_next;
+        p_m->p_next = NULL;
+        p_root      = heap_meld(p_root, p_m);
+    }
+
+    return p_root;
+}
+
+static inline void timer_queue_add(app_timer_t * p_timer)
+{
+    app_timer_heap_item_t * p_item = &p_timer->heap_item;
+
+    p_item->p_child = NULL;
+    p_item->p_next  = NULL;
+    p_item->p_prev  = NULL;
+    m_heap_root = heap_meld(m_heap_root, p_item);
+}
+
+static inline app_timer_t * timer_queue_peek(void)
+{
+    return m_heap_root ? CONTAINER_OF(m_heap_root, app_timer_t, heap_item) : NULL;
+}
+
+static inline app_timer_t * timer_queue_pop(void)
+{
+    app_timer_heap_item_t * p_root = m_heap_root;
+
+    if (p_root == NULL)
+    {
+        return NULL;
+    }
+
+    m_heap_root = heap_merge_pairs(p_root->p_child);
+    p_root->p_child = NULL;
+
+    return CONTAINER_OF(p_root, app_timer_t, heap_item);
+}
+
+static bool timer_queue_remove(app_timer_t * p_timer)
+{
+    app_timer_heap_item_t * p_item = &p_timer->heap_item;
+
+    if (p_item == m_heap_root)
+    {
+        UNUSED_RETURN_VALUE(timer_queue_pop());
+        return true;
+    }
+
+    if (p_item->p_prev == NULL)
+    {
+        /* Not in the heap. */
+        return false;
+    }
+
+    /* Unlink the subtree from its parent or left sibling. */
+    if (p_item->p_prev->p_child == p_item)
+    {
+        p_item->p_prev->p_child = p_item->p_next;
+    }
+    else
+    {
+        p_item->p_prev->p_next = p_item->p_next;
+    }
+    if (p_item->p_next)
+    {
+        p_item->p_next->p_prev = p_item->p_prev;
+    }
+    p_item->p_next = NULL;
+    p_item->p_prev = NULL;
+
+    m_heap_root = heap_meld(m_heap_root, heap_merge_pairs(p_item->p_child));
+    p_item->p_child = NULL;
+
+    return true;
+}
+#else
 /**
  * @brief Function used for comparing items in sorted list.
  */
@@ -140,6 +304,60 @@ static inline bool compare_func(nrf_sortlist_item_t * p_item0, nrf_sortlist_item
     return (p0_end <= p1_end) ? true : false;
 }
 
+static inline void timer_queue_add(app_timer_t * p_timer)
+{
+    nrf_sortlist_add(&m_app_timer_sortlist, &p_timer->list_item);
+}
+
+static inline app_timer_t * timer_queue_pop(void)
+{
+    nrf_sortlist_item_t * p_next_item = nrf_sortlist_pop(&m_app_timer_sortlist);
+    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
+}
+
+static inline app_timer_t * timer_queue_peek(void)
+{
+    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_peek(&m_app_timer_sortlist);
+    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
+}
+
+static inline bool timer_queue_remove(app_timer_t * p_timer)
+{
+    return nrf_sortlist_remove(&m_app_timer_sortlist, &p_timer->list_item);
+}
+#endif // APP_TIMER_CONFIG_USE_HEAP
+
+/**
+ * @brief Function for setting the expiry of a timer, deferred within the timer slack.
+ *
+ * The expiry is moved to the tick with the most trailing zero bits in the range
+ * [nominal, nominal + slack]. Timers with overlapping windows therefore converge on the same tick
+ * and are expired in the same RTC interrupt.
+ *
+ * @param p_timer Timer instance.
+ * @param nominal Nominal expiry.
+ */
+static void timer_end_val_set(app_timer_t * p_timer, uint64_t nominal)
+{
+    uint64_t end_val = nominal;
+
+    if (p_timer->slack)
+    {
+        uint64_t limit = nominal + p_timer->slack;
+        uint64_t mask  = nominal ^ limit;
+
+        /* Keep the most significant bit that differs and clear all bits below it. */
+        while (mask & (mask - 1))
+        {
+            mask &= mask - 1;
+        }
+        end_val = limit & ~(mask - 1);
+    }
+
+    p_timer->slack_offset = (uint32_t)(end_val - nominal);
+    p_timer->end_val      = end_val;
+}
+
 #if APP_TIMER_CONFIG_USE_SCHEDULER
 static void scheduled_timeout_handler(void * p_event_data, uint16_t event_size)
 {
@@ -178,6 +396,9 @@ static bool timer_expire(app_timer_t * p_timer)
                 p_timer->end_val = APP_TIMER_IDLE_VAL;
             }
             CRITICAL_REGION_EXIT();
+    #if APP_TIMER_WITH_PROFILER
+            m_expiration_cnt++;
+    #endif
     #if APP_TIMER_CONFIG_USE_SCHEDULER
             app_timer_event_t timer_event;
 
@@ -195,7 +416,8 @@ static bool timer_expire(app_timer_t * p_timer)
             /* check active flag as it may have been stopped in the user handler */
             if (p_timer->repeat_period && !APP_TIMER_IS_IDLE(p_timer))
             {
-                p_timer->end_val += p_timer->repeat_period;
+                timer_end_val_set(p_timer,
+                                  p_timer->end_val - p_timer->slack_offset + p_timer->repeat_period);
                 cont = true;
             }
             else
@@ -206,13 +428,13 @@ static bool timer_expire(app_timer_t * p_timer)
 
             if (cont)
             {
-                nrf_sortlist_add(&m_app_timer_sortlist, &p_timer->list_item);
+                timer_queue_add(p_timer);
                 ret = true;
             }
         }
         else if (!APP_TIMER_IS_IDLE(p_timer))
         {
-            nrf_sortlist_add(&m_app_timer_sortlist, &p_timer->list_item);
+            timer_queue_add(p_timer);
             ret = true;
         }
     }
@@ -271,18 +493,6 @@ static bool rtc_schedule(app_timer_t * p_timer, bool * p_rerun)
     return false;
 }
 
-static inline app_timer_t * sortlist_pop(void)
-{
-    nrf_sortlist_item_t * p_next_item = nrf_sortlist_pop(&m_app_timer_sortlist);
-    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
-}
-
-static inline app_timer_t * sortlist_peek(void)
-{
-    nrf_sortlist_item_t const * p_next_item = nrf_sortlist_peek(&m_app_timer_sortlist);
-    return p_next_item ? CONTAINER_OF(p_next_item, app_timer_t, list_item) : NULL;
-}
-
 /**
  * @brief Function for deactivating all timers which are in the sorted list (active timers).
  */
@@ -291,7 +501,7 @@ static void sorted_list_stop_all(void)
     app_timer_t * p_next;
     do
     {
-        p_next = sortlist_pop();
+        p_next = timer_queue_pop();
         if (p_next)
         {
             p_next->end_val = APP_TIMER_IDLE_VAL;
@@ -322,6 +532,9 @@ static void on_compare_evt(drv_rtc_t const * const  p_instance)
                                           drv_rtc_compare_get(p_instance, 0)) < APP_TIMER_SAFE_WINDOW);
 
         NRF_LOG_INST_DEBUG(mp_active_timer->p_log, "Compare EVT");
+#if APP_TIMER_WITH_PROFILER
+        m_wakeup_cnt++;
+#endif
         UNUSED_RETURN_VALUE(timer_expire(mp_active_timer));
         mp_active_timer = NULL;
     }
@@ -351,7 +564,7 @@ static void rtc_update(drv_rtc_t const * const  p_instance)
 {
     while(1)
     {
-        app_timer_t * p_next = sortlist_peek();
+        app_timer_t * p_next = timer_queue_peek();
         bool rtc_reconf = false;
         if (p_next) //Candidate for active timer
         {
@@ -364,7 +577,7 @@ static void rtc_update(drv_rtc_t const * const  p_instance)
              * requests are handled.
              */
             if (APP_TIMER_IS_IDLE(p_next)) {
-                (void)sortlist_pop();
+                (void)timer_queue_pop();
                 continue;
             }
             else if (mp_active_timer == NULL)
@@ -380,14 +593,14 @@ static void rtc_update(drv_rtc_t const * const  p_instance)
                 if (!APP_TIMER_IS_IDLE(mp_active_timer))
                 {
                     NRF_LOG_INST_DEBUG(mp_active_timer->p_log, "Timer preempted.");
-                    nrf_sortlist_add(&m_app_timer_sortlist, &mp_active_timer->list_item);
+                    timer_queue_add(mp_active_timer);
                 }
             }
 
             if (rtc_reconf)
             {
                 bool rerun;
-                p_next = sortlist_pop();
+                p_next = timer_queue_pop();
                 NRF_LOG_INST_DEBUG(p_next->p_log, "Activating timer (CC:%d/%08x).", p_next->end_val, p_next->end_val);
                 if (rtc_schedule(p_next, &rerun))
                 {
@@ -454,7 +667,7 @@ static void timer_req_process(drv_rtc_t const * const  p_instance)
                  */
                 if (!APP_TIMER_IS_IDLE(p_req->p_timer))
                 {
-                    nrf_sortlist_add(&m_app_timer_sortlist, &(p_req->p_timer->list_item));
+                    timer_queue_add(p_req->p_timer);
                     NRF_LOG_INST_DEBUG(p_req->p_timer->p_log,"Start request (expiring at %d/0x%08x).",
                                                   p_req->p_timer->end_val, p_req->p_timer->end_val);
                 }
@@ -466,10 +679,10 @@ static void timer_req_process(drv_rtc_t const * const  p_instance)
                 }
                 else
                 {
-                    bool found = nrf_sortlist_remove(&m_app_timer_sortlist, &(p_req->p_timer->list_item));
+                    bool found = timer_queue_remove(p_req->p_timer);
                     if (!found)
                     {
-                         NRF_LOG_INFO("Timer not found on sortlist (stopping expired timer).");
+                         NRF_LOG_INFO("Timer not found in queue (stopping expired timer).");
                     }
                 }
                 NRF_LOG_INST_DEBUG(p_req->p_timer->p_log,"Stop request.");
@@ -611,6 +824,15 @@ ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
     p_t->end_val = APP_TIMER_IDLE_VAL;
     p_t->handler = timeout_handler;
     p_t->repeat_period = (mode == APP_TIMER_MODE_REPEATED) ? 1 : 0;
+    p_t->slack = 0;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_slack_set(app_timer_t * p_timer, uint32_t slack_ticks)
+{
+    ASSERT(p_timer);
+
+    p_timer->slack = slack_ticks;
     return NRF_SUCCESS;
 }
 
@@ -628,7 +850,7 @@ ret_code_t app_timer_start(app_timer_t * p_timer, uint32_t timeout_ticks, void *
          * it was scheduled from higher priority interrupt (same as this start).
          * In that case, end value is shifted to the future which will prevent
          * previous timeout value to expire.*/
-        p_t->end_val = get_now() + timeout_ticks;
+        timer_end_val_set(p_t, get_now() + timeout_ticks);
         cont = true;
     }
     else
@@ -696,6 +918,26 @@ uint8_t app_timer_op_queue_utilization_get(void)
 {
     return m_max_user_op_queue_utilization;
 }
+
+void app_timer_wakeup_stats_get(app_timer_wakeup_stats_t * p_stats, bool reset)
+{
+    ASSERT(p_stats);
+
+    CRITICAL_REGION_ENTER();
+    uint64_t now = get_now();
+
+    p_stats->wakeups     = m_wakeup_cnt;
+    p_stats->expirations = m_expiration_cnt;
+    p_stats->period_ms   = (uint32_t)(((now - m_wakeup_stats_start) * 1000 *
+                                       (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)) / APP_TIMER_CLOCK_FREQ);
+    if (reset)
+    {
+        m_wakeup_cnt         = 0;
+        m_expiration_cnt     = 0;
+        m_wakeup_stats_start = now;
+    }
+    CRITICAL_REGION_EXIT();
+}
 #endif /* APP_TIMER_WITH_PROFILER */
 
 uint32_t app_timer_cnt_diff_compute(uint32_t   ticks_to,
@@ -234,6 +234,32 @@
 
 // </e>
 
+// <e> PM_RAM_CACHE_ENABLED - Enable/disable the RAM cache of peer data locations in flash.
+// <i> Peer Manager remembers where the data of recently used peers is stored, so that
+// <i> restoring bonding data and system attributes on reconnection does not search flash.
+//==========================================================
+#ifndef PM_RAM_CACHE_ENABLED
+#define PM_RAM_CACHE_ENABLED 0
+#endif
+// <o> PM_RAM_CACHE_SIZE - Number of cached peer data locations. <1-255> 
+// <i> Each peer uses up to one entry per type of peer data. Each entry takes 24 bytes of RAM.
+
+#ifndef PM_RAM_CACHE_SIZE
+#define PM_RAM_CACHE_SIZE 16
+#endif
+
+// </e>
+
+// <q> PM_LOCAL_DB_DIGEST_ENABLED  - Skip redundant local GATT database writes without reading flash.
+ 
+
+// <i> Peer Manager keeps a CRC-16 of the system attributes last stored for each connection, and
+// <i> skips storing them again if they have not changed. Requires CRC16_ENABLED.
+
+#ifndef PM_LOCAL_DB_DIGEST_ENABLED
+#define PM_LOCAL_DB_DIGEST_ENABLED 0
+#endif
+
 // <o> PM_HANDLER_SEC_DELAY_MS - Delay before starting security. 
 // <i>  This might be necessary for interoperability reasons, especially as peripheral.
 
@@ -5301,6 +5327,41 @@
 #define APP_SCHEDULER_WITH_PROFILER 0
 #endif
 
+// <e> APP_SCHEDULER_WITH_PRIORITIES - Enabling priority queues
+//==========================================================
+#ifndef APP_SCHEDULER_WITH_PRIORITIES
+#define APP_SCHEDULER_WITH_PRIORITIES 0
+#endif
+// <i> If option is enabled, each priority level has its own queue and app_sched_execute()
+// <i> executes events of higher priority first. Events are queued with an atomic
+// <i> compare-and-exchange instead of a critical region.
+
+// <o> APP_SCHEDULER_PRIORITY_LEVELS - Number of priority levels  <2-8> 
+
+
+#ifndef APP_SCHEDULER_PRIORITY_LEVELS
+#define APP_SCHEDULER_PRIORITY_LEVELS 3
+#endif
+
+// <o> APP_SCHEDULER_DEFAULT_PRIORITY - Priority of events scheduled with app_sched_event_put() 
+// <i> 0 is the highest priority. Must be lower than APP_SCHEDULER_PRIORITY_LEVELS.
+
+#ifndef APP_SCHEDULER_DEFAULT_PRIORITY
+#define APP_SCHEDULER_DEFAULT_PRIORITY 1
+#endif
+
+// <o> APP_SCHEDULER_STARVATION_LIMIT - Starvation guard limit  <1-65535> 
+
+
+// <i> Maximum number of higher-priority events executed while a lower-priority
+// <i> event is waiting. When the limit is reached, the waiting event is executed next.
+
+#ifndef APP_SCHEDULER_STARVATION_LIMIT
+#define APP_SCHEDULER_STARVATION_LIMIT 8
+#endif
+
+// </e>
+
 // </e>
 
 // <e> APP_SDCARD_ENABLED - app_sdcard - SD/MMC card support using SPI
@@ -5400,6 +5461,18 @@
 #define APP_TIMER_CONFIG_USE_SCHEDULER 0
 #endif
 
+// <q> APP_TIMER_CONFIG_USE_HEAP  - Keep active timers in a pairing heap instead of a sorted list
+ 
+
+// <i> If option is enabled, app_timer2 keeps active timers in an intrusive pairing heap.
+// <i> Starting a timer takes constant time and stopping or expiring a timer takes
+// <i> logarithmic amortized time, instead of the linear insertion done by nrf_sortlist.
+// <i> Recommended when many timers are running at the same time.
+
+#ifndef APP_TIMER_CONFIG_USE_HEAP
+#define APP_TIMER_CONFIG_USE_HEAP 0
+#endif
+
 // <q> APP_TIMER_KEEPS_RTC_ACTIVE  - Enable RTC always on
  
 
@@ -5777,19 +5850,43 @@
 #define APP_USBD_MSC_ENABLED 0
 #endif
 
-// <q> CRC16_ENABLED  - crc16 - CRC16 calculation routines
- 
-
+// <e> CRC16_ENABLED - crc16 - CRC16 calculation routines
+//==========================================================
 #ifndef CRC16_ENABLED
 #define CRC16_ENABLED 0
 #endif
-
-// <q> CRC32_ENABLED  - crc32 - CRC32 calculation routines
+// <o> CRC16_CONFIG_ALGORITHM  - CRC16 implementation
  
+// <i> Faster implementations use more flash for lookup tables.
+// <0=> Shift and XOR (no table) 
+// <1=> Byte table (512 bytes) 
+// <2=> Slicing-by-4 (2 kB) 
+
+#ifndef CRC16_CONFIG_ALGORITHM
+#define CRC16_CONFIG_ALGORITHM 1
+#endif
 
+// </e>
+
+// <e> CRC32_ENABLED - crc32 - CRC32 calculation routines
+//==========================================================
 #ifndef CRC32_ENABLED
 #define CRC32_ENABLED 0
 #endif
+// <o> CRC32_CONFIG_ALGORITHM  - CRC32 implementation
+ 
+// <i> Faster implementations use more flash for lookup tables.
+// <0=> Bitwise (no table) 
+// <1=> Nibble table (64 bytes) 
+// <2=> Byte table (1 kB) 
+// <3=> Slicing-by-4 (4 kB) 
+// <4=> Slicing-by-8 (8 kB) 
+
+#ifndef CRC32_CONFIG_ALGORITHM
+#define CRC32_CONFIG_ALGORITHM 1
+#endif
+
+// </e>
 
 // <q> ECC_ENABLED  - ecc - Elliptic Curve Cryptography Library
  
@@ -5850,8 +5947,10 @@
 
 // <i> NRF_FSTORAGE_SD uses the nrf_fstorage_sd backend implementation using the SoftDevice API. Use this if you have a SoftDevice present.
 // <i> NRF_FSTORAGE_NVMC uses the nrf_fstorage_nvmc implementation. Use this setting if you don't use the SoftDevice.
+// <i> NRF_FSTORAGE_FILE uses the nrf_fstorage_file implementation, which emulates flash with a file. Use this setting for host builds.
 // <1=> NRF_FSTORAGE_NVMC 
 // <2=> NRF_FSTORAGE_SD 
+// <3=> NRF_FSTORAGE_FILE 
 
 #ifndef FDS_BACKEND
 #define FDS_BACKEND 2
@@ -6248,6 +6347,60 @@
 
 // </e>
 
+// <e> NRF_SLAB_ENABLED - nrf_slab - Multi-size-class slab allocator built on nrf_balloc
+//==========================================================
+#ifndef NRF_SLAB_ENABLED
+#define NRF_SLAB_ENABLED 0
+#endif
+// <e> NRF_SLAB_MALLOC_ENABLED - Provide heap functions served from nrf_slab
+//==========================================================
+#ifndef NRF_SLAB_MALLOC_ENABLED
+#define NRF_SLAB_MALLOC_ENABLED 0
+#endif
+// <i> Provides nrf_slab_malloc, nrf_slab_calloc, nrf_slab_realloc and nrf_slab_malloc_free,
+// <i> deterministic, interrupt-safe counterparts of the C library heap functions, backed by
+// <i> five size classes of 16, 32, 64, 128 and 256 bytes. Requests larger than 256 bytes fail.
+// <i> The C library heap is not replaced.
+
+// <o> NRF_SLAB_MALLOC_16_COUNT - Number of 16-byte blocks  <1-255> 
+
+
+#ifndef NRF_SLAB_MALLOC_16_COUNT
+#define NRF_SLAB_MALLOC_16_COUNT 8
+#endif
+
+// <o> NRF_SLAB_MALLOC_32_COUNT - Number of 32-byte blocks  <1-255> 
+
+
+#ifndef NRF_SLAB_MALLOC_32_COUNT
+#define NRF_SLAB_MALLOC_32_COUNT 8
+#endif
+
+// <o> NRF_SLAB_MALLOC_64_COUNT - Number of 64-byte blocks  <1-255> 
+
+
+#ifndef NRF_SLAB_MALLOC_64_COUNT
+#define NRF_SLAB_MALLOC_64_COUNT 4
+#endif
+
+// <o> NRF_SLAB_MALLOC_128_COUNT - Number of 128-byte blocks  <1-255> 
+
+
+#ifndef NRF_SLAB_MALLOC_128_COUNT
+#define NRF_SLAB_MALLOC_128_COUNT 2
+#endif
+
+// <o> NRF_SLAB_MALLOC_256_COUNT - Number of 256-byte blocks  <1-255> 
+
+
+#ifndef NRF_SLAB_MALLOC_256_COUNT
+#define NRF_SLAB_MALLOC_256_COUNT 1
+#endif
+
+// </e>
+
+// </e>
+
 // <e> NRF_CSENSE_ENABLED - nrf_csense - Capacitive sensor module
 //==========================================================
 #ifndef NRF_CSENSE_ENABLED
@@ -6377,6 +6530,42 @@
 // </h> 
 //==========================================================
 
+// <h> nrf_fstorage_file - Implementation using a memory-mapped file
+
+// <i> Configuration options for the fstorage implementation that emulates flash with a file on host (x86 Linux) builds
+//==========================================================
+// <s> NRF_FSTORAGE_FILE_PATH - Path of the file that backs the flash
+#ifndef NRF_FSTORAGE_FILE_PATH
+#define NRF_FSTORAGE_FILE_PATH "flash.bin"
+#endif
+
+// <o> NRF_FSTORAGE_FILE_FLASH_SIZE - Size of the emulated flash (in bytes) 
+#ifndef NRF_FSTORAGE_FILE_FLASH_SIZE
+#define NRF_FSTORAGE_FILE_FLASH_SIZE 524288
+#endif
+
+// <o> NRF_FSTORAGE_FILE_PAGE_SIZE - Size of a flash page (in bytes) 
+#ifndef NRF_FSTORAGE_FILE_PAGE_SIZE
+#define NRF_FSTORAGE_FILE_PAGE_SIZE 4096
+#endif
+
+// <o> NRF_FSTORAGE_FILE_WRITE_LATENCY_US - Modeled time to program one word (in microseconds) 
+// <i> Set to 0 to run flash operations at host speed while still counting them.
+
+#ifndef NRF_FSTORAGE_FILE_WRITE_LATENCY_US
+#define NRF_FSTORAGE_FILE_WRITE_LATENCY_US 41
+#endif
+
+// <o> NRF_FSTORAGE_FILE_ERASE_LATENCY_US - Modeled time to erase one page (in microseconds) 
+// <i> Set to 0 to run flash operations at host speed while still counting them.
+
+#ifndef NRF_FSTORAGE_FILE_ERASE_LATENCY_US
+#define NRF_FSTORAGE_FILE_ERASE_LATENCY_US 85000
+#endif
+
+// </h> 
+//==========================================================
+
 // </e>
 
 // <q> NRF_GFX_ENABLED  - nrf_gfx - GFX module
@@ -6864,6 +7053,17 @@
 #define NRF_LOG_DEFERRED 1
 #endif
 
+// <q> NRF_LOG_DICTIONARY_ENABLED  - Send binary dictionary frames instead of formatted strings.
+ 
+
+// <i> If enabled, serial backends (UART, RTT) send the address of the format string,
+// <i> the timestamp and the raw arguments instead of formatting the log on the target.
+// <i> Frames are decoded on the host with scripts/nrf_log_dict_decoder.py and the ELF file.
+
+#ifndef NRF_LOG_DICTIONARY_ENABLED
+#define NRF_LOG_DICTIONARY_ENABLED 0
+#endif
+
 // <q> NRF_LOG_FILTERS_ENABLED  - Enable dynamic filtering of logs.
  
 
@@ -6871,6 +7071,23 @@
 #define NRF_LOG_FILTERS_ENABLED 0
 #endif
 
+// <e> NRF_LOG_RATE_LIMIT_ENABLED - Enable per-module rate limiting and sampling of logs.
+
+// <i> Logs over the configured rate (token bucket) or not selected by 1-in-N sampling
+// <i> are dropped in the frontend before taking any space in the log buffer.
+// <i> Requires NRF_LOG_FILTERS_ENABLED. Rate limits require a timestamp function.
+//==========================================================
+#ifndef NRF_LOG_RATE_LIMIT_ENABLED
+#define NRF_LOG_RATE_LIMIT_ENABLED 0
+#endif
+// <o> NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS - Interval between summaries of suppressed logs (in milliseconds). 
+// <i> Without a timestamp function, the summary is logged whenever the log buffer is drained.
+#ifndef NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS
+#define NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS 1000
+#endif
+
+// </e>
+
 // <q> NRF_LOG_NON_DEFFERED_CRITICAL_REGION_ENABLED  - Enable use of critical region for non deffered mode when flushing logs.
  
 
@@ -10,11 +10,13 @@
 #include "ble_office_mngmt.h"
 #include "nrf_log.h"
 #include "stdlib.h"
+#include "nrf_slab.h"
 #include "app_nvm.h"
 
 #define     Office_Id_Size         8
    
 char ** words;
+uint8_t words_count;
 Memory_Action action;
 
 
@@ -28,13 +30,21 @@ Memory_Action action;
 static char** split_string(uint8_t* str, uint8_t * word_count) 
 {
     // Allocate memory for the array of words
-    char** words = (char**)malloc(3 * sizeof(char*));
+    char** words = (char**)nrf_slab_calloc(3, sizeof(char*));
     *word_count = 0;
+    if (words == NULL)
+    {
+        return NULL;
+    }
     char* token = strtok((char*)str, " ");
     
     while (token != NULL && *word_count < 3) 
     {
-        words[*word_count] = (char*)malloc((strlen(token) + 1) * sizeof(char));
+        words[*word_count] = (char*)nrf_slab_malloc((strlen(token) + 1) * sizeof(char));
+        if (words[*word_count] == NULL)
+        {
+            break;
+        }
         strcpy(words[*word_count], token);
         (*word_count)++;
         token = strtok(NULL, " ");
@@ -43,6 +53,24 @@ static char** split_string(uint8_t* str, uint8_t * word_count)
     return words;
 }
 
+/**@brief Function for releasing the words returned by split_string.
+ *
+ * @param[in]   words              array containing the words.
+ * @param[in]   word_count         number of words in the array.
+ */
+static void free_words(char ** words, uint8_t word_count)
+{
+    if (words == NULL)
+    {
+        return;
+    }
+    for (uint8_t i = 0; i < word_count; i++)
+    {
+        nrf_slab_malloc_free(words[i]);
+    }
+    nrf_slab_malloc_free(words);
+}
+
 /**@brief Function for handling the Write event.
  *
  * @param[in]   p_cus       Custom service structure.
@@ -59,7 +87,16 @@ static void on_write(ble_cus_t * p_cus, ble_evt_t const * p_ble_evt)
    if (p_evt_write->handle == p_cus->office_managing_char_handles.value_handle)
     { 
         read_office_table_from_flash(read_table);
-        words = split_string((uint8_t *)p_evt_write->data, &word_count);
+        // Words of a write that update_memory() has not taken yet are replaced by this one.
+        free_words(words, words_count);
+        words       = split_string((uint8_t *)p_evt_write->data, &word_count);
+        words_count = word_count;
+        if ((words == NULL) || (word_count == 0))
+        {
+            free_words(words, word_count);
+            words = NULL;
+            return;
+        }
         /*NRF_LOG_INFO("words[0] = %s", words[0]);
         NRF_LOG_INFO("Number of words written : %d", word_count);*/
         if((strncmp(words[0],"Free", sizeof("Free")) == 0)&&(word_count==2))
@@ -130,6 +167,13 @@ static void on_write(ble_cus_t * p_cus, ble_evt_t const * p_ble_evt)
         evt.evt_type = BLE_OFFICE_MANAGING_CHAR_EVT_WRITE; 
 
         p_cus->evt_handler(p_cus, &evt);
+
+        // Free and Reserve keep the words until update_memory() has written them to flash.
+        if (action == Monitor_Office)
+        {
+            free_words(words, word_count);
+            words = NULL;
+        }
         
     }
 
@@ -417,7 +461,7 @@ uint32_t ble_cus_char_update(ble_cus_t * p_cus, uint8_t  * p_value, uint16_t len
  */
 void update_memory(void)
 {
-    if (action != Monitor_Office)
+    if ((action != Monitor_Office) && (words != NULL))
     {
         office_item read_table[OFFICE_COUNT];
         read_office_table_from_flash(read_table);
@@ -434,6 +478,8 @@ void update_memory(void)
             erase_office_table_from_flash();
             write_office_table_to_flash(read_table);
         }
+        free_words(words, words_count);
+        words = NULL;
     }        
 }
 
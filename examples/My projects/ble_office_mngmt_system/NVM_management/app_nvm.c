@@ -201,7 +201,7 @@ void clear_office(office_item office_table[OFFICE_COUNT], char* office_id)
         {
             //NRF_LOG_INFO("office found");
             office_table[i].availability = 0; // 0 for available
-            strcpy(office_table[i].employee_name, NULL); 
+            memset(office_table[i].employee_name, 0, sizeof(office_table[i].employee_name));
             break;
         }
     }
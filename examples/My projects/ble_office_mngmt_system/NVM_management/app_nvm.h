@@ -6,6 +6,9 @@
  *
  */
 
+#ifndef APP_NVM_H__
+#define APP_NVM_H__
+
 #include "nrf_fstorage.h"
 #include "nrf_fstorage_sd.h"
 #include "app_error.h"
@@ -94,4 +97,6 @@ char* get_employee_name_for_office(office_item office_table[OFFICE_COUNT], const
  *
  * @return      true if found, false if not.
  */
-bool does_office_exist(office_item office_table[OFFICE_COUNT], const char *office_id);
\ No newline at end of file
+bool does_office_exist(office_item office_table[OFFICE_COUNT], const char *office_id);
+
+#endif // APP_NVM_H__
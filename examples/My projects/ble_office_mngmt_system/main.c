@@ -99,6 +99,10 @@
 #define SAADC_TIMER_INTERVAL            APP_TIMER_TICKS(1000)                    /**< Saadc sampling timer interval (200 ms). */
 #define NOTIFICATION_INTERVAL           APP_TIMER_TICKS(500)
 
+#define BATTERY_LEVEL_MEAS_SLACK        APP_TIMER_TICKS(200)                    /**< Tolerance on the battery timer expiry, used to coalesce timer wakeups (ticks). */
+#define SAADC_TIMER_SLACK               APP_TIMER_TICKS(100)                    /**< Tolerance on the saadc timer expiry, used to coalesce timer wakeups (ticks). */
+#define NOTIFICATION_SLACK              APP_TIMER_TICKS(50)                     /**< Tolerance on the notification timer expiry, used to coalesce timer wakeups (ticks). */
+
 #define MIN_CONN_INTERVAL               MSEC_TO_UNITS(100, UNIT_1_25_MS)        /**< Minimum acceptable connection interval (0.1 seconds). */
 #define MAX_CONN_INTERVAL               MSEC_TO_UNITS(200, UNIT_1_25_MS)        /**< Maximum acceptable connection interval (0.2 second). */
 #define SLAVE_LATENCY                   0                                       /**< Slave latency. */
@@ -149,6 +153,7 @@ NRF_BLE_QWR_DEF(m_qwr);
 BLE_ADVERTISING_DEF(m_advertising);                                             /**< Advertising module instance. */
 
 static uint16_t m_conn_handle = BLE_CONN_HANDLE_INVALID;                        /**< Handle of the current connection. */
+static uint32_t m_connected_ticks;                                              /**< RTC counter value when the current connection was established. */
 
 
 // YOUR_JOB: Use UUIDs for service(s) used in your application.
@@ -197,6 +202,23 @@ static void pm_evt_handler(pm_evt_t const * p_evt)
 
     switch (p_evt->evt_id)
     {
+        case PM_EVT_CONN_SEC_SUCCEEDED:
+            if (p_evt->params.conn_sec_succeeded.procedure == PM_CONN_SEC_PROCEDURE_ENCRYPTION)
+            {
+                // Reconnection of a bonded peer: time until the link is encrypted and ready.
+                pm_ram_cache_stats_t stats;
+                uint32_t ticks = app_timer_cnt_diff_compute(app_timer_cnt_get(), m_connected_ticks);
+
+                NRF_LOG_INFO("Bonded peer ready %d ms after connecting.",
+                             ROUNDED_DIV(ticks * 1000, APP_TIMER_CLOCK_FREQ / (APP_TIMER_CONFIG_RTC_FREQUENCY + 1)));
+
+                if (pm_ram_cache_stats_get(&stats) == NRF_SUCCESS)
+                {
+                    NRF_LOG_INFO("Peer data cache hits: %d, misses: %d.", stats.hits, stats.misses);
+                }
+            }
+            break;
+
         case PM_EVT_PEERS_DELETE_SUCCEEDED:
             advertising_start(false);
             break;
@@ -250,6 +272,17 @@ static void battery_level_meas_timeout_handler(void * p_context)
 {
     UNUSED_PARAMETER(p_context);
     battery_level_update();
+
+#if APP_TIMER_WITH_PROFILER
+    app_timer_wakeup_stats_t stats;
+
+    app_timer_wakeup_stats_get(&stats, true);
+    if (stats.period_ms != 0)
+    {
+        NRF_LOG_INFO("timer wakeups/s (x1000): %d, expirations: %d, wakeups: %d",
+                     (stats.wakeups * 1000000) / stats.period_ms, stats.expirations, stats.wakeups);
+    }
+#endif
 }
 
 /**@brief Function for handling the notification timeout coming from Office Monitoring characteristic.
@@ -283,18 +316,24 @@ static void timers_init(void)
                                 APP_TIMER_MODE_REPEATED,
                                 battery_level_meas_timeout_handler);
     APP_ERROR_CHECK(err_code);
+    err_code = app_timer_slack_set(m_battery_timer_id, BATTERY_LEVEL_MEAS_SLACK);
+    APP_ERROR_CHECK(err_code);
     
     // Create saadc timer.
     err_code = app_timer_create(&m_saadc_timer_id,
                                 APP_TIMER_MODE_REPEATED,
                                 saadc_timer_timeout_handler);
     APP_ERROR_CHECK(err_code); 
+    err_code = app_timer_slack_set(m_saadc_timer_id, SAADC_TIMER_SLACK);
+    APP_ERROR_CHECK(err_code);
     
     // Create notification timer.
     err_code = app_timer_create(&m_notification_timer_id, 
                                 APP_TIMER_MODE_REPEATED, 
                                 notification_timeout_handler);
     APP_ERROR_CHECK(err_code);
+    err_code = app_timer_slack_set(m_notification_timer_id, NOTIFICATION_SLACK);
+    APP_ERROR_CHECK(err_code);
 }
 
 
@@ -332,11 +371,35 @@ static void gap_params_init(void)
 }
 
 
+/**@brief Function for handling events from the GATT module.
+ *
+ * @param[in]   p_gatt  GATT module instance.
+ * @param[in]   p_evt   Event from the GATT module.
+ */
+static void gatt_evt_handler(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const * p_evt)
+{
+    if (p_evt->evt_id == NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED)
+    {
+        NRF_LOG_INFO("Link ready: ATT MTU %d, data length %d, TX/RX PHY %d/%d.",
+                     p_evt->params.link_params.att_mtu_effective,
+                     p_evt->params.link_params.data_length_effective,
+                     p_evt->params.link_params.tx_phy,
+                     p_evt->params.link_params.rx_phy);
+    }
+}
+
+
 /**@brief Function for initializing the GATT module.
+ *
+ * @details Connections use the bulk throughput profile, so that history exports run with the
+ *          largest ATT MTU and data length configured for the SoftDevice and the 2 Mbps PHY.
  */
 static void gatt_init(void)
 {
-    ret_code_t err_code = nrf_ble_gatt_init(&m_gatt, NULL);
+    ret_code_t err_code = nrf_ble_gatt_init(&m_gatt, gatt_evt_handler);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrf_ble_gatt_profile_set(&m_gatt, BLE_CONN_HANDLE_INVALID, NRF_BLE_GATT_PROFILE_BULK);
     APP_ERROR_CHECK(err_code);
 }
 
@@ -598,12 +661,21 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
     switch (p_ble_evt->header.evt_id)
     {
         case BLE_GAP_EVT_DISCONNECTED:
+        {
+            pm_local_db_write_stats_t stats;
+
             NRF_LOG_INFO("Disconnected.");
+            if (pm_local_db_write_stats_get(&stats) == NRF_SUCCESS)
+            {
+                NRF_LOG_INFO("CCCD state writes: %d, skipped: %d (%d without flash read).",
+                             stats.written, stats.skipped, stats.digest_skipped);
+            }
             // LED indication will be changed when advertising starts.
-            break;
+        } break;
 
         case BLE_GAP_EVT_CONNECTED:
             NRF_LOG_INFO("Connected.");
+            m_connected_ticks = app_timer_cnt_get();
             err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
             APP_ERROR_CHECK(err_code);
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
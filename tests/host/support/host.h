@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef HOST_H__
+#define HOST_H__
+
+/* Host replacements for the Cortex-M intrinsics used by the modules under test. This file is
+ * included in front of every source file by the Makefile. */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+
+static inline uint32_t host_rbit(uint32_t value)
+{
+    value = ((value >> 1) & 0x55555555) | ((value & 0x55555555) << 1);
+    value = ((value >> 2) & 0x33333333) | ((value & 0x33333333) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F) | ((value & 0x0F0F0F0F) << 4);
+    return __builtin_bswap32(value);
+}
+
+/* Faster than the portable CMSIS fallback, which would dominate the benchmarks. */
+#define __RBIT(value) host_rbit(value)
+
+/* Barriers, as full fences between the host threads that stand in for interrupt contexts. */
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* There is no NVIC to mask interrupts in. */
+#undef  NVIC_DisableIRQ
+#define NVIC_DisableIRQ(irq) ((void)(irq))
+
+/* Exclusive accesses, emulated with compare-and-swap: the store succeeds if the value loaded by
+ * the exclusive load of the same thread is unchanged. A test can also make every n-th store of
+ * a thread fail spuriously, as it may on the device, by setting g_host_strex_fail_period. */
+extern uint32_t g_host_strex_fail_period;
+
+static __thread uint32_t m_host_exclusive_value;
+static __thread uint32_t m_host_strex_cnt;
+
+static inline uint32_t __LDREXW(volatile uint32_t * p_addr)
+{
+    m_host_exclusive_value = __atomic_load_n(p_addr, __ATOMIC_SEQ_CST);
+    return m_host_exclusive_value;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t * p_addr)
+{
+    uint32_t expected = m_host_exclusive_value;
+
+    if ((g_host_strex_fail_period != 0) && ((++m_host_strex_cnt % g_host_strex_fail_period) == 0))
+    {
+        return 1;
+    }
+    return __atomic_compare_exchange_n(p_addr, &expected, value, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 0 : 1;
+}
+
+static inline void __CLREX(void)
+{
+}
+
+#endif // HOST_H__
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Host implementations of the platform functions used by the modules under test. */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "app_util_platform.h"
+#include "app_error.h"
+#include "nrf_assert.h"
+
+uint32_t g_host_strex_fail_period;
+
+/* Critical regions exclude each other across threads, as interrupts are masked on the device. */
+static pthread_mutex_t m_critical_region = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+    (void) p_nested;
+    (void) pthread_mutex_lock(&m_critical_region);
+}
+
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+    (void) nested;
+    (void) pthread_mutex_unlock(&m_critical_region);
+}
+
+
+void app_error_fault_handler(uint32_t id, uint32_t pc, uint32_t info)
+{
+    fprintf(stderr, "app_error_fault_handler: id 0x%x, info 0x%x\n", id, info);
+    abort();
+}
+
+
+void app_error_handler(ret_code_t error_code, uint32_t line_num, const uint8_t * p_file_name)
+{
+    fprintf(stderr, "%s:%u: error 0x%x\n", (char const *)p_file_name, line_num, error_code);
+    abort();
+}
+
+
+void app_error_handler_bare(ret_code_t error_code)
+{
+    fprintf(stderr, "error 0x%x\n", error_code);
+    abort();
+}
+
+
+void assert_nrf_callback(uint16_t line_num, const uint8_t * file_name)
+{
+    fprintf(stderr, "%s:%u: assertion failed\n", (char const *)file_name, line_num);
+    abort();
+}
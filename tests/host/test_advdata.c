@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* ble_advdata slots, updated in place, against encoding the whole payload again.
+ *
+ * A payload with flags, appearance, a UUID list, manufacturer specific data, service data and
+ * the device name is encoded once as a template. For random values of the dynamic fields, the
+ * template patched through its slots must be identical to a fresh encode. Writes that do not fit
+ * in a slot must be rejected and leave the data unchanged. The benchmark compares the cost of an
+ * update by encoding and by patching. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "ble_advdata.h"
+
+#define MANUF_DATA_LEN  3
+#define MODEL_ROUNDS    100000
+#define BENCH_ROUNDS    2000000
+
+static char const m_device_name[] = "Office";
+
+static uint8_t                    m_manuf_data[MANUF_DATA_LEN];
+static uint8_t                    m_srv_data[2];
+static ble_advdata_manuf_data_t   m_manuf        = {0x0059, {MANUF_DATA_LEN, m_manuf_data}};
+static ble_advdata_service_data_t m_service      = {0x180F, {sizeof(m_srv_data), m_srv_data}};
+static ble_uuid_t                 m_uuids[]      = {{0x1523, BLE_UUID_TYPE_BLE}};
+static ble_advdata_t              m_advdata;
+
+
+uint32_t sd_ble_gap_device_name_get(uint8_t * p_dev_name, uint16_t * p_len)
+{
+    uint16_t const name_len = strlen(m_device_name);
+
+    if (p_dev_name != NULL)
+    {
+        memcpy(p_dev_name, m_device_name, MIN(*p_len, name_len));
+    }
+    *p_len = name_len;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_appearance_get(uint16_t * p_appearance)
+{
+    *p_appearance = BLE_APPEARANCE_GENERIC_TAG;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_addr_get(ble_gap_addr_t * p_addr)
+{
+    memset(p_addr, 0, sizeof(*p_addr));
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_encode(ble_uuid_t const * p_uuid, uint8_t * p_uuid_le_len, uint8_t * p_uuid_le)
+{
+    *p_uuid_le_len = 2;
+    if (p_uuid_le != NULL)
+    {
+        (void) uint16_encode(p_uuid->uuid, p_uuid_le);
+    }
+    return NRF_SUCCESS;
+}
+
+
+static void advdata_setup(void)
+{
+    memset(&m_advdata, 0, sizeof(m_advdata));
+
+    m_advdata.name_type                = BLE_ADVDATA_FULL_NAME;
+    m_advdata.include_appearance       = true;
+    m_advdata.flags                    = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+    m_advdata.uuids_complete.uuid_cnt  = ARRAY_SIZE(m_uuids);
+    m_advdata.uuids_complete.p_uuids   = m_uuids;
+    m_advdata.p_manuf_specific_data    = &m_manuf;
+    m_advdata.service_data_count       = 1;
+    m_advdata.p_service_data_array     = &m_service;
+}
+
+
+static uint16_t encode(uint8_t * p_buf)
+{
+    uint16_t len = BLE_GAP_ADV_SET_DATA_SIZE_MAX;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_encode(&m_advdata, p_buf, &len));
+    return len;
+}
+
+
+static void test_slot_find(void)
+{
+    uint8_t            buf[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    ble_advdata_slot_t slot;
+
+    advdata_setup();
+    uint16_t const len = encode(buf);
+
+    /* The Company Identifier is at offset 0 of the manufacturer data. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      ble_advdata_slot_find(buf, len, BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, &slot));
+    TEST_ASSERT_EQUAL(2 + MANUF_DATA_LEN, slot.len);
+    TEST_ASSERT_EQUAL(m_manuf.company_identifier, uint16_decode(&buf[slot.offset]));
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      ble_advdata_slot_find(buf, len, BLE_GAP_AD_TYPE_SERVICE_DATA, &slot));
+    TEST_ASSERT_EQUAL(2 + sizeof(m_srv_data), slot.len);
+
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND,
+                      ble_advdata_slot_find(buf, len, BLE_GAP_AD_TYPE_TX_POWER_LEVEL, &slot));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL,
+                      ble_advdata_slot_find(NULL, len, BLE_GAP_AD_TYPE_SERVICE_DATA, &slot));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL,
+                      ble_advdata_slot_find(buf, len, BLE_GAP_AD_TYPE_SERVICE_DATA, NULL));
+}
+
+
+static void test_slot_write_bounds(void)
+{
+    uint8_t            buf[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    uint8_t            copy[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    uint8_t const      data[8] = {0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5};
+    ble_advdata_slot_t slot;
+
+    advdata_setup();
+    uint16_t const len = encode(buf);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      ble_advdata_slot_find(buf, len, BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA, &slot));
+    memcpy(copy, buf, len);
+
+    /* Past the end of the slot, longer than the slot, and a slot beyond the data. */
+    TEST_ASSERT_EQUAL(NRF_ERROR_DATA_SIZE, ble_advdata_slot_write(buf, len, &slot, slot.len, data, 1));
+    TEST_ASSERT_EQUAL(NRF_ERROR_DATA_SIZE, ble_advdata_slot_write(buf, len, &slot, 0, data, slot.len + 1));
+    TEST_ASSERT_EQUAL(NRF_ERROR_DATA_SIZE, ble_advdata_slot_write(buf, slot.offset + 1, &slot, 0, data, 1));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL, ble_advdata_slot_write(buf, len, &slot, 0, NULL, 1));
+    TEST_ASSERT(memcmp(copy, buf, len) == 0);
+
+    /* The whole slot, and its last byte. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_write(buf, len, &slot, 0, data, slot.len));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_write(buf, len, &slot, slot.len - 1, data, 1));
+    TEST_ASSERT(memcmp(copy, buf, slot.offset) == 0);
+    TEST_ASSERT(memcmp(copy + slot.offset + slot.len,
+                       buf + slot.offset + slot.len,
+                       len - slot.offset - slot.len) == 0);
+}
+
+
+static void test_patch_equivalence(void)
+{
+    uint8_t            template[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    uint8_t            patched[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    uint8_t            encoded[BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    ble_advdata_slot_t manuf_slot;
+    ble_advdata_slot_t srv_slot;
+
+    advdata_setup();
+    memset(m_manuf_data, 0, sizeof(m_manuf_data));
+    memset(m_srv_data, 0, sizeof(m_srv_data));
+
+    uint16_t const len = encode(template);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_find(template, len,
+                                                         BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA,
+                                                         &manuf_slot));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_find(template, len,
+                                                         BLE_GAP_AD_TYPE_SERVICE_DATA,
+                                                         &srv_slot));
+    srand(1);
+
+    for (uint32_t round = 0; round < MODEL_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < sizeof(m_manuf_data); i++)
+        {
+            m_manuf_data[i] = (uint8_t)rand();
+        }
+        for (uint32_t i = 0; i < sizeof(m_srv_data); i++)
+        {
+            m_srv_data[i] = (uint8_t)rand();
+        }
+
+        /* Manufacturer data after the Company Identifier, service data after the UUID. */
+        memcpy(patched, template, len);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_write(patched, len, &manuf_slot, 2,
+                                                              m_manuf_data, sizeof(m_manuf_data)));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_write(patched, len, &srv_slot, 2,
+                                                              m_srv_data, sizeof(m_srv_data)));
+
+        TEST_ASSERT_EQUAL(len, encode(encoded));
+        TEST_ASSERT(memcmp(patched, encoded, len) == 0);
+    }
+}
+
+
+static void test_bench(void)
+{
+    static uint8_t     buf[2][BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+    volatile uint32_t  sink = 0;
+    ble_advdata_slot_t slot;
+
+    advdata_setup();
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+    {
+        m_manuf_data[0] = (uint8_t)i;
+        (void) encode(buf[i & 1]);
+        sink += buf[i & 1][10];
+    }
+
+    uint64_t const encode_end = test_time_ns();
+
+    uint16_t const len = encode(buf[0]);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_advdata_slot_find(buf[0], len,
+                                                         BLE_GAP_AD_TYPE_MANUFACTURER_SPECIFIC_DATA,
+                                                         &slot));
+
+    uint64_t const patch_start = test_time_ns();
+
+    /* As ble_advertising_advdata_patch() does: copy to the other buffer, then patch it. */
+    for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+    {
+        uint8_t const value = (uint8_t)i;
+
+        memcpy(buf[(i + 1) & 1], buf[i & 1], len);
+        (void) ble_advdata_slot_write(buf[(i + 1) & 1], len, &slot, 2, &value, sizeof(value));
+        sink += buf[(i + 1) & 1][10];
+    }
+
+    uint64_t const patch_end = test_time_ns();
+    (void) sink;
+
+    printf("    %u-byte payload: encode %.1f ns, patch %.1f ns per update\n",
+           len,
+           (double)(encode_end - start) / BENCH_ROUNDS,
+           (double)(patch_end - patch_start) / BENCH_ROUNDS);
+}
+
+
+int main(void)
+{
+    printf("test_advdata\n");
+
+    TEST_RUN(test_slot_find);
+    TEST_RUN(test_slot_write_bounds);
+    TEST_RUN(test_patch_equivalence);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
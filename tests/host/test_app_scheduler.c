@@ -0,0 +1,380 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* app_scheduler with priorities (APP_SCHEDULER_WITH_PRIORITIES).
+ *
+ * The single-threaded cases check the execution order of the priority levels, the promotion of a
+ * starved level after APP_SCHEDULER_STARVATION_LIMIT events and the handling of a full queue. The
+ * stress test runs producer threads, which stand in for interrupts, against the consumer in the
+ * main thread. The timestamp function yields in the producers, between the reservation of an entry
+ * and its ready flag, so that entries are published out of order. The consumer checks that the
+ * events of every producer and priority arrive complete, without gaps and in order. */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "app_scheduler.h"
+
+#define LEVELS          APP_SCHEDULER_PRIORITY_LEVELS
+#define QUEUE_SIZE      8
+#define PRODUCERS       4
+#define PHASES          20000
+#define PER_PHASE       (QUEUE_SIZE / PRODUCERS)    /* Events per producer, priority and phase. */
+
+typedef struct
+{
+    uint32_t producer;
+    uint32_t priority;
+    uint32_t seq;
+} event_t;
+
+static char     m_order[64];    /* Priorities of the executed events, as digits. */
+static uint32_t m_order_len;
+
+static uint32_t          m_next_seq[PRODUCERS][LEVELS];
+static uint32_t          m_received;
+static pthread_barrier_t m_phase_barrier;
+static __thread bool     m_in_producer;
+static __thread uint32_t m_yield_cnt;
+
+
+static void sched_init(void)
+{
+    APP_SCHED_INIT(sizeof(event_t), QUEUE_SIZE);
+
+    memset(m_order, 0, sizeof(m_order));
+    m_order_len = 0;
+    for (uint32_t i = 0; i < LEVELS; i++)
+    {
+        app_sched_prio_stats_t stats;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_prio_stats_get(i, &stats, true));
+    }
+}
+
+
+static void order_handler(void * p_event_data, uint16_t event_size)
+{
+    event_t const * p_evt = p_event_data;
+
+    TEST_ASSERT_EQUAL(sizeof(event_t), event_size);
+    TEST_ASSERT(m_order_len < sizeof(m_order) - 1);
+    m_order[m_order_len++] = (char)('0' + p_evt->priority);
+}
+
+
+static void put(uint32_t priority, uint32_t seq)
+{
+    event_t const evt = {.priority = priority, .seq = seq};
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      app_sched_event_put_prio(&evt, sizeof(evt), order_handler, (uint8_t)priority));
+}
+
+
+static void order_check(char const * p_expected)
+{
+    if (strcmp(p_expected, m_order) != 0)
+    {
+        fprintf(stderr, "order: expected \"%s\", got \"%s\"\n", p_expected, m_order);
+        TEST_ASSERT(false);
+    }
+}
+
+
+/* Levels are executed highest first, each in FIFO order. */
+static void test_priority_order(void)
+{
+    sched_init();
+
+    put(2, 0);
+    put(1, 0);
+    put(0, 0);
+    put(1, 1);
+    put(0, 1);
+    app_sched_execute();
+    order_check("00112");
+
+    // app_sched_event_put() uses the default priority.
+    event_t const evt = {.priority = APP_SCHEDULER_DEFAULT_PRIORITY};
+    put(2, 0);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_event_put(&evt, sizeof(evt), order_handler));
+    app_sched_execute();
+    order_check("00112" "12");
+}
+
+
+static void put_high_handler(void * p_event_data, uint16_t event_size)
+{
+    order_handler(p_event_data, event_size);
+    put(0, 0);
+}
+
+
+/* An event scheduled by a handler runs before the waiting events of lower priority. */
+static void test_put_from_handler(void)
+{
+    event_t const evt = {.priority = 1};
+
+    sched_init();
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_event_put_prio(&evt, sizeof(evt), put_high_handler, 1));
+    put(1, 1);
+    put(2, 0);
+    app_sched_execute();
+    order_check("1012");
+}
+
+
+/* A level that has waited for APP_SCHEDULER_STARVATION_LIMIT events runs next. Among starved
+ * levels, the highest runs first. */
+static void test_starvation(void)
+{
+    app_sched_prio_stats_t stats;
+
+    TEST_ASSERT_EQUAL(4, APP_SCHEDULER_STARVATION_LIMIT);
+    sched_init();
+
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        put(0, i);
+    }
+    put(2, 0);
+    app_sched_execute();
+    order_check("0000200");
+
+    sched_init();
+    for (uint32_t i = 0; i < QUEUE_SIZE; i++)
+    {
+        put(0, i);
+    }
+    put(1, 0);
+    put(1, 1);
+    put(2, 0);
+    put(2, 1);
+
+    // Both levels are starved at the same time, and are promoted in order. The second time,
+    // level 0 is empty and level 1 runs first anyway.
+    app_sched_execute();
+    order_check("000012000012");
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_prio_stats_get(0, &stats, false));
+    TEST_ASSERT_EQUAL(QUEUE_SIZE, stats.executed);
+    TEST_ASSERT_EQUAL(0, stats.starved);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_prio_stats_get(1, &stats, false));
+    TEST_ASSERT_EQUAL(2, stats.executed);
+    TEST_ASSERT_EQUAL(1, stats.starved);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_sched_prio_stats_get(2, &stats, false));
+    TEST_ASSERT_EQUAL(2, stats.executed);
+    TEST_ASSERT_EQUAL(1, stats.starved);
+}
+
+
+/* A full level rejects events without affecting the others, and accepts them again once drained.
+ * Repeated fill and drain cycles wrap the queue indices. */
+static void test_queue_full(void)
+{
+    event_t const evt = {0};
+    uint8_t       big[sizeof(event_t) + 1] = {0};
+
+    sched_init();
+
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM,
+                      app_sched_event_put_prio(&evt, sizeof(evt), order_handler, LEVELS));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_LENGTH,
+                      app_sched_event_put_prio(big, sizeof(big), order_handler, 0));
+
+    for (uint32_t cycle = 0; cycle < 3 * (QUEUE_SIZE + 1); cycle++)
+    {
+        for (uint32_t i = 0; i < QUEUE_SIZE; i++)
+        {
+            put(0, i);
+        }
+        TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM,
+                          app_sched_event_put_prio(&evt, sizeof(evt), order_handler, 0));
+
+        // The default level is not affected.
+        TEST_ASSERT_EQUAL(QUEUE_SIZE, app_sched_queue_space_get());
+        for (uint32_t i = 0; i < QUEUE_SIZE; i++)
+        {
+            put(APP_SCHEDULER_DEFAULT_PRIORITY, i);
+        }
+        TEST_ASSERT_EQUAL(0, app_sched_queue_space_get());
+        TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM, app_sched_event_put(&evt, sizeof(evt), order_handler));
+
+        m_order_len = 0;
+        memset(m_order, 0, sizeof(m_order));
+        app_sched_execute();
+        TEST_ASSERT_EQUAL(2 * QUEUE_SIZE, m_order_len);
+        TEST_ASSERT_EQUAL(QUEUE_SIZE, app_sched_queue_space_get());
+
+        // Partially drained levels take new events up to the same limit.
+        put(0, 0);
+        app_sched_execute();
+    }
+
+    TEST_ASSERT_EQUAL(QUEUE_SIZE, app_sched_queue_utilization_get());
+}
+
+
+/* Timestamp function, also the hook that widens the window between the reservation of an entry
+ * and its ready flag. */
+static uint32_t timestamp_get(void)
+{
+    if (m_in_producer && ((++m_yield_cnt % 3) == 0))
+    {
+        (void)sched_yield();
+    }
+    return 0;
+}
+
+
+static void stress_handler(void * p_event_data, uint16_t event_size)
+{
+    event_t const * p_evt = p_event_data;
+
+    TEST_ASSERT_EQUAL(sizeof(event_t), event_size);
+    TEST_ASSERT(p_evt->producer < PRODUCERS);
+    TEST_ASSERT(p_evt->priority < LEVELS);
+    TEST_ASSERT_EQUAL(m_next_seq[p_evt->producer][p_evt->priority], p_evt->seq);
+    m_next_seq[p_evt->producer][p_evt->priority]++;
+    m_received++;
+}
+
+
+/* On the device, the main loop cannot run while an interrupt that is putting an event is
+ * preempted, so the end index cannot lap a pending reservation. Threads are not preempted that
+ * way: the producers synchronize once per phase, and a phase puts no more than QUEUE_SIZE events
+ * per level, fewer than a full lap of the queue. */
+static void * producer_thread(void * p_arg)
+{
+    uint32_t const producer = (uint32_t)(uintptr_t)p_arg;
+    uint32_t       seq[LEVELS] = {0};
+
+    m_in_producer = true;
+
+    for (uint32_t phase = 0; phase < PHASES; phase++)
+    {
+        for (uint32_t i = 0; i < PER_PHASE * LEVELS; i++)
+        {
+            uint32_t const priority = (i + producer + phase) % LEVELS;
+            event_t const  evt      = {producer, priority, seq[priority]};
+
+            // The consumer may lag behind by more than a queue.
+            uint32_t err_code;
+            while ((err_code = app_sched_event_put_prio(&evt, sizeof(evt), stress_handler,
+                                                        (uint8_t)priority)) == NRF_ERROR_NO_MEM)
+            {
+                (void)sched_yield();
+            }
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, err_code);
+            seq[priority]++;
+        }
+
+        int const ret = pthread_barrier_wait(&m_phase_barrier);
+        TEST_ASSERT((ret == 0) || (ret == PTHREAD_BARRIER_SERIAL_THREAD));
+    }
+
+    return NULL;
+}
+
+
+static void test_producers(void)
+{
+    pthread_t      thread[PRODUCERS];
+    uint32_t const total = PRODUCERS * PHASES * PER_PHASE * LEVELS;
+
+    sched_init();
+    memset(m_next_seq, 0, sizeof(m_next_seq));
+    m_received = 0;
+    app_sched_timestamp_func_set(timestamp_get);
+    TEST_ASSERT(pthread_barrier_init(&m_phase_barrier, NULL, PRODUCERS) == 0);
+
+    uint64_t const t0 = test_time_ns();
+
+    for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+        TEST_ASSERT(pthread_create(&thread[i], NULL, producer_thread, (void *)(uintptr_t)i) == 0);
+    }
+
+    while (m_received < total)
+    {
+        app_sched_execute();
+        (void)sched_yield();
+    }
+
+    uint64_t const t1 = test_time_ns();
+
+    for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+        TEST_ASSERT(pthread_join(thread[i], NULL) == 0);
+    }
+    TEST_ASSERT(pthread_barrier_destroy(&m_phase_barrier) == 0);
+    app_sched_timestamp_func_set(NULL);
+
+    // Nothing is left over.
+    app_sched_execute();
+    TEST_ASSERT_EQUAL(total, m_received);
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        for (uint32_t l = 0; l < LEVELS; l++)
+        {
+            TEST_ASSERT_EQUAL(PHASES * PER_PHASE, m_next_seq[p][l]);
+        }
+    }
+    TEST_ASSERT_EQUAL(QUEUE_SIZE, app_sched_queue_space_get());
+
+    printf("    %u producers, %u levels: %u events, %.2f M events/s\n",
+           PRODUCERS, LEVELS, total, (double)total * 1000.0 / (double)(t1 - t0));
+}
+
+
+int main(void)
+{
+    printf("test_app_scheduler\n");
+
+    TEST_RUN(test_priority_order);
+    TEST_RUN(test_put_from_handler);
+    TEST_RUN(test_starvation);
+    TEST_RUN(test_queue_full);
+    TEST_RUN(test_producers);
+
+    return 0;
+}
@@ -0,0 +1,584 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* app_timer2 on a modelled RTC.
+ *
+ * The RTC driver is replaced by a model whose counter only advances when the test calls
+ * rtc_advance(). Events are generated exactly on the compare values and the interrupt handler runs
+ * in the calling thread, so that expiries can be checked to the tick. The test is built once with
+ * the sortlist timer queue and once with the pairing heap (APP_TIMER_CONFIG_USE_HEAP), and reports
+ * the cost of timer operations for both. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "app_timer.h"
+#include "drv_rtc.h"
+
+#define RTC_EVT_CC_COUNT    2
+
+#define CHECK_TIMERS        200
+#define CHECK_MAX_TIMEOUT   100000
+#define CHECK_ROUNDS        2000
+
+static uint32_t const m_bench_sizes[] = {10, 100, 1000, 10000};
+#define BENCH_MAX_TIMERS    10000
+#define BENCH_MAX_TIMEOUT   (1UL << 22)
+
+
+/* RTC model */
+
+static struct
+{
+    drv_rtc_handler_t handler;
+    bool              running;
+    uint32_t          counter;
+    uint64_t          ticks;                      /* Ticks elapsed while running, not wrapped. */
+    uint32_t          cc[RTC_EVT_CC_COUNT];
+    bool              cc_enabled[RTC_EVT_CC_COUNT];
+    bool              cc_evt[RTC_EVT_CC_COUNT];
+    bool              ovf_evt;
+    bool              in_irq;
+    bool              irq_pending;
+} m_rtc;
+
+
+static uint32_t ticks_sub(uint32_t a, uint32_t b)
+{
+    return (a - b) & DRV_RTC_MAX_CNT;
+}
+
+
+ret_code_t drv_rtc_init(drv_rtc_t const * const  p_instance,
+                        drv_rtc_config_t const * p_config,
+                        drv_rtc_handler_t        handler)
+{
+    memset(&m_rtc, 0, sizeof(m_rtc));
+    m_rtc.handler = handler;
+    return NRF_SUCCESS;
+}
+
+
+void drv_rtc_start(drv_rtc_t const * const p_instance)
+{
+    m_rtc.running = true;
+}
+
+
+void drv_rtc_stop(drv_rtc_t const * const p_instance)
+{
+    m_rtc.running = false;
+}
+
+
+void drv_rtc_compare_set(drv_rtc_t const * const p_instance,
+                         uint32_t                cc,
+                         uint32_t                abs_value,
+                         bool                    irq_enable)
+{
+    m_rtc.cc[cc]         = abs_value & DRV_RTC_MAX_CNT;
+    m_rtc.cc_enabled[cc] = irq_enable;
+}
+
+
+ret_code_t drv_rtc_windowed_compare_set(drv_rtc_t const * const p_instance,
+                                        uint32_t                cc,
+                                        uint32_t                abs_value,
+                                        uint32_t                safe_window)
+{
+    abs_value &= DRV_RTC_MAX_CNT;
+
+    /* The compare value is now, or behind the counter within the safe window. */
+    if (ticks_sub(abs_value - 1, m_rtc.counter) > (DRV_RTC_MAX_CNT - safe_window))
+    {
+        m_rtc.cc_enabled[cc] = false;
+        return NRF_ERROR_TIMEOUT;
+    }
+
+    m_rtc.cc[cc]         = abs_value;
+    m_rtc.cc_enabled[cc] = true;
+    return NRF_SUCCESS;
+}
+
+
+void drv_rtc_overflow_enable(drv_rtc_t const * const p_instance, bool irq_enable)
+{
+}
+
+
+bool drv_rtc_overflow_pending(drv_rtc_t const * const p_instance)
+{
+    bool const pending = m_rtc.ovf_evt;
+    m_rtc.ovf_evt = false;
+    return pending;
+}
+
+
+void drv_rtc_compare_disable(drv_rtc_t const * const p_instance, uint32_t cc)
+{
+    m_rtc.cc_enabled[cc] = false;
+}
+
+
+bool drv_rtc_compare_pending(drv_rtc_t const * const p_instance, uint32_t cc)
+{
+    bool const pending = m_rtc.cc_evt[cc];
+    m_rtc.cc_evt[cc] = false;
+    return pending;
+}
+
+
+uint32_t drv_rtc_compare_get(drv_rtc_t const * const p_instance, uint32_t cc)
+{
+    return m_rtc.cc[cc];
+}
+
+
+uint32_t drv_rtc_counter_get(drv_rtc_t const * const p_instance)
+{
+    return m_rtc.counter;
+}
+
+
+/* Requests made from the interrupt handler, such as starting a timer from its timeout handler,
+ * are processed when the handler returns, as a pended interrupt would be. */
+void drv_rtc_irq_trigger(drv_rtc_t const * const p_instance)
+{
+    if (m_rtc.in_irq)
+    {
+        m_rtc.irq_pending = true;
+        return;
+    }
+
+    m_rtc.in_irq = true;
+    do
+    {
+        m_rtc.irq_pending = false;
+        m_rtc.handler(p_instance);
+    } while (m_rtc.irq_pending);
+    m_rtc.in_irq = false;
+}
+
+
+/* Advance the counter by a number of ticks, generating the events on the way. */
+static void rtc_advance(uint64_t ticks)
+{
+    while (m_rtc.running && (ticks > 0))
+    {
+        /* Distance to the next event, in [1, DRV_RTC_MAX_CNT + 1]. */
+        uint64_t step = (uint64_t)DRV_RTC_MAX_CNT + 1 - m_rtc.counter;
+
+        for (uint32_t cc = 0; cc < RTC_EVT_CC_COUNT; cc++)
+        {
+            if (m_rtc.cc_enabled[cc])
+            {
+                uint64_t const dist = (uint64_t)ticks_sub(m_rtc.cc[cc], m_rtc.counter + 1) + 1;
+                step = (dist < step) ? dist : step;
+            }
+        }
+
+        if (step > ticks)
+        {
+            m_rtc.counter = (m_rtc.counter + ticks) & DRV_RTC_MAX_CNT;
+            m_rtc.ticks  += ticks;
+            return;
+        }
+
+        m_rtc.counter = (m_rtc.counter + step) & DRV_RTC_MAX_CNT;
+        m_rtc.ticks  += step;
+        ticks        -= step;
+
+        m_rtc.ovf_evt = (m_rtc.counter == 0);
+        for (uint32_t cc = 0; cc < RTC_EVT_CC_COUNT; cc++)
+        {
+            m_rtc.cc_evt[cc] = m_rtc.cc_enabled[cc] && (m_rtc.cc[cc] == m_rtc.counter);
+        }
+
+        drv_rtc_irq_trigger(NULL);
+    }
+}
+
+
+/* Timers under test */
+
+typedef struct
+{
+    app_timer_t timer;
+    uint64_t    expected;   /* Expected expiry, in model ticks. */
+    uint32_t    period;     /* Period of a repeated timer, 0 for a single shot one. */
+    uint32_t    slack;      /* The expiry may be deferred by up to this many ticks. */
+    uint32_t    expiries;
+    bool        active;
+} test_timer_t;
+
+static test_timer_t m_timers[BENCH_MAX_TIMERS];
+static uint64_t     m_last_expiry;
+static uint32_t     m_expiries;
+
+
+static void timeout_handler(void * p_context)
+{
+    test_timer_t * p_t = p_context;
+
+    /* Each timer expires on the tick it is due, or within its slack, and expiries come in order. */
+    TEST_ASSERT(p_t->active);
+    if (p_t->slack == 0)
+    {
+        TEST_ASSERT_EQUAL(p_t->expected, m_rtc.ticks);
+    }
+    else
+    {
+        TEST_ASSERT(m_rtc.ticks >= p_t->expected);
+        TEST_ASSERT(m_rtc.ticks <= p_t->expected + p_t->slack);
+    }
+    TEST_ASSERT(m_rtc.ticks >= m_last_expiry);
+
+    m_last_expiry = m_rtc.ticks;
+    m_expiries++;
+    p_t->expiries++;
+
+    if (p_t->period)
+    {
+        p_t->expected += p_t->period;
+    }
+    else
+    {
+        p_t->active = false;
+    }
+}
+
+
+static void timers_create(uint32_t count, bool repeated)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        app_timer_id_t const id = &m_timers[i].timer;
+
+        memset(&m_timers[i], 0, sizeof(m_timers[i]));
+        m_timers[i].timer.end_val = APP_TIMER_IDLE_VAL;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                          app_timer_create(&id,
+                                           repeated ? APP_TIMER_MODE_REPEATED : APP_TIMER_MODE_SINGLE_SHOT,
+                                           timeout_handler));
+    }
+}
+
+
+static void timer_start(test_timer_t * p_t, uint32_t timeout)
+{
+    p_t->expected = m_rtc.ticks + timeout;
+    p_t->period   = (p_t->timer.repeat_period != 0) ? timeout : 0;
+    p_t->active   = true;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_timer_start(&p_t->timer, timeout, p_t));
+}
+
+
+static void timer_stop(test_timer_t * p_t)
+{
+    p_t->active = false;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_timer_stop(&p_t->timer));
+}
+
+
+static void timer_slack_set(test_timer_t * p_t, uint32_t slack)
+{
+    p_t->slack = slack;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_timer_slack_set(&p_t->timer, slack));
+}
+
+
+/* Advance the counter to a multiple of the given alignment, so that the expiry ticks chosen within
+ * the slack windows are known. The RTC only runs while a timer is active, so a timer is started
+ * for the duration. */
+static void rtc_align(uint32_t alignment)
+{
+    static test_timer_t m_align_timer;
+    app_timer_id_t const id = &m_align_timer.timer;
+
+    memset(&m_align_timer, 0, sizeof(m_align_timer));
+    m_align_timer.timer.end_val = APP_TIMER_IDLE_VAL;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_timer_create(&id, APP_TIMER_MODE_SINGLE_SHOT, timeout_handler));
+    timer_start(&m_align_timer, 2 * alignment);
+    rtc_advance((alignment - (m_rtc.counter % alignment)) % alignment);
+    timer_stop(&m_align_timer);
+}
+
+
+static uint32_t random_timeout(uint32_t max)
+{
+    /* Expiries closer than the minimum the RTC driver can handle are not tested. */
+    return DRV_RTC_MIN_TICK_HANDLED + ((uint32_t)rand() % max);
+}
+
+
+/* Random starts, stops and time steps, with expiries checked in the timeout handler. The run lasts
+ * several counter periods, so that the 64-bit time is tested across overflows. */
+static void test_single_shot(void)
+{
+    uint32_t started = 0;
+
+    timers_create(CHECK_TIMERS, false);
+
+    for (uint32_t round = 0; round < CHECK_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            test_timer_t * p_t = &m_timers[(uint32_t)rand() % CHECK_TIMERS];
+
+            if (p_t->active)
+            {
+                timer_stop(p_t);
+            }
+            else
+            {
+                timer_start(p_t, random_timeout(CHECK_MAX_TIMEOUT));
+                started++;
+            }
+        }
+
+        rtc_advance(1 + ((uint32_t)rand() % (CHECK_MAX_TIMEOUT / 2)));
+    }
+
+    rtc_advance(CHECK_MAX_TIMEOUT + DRV_RTC_MIN_TICK_HANDLED);
+
+    for (uint32_t i = 0; i < CHECK_TIMERS; i++)
+    {
+        TEST_ASSERT(!m_timers[i].active);
+    }
+    TEST_ASSERT(m_rtc.ticks > 2 * ((uint64_t)DRV_RTC_MAX_CNT + 1));
+    TEST_ASSERT(m_expiries > started / 2);
+}
+
+
+/* Repeated timers keep their period, including when they share expiry ticks. */
+static void test_repeated(void)
+{
+    uint32_t const periods[] = {100, 250, 1000, 4096};
+    uint32_t const count     = ARRAY_SIZE(periods);
+    uint32_t const duration  = 100000;
+
+    timers_create(count, true);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        timer_start(&m_timers[i], periods[i]);
+    }
+
+    rtc_advance(duration);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(duration / periods[i], m_timers[i].expiries);
+        timer_stop(&m_timers[i]);
+    }
+
+    rtc_advance(duration);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(duration / periods[i], m_timers[i].expiries);
+    }
+}
+
+
+/* Single shot timers whose slack windows overlap expire on the same compare event. */
+static void test_slack_coalesce(void)
+{
+    uint32_t const           timeouts[] = {990, 1000, 1010};
+    uint32_t const           slacks[]   = {50, 100, 100};   /* All windows contain tick 1024. */
+    uint32_t const           count      = ARRAY_SIZE(timeouts);
+    app_timer_wakeup_stats_t stats;
+
+    for (uint32_t with_slack = 0; with_slack < 2; with_slack++)
+    {
+        timers_create(count, false);
+        rtc_align(4096);
+
+        uint64_t const t0 = m_rtc.ticks;
+
+        app_timer_wakeup_stats_get(&stats, true);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (with_slack)
+            {
+                timer_slack_set(&m_timers[i], slacks[i]);
+            }
+            timer_start(&m_timers[i], timeouts[i]);
+        }
+
+        rtc_advance(2 * timeouts[count - 1]);
+        app_timer_wakeup_stats_get(&stats, false);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            TEST_ASSERT_EQUAL(1, m_timers[i].expiries);
+        }
+        TEST_ASSERT_EQUAL(count, stats.expirations);
+        TEST_ASSERT_EQUAL(with_slack ? 1 : count, stats.wakeups);
+        TEST_ASSERT_EQUAL(t0 + (with_slack ? 1024 : timeouts[count - 1]), m_last_expiry);
+    }
+}
+
+
+/* Repeated timers with slack wake up less often, and do not drift: each period is counted from
+ * the nominal expiry, not from the deferred one. */
+static void test_slack_repeated(void)
+{
+    uint32_t const           periods[] = {1000, 1100, 1250, 1500, 2000};
+    uint32_t const           count     = ARRAY_SIZE(periods);
+    uint32_t const           duration  = 300000;
+    uint32_t                 wakeups[2];
+    app_timer_wakeup_stats_t stats;
+
+    for (uint32_t with_slack = 0; with_slack < 2; with_slack++)
+    {
+        uint32_t nominal_expiries = 0;
+
+        timers_create(count, true);
+        rtc_align(4096);
+
+        uint64_t const t0 = m_rtc.ticks;
+
+        app_timer_wakeup_stats_get(&stats, true);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (with_slack)
+            {
+                timer_slack_set(&m_timers[i], periods[i] / 4);
+            }
+            timer_start(&m_timers[i], periods[i]);
+            nominal_expiries += duration / periods[i];
+        }
+
+        rtc_advance(duration);
+        app_timer_wakeup_stats_get(&stats, true);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            test_timer_t const * p_t = &m_timers[i];
+
+            /* The next expiry is still on the nominal grid of the timer. */
+            TEST_ASSERT_EQUAL(t0 + (uint64_t)(p_t->expiries + 1) * periods[i], p_t->expected);
+            TEST_ASSERT_EQUAL(p_t->expected, p_t->timer.end_val - p_t->timer.slack_offset);
+            TEST_ASSERT(p_t->timer.slack_offset <= p_t->slack);
+
+            /* An expiry due at the end of the run may have been deferred past it. */
+            TEST_ASSERT(p_t->expiries + 1 >= duration / periods[i]);
+            TEST_ASSERT(p_t->expiries <= duration / periods[i]);
+        }
+
+        TEST_ASSERT(stats.expirations + count >= nominal_expiries);
+        TEST_ASSERT(stats.expirations <= nominal_expiries);
+        TEST_ASSERT_EQUAL((uint64_t)duration * 1000 * (APP_TIMER_CONFIG_RTC_FREQUENCY + 1) /
+                          APP_TIMER_CLOCK_FREQ,
+                          stats.period_ms);
+        wakeups[with_slack] = stats.wakeups;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            timer_stop(&m_timers[i]);
+        }
+    }
+
+    TEST_ASSERT(wakeups[1] < wakeups[0]);
+    printf("    %u repeated timers, %u ticks: %u wakeups exact, %u with a slack of 1/4 period\n",
+           count, duration, wakeups[0], wakeups[1]);
+}
+
+
+/* Cost of starting, stopping and expiring timers with a given number of them active. Each request
+ * runs the interrupt handler, as it would on the device. */
+static void bench(uint32_t count)
+{
+    uint32_t const rounds = (count < 1000) ? (100000 / count) : 10;
+    uint64_t       start_ns = 0;
+    uint64_t       stop_ns  = 0;
+    uint64_t       expire_ns = 0;
+
+    timers_create(count, false);
+
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        uint64_t t0 = test_time_ns();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            timer_start(&m_timers[i], random_timeout(BENCH_MAX_TIMEOUT));
+        }
+        uint64_t t1 = test_time_ns();
+        for (uint32_t i = 0; i < count; i += 2)
+        {
+            timer_stop(&m_timers[i]);
+        }
+        uint64_t t2 = test_time_ns();
+        rtc_advance(BENCH_MAX_TIMEOUT + DRV_RTC_MIN_TICK_HANDLED);
+        uint64_t t3 = test_time_ns();
+
+        start_ns  += t1 - t0;
+        stop_ns   += t2 - t1;
+        expire_ns += t3 - t2;
+    }
+
+    printf("    %5u timers: start %8.0f ns, stop %8.0f ns, expiry %8.0f ns\n",
+           count,
+           (double)start_ns  / rounds / count,
+           (double)stop_ns   / rounds / ((count + 1) / 2),
+           (double)expire_ns / rounds / (count / 2));
+}
+
+
+int main(void)
+{
+    printf("test_app_timer (%s)\n", APP_TIMER_CONFIG_USE_HEAP ? "heap" : "sortlist");
+
+    srand(1);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, app_timer_init());
+
+    TEST_RUN(test_single_shot);
+    TEST_RUN(test_repeated);
+    TEST_RUN(test_slack_coalesce);
+    TEST_RUN(test_slack_repeated);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(m_bench_sizes); i++)
+    {
+        bench(m_bench_sizes[i]);
+    }
+
+    return 0;
+}
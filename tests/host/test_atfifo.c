@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_atfifo batch functions, against a reference model of the FIFO contents.
+ *
+ * Random sequences of single-item, batch, zero-copy and nested operations run on a FIFO whose
+ * capacity does not divide the batch sizes, so that batches wrap around the end of the buffer.
+ * Nested operations stand in for an interrupt that preempts an open operation. Exclusive stores
+ * fail spuriously now and then, as they may on the device. The benchmark compares bursts of
+ * single-item operations with batch operations. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_atfifo.h"
+
+#define FIFO_CAPACITY       13
+#define OP_MAX_COUNT        16
+#define MODEL_OPS           2000000
+#define STREX_FAIL_PERIOD   5
+
+#define BENCH_ITEMS         8000000
+#define BENCH_BATCH         8
+
+NRF_ATFIFO_DEF(m_fifo, uint32_t, FIFO_CAPACITY);
+
+/* Expected contents of the FIFO, oldest item first. */
+static uint32_t m_model[FIFO_CAPACITY];
+static size_t   m_model_cnt;
+static uint32_t m_seq;
+
+
+static void model_push(uint32_t value)
+{
+    TEST_ASSERT(m_model_cnt < FIFO_CAPACITY);
+    m_model[m_model_cnt++] = value;
+}
+
+
+static void model_pop_check(uint32_t value)
+{
+    TEST_ASSERT(m_model_cnt > 0);
+    TEST_ASSERT_EQUAL(m_model[0], value);
+    memmove(m_model, m_model + 1, --m_model_cnt * sizeof(uint32_t));
+}
+
+
+static void op_put_n(size_t count)
+{
+    uint32_t     data[OP_MAX_COUNT];
+    size_t       put      = count;
+    size_t const expected = MIN(count, FIFO_CAPACITY - m_model_cnt);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data[i] = m_seq + i;
+    }
+
+    ret_code_t const err_code = nrf_atfifo_alloc_put_n(m_fifo, data, &put, NULL);
+    TEST_ASSERT_EQUAL(expected, put);
+    TEST_ASSERT_EQUAL((expected > 0) ? NRF_SUCCESS : NRF_ERROR_NO_MEM, err_code);
+
+    for (size_t i = 0; i < put; i++)
+    {
+        model_push(m_seq + i);
+    }
+    m_seq += put;
+}
+
+
+static void op_get_n(size_t count)
+{
+    uint32_t     data[OP_MAX_COUNT];
+    size_t       got      = count;
+    size_t const expected = MIN(count, m_model_cnt);
+
+    ret_code_t const err_code = nrf_atfifo_get_free_n(m_fifo, data, &got, NULL);
+    TEST_ASSERT_EQUAL(expected, got);
+    TEST_ASSERT_EQUAL((expected > 0) ? NRF_SUCCESS : NRF_ERROR_NOT_FOUND, err_code);
+
+    for (size_t i = 0; i < got; i++)
+    {
+        model_pop_check(data[i]);
+    }
+}
+
+
+/* Zero-copy batch write, optionally preempted by a batch write that completes first. */
+static void op_items_alloc(size_t count, bool nested)
+{
+    nrf_atfifo_item_put_t context;
+    size_t                reserved   = count;
+    size_t                nested_put = 0;
+    uint32_t            * p_items    = nrf_atfifo_items_alloc(m_fifo, &reserved, &context);
+
+    TEST_ASSERT((p_items == NULL) == (reserved == 0));
+    TEST_ASSERT(reserved <= MIN(count, FIFO_CAPACITY - m_model_cnt));
+    for (size_t i = 0; i < reserved; i++)
+    {
+        p_items[i] = m_seq + i;
+    }
+
+    if (nested)
+    {
+        uint32_t data[3] = {m_seq + reserved, m_seq + reserved + 1, m_seq + reserved + 2};
+
+        nested_put = ARRAY_SIZE(data);
+        (void) nrf_atfifo_alloc_put_n(m_fifo, data, &nested_put, NULL);
+    }
+
+    /* The outer operation publishes its items and the nested ones. */
+    TEST_ASSERT(nrf_atfifo_item_put(m_fifo, &context));
+
+    for (size_t i = 0; i < reserved + nested_put; i++)
+    {
+        model_push(m_seq + i);
+    }
+    m_seq += reserved + nested_put;
+}
+
+
+/* Zero-copy batch read, optionally preempted by a batch read that completes first. */
+static void op_items_get(size_t count, bool nested)
+{
+    nrf_atfifo_item_get_t context;
+    size_t                taken   = count;
+    uint32_t            * p_items = nrf_atfifo_items_get(m_fifo, &taken, &context);
+
+    TEST_ASSERT((p_items == NULL) == (taken == 0));
+    TEST_ASSERT(taken <= MIN(count, m_model_cnt));
+    for (size_t i = 0; i < taken; i++)
+    {
+        model_pop_check(p_items[i]);
+    }
+
+    if (nested && (p_items != NULL))
+    {
+        uint32_t data[2];
+        size_t   got = ARRAY_SIZE(data);
+
+        (void) nrf_atfifo_get_free_n(m_fifo, data, &got, NULL);
+        for (size_t i = 0; i < got; i++)
+        {
+            model_pop_check(data[i]);
+        }
+    }
+
+    (void) nrf_atfifo_item_free(m_fifo, &context);
+}
+
+
+static void op_single(void)
+{
+    uint32_t value = m_seq;
+
+    if (nrf_atfifo_alloc_put(m_fifo, &value, sizeof(value), NULL) == NRF_SUCCESS)
+    {
+        model_push(value);
+        m_seq++;
+    }
+
+    if ((rand() & 1) && (nrf_atfifo_get_free(m_fifo, &value, sizeof(value), NULL) == NRF_SUCCESS))
+    {
+        model_pop_check(value);
+    }
+}
+
+
+static void test_model(void)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, NRF_ATFIFO_INIT(m_fifo));
+    g_host_strex_fail_period = STREX_FAIL_PERIOD;
+    srand(1);
+
+    for (uint32_t op = 0; op < MODEL_OPS; op++)
+    {
+        size_t const count = 1 + ((size_t)rand() % OP_MAX_COUNT);
+
+        switch (rand() % 7)
+        {
+            case 0:
+                op_put_n(count);
+                break;
+
+            case 1:
+                op_get_n(count);
+                break;
+
+            case 2:
+            case 3:
+                op_items_alloc(count, rand() & 1);
+                break;
+
+            case 4:
+            case 5:
+                op_items_get(count, rand() & 1);
+                break;
+
+            default:
+                op_single();
+                break;
+        }
+    }
+
+    g_host_strex_fail_period = 0;
+}
+
+
+static void test_bench(void)
+{
+    uint32_t in[BENCH_BATCH] = {0};
+    uint32_t out[BENCH_BATCH];
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, NRF_ATFIFO_INIT(m_fifo));
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t batch = 0; batch < BENCH_ITEMS / BENCH_BATCH; batch++)
+    {
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_atfifo_alloc_put(m_fifo, &in[i], sizeof(in[i]), NULL));
+        }
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_atfifo_get_free(m_fifo, &out[i], sizeof(out[i]), NULL));
+        }
+    }
+
+    uint64_t const single_end = test_time_ns();
+
+    for (uint32_t batch = 0; batch < BENCH_ITEMS / BENCH_BATCH; batch++)
+    {
+        size_t count = BENCH_BATCH;
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_atfifo_alloc_put_n(m_fifo, in, &count, NULL));
+        TEST_ASSERT_EQUAL(BENCH_BATCH, count);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_atfifo_get_free_n(m_fifo, out, &count, NULL));
+        TEST_ASSERT_EQUAL(BENCH_BATCH, count);
+    }
+
+    uint64_t const batch_end = test_time_ns();
+
+    printf("    bursts of %u items: single %.1f ns, batch %.1f ns per item\n",
+           BENCH_BATCH,
+           (double)(single_end - start) / BENCH_ITEMS,
+           (double)(batch_end - single_end) / BENCH_ITEMS);
+}
+
+
+int main(void)
+{
+    printf("test_atfifo\n");
+
+    TEST_RUN(test_model);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
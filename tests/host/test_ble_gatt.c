@@ -0,0 +1,601 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_ble_gatt throughput profiles: order of the ATT_MTU exchange, the data length update and the
+ * PHY update, retries when the SoftDevice is busy or the peer rejects a procedure, and the
+ * NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED event.
+ *
+ * The SoftDevice calls are replaced by a model that records the accepted requests, in order, as
+ * one letter each: M (ATT_MTU exchange request), R (ATT_MTU exchange reply), D (data length
+ * update) and P (PHY update). Like the SoftDevice, the model runs one link layer procedure at a
+ * time and returns NRF_ERROR_BUSY while another one is in progress. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_ble_gatt.h"
+#include "ble_conn_state.h"
+#include "ble_hci.h"
+
+#define CONN_HANDLE     0
+#define MAX_MTU         NRF_SDH_BLE_GATT_MAX_MTU_SIZE
+#define MAX_DL          NRF_SDH_BLE_GAP_DATA_LENGTH
+#define DEFAULT_DL      27      /* Data length of a new connection. */
+
+/* Link layer procedure in progress in the model. */
+#define LL_NONE         0
+#define LL_DATA_LENGTH  'D'     /* Data length update of our own. */
+#define LL_PEER_DL      'd'     /* Data length update started by the peer, waiting for our reply. */
+#define LL_PHY          'P'
+#define LL_OTHER        'X'     /* A procedure that nrf_ble_gatt does not know about. */
+
+static nrf_ble_gatt_t m_gatt;
+
+static char     m_calls[32];    /* Requests accepted by the SoftDevice. */
+static uint32_t m_call_count;
+static uint32_t m_busy_count;   /* Requests rejected with NRF_ERROR_BUSY. */
+static char     m_ll_proc;
+static bool     m_mtu_busy;     /* An ATT procedure is in progress. */
+static uint32_t m_phy_err;      /* Error code of sd_ble_gap_phy_update(), if not NRF_SUCCESS. */
+static bool     m_connected[NRF_BLE_GATT_LINK_COUNT];
+
+/* Events received by the application. */
+static uint32_t                   m_link_params_count;
+static nrf_ble_gatt_link_params_t m_link_params;
+static uint32_t                   m_mtu_evt_count;
+static uint32_t                   m_dl_evt_count;
+
+
+static void call_add(char call)
+{
+    TEST_ASSERT(m_call_count < sizeof(m_calls) - 1);
+    m_calls[m_call_count++] = call;
+}
+
+
+uint32_t sd_ble_gattc_exchange_mtu_request(uint16_t conn_handle, uint16_t client_rx_mtu)
+{
+    TEST_ASSERT_EQUAL(MAX_MTU, client_rx_mtu);
+    if (m_mtu_busy)
+    {
+        m_busy_count++;
+        return NRF_ERROR_BUSY;
+    }
+    call_add('M');
+    m_mtu_busy = true;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_exchange_mtu_reply(uint16_t conn_handle, uint16_t server_rx_mtu)
+{
+    call_add('R');
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_data_length_update(uint16_t                             conn_handle,
+                                       ble_gap_data_length_params_t const * p_dl_params,
+                                       ble_gap_data_length_limitation_t   * p_dl_limitation)
+{
+    TEST_ASSERT(p_dl_params != NULL);
+    TEST_ASSERT_EQUAL(p_dl_params->max_tx_octets, p_dl_params->max_rx_octets);
+
+    if (m_ll_proc == LL_PEER_DL)
+    {
+        // Reply to the peer.
+        call_add('D');
+        m_ll_proc = LL_DATA_LENGTH;
+        return NRF_SUCCESS;
+    }
+    if (m_ll_proc != LL_NONE)
+    {
+        m_busy_count++;
+        return NRF_ERROR_BUSY;
+    }
+    call_add('D');
+    m_ll_proc = LL_DATA_LENGTH;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gap_phy_update(uint16_t conn_handle, ble_gap_phys_t const * p_gap_phys)
+{
+    TEST_ASSERT_EQUAL(BLE_GAP_PHY_2MBPS, p_gap_phys->tx_phys);
+    TEST_ASSERT_EQUAL(BLE_GAP_PHY_2MBPS, p_gap_phys->rx_phys);
+
+    if (m_phy_err != NRF_SUCCESS)
+    {
+        return m_phy_err;
+    }
+    if (m_ll_proc != LL_NONE)
+    {
+        m_busy_count++;
+        return NRF_ERROR_BUSY;
+    }
+    call_add('P');
+    m_ll_proc = LL_PHY;
+    return NRF_SUCCESS;
+}
+
+
+ble_conn_state_status_t ble_conn_state_status(uint16_t conn_handle)
+{
+    if (conn_handle >= NRF_BLE_GATT_LINK_COUNT)
+    {
+        return BLE_CONN_STATUS_INVALID;
+    }
+    return m_connected[conn_handle] ? BLE_CONN_STATUS_CONNECTED : BLE_CONN_STATUS_DISCONNECTED;
+}
+
+
+static void gatt_evt_handler(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const * p_evt)
+{
+    TEST_ASSERT(p_gatt == &m_gatt);
+    TEST_ASSERT_EQUAL(CONN_HANDLE, p_evt->conn_handle);
+
+    switch (p_evt->evt_id)
+    {
+        case NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED:
+            m_link_params_count++;
+            m_link_params = p_evt->params.link_params;
+            break;
+
+        case NRF_BLE_GATT_EVT_ATT_MTU_UPDATED:
+            m_mtu_evt_count++;
+            break;
+
+        case NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED:
+            m_dl_evt_count++;
+            break;
+
+        default:
+            TEST_ASSERT(false);
+            break;
+    }
+}
+
+
+static void evt_send(ble_evt_t * p_evt, uint16_t evt_id)
+{
+    p_evt->header.evt_id  = evt_id;
+    p_evt->header.evt_len = sizeof(*p_evt);
+    nrf_ble_gatt_on_ble_evt(p_evt, &m_gatt);
+}
+
+
+static void record_clear(void)
+{
+    memset(m_calls, 0, sizeof(m_calls));
+    m_call_count        = 0;
+    m_busy_count        = 0;
+    m_link_params_count = 0;
+    m_mtu_evt_count     = 0;
+    m_dl_evt_count      = 0;
+}
+
+
+static void connect(nrf_ble_gatt_profile_t profile)
+{
+    ble_evt_t evt = {0};
+
+    record_clear();
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gatt_profile_set(&m_gatt, BLE_CONN_HANDLE_INVALID, profile));
+
+    m_connected[CONN_HANDLE] = true;
+    evt.evt.gap_evt.conn_handle             = CONN_HANDLE;
+    evt.evt.gap_evt.params.connected.role   = BLE_GAP_ROLE_PERIPH;
+    evt_send(&evt, BLE_GAP_EVT_CONNECTED);
+}
+
+
+static void disconnect(void)
+{
+    ble_evt_t evt = {0};
+
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    evt_send(&evt, BLE_GAP_EVT_DISCONNECTED);
+    m_connected[CONN_HANDLE] = false;
+    m_ll_proc                = LL_NONE;
+    m_mtu_busy               = false;
+    m_phy_err                = NRF_SUCCESS;
+    record_clear();
+}
+
+
+/**@brief An event that nrf_ble_gatt does not handle, after which it retries busy requests. */
+static void other_evt(void)
+{
+    ble_evt_t evt = {0};
+
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    evt_send(&evt, BLE_GAP_EVT_CONN_PARAM_UPDATE);
+}
+
+
+static void mtu_rsp_evt(uint16_t server_rx_mtu)
+{
+    ble_evt_t evt = {0};
+
+    m_mtu_busy = false;
+    evt.evt.gattc_evt.conn_handle                          = CONN_HANDLE;
+    evt.evt.gattc_evt.params.exchange_mtu_rsp.server_rx_mtu = server_rx_mtu;
+    evt_send(&evt, BLE_GATTC_EVT_EXCHANGE_MTU_RSP);
+}
+
+
+static void mtu_request_evt(uint16_t client_rx_mtu)
+{
+    ble_evt_t evt = {0};
+
+    evt.evt.gatts_evt.conn_handle                               = CONN_HANDLE;
+    evt.evt.gatts_evt.params.exchange_mtu_request.client_rx_mtu = client_rx_mtu;
+    evt_send(&evt, BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST);
+}
+
+
+static void dl_update_evt(uint8_t octets)
+{
+    ble_evt_t evt = {0};
+
+    if (m_ll_proc == LL_DATA_LENGTH)
+    {
+        m_ll_proc = LL_NONE;
+    }
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    evt.evt.gap_evt.params.data_length_update.effective_params.max_tx_octets = octets;
+    evt.evt.gap_evt.params.data_length_update.effective_params.max_rx_octets = octets;
+    evt_send(&evt, BLE_GAP_EVT_DATA_LENGTH_UPDATE);
+}
+
+
+static void dl_update_request_evt(uint8_t octets)
+{
+    ble_evt_t evt = {0};
+
+    m_ll_proc = LL_PEER_DL;
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    evt.evt.gap_evt.params.data_length_update_request.peer_params.max_tx_octets = octets;
+    evt.evt.gap_evt.params.data_length_update_request.peer_params.max_rx_octets = octets;
+    evt_send(&evt, BLE_GAP_EVT_DATA_LENGTH_UPDATE_REQUEST);
+}
+
+
+static void phy_update_evt(uint8_t status, uint8_t phy)
+{
+    ble_evt_t evt = {0};
+
+    if (m_ll_proc == LL_PHY)
+    {
+        m_ll_proc = LL_NONE;
+    }
+    evt.evt.gap_evt.conn_handle              = CONN_HANDLE;
+    evt.evt.gap_evt.params.phy_update.status = status;
+    evt.evt.gap_evt.params.phy_update.tx_phy = phy;
+    evt.evt.gap_evt.params.phy_update.rx_phy = phy;
+    evt_send(&evt, BLE_GAP_EVT_PHY_UPDATE);
+}
+
+
+static void calls_check(char const * p_expected)
+{
+    if (strcmp(p_expected, m_calls) != 0)
+    {
+        fprintf(stderr, "requests: expected \"%s\", got \"%s\"\n", p_expected, m_calls);
+        TEST_ASSERT(false);
+    }
+}
+
+
+static void link_params_check(uint16_t mtu, uint8_t data_length, uint8_t phy)
+{
+    TEST_ASSERT_EQUAL(1, m_link_params_count);
+    TEST_ASSERT_EQUAL(mtu, m_link_params.att_mtu_effective);
+    TEST_ASSERT_EQUAL(data_length, m_link_params.data_length_effective);
+    TEST_ASSERT_EQUAL(phy, m_link_params.tx_phy);
+    TEST_ASSERT_EQUAL(phy, m_link_params.rx_phy);
+}
+
+
+/**@brief The PHY update starts only when the data length update has completed, and the link
+ *        parameters are reported once, when all procedures have completed. */
+static void test_bulk_order(void)
+{
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    calls_check("MD");
+
+    dl_update_evt(MAX_DL);
+    calls_check("MDP");
+    TEST_ASSERT_EQUAL(1, m_dl_evt_count);
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    mtu_rsp_evt(MAX_MTU);
+    TEST_ASSERT_EQUAL(1, m_mtu_evt_count);
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_2MBPS);
+
+    // Nothing else is started or reported.
+    other_evt();
+    calls_check("MDP");
+    TEST_ASSERT_EQUAL(1, m_link_params_count);
+    TEST_ASSERT_EQUAL(0, m_busy_count);
+    disconnect();
+
+    // The ATT_MTU response can also come last.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    dl_update_evt(MAX_DL);
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+    mtu_rsp_evt(100);
+    calls_check("MDP");
+    link_params_check(100, MAX_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+/**@brief Requests rejected because the SoftDevice is busy are retried after the next event. */
+static void test_busy(void)
+{
+    // A connection parameter update and an ATT procedure are in progress at connection.
+    m_ll_proc  = LL_OTHER;
+    m_mtu_busy = true;
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    calls_check("");
+    TEST_ASSERT(m_busy_count >= 2);
+
+    uint32_t const busy_count = m_busy_count;
+    other_evt();
+    calls_check("");
+    TEST_ASSERT_EQUAL(busy_count + 2, m_busy_count);
+
+    m_mtu_busy = false;
+    other_evt();
+    calls_check("M");
+
+    m_ll_proc = LL_NONE;
+    other_evt();
+    calls_check("MD");
+
+    // Another procedure starts as the data length update completes: the PHY update waits.
+    m_ll_proc = LL_OTHER;
+    dl_update_evt(MAX_DL);
+    calls_check("MD");
+    mtu_rsp_evt(MAX_MTU);
+    calls_check("MD");
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    m_ll_proc = LL_NONE;
+    other_evt();
+    calls_check("MDP");
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+/**@brief A PHY update rejected by the peer is retried a limited number of times, and not at all
+ *        if the peer does not support it. The link parameters are reported in any case. */
+static void test_phy_rejected(void)
+{
+    char expected[sizeof(m_calls)] = "MDP";
+
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(MAX_DL);
+    calls_check(expected);
+
+    for (uint32_t i = 0; i < NRF_BLE_GATT_PHY_UPDATE_RETRY_COUNT; i++)
+    {
+        phy_update_evt(BLE_HCI_STATUS_CODE_LMP_ERROR_TRANSACTION_COLLISION, BLE_GAP_PHY_1MBPS);
+        strcat(expected, "P");
+        calls_check(expected);
+        TEST_ASSERT_EQUAL(0, m_link_params_count);
+    }
+
+    phy_update_evt(BLE_HCI_STATUS_CODE_LMP_ERROR_TRANSACTION_COLLISION, BLE_GAP_PHY_1MBPS);
+    calls_check(expected);
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_1MBPS);
+    disconnect();
+
+    // Not supported by the peer.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(MAX_DL);
+    phy_update_evt(BLE_HCI_UNSUPPORTED_REMOTE_FEATURE, BLE_GAP_PHY_1MBPS);
+    calls_check("MDP");
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_1MBPS);
+    disconnect();
+
+    // Rejected by the SoftDevice.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    m_phy_err = NRF_ERROR_NOT_SUPPORTED;
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(MAX_DL);
+    calls_check("MD");
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_1MBPS);
+    disconnect();
+
+    // The peer limits the data length; the PHY update follows anyway.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(DEFAULT_DL);
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    calls_check("MDP");
+    link_params_check(MAX_MTU, DEFAULT_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+/**@brief Procedures started by the peer replace the pending requests of our own. */
+static void test_peer_initiated(void)
+{
+    m_ll_proc  = LL_OTHER;
+    m_mtu_busy = true;
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    calls_check("");
+
+    // The ATT_MTU request of the peer completes the exchange, ours is not sent.
+    mtu_request_evt(100);
+    calls_check("R");
+    TEST_ASSERT_EQUAL(1, m_mtu_evt_count);
+    m_mtu_busy = false;
+    other_evt();
+    calls_check("R");
+
+    // So does the data length update of the peer.
+    dl_update_request_evt(MAX_DL);
+    calls_check("RD");
+    other_evt();
+    calls_check("RD");
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    dl_update_evt(MAX_DL);
+    calls_check("RDP");
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    link_params_check(100, MAX_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+/**@brief The low power profile starts nothing, and reports the link parameters at once. Changing
+ *        to the bulk profile later skips the procedures that are no longer needed. */
+static void test_low_power(void)
+{
+    connect(NRF_BLE_GATT_PROFILE_LOW_POWER);
+    calls_check("");
+    link_params_check(BLE_GATT_ATT_MTU_DEFAULT, DEFAULT_DL, BLE_GAP_PHY_1MBPS);
+
+    // Requests from the peer are still answered.
+    mtu_request_evt(MAX_MTU);
+    calls_check("R");
+
+    m_link_params_count = 0;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE,
+                                                            NRF_BLE_GATT_PROFILE_BULK));
+    calls_check("RD");
+    dl_update_evt(MAX_DL);
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    calls_check("RDP");
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+/**@brief The default profile updates the ATT_MTU and the data length, without a PHY update and
+ *        without NRF_BLE_GATT_EVT_LINK_PARAMS_UPDATED. */
+static void test_default(void)
+{
+    connect(NRF_BLE_GATT_PROFILE_DEFAULT);
+    calls_check("MD");
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(MAX_DL);
+    other_evt();
+    calls_check("MD");
+    TEST_ASSERT_EQUAL(0, m_link_params_count);
+
+    // Only the PHY update is left for the bulk profile.
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE,
+                                                            NRF_BLE_GATT_PROFILE_BULK));
+    calls_check("MDP");
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    link_params_check(MAX_MTU, MAX_DL, BLE_GAP_PHY_2MBPS);
+    disconnect();
+}
+
+
+static void test_profile_set_errors(void)
+{
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL,
+                      nrf_ble_gatt_profile_set(NULL, CONN_HANDLE, NRF_BLE_GATT_PROFILE_BULK));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM,
+                      nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE,
+                                               (nrf_ble_gatt_profile_t)(NRF_BLE_GATT_PROFILE_LOW_POWER + 1)));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM,
+                      nrf_ble_gatt_profile_set(&m_gatt, NRF_BLE_GATT_LINK_COUNT,
+                                               NRF_BLE_GATT_PROFILE_BULK));
+
+    // Not connected.
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE,
+                      nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE, NRF_BLE_GATT_PROFILE_BULK));
+    calls_check("");
+
+    // The procedures of the current profile have not completed.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE,
+                      nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE, NRF_BLE_GATT_PROFILE_LOW_POWER));
+    mtu_rsp_evt(MAX_MTU);
+    dl_update_evt(MAX_DL);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE,
+                      nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE, NRF_BLE_GATT_PROFILE_LOW_POWER));
+    phy_update_evt(BLE_HCI_STATUS_CODE_SUCCESS, BLE_GAP_PHY_2MBPS);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      nrf_ble_gatt_profile_set(&m_gatt, CONN_HANDLE, NRF_BLE_GATT_PROFILE_LOW_POWER));
+    calls_check("MDP");
+    TEST_ASSERT_EQUAL(2, m_link_params_count);
+    disconnect();
+
+    // A disconnection in the middle of the procedures clears them.
+    connect(NRF_BLE_GATT_PROFILE_BULK);
+    disconnect();
+    connect(NRF_BLE_GATT_PROFILE_LOW_POWER);
+    link_params_check(BLE_GATT_ATT_MTU_DEFAULT, DEFAULT_DL, BLE_GAP_PHY_1MBPS);
+    disconnect();
+}
+
+
+int main(void)
+{
+    printf("test_ble_gatt\n");
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gatt_init(&m_gatt, gatt_evt_handler));
+
+    TEST_RUN(test_bulk_order);
+    TEST_RUN(test_busy);
+    TEST_RUN(test_phy_rejected);
+    TEST_RUN(test_peer_initiated);
+    TEST_RUN(test_low_power);
+    TEST_RUN(test_default);
+    TEST_RUN(test_profile_set_errors);
+
+    return 0;
+}
@@ -0,0 +1,501 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_ble_gq notifications with payload held by reference in memory objects, and queued
+ * notifications when the SoftDevice TX queue is full.
+ *
+ * sd_ble_gatts_hvx() is replaced by a stub that records the payload, or rejects the call while
+ * the test holds the SoftDevice TX queue full, so that requests take the buffered path. The stub
+ * also models the notification queue of the SoftDevice, which a connection event drains a few
+ * packets at a time before it reports them in one BLE_GATTS_EVT_HVN_TX_COMPLETE event. The test is
+ * built with and without NRF_BLE_GQ_HVX_BURST_ENABLED. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_ble_gq.h"
+
+#define CONN_HANDLE     0
+#define CHAR_HANDLE     0x10
+#define MEMOBJ_CHUNK    8
+#define MEMOBJ_COUNT    4
+
+#define SD_HVN_QUEUE_SIZE       6   /* Notifications the SoftDevice can hold. */
+#define SD_HVN_PER_CONN_EVT     4   /* Notifications sent in one connection event. */
+#define HVX_QUEUE_SIZE          16
+#define HVX_REQ_CNT             40
+
+NRF_BLE_GQ_DEF(m_gq, 1, 4);
+NRF_BLE_GQ_CUSTOM_DEF(m_gq_hvx, 1, HVX_QUEUE_SIZE, 20, HVX_QUEUE_SIZE);
+NRF_MEMOBJ_POOL_DEF(m_payload_pool, MEMOBJ_CHUNK, MEMOBJ_COUNT);
+
+static bool     m_sd_tx_full;
+static uint32_t m_sd_hvn_queued;
+static uint32_t m_hvx_cnt;
+static uint32_t m_hvx_rejected_cnt;
+static uint8_t  m_hvx_data[BLE_GATTS_VAR_ATTR_LEN_MAX];
+static uint16_t m_hvx_len;
+static uint8_t  m_hvx_seq[HVX_REQ_CNT];     /* First payload byte of each accepted request, in order. */
+static uint32_t m_hvx_seq_cnt;
+static uint32_t m_req_err_cnt;
+
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    bool const notification = (p_hvx_params->type == BLE_GATT_HVX_NOTIFICATION);
+
+    if (m_sd_tx_full || (notification && (m_sd_hvn_queued >= SD_HVN_QUEUE_SIZE)))
+    {
+        m_hvx_rejected_cnt++;
+        return NRF_ERROR_RESOURCES;
+    }
+
+    m_hvx_cnt++;
+    m_hvx_len = *p_hvx_params->p_len;
+    memcpy(m_hvx_data, p_hvx_params->p_data, m_hvx_len);
+    if (notification)
+    {
+        m_sd_hvn_queued++;
+    }
+    if (m_hvx_seq_cnt < ARRAY_SIZE(m_hvx_seq))
+    {
+        m_hvx_seq[m_hvx_seq_cnt++] = m_hvx_data[0];
+    }
+    return NRF_SUCCESS;
+}
+
+
+/* GATT client requests are not used by this test. */
+uint32_t sd_ble_gattc_read(uint16_t conn_handle, uint16_t handle, uint16_t offset)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t conn_handle, uint16_t start_handle, ble_uuid_t const * p_srvc_uuid)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_characteristics_discover(uint16_t conn_handle, ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_descriptors_discover(uint16_t conn_handle, ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_char_value_by_uuid_read(uint16_t conn_handle, ble_uuid_t const * p_uuid, ble_gattc_handle_range_t const * p_handle_range)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+static void hvn_tx_complete_evt_send(nrf_ble_gq_t * p_gq, uint8_t count)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                                = BLE_GATTS_EVT_HVN_TX_COMPLETE;
+    evt.evt.gatts_evt.conn_handle                    = CONN_HANDLE;
+    evt.evt.gatts_evt.params.hvn_tx_complete.count   = count;
+
+    nrf_ble_gq_on_ble_evt(&evt, p_gq);
+}
+
+
+/* Let the SoftDevice take notifications again and report a completed one. */
+static void sd_tx_complete(void)
+{
+    m_sd_tx_full    = false;
+    m_sd_hvn_queued = (m_sd_hvn_queued > 0) ? (m_sd_hvn_queued - 1) : 0;
+    hvn_tx_complete_evt_send(&m_gq, 1);
+}
+
+
+/* A connection event sends up to SD_HVN_PER_CONN_EVT queued notifications. Returns false if there
+ * was nothing to send, as the SoftDevice then reports no event. */
+static bool sd_conn_evt(void)
+{
+    uint32_t const count = MIN(m_sd_hvn_queued, SD_HVN_PER_CONN_EVT);
+
+    if (count == 0)
+    {
+        return false;
+    }
+    m_sd_hvn_queued -= count;
+    hvn_tx_complete_evt_send(&m_gq_hvx, (uint8_t)count);
+    return true;
+}
+
+
+static void req_err_handler(uint32_t nrf_error, void * p_context, uint16_t conn_handle)
+{
+    m_req_err_cnt++;
+}
+
+
+/* Queues a notification or an indication with a copied one-byte payload. */
+static void hvx_add(uint8_t seq, uint8_t type)
+{
+    nrf_ble_gq_req_t req;
+    uint16_t         len = sizeof(seq);
+
+    memset(&req, 0, sizeof(req));
+    req.type                     = NRF_BLE_GQ_REQ_GATTS_HVX;
+    req.error_handler.cb         = req_err_handler;
+    req.params.gatts_hvx.handle  = CHAR_HANDLE;
+    req.params.gatts_hvx.type    = type;
+    req.params.gatts_hvx.p_len   = &len;
+    req.params.gatts_hvx.p_data  = &seq;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_item_add(&m_gq_hvx, &req, CONN_HANDLE));
+}
+
+
+/* All requests were passed to the SoftDevice once, in the order they were added. */
+static void hvx_seq_check(uint32_t count)
+{
+    TEST_ASSERT_EQUAL(count, m_hvx_seq_cnt);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(i, m_hvx_seq[i]);
+    }
+    TEST_ASSERT_EQUAL(0, m_req_err_cnt);
+}
+
+
+static void hvx_seq_reset(void)
+{
+    while (sd_conn_evt())
+    {
+    }
+    m_hvx_seq_cnt = 0;
+}
+
+
+static nrf_memobj_t * payload_alloc(uint8_t first, uint16_t len)
+{
+    uint8_t        data[MEMOBJ_CHUNK * MEMOBJ_COUNT];
+    nrf_memobj_t * p_obj = nrf_memobj_alloc(&m_payload_pool, len);
+
+    TEST_ASSERT(p_obj != NULL);
+    nrf_memobj_get(p_obj);
+    for (uint16_t i = 0; i < len; i++)
+    {
+        data[i] = (uint8_t)(first + i);
+    }
+    nrf_memobj_write(p_obj, data, len, 0);
+
+    return p_obj;
+}
+
+
+static void req_init(nrf_ble_gq_req_t * p_req, uint8_t frag_cnt)
+{
+    memset(p_req, 0, sizeof(*p_req));
+    p_req->type                         = NRF_BLE_GQ_REQ_GATTS_HVX_REF;
+    p_req->params.gatts_hvx_ref.handle   = CHAR_HANDLE;
+    p_req->params.gatts_hvx_ref.type     = BLE_GATT_HVX_NOTIFICATION;
+    p_req->params.gatts_hvx_ref.frag_cnt = frag_cnt;
+}
+
+
+/* All memory objects were released, by the test and by the queue. */
+static void payload_pool_check(void)
+{
+    nrf_memobj_t * p_obj[MEMOBJ_COUNT + 1];
+    uint32_t       count = 0;
+
+    /* One-byte objects take one chunk each. */
+    while ((count < ARRAY_SIZE(p_obj)) && ((p_obj[count] = nrf_memobj_alloc(&m_payload_pool, 1)) != NULL))
+    {
+        count++;
+    }
+    TEST_ASSERT_EQUAL(MEMOBJ_COUNT, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        nrf_memobj_free(p_obj[i]);
+    }
+}
+
+
+/* Fragments are gathered across memory object chunks, both when sent directly and when queued. */
+static void test_gather(void)
+{
+    nrf_ble_gq_req_t req;
+    nrf_memobj_t   * p_a = payload_alloc(0, 10);
+    nrf_memobj_t   * p_b = payload_alloc(100, 6);
+
+    req_init(&req, 2);
+    req.params.gatts_hvx_ref.frags[0] = (nrf_ble_gq_memobj_frag_t){p_a, 2, 8};
+    req.params.gatts_hvx_ref.frags[1] = (nrf_ble_gq_memobj_frag_t){p_b, 0, 6};
+
+    for (uint32_t queued = 0; queued < 2; queued++)
+    {
+        uint32_t const hvx_cnt = m_hvx_cnt;
+
+        m_sd_tx_full = queued;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+        if (queued)
+        {
+            TEST_ASSERT_EQUAL(hvx_cnt, m_hvx_cnt);
+            sd_tx_complete();
+        }
+
+        TEST_ASSERT_EQUAL(hvx_cnt + 1, m_hvx_cnt);
+        TEST_ASSERT_EQUAL(14, m_hvx_len);
+        for (uint16_t i = 0; i < 8; i++)
+        {
+            TEST_ASSERT_EQUAL(2 + i, m_hvx_data[i]);
+        }
+        for (uint16_t i = 0; i < 6; i++)
+        {
+            TEST_ASSERT_EQUAL(100 + i, m_hvx_data[8 + i]);
+        }
+    }
+
+    nrf_memobj_put(p_a);
+    nrf_memobj_put(p_b);
+    payload_pool_check();
+}
+
+
+/* Invalid requests are rejected before they are sent or queued. */
+static void test_invalid(void)
+{
+    nrf_ble_gq_req_t req;
+    nrf_memobj_t   * p_obj    = payload_alloc(0, MEMOBJ_CHUNK);
+    uint32_t const   hvx_cnt  = m_hvx_cnt;
+
+    for (uint32_t queued = 0; queued < 2; queued++)
+    {
+        m_sd_tx_full = queued;
+
+        /* No fragments, and more fragments than the request holds. */
+        req_init(&req, 0);
+        TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+
+        req_init(&req, NRF_BLE_GQ_HVX_REF_MAX_FRAGS + 1);
+        for (uint8_t i = 0; i < NRF_BLE_GQ_HVX_REF_MAX_FRAGS; i++)
+        {
+            req.params.gatts_hvx_ref.frags[i] = (nrf_ble_gq_memobj_frag_t){p_obj, 0, 1};
+        }
+        TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+
+        /* Payload longer than the gather buffer. */
+        req_init(&req, 1);
+        req.params.gatts_hvx_ref.frags[0] =
+            (nrf_ble_gq_memobj_frag_t){p_obj, 0, NRF_BLE_GQ_GATTS_HVX_MAX_DATA_LEN + 1};
+        TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+
+        /* Fragment lengths whose 16-bit sum wraps around to a short payload. */
+        req_init(&req, 2);
+        req.params.gatts_hvx_ref.frags[0] = (nrf_ble_gq_memobj_frag_t){p_obj, 0, 0xFFFF};
+        req.params.gatts_hvx_ref.frags[1] = (nrf_ble_gq_memobj_frag_t){p_obj, 0, 2};
+        TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+
+        /* Fragment without a memory object. */
+        req_init(&req, 1);
+        req.params.gatts_hvx_ref.frags[0] = (nrf_ble_gq_memobj_frag_t){NULL, 0, 1};
+        TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_ble_gq_item_add(&m_gq, &req, CONN_HANDLE));
+    }
+
+    /* Nothing was queued. */
+    sd_tx_complete();
+    TEST_ASSERT_EQUAL(hvx_cnt, m_hvx_cnt);
+
+    nrf_memobj_put(p_obj);
+    payload_pool_check();
+}
+
+
+/* Notifications the SoftDevice cannot take are queued and retried, in order, on later events.
+ * NRF_ERROR_RESOURCES does not drop them. */
+static void test_resources_retry(void)
+{
+    hvx_seq_reset();
+
+    /* The first ones go straight to the SoftDevice, until its queue is full. */
+    for (uint8_t i = 0; i < HVX_QUEUE_SIZE; i++)
+    {
+        hvx_add(i, BLE_GATT_HVX_NOTIFICATION);
+    }
+    TEST_ASSERT_EQUAL(SD_HVN_QUEUE_SIZE, m_hvx_seq_cnt);
+
+    /* New requests are added while the queue drains, to keep it full. */
+    for (uint8_t i = HVX_QUEUE_SIZE; i < HVX_REQ_CNT; )
+    {
+        TEST_ASSERT(sd_conn_evt());
+        while ((i < HVX_REQ_CNT) && (i - m_hvx_seq_cnt < HVX_QUEUE_SIZE))
+        {
+            hvx_add(i++, BLE_GATT_HVX_NOTIFICATION);
+        }
+    }
+    while (sd_conn_evt())
+    {
+    }
+    hvx_seq_check(HVX_REQ_CNT);
+}
+
+
+/* Connection events needed to send a full queue, behind a full SoftDevice queue. */
+static void test_hvn_per_conn_evt(void)
+{
+    uint32_t const count   = SD_HVN_QUEUE_SIZE + HVX_QUEUE_SIZE;
+    uint32_t       evt_cnt = 0;
+
+    hvx_seq_reset();
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    nrf_ble_gq_hvx_stats_t before;
+    nrf_ble_gq_hvx_stats_t after;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_hvx_stats_get(&m_gq_hvx, CONN_HANDLE, &before));
+#endif
+    for (uint8_t i = 0; i < count; i++)
+    {
+        hvx_add(i, BLE_GATT_HVX_NOTIFICATION);
+    }
+
+    while (sd_conn_evt())
+    {
+        evt_cnt++;
+    }
+    hvx_seq_check(count);
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    /* Every connection event is filled. */
+    TEST_ASSERT_EQUAL(CEIL_DIV(count, SD_HVN_PER_CONN_EVT), evt_cnt);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_hvx_stats_get(&m_gq_hvx, CONN_HANDLE, &after));
+    TEST_ASSERT_EQUAL(count, after.hvn_tx_cnt - before.hvn_tx_cnt);
+    TEST_ASSERT_EQUAL(evt_cnt, after.tx_complete_cnt - before.tx_complete_cnt);
+    TEST_ASSERT_EQUAL(SD_HVN_PER_CONN_EVT, after.max_burst);
+    TEST_ASSERT(after.resources_cnt > before.resources_cnt);
+#else
+    /* One queued request is passed to the SoftDevice per event. */
+    TEST_ASSERT(evt_cnt >= HVX_QUEUE_SIZE);
+#endif
+    printf("    %u notifications in %u connection events\n", count, evt_cnt);
+}
+
+
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+/* Once the credits are known, the queue does not call the SoftDevice without a credit, and a
+ * completion event releases exactly as many notifications as it reports. */
+static void test_credit_exhaustion(void)
+{
+    uint32_t rejected_cnt;
+
+    hvx_seq_reset();
+
+    for (uint8_t i = 0; i < HVX_QUEUE_SIZE; i++)
+    {
+        hvx_add(i, BLE_GATT_HVX_NOTIFICATION);
+    }
+    rejected_cnt = m_hvx_rejected_cnt;
+
+    /* No credits: adding a request only queues it. */
+    hvx_add(HVX_QUEUE_SIZE, BLE_GATT_HVX_NOTIFICATION);
+    TEST_ASSERT_EQUAL(rejected_cnt, m_hvx_rejected_cnt);
+    TEST_ASSERT_EQUAL(SD_HVN_QUEUE_SIZE, m_hvx_seq_cnt);
+
+    /* A completion of 2 gives 2 credits, whatever the SoftDevice could take. */
+    m_sd_hvn_queued -= 4;
+    hvn_tx_complete_evt_send(&m_gq_hvx, 2);
+    TEST_ASSERT_EQUAL(SD_HVN_QUEUE_SIZE + 2, m_hvx_seq_cnt);
+    TEST_ASSERT_EQUAL(rejected_cnt, m_hvx_rejected_cnt);
+
+    while (sd_conn_evt())
+    {
+    }
+    TEST_ASSERT_EQUAL(rejected_cnt, m_hvx_rejected_cnt);
+    hvx_seq_check(HVX_QUEUE_SIZE + 1);
+}
+
+
+/* A burst stops after a request that is not a notification. */
+static void test_burst_indication(void)
+{
+    hvx_seq_reset();
+
+    for (uint8_t i = 0; i < SD_HVN_QUEUE_SIZE; i++)
+    {
+        hvx_add(i, BLE_GATT_HVX_NOTIFICATION);
+    }
+    hvx_add(SD_HVN_QUEUE_SIZE + 0, BLE_GATT_HVX_NOTIFICATION);
+    hvx_add(SD_HVN_QUEUE_SIZE + 1, BLE_GATT_HVX_INDICATION);
+    hvx_add(SD_HVN_QUEUE_SIZE + 2, BLE_GATT_HVX_NOTIFICATION);
+
+    TEST_ASSERT(sd_conn_evt());
+    TEST_ASSERT_EQUAL(SD_HVN_QUEUE_SIZE + 2, m_hvx_seq_cnt);
+
+    hvn_tx_complete_evt_send(&m_gq_hvx, 0);
+    TEST_ASSERT_EQUAL(SD_HVN_QUEUE_SIZE + 3, m_hvx_seq_cnt);
+    hvx_seq_check(SD_HVN_QUEUE_SIZE + 3);
+}
+#endif
+
+
+int main(void)
+{
+    printf("test_ble_gq%s\n", NRF_BLE_GQ_HVX_BURST_ENABLED ? " (burst)" : "");
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_memobj_pool_init(&m_payload_pool));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_conn_handle_register(&m_gq, CONN_HANDLE));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_gq_conn_handle_register(&m_gq_hvx, CONN_HANDLE));
+
+    TEST_RUN(test_gather);
+    TEST_RUN(test_invalid);
+    TEST_RUN(test_resources_retry);
+    TEST_RUN(test_hvn_per_conn_evt);
+#if (NRF_BLE_GQ_HVX_BURST_ENABLED == 1)
+    TEST_RUN(test_credit_exhaustion);
+    TEST_RUN(test_burst_indication);
+#endif
+
+    return 0;
+}
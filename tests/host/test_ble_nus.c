@@ -0,0 +1,486 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* ble_nus streams, against a SoftDevice stub with a notification queue.
+ *
+ * The stub queues notifications up to a configurable queue size, and each simulated connection
+ * event drains as many as fit in the event. Events reach the module through the BLE observers,
+ * with ble_conn_state and the link context manager in place. The functional tests check buffer
+ * and producer streams, the notification size from the GATT module, and how errors end a stream.
+ * The throughput model compares refilling on BLE_NUS_EVT_TX_RDY with streaming for a 64 kB
+ * export at the ATT MTU of the office app. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "nrf_section.h"
+#include "nrf_sdh_ble.h"
+#include "ble_nus.h"
+
+#define CONN_HANDLE     0
+#define APP_ATT_MTU     120                                 /* NRF_SDH_BLE_GATT_MAX_MTU_SIZE of the office app. */
+#define APP_DATA_LEN    (APP_ATT_MTU - OPCODE_LENGTH - HANDLE_LENGTH)
+#define LL_PAYLOAD      124                                 /* NRF_SDH_BLE_GAP_DATA_LENGTH of the office app. */
+#define PRODUCER_BLOCK  1000
+
+/* The observers registered by the modules under test, normally dispatched by nrf_sdh_ble. */
+NRF_SECTION_DEF(sdh_ble_observers, nrf_sdh_ble_evt_observer_t);
+
+BLE_NUS_DEF(m_nus, 1);
+
+static struct
+{
+    uint32_t queue_size;    /* Notifications the SoftDevice can hold. */
+    uint32_t queued;        /* Notifications waiting for a connection event. */
+    uint32_t per_event;     /* Notifications sent in one connection event. */
+    uint32_t hvx_calls;
+    uint32_t hvx_max_len;
+    uint32_t err_after;     /* Fail the hvx calls after this many have succeeded, if err_code is set. */
+    uint32_t err_code;
+    uint32_t air_bytes;
+} m_sd;
+
+static struct
+{
+    uint32_t done_cnt;
+    uint32_t bytes_sent;
+    uint32_t status;
+    uint32_t tx_rdy_cnt;
+} m_app;
+
+static uint8_t  m_log[64 * 1024];
+static uint32_t m_producer_offset;
+static bool     m_legacy;
+static uint32_t m_legacy_offset;
+
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    if ((m_sd.err_code != NRF_SUCCESS) && (m_sd.hvx_calls >= m_sd.err_after))
+    {
+        return m_sd.err_code;
+    }
+    if (*p_hvx_params->p_len > APP_DATA_LEN)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    if (m_sd.queued == m_sd.queue_size)
+    {
+        return NRF_ERROR_RESOURCES;
+    }
+
+    m_sd.hvx_calls++;
+    m_sd.queued++;
+    m_sd.air_bytes  += *p_hvx_params->p_len;
+    m_sd.hvx_max_len = MAX(m_sd.hvx_max_len, *p_hvx_params->p_len);
+    return NRF_SUCCESS;
+}
+
+
+/* The peer has enabled notifications. */
+uint32_t sd_ble_gatts_value_get(uint16_t conn_handle, uint16_t handle, ble_gatts_value_t * p_value)
+{
+    p_value->p_value[0] = BLE_GATT_HVX_NOTIFICATION;
+    p_value->p_value[1] = 0;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_uuid_vs_add(ble_uuid128_t const * p_vs_uuid, uint8_t * p_uuid_type)
+{
+    *p_uuid_type = BLE_UUID_TYPE_VENDOR_BEGIN;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_add(uint8_t type, ble_uuid_t const * p_uuid, uint16_t * p_handle)
+{
+    *p_handle = 1;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_characteristic_add(uint16_t                         service_handle,
+                                         ble_gatts_char_md_t      const * p_char_md,
+                                         ble_gatts_attr_t         const * p_attr_char_value,
+                                         ble_gatts_char_handles_t       * p_handles)
+{
+    static uint16_t handle = 2;
+
+    memset(p_handles, 0, sizeof(*p_handles));
+    p_handles->value_handle = handle++;
+    p_handles->cccd_handle  = handle++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_descriptor_add(uint16_t                 char_handle,
+                                     ble_gatts_attr_t const * p_attr,
+                                     uint16_t               * p_handle)
+{
+    return NRF_SUCCESS;
+}
+
+
+/* Dispatch an event to the BLE observers, as nrf_sdh_ble does. */
+static void ble_evt_send(ble_evt_t const * p_ble_evt)
+{
+    uint32_t const cnt = NRF_SECTION_ITEM_COUNT(sdh_ble_observers, nrf_sdh_ble_evt_observer_t);
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        nrf_sdh_ble_evt_observer_t * p_observer =
+            NRF_SECTION_ITEM_GET(sdh_ble_observers, nrf_sdh_ble_evt_observer_t, i);
+
+        p_observer->handler(p_ble_evt, p_observer->p_context);
+    }
+}
+
+
+static void legacy_send(void)
+{
+    if (m_legacy_offset < sizeof(m_log))
+    {
+        uint16_t length = MIN(sizeof(m_log) - m_legacy_offset, APP_DATA_LEN);
+
+        if (ble_nus_data_send(&m_nus, &m_log[m_legacy_offset], &length, CONN_HANDLE) == NRF_SUCCESS)
+        {
+            m_legacy_offset += length;
+        }
+    }
+}
+
+
+static void nus_evt_handler(ble_nus_evt_t * p_evt)
+{
+    switch (p_evt->type)
+    {
+        case BLE_NUS_EVT_STREAM_DONE:
+            m_app.done_cnt++;
+            m_app.bytes_sent = p_evt->params.stream.bytes_sent;
+            m_app.status     = p_evt->params.stream.status;
+            break;
+
+        case BLE_NUS_EVT_TX_RDY:
+            m_app.tx_rdy_cnt++;
+            if (m_legacy)
+            {
+                legacy_send();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+static uint32_t producer(uint16_t conn_handle, uint8_t const ** pp_data, void * p_context)
+{
+    uint32_t const length = MIN(PRODUCER_BLOCK, sizeof(m_log) - m_producer_offset);
+
+    *pp_data           = &m_log[m_producer_offset];
+    m_producer_offset += length;
+    return length;
+}
+
+
+/* Connect, with the ATT MTU negotiated by the GATT module, or without an exchange if 0. */
+static void connect(uint16_t att_mtu)
+{
+    ble_evt_t evt;
+
+    memset(&m_sd, 0, sizeof(m_sd));
+    memset(&m_app, 0, sizeof(m_app));
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                     = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle           = CONN_HANDLE;
+    evt.evt.gap_evt.params.connected.role = BLE_GAP_ROLE_PERIPH;
+    ble_evt_send(&evt);
+
+    if (att_mtu != 0)
+    {
+        nrf_ble_gatt_evt_t const gatt_evt =
+        {
+            .evt_id                   = NRF_BLE_GATT_EVT_ATT_MTU_UPDATED,
+            .conn_handle              = CONN_HANDLE,
+            .params.att_mtu_effective = att_mtu,
+        };
+
+        ble_nus_on_gatt_evt(&m_nus, &gatt_evt);
+    }
+}
+
+
+static void disconnect(void)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                          = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle                = CONN_HANDLE;
+    evt.evt.gap_evt.params.disconnected.reason = BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION;
+    ble_evt_send(&evt);
+}
+
+
+/* Transmit the notifications that fit in one connection event. */
+static uint32_t conn_event(void)
+{
+    uint32_t const sent = MIN(m_sd.queued, m_sd.per_event);
+
+    m_sd.queued -= sent;
+    if (sent != 0)
+    {
+        ble_evt_t evt;
+
+        memset(&evt, 0, sizeof(evt));
+        evt.header.evt_id                              = BLE_GATTS_EVT_HVN_TX_COMPLETE;
+        evt.evt.gatts_evt.conn_handle                  = CONN_HANDLE;
+        evt.evt.gatts_evt.params.hvn_tx_complete.count = sent;
+        ble_evt_send(&evt);
+    }
+    return sent;
+}
+
+
+static void test_mtu(void)
+{
+    /* The default ATT MTU until the GATT module reports the negotiated one. */
+    connect(0);
+    m_sd.queue_size = 1;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 100));
+    TEST_ASSERT_EQUAL(BLE_GATT_ATT_MTU_DEFAULT - OPCODE_LENGTH - HANDLE_LENGTH, m_sd.hvx_max_len);
+    disconnect();
+
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 1;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    TEST_ASSERT_EQUAL(APP_DATA_LEN, m_sd.hvx_max_len);
+    disconnect();
+}
+
+
+static void test_stream_buffer(void)
+{
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 3;
+    m_sd.per_event  = 2;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    TEST_ASSERT_EQUAL(3, m_sd.queued);
+    TEST_ASSERT_EQUAL(NRF_ERROR_BUSY, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 10));
+
+    while (m_app.done_cnt == 0)
+    {
+        TEST_ASSERT(conn_event() > 0);
+    }
+
+    TEST_ASSERT_EQUAL(1000, m_app.bytes_sent);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, m_app.status);
+    TEST_ASSERT_EQUAL(1000, m_sd.air_bytes);
+    TEST_ASSERT_EQUAL(CEIL_DIV(1000, APP_DATA_LEN), m_sd.hvx_calls);
+    TEST_ASSERT_EQUAL(0, m_app.tx_rdy_cnt);
+    disconnect();
+}
+
+
+static void test_stream_producer(void)
+{
+    connect(APP_ATT_MTU);
+    m_sd.queue_size   = 4;
+    m_sd.per_event    = 4;
+    m_producer_offset = 0;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_producer_start(&m_nus, CONN_HANDLE, producer, NULL));
+
+    while (m_app.done_cnt == 0)
+    {
+        TEST_ASSERT(conn_event() > 0);
+    }
+
+    TEST_ASSERT_EQUAL(sizeof(m_log), m_app.bytes_sent);
+    TEST_ASSERT_EQUAL(sizeof(m_log), m_sd.air_bytes);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, m_app.status);
+    disconnect();
+}
+
+
+static void test_stream_errors(void)
+{
+    /* The first notification fails: no stream, no event. */
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 8;
+    m_sd.err_code   = NRF_ERROR_INVALID_STATE;
+    m_sd.err_after  = 0;
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    TEST_ASSERT_EQUAL(0, m_app.done_cnt);
+    m_sd.err_code = NRF_SUCCESS;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    disconnect();
+
+    /* A later notification fails while starting: the stream ends with the error. */
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 8;
+    m_sd.err_code   = NRF_ERROR_INVALID_STATE;
+    m_sd.err_after  = 2;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    TEST_ASSERT_EQUAL(1, m_app.done_cnt);
+    TEST_ASSERT_EQUAL(2 * APP_DATA_LEN, m_app.bytes_sent);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, m_app.status);
+    m_sd.err_code = NRF_SUCCESS;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    disconnect();
+
+    /* A notification fails after a connection event. */
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 2;
+    m_sd.per_event  = 2;
+    m_sd.err_code   = NRF_ERROR_INVALID_STATE;
+    m_sd.err_after  = 3;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    TEST_ASSERT_EQUAL(0, m_app.done_cnt);
+    (void) conn_event();
+    TEST_ASSERT_EQUAL(1, m_app.done_cnt);
+    TEST_ASSERT_EQUAL(3 * APP_DATA_LEN, m_app.bytes_sent);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, m_app.status);
+    disconnect();
+
+    /* Disconnection ends the stream. */
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = 2;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, 1000));
+    disconnect();
+    TEST_ASSERT_EQUAL(1, m_app.done_cnt);
+    TEST_ASSERT_EQUAL(BLE_ERROR_INVALID_CONN_HANDLE, m_app.status);
+}
+
+
+/* Throughput of a 64 kB export, in kB/s. Each connection event sends as many packets as fit in
+ * the event length, with an empty packet from the peer after each of them. */
+static double throughput_run(bool     streaming,
+                             uint32_t queue_size,
+                             double   interval_ms,
+                             double   event_ms,
+                             uint32_t phy_mbps)
+{
+    double const packet_us = ((1 + 4 + 2 + LL_PAYLOAD + 3) * 8.0 / phy_mbps) + 150
+                           + ((1 + 4 + 2 + 3) * 8.0 / phy_mbps) + 150;
+    uint32_t     events    = 0;
+
+    connect(APP_ATT_MTU);
+    m_sd.queue_size = queue_size;
+    m_sd.per_event  = (uint32_t)(MIN(event_ms, interval_ms) * 1000 / packet_us);
+    m_legacy        = !streaming;
+    m_legacy_offset = 0;
+
+    if (streaming)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_stream_start(&m_nus, CONN_HANDLE, m_log, sizeof(m_log)));
+    }
+    else
+    {
+        legacy_send();
+    }
+
+    while (streaming ? (m_app.done_cnt == 0) : ((m_legacy_offset < sizeof(m_log)) || (m_sd.queued != 0)))
+    {
+        (void) conn_event();
+        events++;
+    }
+
+    TEST_ASSERT_EQUAL(sizeof(m_log), m_sd.air_bytes);
+    disconnect();
+    m_legacy = false;
+
+    return (sizeof(m_log) / 1024.0) / (events * interval_ms / 1000.0);
+}
+
+
+static void test_throughput(void)
+{
+    static struct
+    {
+        uint32_t queue_size;
+        double   interval_ms;
+        double   event_ms;
+        uint32_t phy_mbps;
+    } const configs[] =
+    {
+        {1, 100, 7.5, 1},
+        {1, 7.5, 7.5, 1},
+        {4, 7.5, 7.5, 1},
+        {8, 7.5, 7.5, 1},
+        {8, 7.5, 7.5, 2},
+        {8, 30,  30,  2},
+    };
+
+    printf("    queue  CI ms  event ms  PHY  TX_RDY kB/s  stream kB/s\n");
+    for (uint32_t i = 0; i < ARRAY_SIZE(configs); i++)
+    {
+        double const legacy = throughput_run(false, configs[i].queue_size, configs[i].interval_ms,
+                                             configs[i].event_ms, configs[i].phy_mbps);
+        double const stream = throughput_run(true, configs[i].queue_size, configs[i].interval_ms,
+                                             configs[i].event_ms, configs[i].phy_mbps);
+
+        printf("    %5u  %5.1f  %8.1f  %uM   %11.1f  %11.1f\n",
+               configs[i].queue_size, configs[i].interval_ms, configs[i].event_ms,
+               configs[i].phy_mbps, legacy, stream);
+    }
+}
+
+
+int main(void)
+{
+    ble_nus_init_t const nus_init = {.data_handler = nus_evt_handler};
+
+    printf("test_ble_nus\n");
+
+    ble_conn_state_init();
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_nus_init(&m_nus, &nus_init));
+
+    TEST_RUN(test_mtu);
+    TEST_RUN(test_stream_buffer);
+    TEST_RUN(test_stream_producer);
+    TEST_RUN(test_stream_errors);
+    TEST_RUN(test_throughput);
+
+    return 0;
+}
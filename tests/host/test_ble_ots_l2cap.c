@@ -0,0 +1,398 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* ble_ots_l2cap object sends, against a SoftDevice stub with an L2CAP channel transmit queue.
+ *
+ * The stub accepts SDUs up to a configurable queue size, and each simulated connection event sends
+ * as many PDUs as fit in the event and the credits the peer has given. Completed SDUs are reported
+ * with BLE_L2CAP_EVT_CH_TX after the event, as the SoftDevice does. The functional tests check that
+ * every byte of the object is queued once and in order, and that a failing send is reported. The
+ * throughput model compares one SDU in flight with a full transmit queue, and with 30-byte
+ * notifications, for a 2784-byte object on the link of the office app. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "ble_ots.h"
+#include "ble_ots_l2cap.h"
+
+#define CONN_HANDLE     0
+#define LOCAL_CID       0x40
+#define EXPORT_SIZE     2784                                /* Office registry with a 64-entry change history. */
+#define LL_PAYLOAD      124                                 /* NRF_SDH_BLE_GAP_DATA_LENGTH of the office app. */
+#define TX_MPS          (LL_PAYLOAD - 4)                    /* One PDU per link layer packet. */
+#define SDU_LEN_SIZE    2                                   /* SDU length field in the first PDU of an SDU. */
+#define NOTIF_LEN       30
+#define QUEUE_MAX       8
+
+/* Link model, 1M PHY: 100 ms connection interval and 7.5 ms event length of the office app.
+ * A packet costs its air time, the inter frame space, an empty acknowledgement and another IFS. */
+#define CONN_INTERVAL_US    100000
+#define EVENT_US            7500
+#define PKT_US(ll_len)      ((((ll_len) + 10) * 8) + 150 + 80 + 150)
+#define MAX_EVENTS          100000
+
+STATIC_ASSERT(EXPORT_SIZE <= BLE_OTS_MAX_OBJ_SIZE);
+
+static struct
+{
+    uint32_t queue_size;            /* SDUs the channel can hold. */
+    uint32_t queued;
+    uint16_t len[QUEUE_MAX];
+    uint16_t sent[QUEUE_MAX];       /* Bytes of each SDU, with its length field, already in PDUs. */
+    uint32_t credits;               /* Credits held by the SoftDevice. */
+    uint32_t credits_back;          /* Credits the peer returns at the next event. */
+    uint32_t tx_calls;
+    uint32_t tx_busy;
+    uint32_t err_code;
+    uint8_t  const * p_next;        /* Where the next SDU is expected to start. */
+} m_sd;
+
+static struct
+{
+    uint32_t complete_cnt;
+    uint8_t  const * p_data;
+    uint16_t len;
+    uint32_t err_cnt;
+    uint32_t err_code;
+} m_app;
+
+static ble_ots_t m_ots;
+static uint8_t   m_object[BLE_OTS_MAX_OBJ_SIZE];
+static uint8_t   m_transfer_buffer[BLE_L2CAP_MTU_MIN];
+
+
+uint32_t sd_ble_l2cap_ch_tx(uint16_t conn_handle, uint16_t local_cid, ble_data_t const * p_sdu_buf)
+{
+    TEST_ASSERT_EQUAL(CONN_HANDLE, conn_handle);
+    TEST_ASSERT_EQUAL(LOCAL_CID, local_cid);
+
+    m_sd.tx_calls++;
+    if (m_sd.err_code != NRF_SUCCESS)
+    {
+        return m_sd.err_code;
+    }
+    if (m_sd.queued == m_sd.queue_size)
+    {
+        m_sd.tx_busy++;
+        return NRF_ERROR_RESOURCES;
+    }
+
+    /* The object is queued once, in order. */
+    TEST_ASSERT(p_sdu_buf->p_data == m_sd.p_next);
+    m_sd.p_next += p_sdu_buf->len;
+
+    m_sd.len[m_sd.queued]  = p_sdu_buf->len;
+    m_sd.sent[m_sd.queued] = 0;
+    m_sd.queued++;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_l2cap_ch_rx(uint16_t conn_handle, uint16_t local_cid, ble_data_t const * p_sdu_buf)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_l2cap_ch_setup(uint16_t                            conn_handle,
+                               uint16_t                          * p_local_cid,
+                               ble_l2cap_ch_setup_params_t const * p_params)
+{
+    return NRF_SUCCESS;
+}
+
+
+static void l2cap_evt_handler(ble_ots_l2cap_t * p_ots_l2cap, ble_ots_l2cap_evt_t * p_evt)
+{
+    if (p_evt->type == BLE_OTS_L2CAP_EVT_SEND_COMPLETE)
+    {
+        m_app.complete_cnt++;
+        m_app.p_data = p_evt->param.p_data;
+        m_app.len    = p_evt->param.len;
+    }
+}
+
+
+static void error_handler(uint32_t nrf_error)
+{
+    m_app.err_cnt++;
+    m_app.err_code = nrf_error;
+}
+
+
+/* Opens the channel with the given transmit parameters. */
+static void channel_setup(uint32_t queue_size, uint16_t tx_mtu, uint16_t credits)
+{
+    ble_ots_l2cap_init_t init =
+    {
+        .p_ots_oacp        = &m_ots.oacp_chars,
+        .evt_handler       = l2cap_evt_handler,
+        .p_transfer_buffer = m_transfer_buffer,
+        .buffer_len        = sizeof(m_transfer_buffer),
+    };
+    ble_evt_t evt;
+
+    memset(&m_sd, 0, sizeof(m_sd));
+    memset(&m_app, 0, sizeof(m_app));
+    m_sd.queue_size = queue_size;
+    m_sd.credits    = credits;
+    m_sd.p_next     = m_object;
+
+    m_ots.conn_handle      = CONN_HANDLE;
+    m_ots.error_handler    = error_handler;
+    m_ots.oacp_chars.p_ots = &m_ots;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_ots_l2cap_init(&m_ots.oacp_chars.ots_l2cap, &init));
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                                   = BLE_L2CAP_EVT_CH_SETUP;
+    evt.evt.l2cap_evt.conn_handle                       = CONN_HANDLE;
+    evt.evt.l2cap_evt.local_cid                         = LOCAL_CID;
+    evt.evt.l2cap_evt.params.ch_setup.tx_params.tx_mtu  = tx_mtu;
+    evt.evt.l2cap_evt.params.ch_setup.tx_params.tx_mps  = TX_MPS;
+    evt.evt.l2cap_evt.params.ch_setup.tx_params.credits = credits;
+    ble_ots_l2cap_on_ble_evt(&m_ots.oacp_chars.ots_l2cap, &evt);
+
+    TEST_ASSERT(ble_ots_l2cap_is_channel_available(&m_ots.oacp_chars.ots_l2cap));
+}
+
+
+/* Simulates one connection event, then reports the SDUs it completed. */
+static void conn_event(void)
+{
+    uint16_t done_len[QUEUE_MAX];
+    uint32_t done    = 0;
+    uint32_t time_us = 0;
+
+    m_sd.credits     += m_sd.credits_back;
+    m_sd.credits_back = 0;
+
+    while ((done < m_sd.queued) && (m_sd.credits > 0))
+    {
+        uint16_t const total = m_sd.len[done] + SDU_LEN_SIZE;
+        uint16_t const pdu   = MIN(TX_MPS, total - m_sd.sent[done]);
+
+        if (time_us + PKT_US(pdu + 4) > EVENT_US)
+        {
+            break;
+        }
+        time_us += PKT_US(pdu + 4);
+
+        /* The peer consumes each PDU at once and returns its credit. */
+        m_sd.credits--;
+        m_sd.credits_back++;
+        m_sd.sent[done] += pdu;
+        if (m_sd.sent[done] == total)
+        {
+            done_len[done] = m_sd.len[done];
+            done++;
+        }
+    }
+
+    memmove(&m_sd.len[0],  &m_sd.len[done],  (m_sd.queued - done) * sizeof(uint16_t));
+    memmove(&m_sd.sent[0], &m_sd.sent[done], (m_sd.queued - done) * sizeof(uint16_t));
+    m_sd.queued -= done;
+
+    for (uint32_t i = 0; i < done; i++)
+    {
+        ble_evt_t evt;
+
+        memset(&evt, 0, sizeof(evt));
+        evt.header.evt_id                       = BLE_L2CAP_EVT_CH_TX;
+        evt.evt.l2cap_evt.conn_handle           = CONN_HANDLE;
+        evt.evt.l2cap_evt.local_cid             = LOCAL_CID;
+        evt.evt.l2cap_evt.params.tx.sdu_buf.len = done_len[i];
+        ble_ots_l2cap_on_ble_evt(&m_ots.oacp_chars.ots_l2cap, &evt);
+    }
+}
+
+
+/* Sends the object and returns the number of connection events until it is complete. */
+static uint32_t coc_run(uint16_t len, uint32_t queue_size, uint16_t tx_mtu, uint16_t credits)
+{
+    uint32_t events = 0;
+
+    channel_setup(queue_size, tx_mtu, credits);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_ots_l2cap_obj_send(&m_ots.oacp_chars.ots_l2cap, m_object, len));
+
+    while ((m_app.complete_cnt == 0) && (events < MAX_EVENTS))
+    {
+        conn_event();
+        events++;
+    }
+
+    TEST_ASSERT_EQUAL(1, m_app.complete_cnt);
+    TEST_ASSERT(m_app.p_data == m_object);
+    TEST_ASSERT_EQUAL(len, m_app.len);
+    TEST_ASSERT(m_sd.p_next == m_object + len);
+    TEST_ASSERT_EQUAL(0, m_sd.queued);
+    TEST_ASSERT_EQUAL(0, m_app.err_cnt);
+    TEST_ASSERT(ble_ots_l2cap_is_channel_available(&m_ots.oacp_chars.ots_l2cap));
+
+    return events;
+}
+
+
+/* Returns the number of connection events for the same length in notifications. */
+static uint32_t notif_run(uint16_t len, uint32_t queue_size)
+{
+    uint32_t events = 0;
+    uint32_t left   = len;
+
+    while (left > 0)
+    {
+        uint32_t time_us = 0;
+
+        for (uint32_t i = 0;
+             (i < queue_size) && (left > 0) && (time_us + PKT_US(NOTIF_LEN + 7) <= EVENT_US);
+             i++)
+        {
+            time_us += PKT_US(NOTIF_LEN + 7);
+            left    -= MIN(left, NOTIF_LEN);
+        }
+        events++;
+    }
+
+    return events;
+}
+
+
+static void test_send(void)
+{
+    static uint16_t const lengths[]     = {1, TX_MPS, 511, 512, 513, 1024, 1025, EXPORT_SIZE,
+                                           BLE_OTS_MAX_OBJ_SIZE};
+    static uint16_t const mtus[]        = {BLE_L2CAP_MTU_MIN, 512, 1024};
+    static uint32_t const queue_sizes[] = {1, 3, QUEUE_MAX};
+
+    for (uint32_t l = 0; l < ARRAY_SIZE(lengths); l++)
+    {
+        for (uint32_t m = 0; m < ARRAY_SIZE(mtus); m++)
+        {
+            for (uint32_t q = 0; q < ARRAY_SIZE(queue_sizes); q++)
+            {
+                uint32_t const sdu_cnt = CEIL_DIV(lengths[l], mtus[m]);
+
+                (void) coc_run(lengths[l], queue_sizes[q], mtus[m], 4);
+
+                /* Every SDU is queued with a single call once the queue has room. */
+                TEST_ASSERT_EQUAL(sdu_cnt, m_sd.tx_calls - m_sd.tx_busy);
+            }
+        }
+    }
+
+    /* The channel takes the next object once the previous one is complete. */
+    (void) coc_run(EXPORT_SIZE, 3, 1024, 10);
+    m_sd.p_next        = m_object;
+    m_app.complete_cnt = 0;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      ble_ots_l2cap_obj_send(&m_ots.oacp_chars.ots_l2cap, m_object, EXPORT_SIZE));
+    while (m_app.complete_cnt == 0)
+    {
+        conn_event();
+    }
+    TEST_ASSERT(m_sd.p_next == m_object + EXPORT_SIZE);
+}
+
+
+static void test_send_error(void)
+{
+    channel_setup(3, 1024, 10);
+
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_LENGTH,
+                      ble_ots_l2cap_obj_send(&m_ots.oacp_chars.ots_l2cap, m_object, 0));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL, ble_ots_l2cap_obj_send(&m_ots.oacp_chars.ots_l2cap, NULL, 1));
+
+    /* An error other than a full queue is reported, and nothing more is queued. */
+    m_sd.err_code = NRF_ERROR_NO_MEM;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      ble_ots_l2cap_obj_send(&m_ots.oacp_chars.ots_l2cap, m_object, EXPORT_SIZE));
+    TEST_ASSERT_EQUAL(1, m_sd.tx_calls);
+    TEST_ASSERT_EQUAL(1, m_app.err_cnt);
+    TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM, m_app.err_code);
+    TEST_ASSERT_EQUAL(0, m_sd.queued);
+}
+
+
+static void test_throughput(void)
+{
+    static struct
+    {
+        uint16_t tx_mtu;
+        uint16_t credits;
+    } const configs[] =
+    {
+        {1024, 10}, {1024, 4}, {512, 10}, {512, 4},
+    };
+
+    printf("    %u-byte object, %u ms interval, %.1f ms event:\n",
+           EXPORT_SIZE, CONN_INTERVAL_US / 1000, EVENT_US / 1000.0);
+    for (uint32_t q = 1; q <= 4; q *= 4)
+    {
+        uint32_t const events = notif_run(EXPORT_SIZE, q);
+
+        printf("      %u-byte notifications, queue %u: %.2f s\n",
+               NOTIF_LEN, q, (double)events * CONN_INTERVAL_US / 1e6);
+    }
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(configs); i++)
+    {
+        uint32_t const single    = coc_run(EXPORT_SIZE, 1, configs[i].tx_mtu, configs[i].credits);
+        uint32_t const pipelined = coc_run(EXPORT_SIZE, 3, configs[i].tx_mtu, configs[i].credits);
+
+        /* A full transmit queue is never slower than one SDU in flight. */
+        TEST_ASSERT(pipelined <= single);
+
+        printf("      CoC SDU %4u, MPS %u, %2u credits: single %.2f s, queue 3 %.2f s\n",
+               configs[i].tx_mtu, TX_MPS, configs[i].credits,
+               (double)single * CONN_INTERVAL_US / 1e6,
+               (double)pipelined * CONN_INTERVAL_US / 1e6);
+    }
+}
+
+
+int main(void)
+{
+    printf("test_ble_ots_l2cap\n");
+
+    TEST_RUN(test_send);
+    TEST_RUN(test_send_error);
+    TEST_RUN(test_throughput);
+
+    return 0;
+}
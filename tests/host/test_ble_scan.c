@@ -0,0 +1,342 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_ble_scan filter matching, legacy filters against the single-pass classifier.
+ *
+ * Random advertising reports are replayed to two scanner instances with the same filters, one
+ * of them with a classifier attached. Both must report the same events and the same matched
+ * filters for every combination of enabled filter types and match-all mode. The benchmark
+ * measures the report rate with 40 filters, and with 1040 filters on the classifier. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_ble_scan.h"
+
+#define REPORT_CNT      4096
+#define NAME_CNT        8
+#define EXTRA_FILTERS   1000
+#define BENCH_ROUNDS    200
+
+/* Base of the vendor-specific UUIDs. Bytes 12 and 13 hold the 16-bit UUID. */
+static uint8_t const m_vendor_base[16] =
+{
+    0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x00, 0x00, 0x40, 0x6E
+};
+
+static char const * const m_names[NAME_CNT] =
+{
+    "Office1", "Office2", "Desk-A", "Desk-B", "Lamp", "Sensor", "Beacon", "Hub"
+};
+
+NRF_BLE_SCAN_CLASSIFIER_DEF(m_classifier, 2048, 8192);
+
+static nrf_ble_scan_t m_scan_legacy;
+static nrf_ble_scan_t m_scan_classifier;
+static scan_evt_t     m_last_evt;
+
+static uint8_t        m_report_data[REPORT_CNT][BLE_GAP_ADV_SET_DATA_SIZE_MAX];
+static ble_evt_t      m_report_evt[REPORT_CNT];
+
+
+uint32_t sd_ble_uuid_encode(ble_uuid_t const * p_uuid, uint8_t * p_uuid_le_len, uint8_t * p_uuid_le)
+{
+    if (p_uuid->type == BLE_UUID_TYPE_BLE)
+    {
+        *p_uuid_le_len = 2;
+        if (p_uuid_le != NULL)
+        {
+            (void) uint16_encode(p_uuid->uuid, p_uuid_le);
+        }
+        return NRF_SUCCESS;
+    }
+
+    *p_uuid_le_len = 16;
+    if (p_uuid_le != NULL)
+    {
+        memcpy(p_uuid_le, m_vendor_base, sizeof(m_vendor_base));
+        (void) uint16_encode(p_uuid->uuid, &p_uuid_le[12]);
+    }
+    return NRF_SUCCESS;
+}
+
+
+/* Advertising data encoding is not used by this test. */
+uint32_t sd_ble_gap_addr_get(ble_gap_addr_t * p_addr)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gap_appearance_get(uint16_t * p_appearance)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gap_device_name_get(uint8_t * p_dev_name, uint16_t * p_len)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gap_scan_start(ble_gap_scan_params_t const * p_scan_params, ble_data_t const * p_adv_report_buffer)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_scan_stop(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t sd_ble_gap_connect(ble_gap_addr_t const * p_peer_addr, ble_gap_scan_params_t const * p_scan_params, ble_gap_conn_params_t const * p_conn_params, uint8_t conn_cfg_tag)
+{
+    return NRF_SUCCESS;
+}
+
+
+static void scan_evt_handler(scan_evt_t const * p_scan_evt)
+{
+    m_last_evt = *p_scan_evt;
+}
+
+
+static uint32_t rand_get(void)
+{
+    static uint32_t state = 12345;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+
+/* Flags, then a name, a shortened name or an appearance, then 16-bit UUIDs and sometimes a
+ * vendor-specific UUID. Addresses and values often hit the filters. */
+static void report_make(uint32_t idx)
+{
+    ble_gap_evt_adv_report_t * p_report = &m_report_evt[idx].evt.gap_evt.params.adv_report;
+    uint8_t                  * p_data   = m_report_data[idx];
+    uint16_t                   len      = 0;
+
+    m_report_evt[idx].header.evt_id = BLE_GAP_EVT_ADV_REPORT;
+
+    for (uint8_t i = 0; i < BLE_GAP_ADDR_LEN; i++)
+    {
+        p_report->peer_addr.addr[i] = ((rand_get() % 4) == 0) ? i : (uint8_t)rand_get();
+    }
+
+    p_data[len++] = 2;
+    p_data[len++] = BLE_GAP_AD_TYPE_FLAGS;
+    p_data[len++] = BLE_GAP_ADV_FLAGS_LE_ONLY_GENERAL_DISC_MODE;
+
+    switch (rand_get() % 4)
+    {
+        case 0:
+        {
+            char const * p_name   = m_names[rand_get() % NAME_CNT];
+            uint8_t      name_len = strlen(p_name);
+
+            p_data[len++] = name_len + 1;
+            p_data[len++] = BLE_GAP_AD_TYPE_COMPLETE_LOCAL_NAME;
+            memcpy(&p_data[len], p_name, name_len);
+            len += name_len;
+        } break;
+
+        case 1:
+        {
+            char const * p_name   = m_names[rand_get() % NAME_CNT];
+            uint8_t      name_len = MIN(1 + (rand_get() % strlen(p_name)), 6);
+
+            p_data[len++] = name_len + 1;
+            p_data[len++] = BLE_GAP_AD_TYPE_SHORT_LOCAL_NAME;
+            memcpy(&p_data[len], p_name, name_len);
+            len += name_len;
+        } break;
+
+        case 2:
+            p_data[len++] = 3;
+            p_data[len++] = BLE_GAP_AD_TYPE_APPEARANCE;
+            p_data[len++] = (uint8_t)(rand_get() % 16);
+            p_data[len++] = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    uint8_t const uuid_cnt = 1 + (rand_get() % 3);
+
+    p_data[len++] = 1 + (2 * uuid_cnt);
+    p_data[len++] = (rand_get() & 1) ? BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_COMPLETE
+                                     : BLE_GAP_AD_TYPE_16BIT_SERVICE_UUID_MORE_AVAILABLE;
+    for (uint8_t i = 0; i < uuid_cnt; i++)
+    {
+        len += uint16_encode(0x1800 + (rand_get() % 24), &p_data[len]);
+    }
+
+    if (((rand_get() % 4) == 0) && ((len + 18) <= BLE_GAP_ADV_SET_DATA_SIZE_MAX))
+    {
+        p_data[len++] = 17;
+        p_data[len++] = BLE_GAP_AD_TYPE_128BIT_SERVICE_UUID_COMPLETE;
+        memcpy(&p_data[len], m_vendor_base, sizeof(m_vendor_base));
+        p_data[len + 12] = (uint8_t)(rand_get() % 4);
+        len += sizeof(m_vendor_base);
+    }
+
+    p_report->data.p_data = p_data;
+    p_report->data.len    = len;
+}
+
+
+/* Eight filters of each type, and optionally more address filters. */
+static void filters_add(nrf_ble_scan_t * p_scan, uint32_t extra_cnt)
+{
+    for (uint8_t i = 0; i < NAME_CNT; i++)
+    {
+        nrf_ble_scan_short_name_t short_name = {m_names[i], 2 + (i % 3)};
+        uint8_t                   addr[BLE_GAP_ADDR_LEN] = {0, 1, 2, 3, 4, 5 + i};
+        ble_uuid_t                uuid = {0x1800 + i, (i < 6) ? BLE_UUID_TYPE_BLE
+                                                              : BLE_UUID_TYPE_VENDOR_BEGIN};
+        uint16_t                  appearance = i + 1;
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_NAME_FILTER, m_names[i]));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_SHORT_NAME_FILTER, &short_name));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_ADDR_FILTER, addr));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_UUID_FILTER, &uuid));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_APPEARANCE_FILTER, &appearance));
+    }
+
+    for (uint32_t i = 0; i < extra_cnt; i++)
+    {
+        uint8_t addr[BLE_GAP_ADDR_LEN] = {9, (uint8_t)i, (uint8_t)(i >> 8), 7, 7, 7};
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filter_set(p_scan, SCAN_ADDR_FILTER, addr));
+    }
+}
+
+
+static void test_equivalence(void)
+{
+    uint32_t matches = 0;
+
+    for (uint32_t i = 0; i < REPORT_CNT; i++)
+    {
+        report_make(i);
+    }
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_init(&m_scan_legacy, NULL, scan_evt_handler));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_init(&m_scan_classifier, NULL, scan_evt_handler));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_classifier_attach(&m_scan_classifier, &m_classifier));
+    filters_add(&m_scan_legacy, 0);
+    filters_add(&m_scan_classifier, 0);
+
+    for (uint32_t match_all = 0; match_all < 2; match_all++)
+    {
+        for (uint8_t mode = 1; mode <= NRF_BLE_SCAN_ALL_FILTER; mode++)
+        {
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filters_enable(&m_scan_legacy, mode, match_all));
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ble_scan_filters_enable(&m_scan_classifier, mode, match_all));
+
+            for (uint32_t i = 0; i < REPORT_CNT; i++)
+            {
+                scan_evt_t legacy_evt;
+
+                nrf_ble_scan_on_ble_evt(&m_report_evt[i], &m_scan_legacy);
+                legacy_evt = m_last_evt;
+                nrf_ble_scan_on_ble_evt(&m_report_evt[i], &m_scan_classifier);
+
+                TEST_ASSERT_EQUAL(legacy_evt.scan_evt_id, m_last_evt.scan_evt_id);
+                if (legacy_evt.scan_evt_id == NRF_BLE_SCAN_EVT_FILTER_MATCH)
+                {
+                    TEST_ASSERT(memcmp(&legacy_evt.params.filter_match.filter_match,
+                                       &m_last_evt.params.filter_match.filter_match,
+                                       sizeof(legacy_evt.params.filter_match.filter_match)) == 0);
+                    matches++;
+                }
+            }
+        }
+    }
+
+    /* The reports hit the filters often enough for the comparison to mean something. */
+    TEST_ASSERT(matches > REPORT_CNT);
+}
+
+
+static double report_rate_get(nrf_ble_scan_t * p_scan)
+{
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (uint32_t i = 0; i < REPORT_CNT; i++)
+        {
+            nrf_ble_scan_on_ble_evt(&m_report_evt[i], p_scan);
+        }
+    }
+
+    return (double)BENCH_ROUNDS * REPORT_CNT * 1000.0 / (test_time_ns() - start);
+}
+
+
+static void test_bench(void)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      nrf_ble_scan_filters_enable(&m_scan_legacy, NRF_BLE_SCAN_ALL_FILTER, false));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      nrf_ble_scan_filters_enable(&m_scan_classifier, NRF_BLE_SCAN_ALL_FILTER, false));
+
+    printf("      40 filters, legacy:     %.2f M reports/s\n", report_rate_get(&m_scan_legacy));
+    printf("      40 filters, classifier: %.2f M reports/s\n", report_rate_get(&m_scan_classifier));
+
+    filters_add(&m_scan_classifier, EXTRA_FILTERS);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      nrf_ble_scan_filters_enable(&m_scan_classifier, NRF_BLE_SCAN_ALL_FILTER, false));
+    printf("    1040 filters, classifier: %.2f M reports/s\n", report_rate_get(&m_scan_classifier));
+}
+
+
+int main(void)
+{
+    printf("test_ble_scan\n");
+
+    TEST_RUN(test_equivalence);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
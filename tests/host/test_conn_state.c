@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* ble_conn_state connection iteration and counts, against a reference model of the links.
+ *
+ * Random connect and disconnect events, with random roles, are sent to the module through its
+ * BLE observer. After every event, the counts, the handle lists, the connected callbacks, the
+ * status and role of every handle, and a user flag must match the model. The benchmark measures
+ * iteration, handle lists and counts with 1, 4 and the maximum number of links. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "nrf_section.h"
+#include "nrf_sdh_ble.h"
+#include "ble_conn_state.h"
+
+#define MODEL_EVENTS    200000
+#define BENCH_ROUNDS    2000000
+
+/* The observers registered by the module under test, normally dispatched by nrf_sdh_ble. */
+NRF_SECTION_DEF(sdh_ble_observers, nrf_sdh_ble_evt_observer_t);
+
+/* The reference model. A disconnected record stays valid, with its role and user flags, until
+ * the next connection event purges it. */
+static bool     m_valid[BLE_CONN_STATE_MAX_CONNECTIONS];
+static bool     m_connected[BLE_CONN_STATE_MAX_CONNECTIONS];
+static bool     m_central[BLE_CONN_STATE_MAX_CONNECTIONS];
+static bool     m_user_flag[BLE_CONN_STATE_MAX_CONNECTIONS];
+static uint32_t m_handle_sum;
+
+
+/* Dispatch an event to the BLE observers, as nrf_sdh_ble does. */
+static void ble_evt_send(ble_evt_t const * p_ble_evt)
+{
+    uint32_t const cnt = NRF_SECTION_ITEM_COUNT(sdh_ble_observers, nrf_sdh_ble_evt_observer_t);
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        nrf_sdh_ble_evt_observer_t * p_observer =
+            NRF_SECTION_ITEM_GET(sdh_ble_observers, nrf_sdh_ble_evt_observer_t, i);
+
+        p_observer->handler(p_ble_evt, p_observer->p_context);
+    }
+}
+
+
+static void connect(uint16_t conn_handle, uint8_t role)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id                     = BLE_GAP_EVT_CONNECTED;
+    evt.evt.gap_evt.conn_handle           = conn_handle;
+    evt.evt.gap_evt.params.connected.role = role;
+    ble_evt_send(&evt);
+}
+
+
+static void disconnect(uint16_t conn_handle)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle = conn_handle;
+    ble_evt_send(&evt);
+}
+
+
+static void handle_sum(uint16_t conn_handle, void * p_context)
+{
+    m_handle_sum += conn_handle;
+}
+
+
+static void list_check(ble_conn_state_conn_handle_list_t const * p_list, bool const * p_expected)
+{
+    uint32_t idx = 0;
+
+    /* In increasing handle order. */
+    for (uint16_t handle = 0; handle < BLE_CONN_STATE_MAX_CONNECTIONS; handle++)
+    {
+        if (p_expected[handle])
+        {
+            TEST_ASSERT(idx < p_list->len);
+            TEST_ASSERT_EQUAL(handle, p_list->conn_handles[idx]);
+            idx++;
+        }
+    }
+    TEST_ASSERT_EQUAL(idx, p_list->len);
+}
+
+
+static void state_check(ble_conn_state_user_flag_id_t flag_id)
+{
+    bool     central[BLE_CONN_STATE_MAX_CONNECTIONS];
+    bool     periph[BLE_CONN_STATE_MAX_CONNECTIONS];
+    uint32_t conn_cnt     = 0;
+    uint32_t central_cnt  = 0;
+    uint32_t flag_cnt     = 0;
+    uint32_t expected_sum = 0;
+
+    for (uint16_t handle = 0; handle < BLE_CONN_STATE_MAX_CONNECTIONS; handle++)
+    {
+        central[handle] = m_connected[handle] && m_central[handle];
+        periph[handle]  = m_connected[handle] && !m_central[handle];
+
+        conn_cnt     += m_connected[handle];
+        central_cnt  += central[handle];
+        flag_cnt     += (m_valid[handle] && m_user_flag[handle]);
+        expected_sum += m_connected[handle] ? handle : 0;
+
+        ble_conn_state_status_t const status = !m_valid[handle]    ? BLE_CONN_STATUS_INVALID
+                                             : m_connected[handle] ? BLE_CONN_STATUS_CONNECTED
+                                                                   : BLE_CONN_STATUS_DISCONNECTED;
+        TEST_ASSERT_EQUAL(status, ble_conn_state_status(handle));
+
+        if (m_valid[handle])
+        {
+            TEST_ASSERT_EQUAL(m_central[handle] ? BLE_GAP_ROLE_CENTRAL : BLE_GAP_ROLE_PERIPH,
+                              ble_conn_state_role(handle));
+            TEST_ASSERT_EQUAL(m_user_flag[handle], ble_conn_state_user_flag_get(handle, flag_id));
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(BLE_GAP_ROLE_INVALID, ble_conn_state_role(handle));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(conn_cnt, ble_conn_state_conn_count());
+    TEST_ASSERT_EQUAL(central_cnt, ble_conn_state_central_conn_count());
+    TEST_ASSERT_EQUAL(conn_cnt - central_cnt, ble_conn_state_peripheral_conn_count());
+
+    m_handle_sum = 0;
+    TEST_ASSERT_EQUAL(conn_cnt, ble_conn_state_for_each_connected(handle_sum, NULL));
+    TEST_ASSERT_EQUAL(expected_sum, m_handle_sum);
+
+    ble_conn_state_conn_handle_list_t list;
+
+    /* All valid records, but only connected ones for each role. */
+    list = ble_conn_state_conn_handles();
+    list_check(&list, m_valid);
+    list = ble_conn_state_central_handles();
+    list_check(&list, central);
+    list = ble_conn_state_periph_handles();
+    list_check(&list, periph);
+
+    TEST_ASSERT_EQUAL(flag_cnt, ble_conn_state_for_each_set_user_flag(flag_id, handle_sum, NULL));
+}
+
+
+static void test_model(void)
+{
+    ble_conn_state_init();
+    memset(m_valid, 0, sizeof(m_valid));
+    memset(m_connected, 0, sizeof(m_connected));
+
+    ble_conn_state_user_flag_id_t const flag_id = ble_conn_state_user_flag_acquire();
+    TEST_ASSERT(flag_id != BLE_CONN_STATE_USER_FLAG_INVALID);
+
+    srand(1);
+
+    for (uint32_t event = 0; event < MODEL_EVENTS; event++)
+    {
+        uint16_t const handle = (uint16_t)(rand() % BLE_CONN_STATE_MAX_CONNECTIONS);
+
+        if (m_connected[handle])
+        {
+            disconnect(handle);
+            m_connected[handle] = false;
+        }
+        else
+        {
+            bool const central = rand() & 1;
+
+            connect(handle, central ? BLE_GAP_ROLE_CENTRAL : BLE_GAP_ROLE_PERIPH);
+
+            for (uint16_t i = 0; i < BLE_CONN_STATE_MAX_CONNECTIONS; i++)
+            {
+                if (!m_connected[i])
+                {
+                    m_valid[i]     = false;
+                    m_user_flag[i] = false;
+                }
+            }
+            m_valid[handle]     = true;
+            m_connected[handle] = true;
+            m_central[handle]   = central;
+
+            if (rand() & 1)
+            {
+                ble_conn_state_user_flag_set(handle, flag_id, true);
+                m_user_flag[handle] = true;
+            }
+        }
+
+        /* Events for handles out of range are ignored. */
+        if ((event % 1000) == 0)
+        {
+            disconnect(BLE_CONN_STATE_MAX_CONNECTIONS);
+            disconnect(BLE_CONN_HANDLE_INVALID);
+        }
+
+        state_check(flag_id);
+    }
+}
+
+
+static void test_bench(void)
+{
+    uint32_t const link_cnts[] = {1, 4, BLE_CONN_STATE_MAX_CONNECTIONS};
+
+    for (uint32_t cfg = 0; cfg < ARRAY_SIZE(link_cnts); cfg++)
+    {
+        volatile uint32_t sink = 0;
+
+        ble_conn_state_init();
+
+        /* Spread the links over the handle range. */
+        for (uint32_t i = 0; i < link_cnts[cfg]; i++)
+        {
+            connect(i * BLE_CONN_STATE_MAX_CONNECTIONS / link_cnts[cfg],
+                    (i & 1) ? BLE_GAP_ROLE_CENTRAL : BLE_GAP_ROLE_PERIPH);
+        }
+
+        uint64_t const start = test_time_ns();
+
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+        {
+            sink += ble_conn_state_for_each_connected(handle_sum, NULL);
+        }
+
+        uint64_t const for_each_end = test_time_ns();
+
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+        {
+            sink += ble_conn_state_periph_handles().len;
+        }
+
+        uint64_t const handles_end = test_time_ns();
+
+        for (uint32_t i = 0; i < BENCH_ROUNDS; i++)
+        {
+            sink += ble_conn_state_conn_count()
+                  + ble_conn_state_central_conn_count()
+                  + ble_conn_state_peripheral_conn_count();
+        }
+
+        uint64_t const counts_end = test_time_ns();
+        (void) sink;
+
+        printf("    %2u links: for_each_connected %.1f ns, periph_handles %.1f ns, "
+               "three counts %.1f ns\n",
+               link_cnts[cfg],
+               (double)(for_each_end - start) / BENCH_ROUNDS,
+               (double)(handles_end - for_each_end) / BENCH_ROUNDS,
+               (double)(counts_end - handles_end) / BENCH_ROUNDS);
+    }
+}
+
+
+int main(void)
+{
+    printf("test_conn_state\n");
+
+    TEST_RUN(test_model);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* crc16_compute() with the implementation selected by CRC16_CONFIG_ALGORITHM.
+ *
+ * The test is built once for every implementation. Each build checks the CRC-16/CCITT-FALSE test
+ * vectors, and compares all lengths up to 300 bytes, at every alignment and split into chained
+ * blocks, with a bit-at-a-time reference. The benchmark reports the cost per byte for sizes
+ * typical of FDS records. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "crc16.h"
+
+#define MAX_LEN         300
+#define ALIGNMENTS      4
+#define CHAIN_STEP      5
+#define BENCH_BYTES     20000000
+
+static uint8_t m_data[4096 + ALIGNMENTS];
+
+
+/* CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), one bit at a time. */
+static uint16_t crc16_reference(uint8_t const * p_data, uint32_t size)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= (uint16_t)(p_data[i] << 8);
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (uint16_t)((crc << 1) ^ ((crc & 0x8000) ? 0x1021 : 0));
+        }
+    }
+
+    return crc;
+}
+
+
+static void test_vectors(void)
+{
+    static struct
+    {
+        char const * p_data;
+        uint16_t     crc;
+    } const vectors[] =
+    {
+        {"",          0xFFFF},
+        {"A",         0xB915},
+        {"123456789", 0x29B1},
+    };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(vectors); i++)
+    {
+        uint32_t const len = strlen(vectors[i].p_data);
+
+        TEST_ASSERT_EQUAL(vectors[i].crc,
+                          crc16_compute((uint8_t const *)vectors[i].p_data, len, NULL));
+        TEST_ASSERT_EQUAL(vectors[i].crc,
+                          crc16_reference((uint8_t const *)vectors[i].p_data, len));
+    }
+}
+
+
+static void test_reference(void)
+{
+    srand(2);
+    for (uint32_t i = 0; i < sizeof(m_data); i++)
+    {
+        m_data[i] = (uint8_t)rand();
+    }
+
+    for (uint32_t offset = 0; offset < ALIGNMENTS; offset++)
+    {
+        for (uint32_t len = 0; len < MAX_LEN; len++)
+        {
+            uint8_t const * p_data   = m_data + offset;
+            uint16_t const  expected = crc16_reference(p_data, len);
+
+            TEST_ASSERT_EQUAL(expected, crc16_compute(p_data, len, NULL));
+
+            /* Computed in two blocks, the second continuing from the first. */
+            for (uint32_t split = 0; split <= len; split += CHAIN_STEP)
+            {
+                uint16_t crc = crc16_compute(p_data, split, NULL);
+
+                crc = crc16_compute(p_data + split, len - split, &crc);
+                TEST_ASSERT_EQUAL(expected, crc);
+            }
+        }
+    }
+}
+
+
+static void test_bench(void)
+{
+    static uint32_t const sizes[] = {16, 64, 256, 1024, 4096};
+    volatile uint16_t     sink;
+
+    for (uint32_t s = 0; s < ARRAY_SIZE(sizes); s++)
+    {
+        uint32_t const rounds = BENCH_BYTES / sizes[s];
+        uint64_t const start  = test_time_ns();
+
+        for (uint32_t round = 0; round < rounds; round++)
+        {
+            sink = crc16_compute(m_data, sizes[s], NULL);
+        }
+
+        uint64_t const elapsed = test_time_ns() - start;
+
+        printf("    %4u-byte records: %.2f ns per byte\n",
+               sizes[s], (double)elapsed / ((double)rounds * sizes[s]));
+    }
+    (void) sink;
+}
+
+
+int main(void)
+{
+    printf("test_crc16 (CRC16_CONFIG_ALGORITHM %d)\n", CRC16_CONFIG_ALGORITHM);
+
+    TEST_RUN(test_vectors);
+    TEST_RUN(test_reference);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
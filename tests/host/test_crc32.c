@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* crc32_compute() with the implementation selected by CRC32_CONFIG_ALGORITHM.
+ *
+ * The test is built once for every implementation. Each build checks the standard test vectors,
+ * and compares all lengths up to 300 bytes, at every alignment and split into chained blocks,
+ * with a bit-at-a-time reference. The benchmark reports the time for a 512 kB image. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "crc32.h"
+
+#define MAX_LEN         300
+#define ALIGNMENTS      8
+#define CHAIN_STEP      7
+#define IMAGE_SIZE      (512 * 1024)
+#define IMAGE_ROUNDS    5
+
+static uint8_t m_data[MAX_LEN + ALIGNMENTS];
+static uint8_t m_image[IMAGE_SIZE];
+
+
+/* Reflected CRC-32 (polynomial 0xEDB88320), one bit at a time. */
+static uint32_t crc32_reference(uint8_t const * p_data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= p_data[i];
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+
+    return ~crc;
+}
+
+
+static void test_vectors(void)
+{
+    static struct
+    {
+        char const * p_data;
+        uint32_t     crc;
+    } const vectors[] =
+    {
+        {"",                                            0x00000000},
+        {"a",                                           0xE8B7BE43},
+        {"abc",                                         0x352441C2},
+        {"123456789",                                   0xCBF43926},
+        {"The quick brown fox jumps over the lazy dog", 0x414FA339},
+    };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(vectors); i++)
+    {
+        uint32_t const len = strlen(vectors[i].p_data);
+
+        TEST_ASSERT_EQUAL(vectors[i].crc,
+                          crc32_compute((uint8_t const *)vectors[i].p_data, len, NULL));
+        TEST_ASSERT_EQUAL(vectors[i].crc,
+                          crc32_reference((uint8_t const *)vectors[i].p_data, len));
+    }
+}
+
+
+static void test_reference(void)
+{
+    srand(1);
+    for (uint32_t i = 0; i < sizeof(m_data); i++)
+    {
+        m_data[i] = (uint8_t)rand();
+    }
+
+    for (uint32_t offset = 0; offset < ALIGNMENTS; offset++)
+    {
+        for (uint32_t len = 0; len < MAX_LEN; len++)
+        {
+            uint8_t const * p_data   = m_data + offset;
+            uint32_t const  expected = crc32_reference(p_data, len);
+
+            TEST_ASSERT_EQUAL(expected, crc32_compute(p_data, len, NULL));
+
+            /* Computed in two blocks, the second continuing from the first. */
+            for (uint32_t split = 0; split <= len; split += CHAIN_STEP)
+            {
+                uint32_t crc = crc32_compute(p_data, split, NULL);
+
+                crc = crc32_compute(p_data + split, len - split, &crc);
+                TEST_ASSERT_EQUAL(expected, crc);
+            }
+        }
+    }
+}
+
+
+static void test_bench(void)
+{
+    volatile uint32_t sink;
+
+    for (uint32_t i = 0; i < sizeof(m_image); i++)
+    {
+        m_image[i] = (uint8_t)rand();
+    }
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t round = 0; round < IMAGE_ROUNDS; round++)
+    {
+        sink = crc32_compute(m_image, sizeof(m_image), NULL);
+    }
+
+    uint64_t const elapsed = test_time_ns() - start;
+    (void) sink;
+
+    printf("    512 kB image: %.2f ms\n", (double)elapsed / 1e6 / IMAGE_ROUNDS);
+}
+
+
+int main(void)
+{
+    printf("test_crc32 (CRC32_CONFIG_ALGORITHM %d)\n", CRC32_CONFIG_ALGORITHM);
+
+    TEST_RUN(test_vectors);
+    TEST_RUN(test_reference);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
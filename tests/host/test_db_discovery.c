@@ -0,0 +1,605 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* ble_db_discovery with a cache validated by the Database Hash of the peer, through nrf_ble_gq.
+ *
+ * The GATT client calls of the SoftDevice are replaced by a model of a peer GATT server that
+ * answers from an attribute table, one procedure at a time, like the SoftDevice does. Every
+ * response costs one connection interval of simulated time, which gives the time from the start
+ * of the discovery to BLE_DB_DISCOVERY_AVAILABLE. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_ble_gq.h"
+#include "ble_db_discovery.h"
+#include "ble_srv_common.h"
+
+#define CONN_HANDLE         0
+#define CONN_INTERVAL_MS    30
+#define CHARS_PER_RSP       2   /* Characteristics that fit in one response at the default ATT MTU. */
+#define DESCS_PER_RSP       4   /* Descriptors that fit in one response at the default ATT MTU. */
+
+#define UUID_HRS            BLE_UUID_HEART_RATE_SERVICE
+#define UUID_BAS            BLE_UUID_BATTERY_SERVICE
+#define UUID_DB_HASH        0x2B2A
+
+/* Attribute of the peer GATT server. Characteristic declarations have the handle of their value
+ * next to them. */
+typedef struct
+{
+    uint16_t type;  /* BLE_UUID_SERVICE_PRIMARY, BLE_UUID_CHARACTERISTIC or a descriptor UUID. */
+    uint16_t uuid;  /* Service or characteristic UUID. */
+} attr_t;
+
+#define ATTR_MAX    48
+
+NRF_BLE_GQ_DEF(m_gq, 1, 4);
+
+static ble_db_discovery_t       m_db_disc;
+static ble_db_discovery_cache_t m_cache;
+
+static attr_t   m_attrs[ATTR_MAX + 1];  /* Indexed by handle, handle 0 is not used. */
+static uint16_t m_attr_count;
+static uint8_t  m_db_hash[BLE_DB_DISCOVERY_DB_HASH_LEN];
+
+static union
+{
+    ble_evt_t evt;
+    uint8_t   raw[sizeof(ble_evt_t) + 256];
+}               m_rsp;                  /* Response of the procedure in progress. */
+static bool     m_rsp_pending;
+static uint32_t m_sd_req_count;         /* Requests accepted by the SoftDevice. */
+static uint32_t m_time_ms;
+
+/* Events received by the application. */
+static ble_gatt_db_srv_t m_srvs[2];
+static uint32_t          m_complete_count;
+static uint32_t          m_not_found_count;
+static uint32_t          m_error_count;
+static uint32_t          m_cache_updated_count;
+static bool              m_available;
+static uint32_t          m_available_ms;
+static bool              m_cache_updated_before_available;
+
+
+static void db_disc_evt_handler(ble_db_discovery_evt_t * p_evt)
+{
+    switch (p_evt->evt_type)
+    {
+        case BLE_DB_DISCOVERY_COMPLETE:
+        case BLE_DB_DISCOVERY_SRV_NOT_FOUND:
+        {
+            ble_gatt_db_srv_t const * p_srv = &p_evt->params.discovered_db;
+
+            m_srvs[(p_srv->srv_uuid.uuid == UUID_HRS) ? 0 : 1] = *p_srv;
+            if (p_evt->evt_type == BLE_DB_DISCOVERY_COMPLETE)
+            {
+                m_complete_count++;
+            }
+            else
+            {
+                m_not_found_count++;
+            }
+        } break;
+
+        case BLE_DB_DISCOVERY_ERROR:
+            m_error_count++;
+            break;
+
+        case BLE_DB_DISCOVERY_CACHE_UPDATED:
+            TEST_ASSERT(p_evt->params.p_cache == &m_cache);
+            m_cache_updated_count++;
+            m_cache_updated_before_available = !m_available;
+            break;
+
+        case BLE_DB_DISCOVERY_AVAILABLE:
+            m_available    = true;
+            m_available_ms = m_time_ms;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+static uint16_t attr_add(uint16_t type, uint16_t uuid)
+{
+    TEST_ASSERT(m_attr_count < ATTR_MAX);
+    m_attr_count++;
+    m_attrs[m_attr_count] = (attr_t){.type = type, .uuid = uuid};
+    return m_attr_count;
+}
+
+
+static void char_add(uint16_t uuid, bool cccd)
+{
+    (void)attr_add(BLE_UUID_CHARACTERISTIC, uuid);
+    (void)attr_add(uuid, 0);
+    if (cccd)
+    {
+        (void)attr_add(BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG, 0);
+    }
+}
+
+
+/**@brief Builds the peer database: the GATT service with a Database Hash, a Heart Rate service,
+ *        and optionally a Battery service with one or two characteristics. */
+static void peer_db_build(bool db_hash, bool bas, uint8_t bas_chars)
+{
+    memset(m_attrs, 0, sizeof(m_attrs));
+    m_attr_count = 0;
+
+    (void)attr_add(BLE_UUID_SERVICE_PRIMARY, BLE_UUID_GATT);
+    char_add(BLE_UUID_GATT_CHARACTERISTIC_SERVICE_CHANGED, true);
+    if (db_hash)
+    {
+        char_add(UUID_DB_HASH, false);
+    }
+
+    (void)attr_add(BLE_UUID_SERVICE_PRIMARY, UUID_HRS);
+    char_add(BLE_UUID_HEART_RATE_MEASUREMENT_CHAR, true);
+    char_add(BLE_UUID_BODY_SENSOR_LOCATION_CHAR, false);
+    char_add(BLE_UUID_HEART_RATE_CONTROL_POINT_CHAR, false);
+
+    if (bas)
+    {
+        (void)attr_add(BLE_UUID_SERVICE_PRIMARY, UUID_BAS);
+        for (uint8_t i = 0; i < bas_chars; i++)
+        {
+            char_add(BLE_UUID_BATTERY_LEVEL_CHAR + i, true);
+        }
+    }
+
+    // The hash covers the database structure; any change gives a new one.
+    memset(m_db_hash, 0, sizeof(m_db_hash));
+    for (uint16_t h = 1; h <= m_attr_count; h++)
+    {
+        m_db_hash[h % sizeof(m_db_hash)] ^= (uint8_t)(m_attrs[h].type + m_attrs[h].uuid + h);
+    }
+}
+
+
+static uint16_t srv_end_handle(uint16_t start_handle)
+{
+    uint16_t h = start_handle + 1;
+
+    while ((h <= m_attr_count) && (m_attrs[h].type != BLE_UUID_SERVICE_PRIMARY))
+    {
+        h++;
+    }
+    return h - 1;
+}
+
+
+/**@brief Starts the response to a GATT client procedure, or rejects the procedure if another
+ *        one is in progress. */
+static ble_gattc_evt_t * rsp_start(uint16_t evt_id, uint16_t gatt_status)
+{
+    memset(&m_rsp, 0, sizeof(m_rsp));
+    m_rsp.evt.header.evt_id           = evt_id;
+    m_rsp.evt.evt.gattc_evt.conn_handle = CONN_HANDLE;
+    m_rsp.evt.evt.gattc_evt.gatt_status = gatt_status;
+    m_rsp_pending = true;
+    m_sd_req_count++;
+    return &m_rsp.evt.evt.gattc_evt;
+}
+
+
+uint32_t sd_ble_gattc_primary_services_discover(uint16_t conn_handle, uint16_t start_handle,
+                                                ble_uuid_t const * p_srvc_uuid)
+{
+    if (m_rsp_pending)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    for (uint16_t h = start_handle; h <= m_attr_count; h++)
+    {
+        if ((m_attrs[h].type == BLE_UUID_SERVICE_PRIMARY) && (m_attrs[h].uuid == p_srvc_uuid->uuid))
+        {
+            ble_gattc_evt_t * p_evt = rsp_start(BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP,
+                                                BLE_GATT_STATUS_SUCCESS);
+
+            p_evt->params.prim_srvc_disc_rsp.count                        = 1;
+            p_evt->params.prim_srvc_disc_rsp.services[0].uuid             = *p_srvc_uuid;
+            p_evt->params.prim_srvc_disc_rsp.services[0].handle_range.start_handle = h;
+            p_evt->params.prim_srvc_disc_rsp.services[0].handle_range.end_handle   =
+                srv_end_handle(h);
+            return NRF_SUCCESS;
+        }
+    }
+
+    (void)rsp_start(BLE_GATTC_EVT_PRIM_SRVC_DISC_RSP, BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND);
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_characteristics_discover(uint16_t conn_handle,
+                                               ble_gattc_handle_range_t const * p_handle_range)
+{
+    if (m_rsp_pending)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    ble_gattc_evt_t * p_evt = rsp_start(BLE_GATTC_EVT_CHAR_DISC_RSP, BLE_GATT_STATUS_SUCCESS);
+    ble_gattc_evt_char_disc_rsp_t * p_rsp = &p_evt->params.char_disc_rsp;
+
+    for (uint16_t h = p_handle_range->start_handle;
+         (h <= MIN(p_handle_range->end_handle, m_attr_count)) && (p_rsp->count < CHARS_PER_RSP);
+         h++)
+    {
+        if (m_attrs[h].type == BLE_UUID_CHARACTERISTIC)
+        {
+            ble_gattc_char_t * p_char = &p_rsp->chars[p_rsp->count++];
+
+            p_char->uuid.type    = BLE_UUID_TYPE_BLE;
+            p_char->uuid.uuid    = m_attrs[h].uuid;
+            p_char->handle_decl  = h;
+            p_char->handle_value = h + 1;
+        }
+    }
+
+    if (p_rsp->count == 0)
+    {
+        p_evt->gatt_status = BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_descriptors_discover(uint16_t conn_handle,
+                                           ble_gattc_handle_range_t const * p_handle_range)
+{
+    if (m_rsp_pending)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    ble_gattc_evt_t * p_evt = rsp_start(BLE_GATTC_EVT_DESC_DISC_RSP, BLE_GATT_STATUS_SUCCESS);
+    ble_gattc_evt_desc_disc_rsp_t * p_rsp = &p_evt->params.desc_disc_rsp;
+
+    for (uint16_t h = p_handle_range->start_handle;
+         (h <= MIN(p_handle_range->end_handle, m_attr_count)) && (p_rsp->count < DESCS_PER_RSP);
+         h++)
+    {
+        ble_gattc_desc_t * p_desc = &p_rsp->descs[p_rsp->count++];
+
+        p_desc->handle    = h;
+        p_desc->uuid.type = BLE_UUID_TYPE_BLE;
+        p_desc->uuid.uuid = m_attrs[h].type;
+    }
+
+    if (p_rsp->count == 0)
+    {
+        p_evt->gatt_status = BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND;
+    }
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gattc_char_value_by_uuid_read(uint16_t conn_handle, ble_uuid_t const * p_uuid,
+                                              ble_gattc_handle_range_t const * p_handle_range)
+{
+    if (m_rsp_pending)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    ble_gattc_evt_t * p_evt = rsp_start(BLE_GATTC_EVT_CHAR_VAL_BY_UUID_READ_RSP,
+                                        BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND);
+    ble_gattc_evt_char_val_by_uuid_read_rsp_t * p_rsp = &p_evt->params.char_val_by_uuid_read_rsp;
+
+    for (uint16_t h = p_handle_range->start_handle; h <= m_attr_count; h++)
+    {
+        if (m_attrs[h].type == p_uuid->uuid)
+        {
+            p_evt->gatt_status = BLE_GATT_STATUS_SUCCESS;
+            p_rsp->count       = 1;
+            p_rsp->value_len   = sizeof(m_db_hash);
+            uint16_encode(h, p_rsp->handle_value);
+            memcpy(&p_rsp->handle_value[sizeof(uint16_t)], m_db_hash, sizeof(m_db_hash));
+            break;
+        }
+    }
+    return NRF_SUCCESS;
+}
+
+
+/* Other requests are not used by the discovery. */
+uint32_t sd_ble_gattc_read(uint16_t conn_handle, uint16_t handle, uint16_t offset)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gattc_write(uint16_t conn_handle, ble_gattc_write_params_t const * p_write_params)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+uint32_t sd_ble_gatts_hvx(uint16_t conn_handle, ble_gatts_hvx_params_t const * p_hvx_params)
+{
+    return NRF_ERROR_NOT_SUPPORTED;
+}
+
+
+static void ble_evt_send(ble_evt_t const * p_evt)
+{
+    ble_db_discovery_on_ble_evt(p_evt, &m_db_disc);
+    nrf_ble_gq_on_ble_evt(p_evt, &m_gq);
+}
+
+
+/**@brief Lets the peer answer until the discovery makes no more requests. */
+static void peer_run(void)
+{
+    while (m_rsp_pending)
+    {
+        static union
+        {
+            ble_evt_t evt;
+            uint8_t   raw[sizeof(m_rsp)];
+        } rsp;
+
+        memcpy(&rsp, &m_rsp, sizeof(rsp));
+        m_rsp_pending = false;
+        m_time_ms    += CONN_INTERVAL_MS;
+
+        ble_evt_send(&rsp.evt);
+    }
+}
+
+
+/**@brief Connects, runs a cached discovery to the end and returns the number of requests. */
+static uint32_t discovery_run(void)
+{
+    uint32_t const sd_req_count = m_sd_req_count;
+
+    m_complete_count      = 0;
+    m_not_found_count     = 0;
+    m_error_count         = 0;
+    m_cache_updated_count = 0;
+    m_available           = false;
+    m_time_ms             = 0;
+    memset(m_srvs, 0, sizeof(m_srvs));
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_db_discovery_start_cached(&m_db_disc, CONN_HANDLE, &m_cache));
+    peer_run();
+
+    TEST_ASSERT(m_available);
+    TEST_ASSERT(!m_db_disc.discovery_in_progress);
+    TEST_ASSERT_EQUAL(0, m_error_count);
+    TEST_ASSERT_EQUAL(2, m_complete_count + m_not_found_count);
+    TEST_ASSERT_EQUAL(m_sd_req_count - sd_req_count, m_db_disc.req_count);
+
+    return m_db_disc.req_count;
+}
+
+
+static void disconnect(void)
+{
+    ble_evt_t evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.header.evt_id           = BLE_GAP_EVT_DISCONNECTED;
+    evt.evt.gap_evt.conn_handle = CONN_HANDLE;
+    ble_evt_send(&evt);
+}
+
+
+static void srv_check(ble_gatt_db_srv_t const * p_srv, uint16_t uuid, uint8_t char_count)
+{
+    TEST_ASSERT_EQUAL(uuid, p_srv->srv_uuid.uuid);
+    TEST_ASSERT_EQUAL(char_count, p_srv->char_count);
+    TEST_ASSERT_EQUAL(BLE_UUID_SERVICE_PRIMARY, m_attrs[p_srv->handle_range.start_handle].type);
+    TEST_ASSERT_EQUAL(uuid, m_attrs[p_srv->handle_range.start_handle].uuid);
+
+    for (uint8_t i = 0; i < char_count; i++)
+    {
+        ble_gatt_db_char_t const * p_char = &p_srv->charateristics[i];
+        uint16_t                   cccd   = p_char->characteristic.handle_value + 1;
+
+        TEST_ASSERT_EQUAL(BLE_UUID_CHARACTERISTIC, m_attrs[p_char->characteristic.handle_decl].type);
+        if (m_attrs[cccd].type == BLE_UUID_DESCRIPTOR_CLIENT_CHAR_CONFIG)
+        {
+            TEST_ASSERT_EQUAL(cccd, p_char->cccd_handle);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(BLE_GATT_HANDLE_INVALID, p_char->cccd_handle);
+        }
+    }
+}
+
+
+static void test_cache_hit(void)
+{
+    peer_db_build(true, true, 1);
+    memset(&m_cache, 0, sizeof(m_cache));
+
+    // Empty cache: the hash read, then a full discovery of both services.
+    uint32_t const full_reqs = discovery_run();
+    uint32_t const full_ms   = m_available_ms;
+
+    TEST_ASSERT(!m_db_disc.from_cache);
+    TEST_ASSERT_EQUAL(2, m_complete_count);
+    TEST_ASSERT_EQUAL(1, m_cache_updated_count);
+    TEST_ASSERT(m_cache_updated_before_available);
+    TEST_ASSERT(m_cache.db_hash_valid);
+    TEST_ASSERT_EQUAL(0, memcmp(m_cache.db_hash, m_db_hash, sizeof(m_db_hash)));
+    srv_check(&m_srvs[0], UUID_HRS, 3);
+    srv_check(&m_srvs[1], UUID_BAS, 1);
+
+    ble_gatt_db_srv_t discovered[2];
+    memcpy(discovered, m_srvs, sizeof(discovered));
+    disconnect();
+
+    // Reconnection: the hash matches, so the services come from the cache after one request.
+    uint32_t const cached_reqs = discovery_run();
+
+    TEST_ASSERT(m_db_disc.from_cache);
+    TEST_ASSERT_EQUAL(1, cached_reqs);
+    TEST_ASSERT_EQUAL(2, m_complete_count);
+    TEST_ASSERT_EQUAL(0, m_cache_updated_count);
+    TEST_ASSERT_EQUAL(0, memcmp(discovered, m_srvs, sizeof(discovered)));
+
+    printf("  connection to ready at %u ms interval: full %u requests, %u ms; "
+           "cached %u request, %u ms\n",
+           CONN_INTERVAL_MS, (unsigned)full_reqs, (unsigned)full_ms,
+           (unsigned)cached_reqs, (unsigned)m_available_ms);
+    TEST_ASSERT_EQUAL(CONN_INTERVAL_MS, m_available_ms);
+    TEST_ASSERT(full_reqs > 4);
+    disconnect();
+}
+
+
+static void test_hash_mismatch(void)
+{
+    // The peer adds a characteristic to its Battery service, which changes its hash.
+    peer_db_build(true, true, 2);
+    TEST_ASSERT(memcmp(m_cache.db_hash, m_db_hash, sizeof(m_db_hash)) != 0);
+
+    uint32_t const reqs = discovery_run();
+
+    TEST_ASSERT(!m_db_disc.from_cache);
+    TEST_ASSERT(reqs > 1);
+    TEST_ASSERT_EQUAL(1, m_cache_updated_count);
+    TEST_ASSERT_EQUAL(0, memcmp(m_cache.db_hash, m_db_hash, sizeof(m_db_hash)));
+    srv_check(&m_srvs[0], UUID_HRS, 3);
+    srv_check(&m_srvs[1], UUID_BAS, 2);
+    TEST_ASSERT_EQUAL(2, m_cache.services[1].char_count);
+    disconnect();
+
+    // The updated cache is used on the next connection.
+    TEST_ASSERT_EQUAL(1, discovery_run());
+    TEST_ASSERT(m_db_disc.from_cache);
+    srv_check(&m_srvs[1], UUID_BAS, 2);
+    disconnect();
+}
+
+
+static void test_srv_not_found(void)
+{
+    // A peer without the Battery service: one service is found, the other is reported missing,
+    // and the same comes from the cache on the next connection.
+    peer_db_build(true, false, 0);
+
+    (void)discovery_run();
+    TEST_ASSERT_EQUAL(1, m_complete_count);
+    TEST_ASSERT_EQUAL(1, m_not_found_count);
+    TEST_ASSERT_EQUAL(UUID_BAS, m_srvs[1].srv_uuid.uuid);
+    disconnect();
+
+    TEST_ASSERT_EQUAL(1, discovery_run());
+    TEST_ASSERT(m_db_disc.from_cache);
+    TEST_ASSERT_EQUAL(1, m_complete_count);
+    TEST_ASSERT_EQUAL(1, m_not_found_count);
+    srv_check(&m_srvs[0], UUID_HRS, 3);
+    disconnect();
+}
+
+
+static void test_no_db_hash(void)
+{
+    // A peer without a Database Hash: the cache from a peer with one is not used, and the new
+    // cache is used unverified afterwards.
+    peer_db_build(false, true, 1);
+
+    TEST_ASSERT(discovery_run() > 1);
+    TEST_ASSERT(!m_db_disc.from_cache);
+    TEST_ASSERT(!m_cache.db_hash_valid);
+    disconnect();
+
+    TEST_ASSERT_EQUAL(1, discovery_run());
+    TEST_ASSERT(m_db_disc.from_cache);
+    TEST_ASSERT_EQUAL(2, m_complete_count);
+    disconnect();
+
+    // After Service Changed, the application clears the cache.
+    m_cache.entry_count = 0;
+    TEST_ASSERT(discovery_run() > 1);
+    TEST_ASSERT_EQUAL(1, m_cache_updated_count);
+    disconnect();
+}
+
+
+static void test_uncached(void)
+{
+    // ble_db_discovery_start() makes the same discovery without the hash read or the cache.
+    peer_db_build(true, true, 1);
+    memset(&m_cache, 0, sizeof(m_cache));
+    uint32_t const cached_full = discovery_run();
+    disconnect();
+
+    m_available = false;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_db_discovery_start(&m_db_disc, CONN_HANDLE));
+    peer_run();
+    TEST_ASSERT(m_available);
+    TEST_ASSERT_EQUAL(cached_full - 1, m_db_disc.req_count);
+    srv_check(&m_srvs[0], UUID_HRS, 3);
+    disconnect();
+}
+
+
+int main(void)
+{
+    printf("test_db_discovery\n");
+
+    ble_db_discovery_init_t db_init =
+    {
+        .evt_handler  = db_disc_evt_handler,
+        .p_gatt_queue = &m_gq,
+    };
+    ble_uuid_t hrs = {.uuid = UUID_HRS, .type = BLE_UUID_TYPE_BLE};
+    ble_uuid_t bas = {.uuid = UUID_BAS, .type = BLE_UUID_TYPE_BLE};
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_db_discovery_init(&db_init));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_db_discovery_evt_register(&hrs));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ble_db_discovery_evt_register(&bas));
+
+    TEST_RUN(test_cache_hit);
+    TEST_RUN(test_hash_mismatch);
+    TEST_RUN(test_srv_not_found);
+    TEST_RUN(test_no_db_hash);
+    TEST_RUN(test_uncached);
+
+    return 0;
+}
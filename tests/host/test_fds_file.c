@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* FDS running on the file-backed fstorage implementation.
+ *
+ * Each phase runs in its own process, so that FDS is initialized from scratch on the flash file
+ * left behind by the previous phase, as after a reset. The last phase reports the flash wear of
+ * repeated record updates. */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "fds.h"
+#include "nrf_fstorage_file.h"
+
+#define FILE_ID         0x1111
+#define RECORD_COUNT    32
+#define RECORD_WORDS    8
+#define UPDATE_ROUNDS   50
+
+/* Device flash timing used to convert the operation counters into flash busy time. */
+#define WORD_WRITE_US   41
+#define PAGE_ERASE_US   85000
+
+static volatile bool m_init_done;
+static ret_code_t    m_result;
+
+
+static void fds_evt_handler(fds_evt_t const * p_evt)
+{
+    m_result = p_evt->result;
+
+    if (p_evt->id == FDS_EVT_INIT)
+    {
+        m_init_done = (p_evt->result == NRF_SUCCESS);
+    }
+}
+
+
+static void record_data_make(uint16_t key, uint32_t round, uint32_t data[RECORD_WORDS])
+{
+    for (uint32_t i = 0; i < RECORD_WORDS; i++)
+    {
+        data[i] = ((uint32_t)key << 16) | (round << 4) | i;
+    }
+}
+
+
+static void fds_start(void)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_register(fds_evt_handler));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_init());
+    TEST_ASSERT(m_init_done);
+}
+
+
+/* The backend completes operations synchronously, FDS has processed the event on return. */
+static ret_code_t record_update(fds_record_desc_t * p_desc, uint16_t key, uint32_t round)
+{
+    uint32_t     data[RECORD_WORDS];
+    fds_record_t record =
+    {
+        .file_id           = FILE_ID,
+        .key               = key,
+        .data.p_data       = data,
+        .data.length_words = RECORD_WORDS,
+    };
+
+    record_data_make(key, round, data);
+
+    ret_code_t ret = fds_record_update(p_desc, &record);
+    if (ret == FDS_ERR_NO_SPACE_IN_FLASH)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_gc());
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, m_result);
+        ret = fds_record_update(p_desc, &record);
+    }
+
+    return (ret == NRF_SUCCESS) ? m_result : ret;
+}
+
+
+static void record_check(uint16_t key, uint32_t round)
+{
+    fds_record_desc_t  desc  = {0};
+    fds_find_token_t   token = {0};
+    fds_flash_record_t flash_record;
+    uint32_t           expected[RECORD_WORDS];
+
+    record_data_make(key, round, expected);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_find(FILE_ID, key, &desc, &token));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_open(&desc, &flash_record));
+
+    /* Records are read in place, from the mapping of the file. */
+    uint32_t const addr = (uint32_t)(uintptr_t)flash_record.p_data;
+    TEST_ASSERT(addr >= nrf_fstorage_file_flash_start_get());
+    TEST_ASSERT(addr <  nrf_fstorage_file_flash_end_get());
+
+    TEST_ASSERT_EQUAL(RECORD_WORDS, flash_record.p_header->length_words);
+    TEST_ASSERT(memcmp(flash_record.p_data, expected, sizeof(expected)) == 0);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_close(&desc));
+
+    /* Only one copy of the record is valid. */
+    TEST_ASSERT_EQUAL(FDS_ERR_NOT_FOUND, fds_record_find(FILE_ID, key, &desc, &token));
+}
+
+
+static void phase_write(void)
+{
+    fds_start();
+
+    for (uint16_t key = 1; key <= RECORD_COUNT; key++)
+    {
+        fds_record_desc_t desc = {0};
+        uint32_t          data[RECORD_WORDS];
+        fds_record_t      record =
+        {
+            .file_id           = FILE_ID,
+            .key               = key,
+            .data.p_data       = data,
+            .data.length_words = RECORD_WORDS,
+        };
+
+        record_data_make(key, 0, data);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_write(&desc, &record));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, m_result);
+    }
+
+    for (uint16_t key = 1; key <= RECORD_COUNT; key++)
+    {
+        record_check(key, 0);
+    }
+
+    /* New records are written to erased flash only. */
+    nrf_fstorage_file_stats_t stats;
+    nrf_fstorage_file_stats_get(&stats);
+    TEST_ASSERT_EQUAL(0, stats.bit_set_violations);
+    TEST_ASSERT_EQUAL(0, stats.rejected_cnt);
+}
+
+
+static void phase_reopen(void)
+{
+    fds_stat_t stat;
+
+    fds_start();
+
+    /* The records written by the previous process are found in the file. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_stat(&stat));
+    TEST_ASSERT_EQUAL(RECORD_COUNT, stat.valid_records);
+    TEST_ASSERT_EQUAL(0, stat.dirty_records);
+    TEST_ASSERT(!stat.corruption);
+
+    for (uint16_t key = 1; key <= RECORD_COUNT; key++)
+    {
+        record_check(key, 0);
+    }
+
+    /* Delete half of the records and reclaim the space. */
+    for (uint16_t key = 2; key <= RECORD_COUNT; key += 2)
+    {
+        fds_record_desc_t desc  = {0};
+        fds_find_token_t  token = {0};
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_find(FILE_ID, key, &desc, &token));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_delete(&desc));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, m_result);
+    }
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_gc());
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, m_result);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_stat(&stat));
+    TEST_ASSERT_EQUAL(RECORD_COUNT / 2, stat.valid_records);
+    TEST_ASSERT_EQUAL(0, stat.dirty_records);
+}
+
+
+static void phase_wear(void)
+{
+    nrf_fstorage_file_stats_t stats;
+    uint32_t                  updates  = 0;
+    uint32_t                  max_wear = 0;
+
+    fds_start();
+    nrf_fstorage_file_stats_reset();
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t round = 1; round <= UPDATE_ROUNDS; round++)
+    {
+        for (uint16_t key = 1; key <= RECORD_COUNT; key += 2)
+        {
+            fds_record_desc_t desc  = {0};
+            fds_find_token_t  token = {0};
+
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, fds_record_find(FILE_ID, key, &desc, &token));
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, record_update(&desc, key, round));
+            updates++;
+        }
+    }
+
+    uint64_t const elapsed = test_time_ns() - start;
+
+    for (uint16_t key = 1; key <= RECORD_COUNT; key += 2)
+    {
+        record_check(key, UPDATE_ROUNDS);
+    }
+
+    /* Records are invalidated by writing ones over their programmed key, which leaves those bits
+     * unchanged, so only rejected accesses are errors here. */
+    nrf_fstorage_file_stats_get(&stats);
+    TEST_ASSERT_EQUAL(0, stats.rejected_cnt);
+
+    for (uint32_t addr = nrf_fstorage_file_flash_start_get();
+         addr < nrf_fstorage_file_flash_end_get();
+         addr += NRF_FSTORAGE_FILE_PAGE_SIZE)
+    {
+        uint32_t const wear = nrf_fstorage_file_page_erase_cnt_get(addr);
+        max_wear = (wear > max_wear) ? wear : max_wear;
+    }
+
+    printf("    %u updates of %u-word records: %.2f us per update on the host\n",
+           updates, RECORD_WORDS, (double)elapsed / 1000.0 / updates);
+    printf("    %.1f words written per update, %llu page erases, %u erases on the most worn page\n",
+           (double)stats.words_written / updates, (unsigned long long)stats.pages_erased, max_wear);
+    printf("    flash busy time on the device: %.1f ms per update\n",
+           ((double)stats.words_written * WORD_WRITE_US + (double)stats.pages_erased * PAGE_ERASE_US)
+           / 1000.0 / updates);
+}
+
+
+static void run_in_process(char const * p_name, void (*phase)(void))
+{
+    int status;
+
+    printf("  %s\n", p_name);
+    fflush(stdout);
+
+    pid_t const pid = fork();
+    TEST_ASSERT(pid >= 0);
+
+    if (pid == 0)
+    {
+        phase();
+        exit(EXIT_SUCCESS);
+    }
+
+    TEST_ASSERT(waitpid(pid, &status, 0) == pid);
+    TEST_ASSERT(WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS));
+}
+
+
+int main(void)
+{
+    printf("test_fds_file\n");
+
+    (void) unlink(NRF_FSTORAGE_FILE_PATH);
+
+    run_in_process("phase_write",  phase_write);
+    run_in_process("phase_reopen", phase_reopen);
+    run_in_process("phase_wear",   phase_wear);
+
+    return 0;
+}
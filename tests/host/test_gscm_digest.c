@@ -0,0 +1,450 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* GATTS Cache Manager digest of stored local GATT databases (PM_LOCAL_DB_DIGEST_ENABLED).
+ *
+ * The Peer Database and the SoftDevice are replaced by models: each connection has system
+ * attributes in the SoftDevice, each peer has a local database record in flash, and writes reach
+ * flash only when write_complete() runs, which clears the digest the way the GATT Cache Manager
+ * does on the Peer Database event. Flash reads and writes are counted. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "ble_conn_state.h"
+#include "peer_manager_types.h"
+#include "peer_manager_internal.h"
+#include "peer_database.h"
+#include "id_manager.h"
+#include "gatts_cache_manager.h"
+
+#define CONN_COUNT      BLE_CONN_STATE_MAX_CONNECTIONS
+#define PEER_COUNT      4
+#define SYS_ATTR_MAX    64
+#define BUF_WORDS       (PM_LOCAL_DB_N_WORDS(SYS_ATTR_MAX))
+
+typedef struct
+{
+    uint16_t len;
+    uint8_t  data[SYS_ATTR_MAX];
+} sys_attr_t;
+
+static sys_attr_t   m_sd_sys_attr[CONN_COUNT];       // System attributes in the SoftDevice.
+static pm_peer_id_t m_conn_peer[CONN_COUNT];         // Peer bonded on each connection.
+static uint32_t     m_flash[PEER_COUNT][BUF_WORDS];  // Local database records in flash.
+static bool         m_flash_valid[PEER_COUNT];
+static uint32_t     m_write_buf[BUF_WORDS];
+static pm_peer_id_t m_write_buf_peer = PM_PEER_ID_INVALID;
+static pm_peer_id_t m_pending_peer   = PM_PEER_ID_INVALID; // Peer of the queued write.
+static uint32_t     m_pending[BUF_WORDS];
+static ret_code_t   m_store_result   = NRF_SUCCESS;
+
+static uint32_t     m_flash_reads;
+static uint32_t     m_flash_writes;
+
+
+uint16_t ble_conn_state_conn_idx(uint16_t conn_handle)
+{
+    return (conn_handle < CONN_COUNT) ? conn_handle : BLE_CONN_STATE_MAX_CONNECTIONS;
+}
+
+
+pm_peer_id_t im_peer_id_get_by_conn_handle(uint16_t conn_handle)
+{
+    return (conn_handle < CONN_COUNT) ? m_conn_peer[conn_handle] : PM_PEER_ID_INVALID;
+}
+
+
+uint16_t im_conn_handle_get(pm_peer_id_t peer_id)
+{
+    return BLE_CONN_HANDLE_INVALID;
+}
+
+
+void pm_gscm_evt_handler(pm_evt_t * p_gcm_evt)
+{
+}
+
+
+ret_code_t pds_peer_data_store(pm_peer_id_t                 peer_id,
+                               pm_peer_data_const_t const * p_peer_data,
+                               pm_store_token_t           * p_store_token)
+{
+    return NRF_SUCCESS;
+}
+
+
+pm_peer_id_t pds_next_peer_id_get(pm_peer_id_t prev_peer_id)
+{
+    return PM_PEER_ID_INVALID;
+}
+
+
+ret_code_t pdb_write_buf_get(pm_peer_id_t      peer_id,
+                             pm_peer_data_id_t data_id,
+                             uint32_t          n_bufs,
+                             pm_peer_data_t  * p_peer_data)
+{
+    TEST_ASSERT_EQUAL(PM_PEER_DATA_ID_GATT_LOCAL, data_id);
+    TEST_ASSERT_EQUAL(PM_PEER_ID_INVALID, m_write_buf_peer);
+
+    m_write_buf_peer          = peer_id;
+    p_peer_data->data_id      = data_id;
+    p_peer_data->length_words = BUF_WORDS;
+    p_peer_data->p_all_data   = m_write_buf;
+
+    // As the Peer Database does, tell the SoftDevice how much room there is.
+    p_peer_data->p_local_gatt_db->len = PM_LOCAL_DB_LEN(BUF_WORDS);
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_write_buf_release(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    TEST_ASSERT_EQUAL(m_write_buf_peer, peer_id);
+    m_write_buf_peer = PM_PEER_ID_INVALID;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_write_buf_store(pm_peer_id_t      peer_id,
+                               pm_peer_data_id_t data_id,
+                               pm_peer_id_t      new_peer_id)
+{
+    TEST_ASSERT_EQUAL(m_write_buf_peer, peer_id);
+    m_write_buf_peer = PM_PEER_ID_INVALID;
+
+    if (m_store_result != NRF_SUCCESS)
+    {
+        return m_store_result;
+    }
+    m_flash_writes++;
+    m_pending_peer = new_peer_id;
+    memcpy(m_pending, m_write_buf, sizeof(m_pending));
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t pdb_peer_data_ptr_get(pm_peer_id_t                 peer_id,
+                                 pm_peer_data_id_t            data_id,
+                                 pm_peer_data_flash_t * const p_peer_data)
+{
+    TEST_ASSERT_EQUAL(PM_PEER_DATA_ID_GATT_LOCAL, data_id);
+    m_flash_reads++;
+
+    if (!m_flash_valid[peer_id])
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    p_peer_data->p_all_data = m_flash[peer_id];
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_get(uint16_t conn_handle, uint8_t * p_sys_attrs, uint16_t * p_len,
+                                   uint32_t flags)
+{
+    sys_attr_t const * p_attr = &m_sd_sys_attr[conn_handle];
+
+    if (p_attr->len == 0)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (*p_len < p_attr->len)
+    {
+        return NRF_ERROR_DATA_SIZE;
+    }
+    memcpy(p_sys_attrs, p_attr->data, p_attr->len);
+    *p_len = p_attr->len;
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_sys_attr_set(uint16_t conn_handle, uint8_t const * p_sys_attrs, uint16_t len,
+                                   uint32_t flags)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_initial_user_handle_get(uint16_t * p_handle)
+{
+    return NRF_SUCCESS;
+}
+
+
+uint32_t sd_ble_gatts_service_changed(uint16_t conn_handle, uint16_t start_handle,
+                                      uint16_t end_handle)
+{
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Writes the queued local database to flash and clears the digest, as the GATT Cache
+ *        Manager does on PM_EVT_PEER_DATA_UPDATE_SUCCEEDED. */
+static void write_complete(void)
+{
+    TEST_ASSERT(m_pending_peer != PM_PEER_ID_INVALID);
+
+    memcpy(m_flash[m_pending_peer], m_pending, sizeof(m_pending));
+    m_flash_valid[m_pending_peer] = true;
+    gscm_local_db_digest_clear(m_pending_peer);
+    m_pending_peer = PM_PEER_ID_INVALID;
+}
+
+
+/**@brief Sets the value of one CCCD of a connection. */
+static void cccd_set(uint16_t conn_handle, uint16_t handle, uint16_t value)
+{
+    sys_attr_t * p_attr = &m_sd_sys_attr[conn_handle];
+
+    // Layout of the SoftDevice: handle, length, value, for each CCCD, and a CRC at the end.
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        uint8_t * p_cccd = &p_attr->data[i * 6];
+        uint16_encode(0x000C + 4 * i, p_cccd);
+        uint16_encode(2, p_cccd + 2);
+        if (0x000C + 4 * i == handle)
+        {
+            uint16_encode(value, p_cccd + 4);
+        }
+    }
+    p_attr->len = 3 * 6 + 2;
+}
+
+
+typedef struct
+{
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t skipped;
+    uint32_t digest_skipped;
+} counts_t;
+
+
+static counts_t counts_get(void)
+{
+    pm_local_db_write_stats_t stats;
+    gscm_local_db_write_stats_get(&stats);
+
+    return (counts_t)
+    {
+        .reads          = m_flash_reads,
+        .writes         = m_flash_writes,
+        .skipped        = stats.skipped,
+        .digest_skipped = stats.digest_skipped,
+    };
+}
+
+
+/**@brief Runs an update and checks how many flash reads, writes and skips it caused. */
+static void update_check(uint16_t conn_handle, ret_code_t expected,
+                         uint32_t reads, uint32_t writes, uint32_t digest_skipped)
+{
+    counts_t before = counts_get();
+
+    TEST_ASSERT_EQUAL(expected, gscm_local_db_cache_update(conn_handle));
+    TEST_ASSERT_EQUAL(PM_PEER_ID_INVALID, m_write_buf_peer);
+
+    counts_t after = counts_get();
+    TEST_ASSERT_EQUAL(before.reads + reads, after.reads);
+    TEST_ASSERT_EQUAL(before.writes + writes, after.writes);
+    TEST_ASSERT_EQUAL(before.digest_skipped + digest_skipped, after.digest_skipped);
+    TEST_ASSERT_EQUAL(before.skipped + ((expected == NRF_ERROR_INVALID_DATA) ? 1 : 0),
+                      after.skipped);
+}
+
+
+static void test_new_peer(void)
+{
+    m_conn_peer[0] = 0;
+    cccd_set(0, 0x000C, 1);
+
+    // Nothing in flash yet: one read to find out, then the write.
+    update_check(0, NRF_SUCCESS, 1, 1, 0);
+
+    // Repeats while the write is still queued are skipped without reading flash.
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+
+    // Once written, the digest is cleared: the next update compares with flash, once.
+    write_complete();
+    update_check(0, NRF_ERROR_INVALID_DATA, 1, 0, 0);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+}
+
+
+static void test_changed(void)
+{
+    // A CCCD write is written without reading flash, since the digest is of the newest data,
+    // and a repeat of it is skipped by the digest.
+    cccd_set(0, 0x0010, 2);
+    update_check(0, NRF_SUCCESS, 0, 1, 0);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+
+    // Changing it back before the write completes matches the old data still in flash, but must
+    // be written, or the queued write would leave the changed value in flash.
+    cccd_set(0, 0x0010, 0);
+    update_check(0, NRF_SUCCESS, 0, 1, 0);
+    write_complete();
+
+    uint8_t const * p_stored = ((pm_peer_data_local_gatt_db_t *)m_flash[0])->data;
+    TEST_ASSERT_EQUAL(0, memcmp(p_stored, m_sd_sys_attr[0].data, m_sd_sys_attr[0].len));
+
+    // A one-bit change is always caught. Each completed write clears the digest, so the update
+    // after it compares with flash.
+    for (uint32_t bit = 0; bit < 16; bit++)
+    {
+        cccd_set(0, 0x0014, (uint16_t)(1u << bit));
+        update_check(0, NRF_SUCCESS, 1, 1, 0);
+        write_complete();
+    }
+}
+
+
+static void test_store_failure(void)
+{
+    cccd_set(0, 0x000C, 2);
+
+    // A write that cannot be queued is not remembered, so the next update tries again.
+    m_store_result = NRF_ERROR_BUSY;
+    update_check(0, NRF_ERROR_BUSY, 1, 0, 0);
+
+    m_store_result = NRF_SUCCESS;
+    update_check(0, NRF_SUCCESS, 1, 1, 0);
+    write_complete();
+}
+
+
+static void test_peers(void)
+{
+    // Another peer on the same connection index does not match the digest of the first.
+    m_conn_peer[0] = 1;
+    update_check(0, NRF_SUCCESS, 1, 1, 0);
+    write_complete();
+
+    // A second connection has its own digest.
+    m_conn_peer[1] = 2;
+    m_sd_sys_attr[1] = m_sd_sys_attr[0];
+    update_check(1, NRF_SUCCESS, 1, 1, 0);
+    update_check(0, NRF_ERROR_INVALID_DATA, 1, 0, 0);
+    update_check(1, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+    write_complete();
+
+    // Deleting a peer clears its digest.
+    gscm_local_db_digest_clear(1);
+    update_check(0, NRF_ERROR_INVALID_DATA, 1, 0, 0);
+
+    // No system attributes: nothing to store.
+    m_sd_sys_attr[1].len = 0;
+    update_check(1, NRF_SUCCESS, 0, 0, 0);
+}
+
+
+static void test_reset(void)
+{
+    // The digest is in RAM only. After a reset the first update reads flash, and data that
+    // matches flash is still not written again.
+    m_conn_peer[0] = 0;
+    update_check(0, NRF_ERROR_INVALID_DATA, 1, 0, 0);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, gscm_init());
+    TEST_ASSERT_EQUAL(0, counts_get().digest_skipped);
+    update_check(0, NRF_ERROR_INVALID_DATA, 1, 0, 0);
+    update_check(0, NRF_ERROR_INVALID_DATA, 0, 0, 1);
+
+    // Data that changed while the device was off is written.
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, gscm_init());
+    cccd_set(0, 0x000C, 0);
+    update_check(0, NRF_SUCCESS, 1, 1, 0);
+    write_complete();
+}
+
+
+static void test_reconnections(void)
+{
+    uint32_t const rounds = 100;
+    counts_t       before;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, gscm_init());
+    m_conn_peer[0] = 0;
+    cccd_set(0, 0x000C, 1);
+    update_check(0, NRF_SUCCESS, 1, 1, 0);
+    write_complete();
+
+    // Each round is a reconnection with the same CCCDs, followed by the update after the CCCD
+    // writes and the one on disconnection.
+    before = counts_get();
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        (void)gscm_local_db_cache_update(0);
+        (void)gscm_local_db_cache_update(0);
+    }
+    counts_t after = counts_get();
+
+    printf("  %u updates: %u flash reads, %u writes, %u skipped by digest\n",
+           (unsigned)(2 * rounds), (unsigned)(after.reads - before.reads),
+           (unsigned)(after.writes - before.writes),
+           (unsigned)(after.digest_skipped - before.digest_skipped));
+    TEST_ASSERT_EQUAL(before.reads + 1, after.reads);
+    TEST_ASSERT_EQUAL(before.writes, after.writes);
+}
+
+
+int main(void)
+{
+    printf("test_gscm_digest\n");
+
+    for (uint32_t i = 0; i < CONN_COUNT; i++)
+    {
+        m_conn_peer[i] = PM_PEER_ID_INVALID;
+    }
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, gscm_init());
+
+    TEST_RUN(test_new_peer);
+    TEST_RUN(test_changed);
+    TEST_RUN(test_store_failure);
+    TEST_RUN(test_peers);
+    TEST_RUN(test_reset);
+    TEST_RUN(test_reconnections);
+
+    return 0;
+}
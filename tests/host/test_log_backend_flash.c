@@ -0,0 +1,499 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_log_backend_flash in compact circular mode, against a reference log.
+ *
+ * The flash is an mmap-ed region at the start page of the backend, behind an fstorage
+ * implementation with NOR semantics that reports operation results later, as the NVMC and
+ * SoftDevice implementations do. Random standard and hexdump entries are logged until the area has
+ * wrapped several times. Along the way, full reads, last-N reads and since-timestamp reads are
+ * checked against the reference log, and the backend is initialized again to check that the
+ * write position and sequence numbers are restored from flash. The compact format is compared
+ * with the size of the same entries in the raw format. */
+
+#include <string.h>
+#include <sys/mman.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "nrf_log_backend_flash.h"
+#include "nrf_fstorage_nvmc.h"
+#include "nrf_memobj.h"
+
+#define FLASH_PAGE_SIZE     4096
+#define FLASH_START         (NRF_LOG_BACKEND_FLASH_START_PAGE * FLASH_PAGE_SIZE)
+#define FLASH_SIZE          (NRF_LOG_BACKEND_PAGES * FLASH_PAGE_SIZE)
+#define PAGE_HDR_SIZE       16
+#define EVT_MAX             8
+
+#define ENTRY_COUNT         7500
+#define CHECK_PERIOD        250
+#define REINIT_PERIOD       1000
+#define HEXDUMP_MAX_LEN     40
+#define TS_STEP_MAX         5000
+#define ENTRY_SIZE_MAX      56                  /* Compact size of a hexdump of HEXDUMP_MAX_LEN bytes. */
+
+typedef struct
+{
+    nrf_log_header_t header;
+    uint8_t          data[HEXDUMP_MAX_LEN];             /* Arguments or hexdump data. */
+} ref_entry_t;
+
+NRF_MEMOBJ_POOL_DEF(m_msg_pool, sizeof(nrf_log_header_t) + HEXDUMP_MAX_LEN, 4);
+
+static struct
+{
+    nrf_fstorage_evt_t    evt[EVT_MAX];             /* Results not reported yet, oldest first. */
+    uint32_t              evt_cnt;
+    nrf_fstorage_t const * p_fs;
+    uint32_t              entry_bytes;              /* Bytes written for entries, without page headers. */
+    uint32_t              page_hdr_cnt;
+    uint32_t              erase_cnt;
+} m_flash;
+
+static ref_entry_t m_ref[ENTRY_COUNT];
+static uint32_t    m_ref_cnt;
+static uint32_t    m_raw_bytes;                     /* Size of the logged entries in the raw format. */
+
+
+static bool flash_access_valid(uint32_t addr, uint32_t len)
+{
+    return (addr >= FLASH_START) && (len <= FLASH_SIZE) && (addr - FLASH_START <= FLASH_SIZE - len) &&
+           ((addr % sizeof(uint32_t)) == 0);
+}
+
+
+static void flash_evt_push(nrf_fstorage_t const * p_fs, nrf_fstorage_evt_t const * p_evt)
+{
+    TEST_ASSERT(m_flash.evt_cnt < EVT_MAX);
+    m_flash.p_fs                    = p_fs;
+    m_flash.evt[m_flash.evt_cnt++] = *p_evt;
+}
+
+
+static ret_code_t flash_init(nrf_fstorage_t * p_fs, void * p_param)
+{
+    static nrf_fstorage_info_t info =
+    {
+        .erase_unit   = FLASH_PAGE_SIZE,
+        .program_unit = sizeof(uint32_t),
+        .rmap         = true,
+        .wmap         = false,
+    };
+
+    p_fs->p_flash_info = &info;
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_uninit(nrf_fstorage_t * p_fs, void * p_param)
+{
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_read(nrf_fstorage_t const * p_fs, uint32_t src, void * p_dest, uint32_t len)
+{
+    TEST_ASSERT(flash_access_valid(src, len));
+    memcpy(p_dest, (void const *)(uintptr_t)src, len);
+    return NRF_SUCCESS;
+}
+
+
+/* Programming can only clear bits. */
+static ret_code_t flash_write(nrf_fstorage_t const * p_fs,
+                              uint32_t               dest,
+                              void const           * p_src,
+                              uint32_t               len,
+                              void                 * p_param)
+{
+    uint8_t * p_dest = (uint8_t *)(uintptr_t)dest;
+
+    if (!flash_access_valid(dest, len) || ((len % sizeof(uint32_t)) != 0))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    for (uint32_t i = 0; i < len; i++)
+    {
+        TEST_ASSERT((p_dest[i] & ((uint8_t const *)p_src)[i]) == ((uint8_t const *)p_src)[i]);
+        p_dest[i] &= ((uint8_t const *)p_src)[i];
+    }
+
+    if (((dest - FLASH_START) % FLASH_PAGE_SIZE) == 0)
+    {
+        m_flash.page_hdr_cnt++;
+        m_flash.entry_bytes += len - PAGE_HDR_SIZE;
+    }
+    else
+    {
+        m_flash.entry_bytes += len;
+    }
+
+    flash_evt_push(p_fs, &(nrf_fstorage_evt_t){
+                             .id      = NRF_FSTORAGE_EVT_WRITE_RESULT,
+                             .result  = NRF_SUCCESS,
+                             .addr    = dest,
+                             .p_src   = p_src,
+                             .len     = len,
+                             .p_param = p_param,
+                         });
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t flash_erase(nrf_fstorage_t const * p_fs, uint32_t addr, uint32_t len, void * p_param)
+{
+    if (!flash_access_valid(addr, len * FLASH_PAGE_SIZE) || (((addr - FLASH_START) % FLASH_PAGE_SIZE) != 0))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    memset((void *)(uintptr_t)addr, 0xFF, len * FLASH_PAGE_SIZE);
+    m_flash.erase_cnt += len;
+
+    flash_evt_push(p_fs, &(nrf_fstorage_evt_t){
+                             .id      = NRF_FSTORAGE_EVT_ERASE_RESULT,
+                             .result  = NRF_SUCCESS,
+                             .addr    = addr,
+                             .len     = len,
+                             .p_param = p_param,
+                         });
+    return NRF_SUCCESS;
+}
+
+
+static uint8_t const * flash_rmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    return flash_access_valid(addr & ~3u, 0) ? (uint8_t const *)(uintptr_t)addr : NULL;
+}
+
+
+static uint8_t * flash_wmap(nrf_fstorage_t const * p_fs, uint32_t addr)
+{
+    return NULL;
+}
+
+
+static bool flash_is_busy(nrf_fstorage_t const * p_fs)
+{
+    return (m_flash.evt_cnt != 0);
+}
+
+
+/* The flash model stands in for the NVMC implementation, which the crashlog also refers to. */
+nrf_fstorage_api_t nrf_fstorage_nvmc =
+{
+    .init    = flash_init,
+    .uninit  = flash_uninit,
+    .read    = flash_read,
+    .write   = flash_write,
+    .erase   = flash_erase,
+    .rmap    = flash_rmap,
+    .wmap    = flash_wmap,
+    .is_busy = flash_is_busy,
+};
+
+
+/* Reports the results of the pending operations, as the flash interrupt would. */
+static void flash_evts_process(void)
+{
+    while (m_flash.evt_cnt > 0)
+    {
+        nrf_fstorage_evt_t evt = m_flash.evt[0];
+
+        memmove(&m_flash.evt[0], &m_flash.evt[1], --m_flash.evt_cnt * sizeof(evt));
+        m_flash.p_fs->evt_handler(&evt);
+    }
+}
+
+
+static void flash_map(void)
+{
+#if defined(MAP_FIXED_NOREPLACE)
+    int const flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+#else
+    int const flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#endif
+    void * p_map = mmap((void *)(uintptr_t)FLASH_START, FLASH_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+
+    TEST_ASSERT(p_map == (void *)(uintptr_t)FLASH_START);
+    memset(p_map, 0xFF, FLASH_SIZE);
+}
+
+
+/* Creates a random entry with a timestamp after the previous one and logs it. */
+static void entry_log(void)
+{
+    ref_entry_t     * p_ref = &m_ref[m_ref_cnt];
+    nrf_log_header_t * p_hdr = &p_ref->header;
+    uint32_t          data_len;
+    uint32_t const    prev_ts = (m_ref_cnt > 0) ? m_ref[m_ref_cnt - 1].header.timestamp : 0;
+
+    memset(p_ref, 0, sizeof(*p_ref));
+    p_hdr->module_id = (uint16_t)(rand() % 40);
+    p_hdr->timestamp = prev_ts + 1 + (uint32_t)(rand() % TS_STEP_MAX);
+
+    if ((rand() % 4) == 0)
+    {
+        p_hdr->base.hexdump.type     = HEADER_TYPE_HEXDUMP;
+        p_hdr->base.hexdump.severity = 1 + (rand() % 4);
+        p_hdr->base.hexdump.len      = 1 + (rand() % HEXDUMP_MAX_LEN);
+        data_len                     = p_hdr->base.hexdump.len;
+        for (uint32_t i = 0; i < data_len; i++)
+        {
+            p_ref->data[i] = (uint8_t)rand();
+        }
+        m_raw_bytes += sizeof(nrf_log_header_t) + ALIGN_NUM(sizeof(uint32_t), data_len);
+    }
+    else
+    {
+        p_hdr->base.std.type     = HEADER_TYPE_STD;
+        p_hdr->base.std.severity = 1 + (rand() % 4);
+        p_hdr->base.std.nargs    = rand() % (NRF_LOG_MAX_NUM_OF_ARGS + 1);
+        p_hdr->base.std.addr     = (uint32_t)rand() & STD_ADDR_MASK;
+        data_len                 = p_hdr->base.std.nargs * sizeof(uint32_t);
+        for (uint32_t i = 0; i < p_hdr->base.std.nargs; i++)
+        {
+            /* Mostly small values, as counters and lengths are, and now and then a full word. */
+            uint32_t const arg = ((rand() % 8) == 0) ? ((uint32_t)rand() << 1) ^ (uint32_t)rand()
+                                                     : (uint32_t)(rand() % 1000);
+            memcpy(&p_ref->data[i * sizeof(uint32_t)], &arg, sizeof(arg));
+        }
+        m_raw_bytes += sizeof(nrf_log_header_t) + data_len;
+    }
+
+    nrf_log_entry_t * p_msg = nrf_memobj_alloc(&m_msg_pool, sizeof(nrf_log_header_t) + data_len);
+
+    TEST_ASSERT(p_msg != NULL);
+    nrf_memobj_write(p_msg, p_hdr, sizeof(nrf_log_header_t), 0);
+    nrf_memobj_write(p_msg, p_ref->data, data_len, sizeof(nrf_log_header_t));
+
+    nrf_log_backend_flashlog_api.put(NULL, p_msg);
+    nrf_memobj_put(p_msg);
+    flash_evts_process();
+
+    m_ref_cnt++;
+}
+
+
+static void entry_check(ref_entry_t const * p_ref, nrf_log_header_t const * p_hdr, uint8_t const * p_data)
+{
+    TEST_ASSERT_EQUAL(p_ref->header.base.generic.type, p_hdr->base.generic.type);
+    TEST_ASSERT_EQUAL(p_ref->header.module_id, p_hdr->module_id);
+    TEST_ASSERT_EQUAL(p_ref->header.timestamp, p_hdr->timestamp);
+
+    if (p_ref->header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        TEST_ASSERT_EQUAL(p_ref->header.base.hexdump.severity, p_hdr->base.hexdump.severity);
+        TEST_ASSERT_EQUAL(p_ref->header.base.hexdump.len, p_hdr->base.hexdump.len);
+        TEST_ASSERT(memcmp(p_ref->data, p_data, p_hdr->base.hexdump.len) == 0);
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL(p_ref->header.base.std.severity, p_hdr->base.std.severity);
+        TEST_ASSERT_EQUAL(p_ref->header.base.std.nargs, p_hdr->base.std.nargs);
+        TEST_ASSERT_EQUAL(p_ref->header.base.std.addr, p_hdr->base.std.addr);
+        TEST_ASSERT(memcmp(p_ref->data, p_data, p_hdr->base.std.nargs * sizeof(uint32_t)) == 0);
+    }
+}
+
+
+/* Reads from the token to the end of the log, which must hold the reference entries from the
+ * given one to the newest. */
+static void log_check(uint32_t token, uint32_t first)
+{
+    nrf_log_header_t * p_hdr;
+    uint8_t          * p_data;
+
+    for (uint32_t i = first; i < m_ref_cnt; i++)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_next_entry_get(&token, &p_hdr, &p_data));
+        entry_check(&m_ref[i], p_hdr, p_data);
+    }
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND, nrf_log_backend_flash_next_entry_get(&token, &p_hdr, &p_data));
+}
+
+
+/* Returns the index of the oldest stored entry. */
+static uint32_t oldest_get(void)
+{
+    nrf_log_header_t * p_hdr;
+    uint8_t          * p_data;
+    uint32_t           token = 0;
+    uint32_t           first = 0;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_next_entry_get(&token, &p_hdr, &p_data));
+    while (m_ref[first].header.timestamp != p_hdr->timestamp)
+    {
+        first++;
+        TEST_ASSERT(first < m_ref_cnt);
+    }
+    return first;
+}
+
+
+static void reads_check(void)
+{
+    static uint32_t const counts[] = {1, 2, 10, 100};
+    uint32_t const        oldest   = oldest_get();
+    uint32_t const        stored   = m_ref_cnt - oldest;
+    uint32_t              token;
+
+    /* Everything but the page being reused must still be stored. */
+    TEST_ASSERT(stored * ENTRY_SIZE_MAX >= (NRF_LOG_BACKEND_PAGES - 1) * (FLASH_PAGE_SIZE - PAGE_HDR_SIZE) ||
+                (oldest == 0));
+
+    log_check(0, oldest);
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(counts); i++)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_last_entries_token_get(counts[i], &token));
+        log_check(token, m_ref_cnt - MIN(counts[i], stored));
+    }
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_last_entries_token_get(stored, &token));
+    log_check(token, oldest);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_last_entries_token_get(stored + 5, &token));
+    log_check(token, oldest);
+
+    /* Exact timestamps, timestamps between two entries, and the edges of the log. */
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        uint32_t const k = oldest + 1 + (uint32_t)rand() % (stored - 1);
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_since_token_get(m_ref[k].header.timestamp, &token));
+        log_check(token, k);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                          nrf_log_backend_flash_since_token_get(m_ref[k - 1].header.timestamp + 1, &token));
+        log_check(token, k);
+    }
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_since_token_get(0, &token));
+    log_check(token, oldest);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS,
+                      nrf_log_backend_flash_since_token_get(m_ref[m_ref_cnt - 1].header.timestamp + 1, &token));
+    log_check(token, m_ref_cnt);
+}
+
+
+static void test_empty(void)
+{
+    nrf_log_header_t * p_hdr;
+    uint8_t          * p_data;
+    uint32_t           token = 0;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_init(&nrf_fstorage_nvmc));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND, nrf_log_backend_flash_next_entry_get(&token, &p_hdr, &p_data));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND, nrf_log_backend_flash_last_entries_token_get(10, &token));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND, nrf_log_backend_flash_since_token_get(0, &token));
+
+    /* The first entry starts the first page. */
+    entry_log();
+    TEST_ASSERT_EQUAL(1, m_flash.page_hdr_cnt);
+    log_check(0, 0);
+}
+
+
+static void test_wraparound(void)
+{
+    while (m_ref_cnt < ENTRY_COUNT)
+    {
+        entry_log();
+
+        if ((m_ref_cnt % CHECK_PERIOD) == 0)
+        {
+            reads_check();
+        }
+        if ((m_ref_cnt % REINIT_PERIOD) == 0)
+        {
+            /* As after a reset: the write position and sequence numbers come from flash. */
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_init(&nrf_fstorage_nvmc));
+            reads_check();
+        }
+    }
+
+    /* The area has wrapped several times, reusing each page in turn. */
+    TEST_ASSERT(m_flash.page_hdr_cnt > 4 * NRF_LOG_BACKEND_PAGES);
+    TEST_ASSERT_EQUAL(m_flash.page_hdr_cnt - NRF_LOG_BACKEND_PAGES, m_flash.erase_cnt);
+    printf("    %u entries, %u pages used, %u erases\n",
+           m_ref_cnt, m_flash.page_hdr_cnt, m_flash.erase_cnt);
+}
+
+
+static void test_compaction(void)
+{
+    double const compact = (double)m_flash.entry_bytes / m_ref_cnt;
+    double const raw     = (double)m_raw_bytes / m_ref_cnt;
+
+    TEST_ASSERT(compact < raw);
+    printf("    %.1f B per entry compact, %.1f B raw\n", compact, raw);
+}
+
+
+static void test_erase(void)
+{
+    nrf_log_header_t * p_hdr;
+    uint8_t          * p_data;
+    uint32_t           token = 0;
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_erase());
+    flash_evts_process();
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND, nrf_log_backend_flash_next_entry_get(&token, &p_hdr, &p_data));
+
+    /* Logging starts over in the first page once the erase has completed. */
+    m_ref_cnt = 0;
+    entry_log();
+    entry_log();
+    log_check(0, 0);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_backend_flash_init(&nrf_fstorage_nvmc));
+    log_check(0, 0);
+}
+
+
+int main(void)
+{
+    printf("test_log_backend_flash\n");
+
+    flash_map();
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_memobj_pool_init(&m_msg_pool));
+    srand(1);
+
+    TEST_RUN(test_empty);
+    TEST_RUN(test_wraparound);
+    TEST_RUN(test_compaction);
+    TEST_RUN(test_erase);
+
+    return 0;
+}
@@ -0,0 +1,532 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Dictionary frames of the serial log backend (NRF_LOG_DICTIONARY_ENABLED).
+ *
+ * A backend passes the entries of the nrf_log frontend to nrf_log_backend_serial_put() with a
+ * 16-byte output buffer and captures the transmitted bytes. The tests build the expected frames
+ * byte by byte: sync, length, descriptor, timestamp, module name address, dropped count, format
+ * string address, arguments with inline strings, hexdump data and XOR checksum. They also check
+ * the flushing of the output buffer.
+ *
+ * The whole capture is written to test_log_dict.bin, together with the text the dictionary
+ * decoder must print for it in test_log_dict.txt. The Makefile runs the decoder on the test
+ * binary and compares the output. The binary is linked low, so the string addresses fit in the
+ * 22-bit address field of the log header. */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+#include "nrf_log_internal.h"
+#include "nrf_log_backend_interface.h"
+#include "nrf_log_backend_serial.h"
+
+#define TIMESTAMP_FREQ  1000
+#define TX_BUF_SIZE     16
+#define CAPTURE_SIZE    16384
+#define TEXT_SIZE       32768
+#define LONG_STR_LEN    300
+#define DROP_LOG_CNT    400
+
+#define DESC(type, severity)  ((uint8_t)((type) | ((severity) << 2)))
+#define DESC_DROPPED          0x20
+
+NRF_LOG_INTERNAL_ITEM_REGISTER(dict, "dict", 0, 0, NRF_LOG_SEVERITY_DEBUG, NRF_LOG_SEVERITY_DEBUG);
+
+#define DICT_ID NRF_LOG_MODULE_ID_GET_CONST(&NRF_LOG_ITEM_DATA_CONST(dict))
+
+static const char m_fmt_plain[] = "plain";
+static const char m_fmt_mixed[] = "%d %x %%d %s";
+static const char m_fmt_width[] = "%*d|%s";
+static const char m_fmt_long[]  = "%s";
+static const char m_fmt_sev[]   = "sev %u";
+static const char m_fmt_drop[]  = "fill";
+static const char m_const_str[] = "const";
+
+static char m_long_str[LONG_STR_LEN + 1];
+
+/* Bytes sent by the backend since the last check, and in the whole test. */
+static struct
+{
+    uint8_t  data[CAPTURE_SIZE];
+    uint32_t len;
+    uint32_t tx_cnt;
+} m_tx;
+
+static struct
+{
+    uint8_t  data[CAPTURE_SIZE * 4];
+    uint32_t len;
+} m_stream;
+
+/* Expected bytes, and the start of the frame being built. */
+static struct
+{
+    uint8_t  data[CAPTURE_SIZE];
+    uint32_t len;
+    uint32_t frame_start;
+    uint32_t frame_cnt;
+} m_exp;
+
+static char     m_text[TEXT_SIZE];
+static uint32_t m_text_len;
+static uint8_t  m_tx_buf[TX_BUF_SIZE];
+static uint32_t m_now;
+
+
+static uint32_t timestamp_get(void)
+{
+    return m_now;
+}
+
+
+static void tx_func(void const * p_user_ctx, char const * p_str, size_t length)
+{
+    TEST_ASSERT(length > 0);
+    TEST_ASSERT(length <= TX_BUF_SIZE);
+    TEST_ASSERT(m_tx.len + length <= sizeof(m_tx.data));
+    TEST_ASSERT(m_stream.len + length <= sizeof(m_stream.data));
+
+    memcpy(&m_tx.data[m_tx.len], p_str, length);
+    memcpy(&m_stream.data[m_stream.len], p_str, length);
+    m_tx.len     += length;
+    m_stream.len += length;
+    m_tx.tx_cnt++;
+}
+
+
+static void backend_put(nrf_log_backend_t const * p_backend, nrf_log_entry_t * p_msg)
+{
+    nrf_log_backend_serial_put(p_backend, p_msg, m_tx_buf, sizeof(m_tx_buf), tx_func);
+}
+
+
+static void backend_panic_set(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static void backend_flush(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static const nrf_log_backend_api_t m_backend_api =
+{
+    .put       = backend_put,
+    .panic_set = backend_panic_set,
+    .flush     = backend_flush,
+};
+
+NRF_LOG_BACKEND_DEF(m_backend, m_backend_api, NULL);
+
+
+static void log_init(void)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_init(timestamp_get, TIMESTAMP_FREQ));
+    if (m_backend.p_cb->id != NRF_LOG_BACKEND_INVALID_ID)
+    {
+        nrf_log_backend_remove(&m_backend);
+    }
+    TEST_ASSERT(nrf_log_backend_add(&m_backend, NRF_LOG_SEVERITY_DEBUG) >= 0);
+    nrf_log_backend_enable(&m_backend);
+}
+
+
+static void log_process(void)
+{
+    while (nrf_log_frontend_dequeue())
+    {
+    }
+}
+
+
+static uint32_t addr_get(void const * p)
+{
+    uint32_t const addr = (uint32_t)(uintptr_t)p;
+
+    /* The format string address is stored in 22 bits of the log header. */
+    TEST_ASSERT(addr < (1UL << 22));
+    return addr;
+}
+
+
+static void capture_clear(void)
+{
+    m_tx.len        = 0;
+    m_tx.tx_cnt     = 0;
+    m_exp.len       = 0;
+    m_exp.frame_cnt = 0;
+}
+
+
+static void exp_u8(uint8_t value)
+{
+    TEST_ASSERT(m_exp.len < sizeof(m_exp.data));
+    m_exp.data[m_exp.len++] = value;
+}
+
+
+static void exp_u16(uint16_t value)
+{
+    exp_u8((uint8_t)value);
+    exp_u8((uint8_t)(value >> 8));
+}
+
+
+static void exp_u32(uint32_t value)
+{
+    exp_u16((uint16_t)value);
+    exp_u16((uint16_t)(value >> 16));
+}
+
+
+/* String arguments are inlined as a length byte and at most 255 characters. */
+static void exp_str(char const * p_str)
+{
+    size_t const len = MIN(strlen(p_str), UINT8_MAX);
+
+    exp_u8((uint8_t)len);
+    for (size_t i = 0; i < len; i++)
+    {
+        exp_u8((uint8_t)p_str[i]);
+    }
+}
+
+
+static void frame_begin(uint8_t desc, uint32_t timestamp, uint16_t dropped)
+{
+    m_exp.frame_start = m_exp.len;
+    exp_u8(NRF_LOG_DICT_SYNC);
+    exp_u16(0);
+    exp_u8(dropped ? (desc | DESC_DROPPED) : desc);
+    exp_u32(timestamp);
+    exp_u32(addr_get(NRF_LOG_ITEM_DATA_CONST(dict).p_module_name));
+    if (dropped)
+    {
+        exp_u16(dropped);
+    }
+}
+
+
+static void frame_std_begin(uint8_t    severity,
+                            uint32_t   timestamp,
+                            uint16_t   dropped,
+                            char const * p_fmt,
+                            uint8_t    nargs)
+{
+    frame_begin(DESC(HEADER_TYPE_STD, severity), timestamp, dropped);
+    exp_u32(addr_get(p_fmt));
+    exp_u8(nargs);
+}
+
+
+/* Fills in the length and appends the checksum. Returns the length of the frame. */
+static uint32_t frame_end(void)
+{
+    uint32_t const payload_start = m_exp.frame_start + 3;
+    uint32_t const payload_len   = m_exp.len - payload_start;
+    uint8_t        checksum      = 0;
+
+    m_exp.data[m_exp.frame_start + 1] = (uint8_t)payload_len;
+    m_exp.data[m_exp.frame_start + 2] = (uint8_t)(payload_len >> 8);
+    for (uint32_t i = payload_start; i < m_exp.len; i++)
+    {
+        checksum ^= m_exp.data[i];
+    }
+    exp_u8(checksum);
+    m_exp.frame_cnt++;
+
+    return m_exp.len - m_exp.frame_start;
+}
+
+
+/* Every frame is sent in full chunks of the output buffer and one flush for the rest. */
+static void capture_check(uint32_t tx_cnt)
+{
+    TEST_ASSERT_EQUAL(m_exp.len, m_tx.len);
+    for (uint32_t i = 0; i < m_exp.len; i++)
+    {
+        if (m_exp.data[i] != m_tx.data[i])
+        {
+            printf("  byte %u: expected 0x%02x, got 0x%02x\n", i, m_exp.data[i], m_tx.data[i]);
+        }
+        TEST_ASSERT_EQUAL(m_exp.data[i], m_tx.data[i]);
+    }
+    TEST_ASSERT_EQUAL(tx_cnt, m_tx.tx_cnt);
+}
+
+
+static uint32_t chunk_cnt(uint32_t frame_len)
+{
+    return (frame_len + TX_BUF_SIZE - 1) / TX_BUF_SIZE;
+}
+
+
+/* Text printed by the dictionary decoder without a timestamp frequency. */
+static void text_add(char const * p_fmt, ...)
+{
+    va_list args;
+    int     len;
+
+    va_start(args, p_fmt);
+    len = vsnprintf(&m_text[m_text_len], sizeof(m_text) - m_text_len, p_fmt, args);
+    va_end(args);
+    TEST_ASSERT((len >= 0) && (m_text_len + len < sizeof(m_text)));
+    m_text_len += len;
+}
+
+
+static char const * severity_name(uint8_t severity)
+{
+    static char const * const names[] = {NULL, "error", "warning", "info", "debug"};
+
+    return names[severity];
+}
+
+
+static void text_prefix_add(uint8_t severity, uint32_t timestamp)
+{
+    text_add("[%08u] <%s> dict: ", timestamp, severity_name(severity));
+}
+
+
+static void test_std(void)
+{
+    uint32_t const sev_mid = NRF_LOG_SEVERITY_INFO | (DICT_ID << NRF_LOG_MODULE_ID_POS);
+    char           ram_str[] = "pushed";
+    char const *   p_pushed;
+    uint32_t       tx_cnt = 0;
+
+    log_init();
+    capture_clear();
+    memset(m_long_str, 'a', LONG_STR_LEN);
+    m_long_str[LONG_STR_LEN - 1] = 'z';
+
+    /* No arguments. */
+    m_now = 100;
+    nrf_log_frontend_std_0(sev_mid, m_fmt_plain);
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 100, 0, m_fmt_plain, 0);
+    tx_cnt += chunk_cnt(frame_end());
+    text_prefix_add(NRF_LOG_SEVERITY_INFO, 100);
+    text_add("plain\r\n");
+
+    /* An escaped '%' does not take an argument, a string pushed to RAM is sent inline. */
+    m_now    = 0x12345678;
+    p_pushed = nrf_log_push(ram_str);
+    nrf_log_frontend_std_3(sev_mid, m_fmt_mixed, (uint32_t)-5, 0xBEEF, (uint32_t)(uintptr_t)p_pushed);
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 0x12345678, 0, m_fmt_mixed, 3);
+    exp_u32((uint32_t)-5);
+    exp_u32(0xBEEF);
+    exp_str("pushed");
+    tx_cnt += chunk_cnt(frame_end());
+    text_prefix_add(NRF_LOG_SEVERITY_INFO, 0x12345678);
+    text_add("-5 beef %%d pushed\r\n");
+
+    /* A '*' width takes an argument of its own. */
+    m_now = 0xFFFFFFFF;
+    nrf_log_frontend_std_3(sev_mid, m_fmt_width, 6, 42, (uint32_t)(uintptr_t)m_const_str);
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 0xFFFFFFFF, 0, m_fmt_width, 3);
+    exp_u32(6);
+    exp_u32(42);
+    exp_str(m_const_str);
+    tx_cnt += chunk_cnt(frame_end());
+    text_prefix_add(NRF_LOG_SEVERITY_INFO, 0xFFFFFFFF);
+    text_add("%6d|%s\r\n", 42, m_const_str);
+
+    /* Long strings are truncated to 255 characters. */
+    m_now = 7;
+    nrf_log_frontend_std_1(sev_mid, m_fmt_long, (uint32_t)(uintptr_t)m_long_str);
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 7, 0, m_fmt_long, 1);
+    exp_str(m_long_str);
+    TEST_ASSERT_EQUAL(3 + 1 + 4 + 4 + 4 + 1 + 1 + 255 + 1, frame_end());
+    tx_cnt += chunk_cnt(3 + 1 + 4 + 4 + 4 + 1 + 1 + 255 + 1);
+    text_prefix_add(NRF_LOG_SEVERITY_INFO, 7);
+    text_add("%.255s\r\n", m_long_str);
+
+    /* Severity levels. */
+    for (uint8_t severity = NRF_LOG_SEVERITY_ERROR; severity <= NRF_LOG_SEVERITY_DEBUG; severity++)
+    {
+        m_now = 1000 + severity;
+        nrf_log_frontend_std_1(severity | (DICT_ID << NRF_LOG_MODULE_ID_POS), m_fmt_sev, severity);
+        frame_std_begin(severity, m_now, 0, m_fmt_sev, 1);
+        exp_u32(severity);
+        tx_cnt += chunk_cnt(frame_end());
+        text_prefix_add(severity, m_now);
+        text_add("sev %u\r\n", severity);
+    }
+
+    log_process();
+    capture_check(tx_cnt);
+}
+
+
+static void test_hexdump(void)
+{
+    uint32_t const sev_mid = NRF_LOG_SEVERITY_WARNING | (DICT_ID << NRF_LOG_MODULE_ID_POS);
+    uint8_t        data[20];
+    uint32_t       tx_cnt = 0;
+
+    log_init();
+    capture_clear();
+    for (uint32_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)((i < 10) ? ('A' + i) : (0xF0 + i));
+    }
+
+    /* Sizes around the 8-byte chunks read from the log entry. */
+    static const uint32_t lengths[] = {1, 8, 9, 20};
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(lengths); i++)
+    {
+        uint32_t const len = lengths[i];
+
+        m_now = 500 + i;
+        nrf_log_frontend_hexdump(sev_mid, data, len);
+        frame_begin(DESC(HEADER_TYPE_HEXDUMP, NRF_LOG_SEVERITY_WARNING), m_now, 0);
+        for (uint32_t j = 0; j < len; j++)
+        {
+            exp_u8(data[j]);
+        }
+        TEST_ASSERT_EQUAL(3 + 1 + 4 + 4 + len + 1, frame_end());
+        tx_cnt += chunk_cnt(3 + 1 + 4 + 4 + len + 1);
+
+        for (uint32_t line = 0; line < len; line += 8)
+        {
+            char hex[3 * 8 + 1] = "";
+            char chr[8 + 1]     = "";
+
+            for (uint32_t j = line; (j < len) && (j < line + 8); j++)
+            {
+                sprintf(&hex[strlen(hex)], " %02x", data[j]);
+                chr[j - line] = ((data[j] >= 0x20) && (data[j] <= 0x7E)) ? (char)data[j] : '.';
+            }
+            text_prefix_add(NRF_LOG_SEVERITY_WARNING, m_now);
+            text_add("%-24s|%-8s\r\n", hex, chr);
+        }
+    }
+
+    log_process();
+    capture_check(tx_cnt);
+}
+
+
+/* Logs that do not fit in the full buffer are counted and reported with the next entry. */
+static void test_dropped(void)
+{
+    uint32_t const sev_mid = NRF_LOG_SEVERITY_INFO | (DICT_ID << NRF_LOG_MODULE_ID_POS);
+    uint32_t       frame_len;
+    uint32_t       accepted;
+
+    log_init();
+    capture_clear();
+
+    m_now = 42;
+    for (uint32_t i = 0; i < DROP_LOG_CNT; i++)
+    {
+        nrf_log_frontend_std_0(sev_mid, m_fmt_drop);
+    }
+    log_process();
+
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 42, 0, m_fmt_drop, 0);
+    frame_len = frame_end();
+    TEST_ASSERT_EQUAL(0, m_tx.len % frame_len);
+    accepted = m_tx.len / frame_len;
+    TEST_ASSERT((accepted > 0) && (accepted < DROP_LOG_CNT));
+    printf("  %u of %u logs dropped\n", DROP_LOG_CNT - accepted, DROP_LOG_CNT);
+
+    for (uint32_t i = 1; i < accepted; i++)
+    {
+        frame_std_begin(NRF_LOG_SEVERITY_INFO, 42, 0, m_fmt_drop, 0);
+        (void)frame_end();
+    }
+    for (uint32_t i = 0; i < accepted; i++)
+    {
+        text_prefix_add(NRF_LOG_SEVERITY_INFO, 42);
+        text_add("fill\r\n");
+    }
+
+    /* The dropped counter is sent once, with the next entry. */
+    m_now = 43;
+    nrf_log_frontend_std_0(sev_mid, m_fmt_drop);
+    nrf_log_frontend_std_0(sev_mid, m_fmt_drop);
+    log_process();
+
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 43, DROP_LOG_CNT - accepted, m_fmt_drop, 0);
+    TEST_ASSERT_EQUAL(frame_len + 2, frame_end());
+    frame_std_begin(NRF_LOG_SEVERITY_INFO, 43, 0, m_fmt_drop, 0);
+    (void)frame_end();
+    text_add("Logs dropped (%u)\r\n", DROP_LOG_CNT - accepted);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        text_prefix_add(NRF_LOG_SEVERITY_INFO, 43);
+        text_add("fill\r\n");
+    }
+
+    capture_check((accepted + 1) * chunk_cnt(frame_len) + chunk_cnt(frame_len + 2));
+}
+
+
+static void file_write(char const * p_name, void const * p_data, size_t len)
+{
+    FILE * p_file = fopen(p_name, "wb");
+
+    TEST_ASSERT(p_file != NULL);
+    TEST_ASSERT_EQUAL(len, fwrite(p_data, 1, len, p_file));
+    TEST_ASSERT_EQUAL(0, fclose(p_file));
+}
+
+
+int main(void)
+{
+    printf("test_log_dict\n");
+
+    TEST_RUN(test_std);
+    TEST_RUN(test_hexdump);
+    TEST_RUN(test_dropped);
+
+    file_write("test_log_dict.bin", m_stream.data, m_stream.len);
+    file_write("test_log_dict.txt", m_text, m_text_len);
+
+    return 0;
+}
@@ -0,0 +1,372 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Per-module rate limiting and sampling in the nrf_log frontend.
+ *
+ * Three modules log through the frontend into a backend that counts the entries it receives for
+ * each module and keeps the summary lines of suppressed logs. The timestamp is a millisecond counter
+ * set by the test. The checks cover the burst cap and the refill of the token bucket, 1-in-N
+ * sampling, the summary of suppressed logs with and without a timestamp function, and the
+ * parameter checks. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "nrf_log.h"
+#include "nrf_log_ctrl.h"
+#include "nrf_log_internal.h"
+#include "nrf_log_backend_interface.h"
+
+#define TIMESTAMP_FREQ  1000
+#define MODULE_CNT_MAX  8
+
+NRF_LOG_INTERNAL_ITEM_REGISTER(flood, "flood", 0, 0, NRF_LOG_SEVERITY_DEBUG, NRF_LOG_SEVERITY_DEBUG);
+NRF_LOG_INTERNAL_ITEM_REGISTER(noisy, "noisy", 0, 0, NRF_LOG_SEVERITY_DEBUG, NRF_LOG_SEVERITY_DEBUG);
+NRF_LOG_INTERNAL_ITEM_REGISTER(quiet, "quiet", 0, 0, NRF_LOG_SEVERITY_DEBUG, NRF_LOG_SEVERITY_DEBUG);
+
+#define FLOOD_ID NRF_LOG_MODULE_ID_GET_CONST(&NRF_LOG_ITEM_DATA_CONST(flood))
+#define NOISY_ID NRF_LOG_MODULE_ID_GET_CONST(&NRF_LOG_ITEM_DATA_CONST(noisy))
+#define QUIET_ID NRF_LOG_MODULE_ID_GET_CONST(&NRF_LOG_ITEM_DATA_CONST(quiet))
+
+static struct
+{
+    uint32_t std_cnt[MODULE_CNT_MAX];
+    uint32_t hexdump_cnt[MODULE_CNT_MAX];
+    uint32_t last_arg[MODULE_CNT_MAX];
+    uint32_t summary_cnt;
+    char     summary[NRF_LOG_STR_PUSH_BUFFER_SIZE];
+} m_out;
+
+static uint32_t m_now;
+
+
+static uint32_t timestamp_get(void)
+{
+    return m_now;
+}
+
+
+/* Summary lines come from the logger module itself, with the pushed module list as argument. */
+static void backend_put(nrf_log_backend_t const * p_backend, nrf_log_entry_t * p_msg)
+{
+    nrf_log_header_t header;
+    uint32_t         arg = 0;
+
+    nrf_memobj_get(p_msg);
+    nrf_memobj_read(p_msg, &header, HEADER_SIZE * sizeof(uint32_t), 0);
+    TEST_ASSERT(header.module_id < MODULE_CNT_MAX);
+
+    if (header.base.generic.type == HEADER_TYPE_HEXDUMP)
+    {
+        m_out.hexdump_cnt[header.module_id]++;
+    }
+    else
+    {
+        if (header.base.std.nargs > 0)
+        {
+            nrf_memobj_read(p_msg, &arg, sizeof(arg), HEADER_SIZE * sizeof(uint32_t));
+        }
+
+        if (strcmp(nrf_log_module_name_get(header.module_id, false), "app") == 0)
+        {
+            TEST_ASSERT_EQUAL(NRF_LOG_SEVERITY_WARNING, header.base.std.severity);
+            TEST_ASSERT_EQUAL(1, header.base.std.nargs);
+            strncpy(m_out.summary, (char const *)(uintptr_t)arg, sizeof(m_out.summary) - 1);
+            m_out.summary_cnt++;
+        }
+        else
+        {
+            m_out.std_cnt[header.module_id]++;
+            m_out.last_arg[header.module_id] = arg;
+        }
+    }
+    nrf_memobj_put(p_msg);
+}
+
+
+static void backend_panic_set(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static void backend_flush(nrf_log_backend_t const * p_backend)
+{
+}
+
+
+static const nrf_log_backend_api_t m_backend_api =
+{
+    .put       = backend_put,
+    .panic_set = backend_panic_set,
+    .flush     = backend_flush,
+};
+
+NRF_LOG_BACKEND_DEF(m_backend, m_backend_api, NULL);
+
+
+/* Initializes the logger, which also clears the filters and the limits of all modules. */
+static void log_init(nrf_log_timestamp_func_t timestamp_func)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_init(timestamp_func, TIMESTAMP_FREQ));
+    if (m_backend.p_cb->id != NRF_LOG_BACKEND_INVALID_ID)
+    {
+        nrf_log_backend_remove(&m_backend);
+    }
+    TEST_ASSERT(nrf_log_backend_add(&m_backend, NRF_LOG_SEVERITY_DEBUG) >= 0);
+    nrf_log_backend_enable(&m_backend);
+}
+
+
+static void log_std(uint32_t module_id, uint32_t arg)
+{
+    nrf_log_frontend_std_1(NRF_LOG_SEVERITY_INFO | (module_id << NRF_LOG_MODULE_ID_POS), "%d", arg);
+}
+
+
+/* Logs the given number of entries from the module, then processes the buffer. Returns the
+ * number of entries that reached the backend. */
+static uint32_t log_burst(uint32_t module_id, uint32_t count)
+{
+    uint32_t const before = m_out.std_cnt[module_id];
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        log_std(module_id, i);
+    }
+    while (nrf_log_frontend_dequeue())
+    {
+    }
+    return m_out.std_cnt[module_id] - before;
+}
+
+
+static void log_process(void)
+{
+    while (nrf_log_frontend_dequeue())
+    {
+    }
+}
+
+
+static void test_params(void)
+{
+    uint32_t const module_cnt = nrf_log_module_cnt_get();
+
+    TEST_ASSERT(module_cnt <= MODULE_CNT_MAX);
+    log_init(NULL);
+
+    /* A rate limit needs the timestamp, sampling does not. */
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 5));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 0, 0));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_log_module_rate_limit_set(module_cnt, 0, 0));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_log_module_sampling_set(module_cnt, 2));
+
+    log_init(timestamp_get);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 0));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM,
+                      nrf_log_module_rate_limit_set(FLOOD_ID, TIMESTAMP_FREQ + 1, 5));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, TIMESTAMP_FREQ, 5));
+}
+
+
+static void test_sampling(void)
+{
+    log_init(NULL);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_sampling_set(FLOOD_ID, 4));
+
+    /* Every 4th log is accepted, the other modules are not affected. */
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        log_std(FLOOD_ID, i);
+        if ((i % 10) == 0)
+        {
+            log_std(QUIET_ID, i);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, m_out.summary_cnt);
+
+    uint32_t const flood_cnt = m_out.std_cnt[FLOOD_ID];
+    uint32_t const quiet_cnt = m_out.std_cnt[QUIET_ID];
+
+    log_process();
+    TEST_ASSERT_EQUAL(25, m_out.std_cnt[FLOOD_ID] - flood_cnt);
+    TEST_ASSERT_EQUAL(99, m_out.last_arg[FLOOD_ID]);
+    TEST_ASSERT_EQUAL(10, m_out.std_cnt[QUIET_ID] - quiet_cnt);
+
+    /* Without a timestamp, the summary is logged when the buffer is drained. */
+    TEST_ASSERT_EQUAL(1, m_out.summary_cnt);
+    TEST_ASSERT(strcmp(m_out.summary, "flood=75") == 0);
+    log_process();
+    TEST_ASSERT_EQUAL(1, m_out.summary_cnt);
+
+    /* 0 and 1 disable sampling. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_sampling_set(FLOOD_ID, 1));
+    TEST_ASSERT_EQUAL(10, log_burst(FLOOD_ID, 10));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_sampling_set(FLOOD_ID, 0));
+    TEST_ASSERT_EQUAL(10, log_burst(FLOOD_ID, 10));
+    TEST_ASSERT_EQUAL(1, m_out.summary_cnt);
+}
+
+
+static void test_bucket(void)
+{
+    m_now = 1000;
+    log_init(timestamp_get);
+
+    /* 10 logs per second, 100 ms per token, and bursts of 5. The bucket starts full. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 5));
+    TEST_ASSERT_EQUAL(5, log_burst(FLOOD_ID, 20));
+    TEST_ASSERT_EQUAL(0, log_burst(FLOOD_ID, 20));
+    TEST_ASSERT_EQUAL(20, log_burst(QUIET_ID, 20));
+
+    /* Refill at the configured rate. */
+    m_now += 99;
+    TEST_ASSERT_EQUAL(0, log_burst(FLOOD_ID, 10));
+    m_now += 1;
+    TEST_ASSERT_EQUAL(1, log_burst(FLOOD_ID, 10));
+    m_now += 300;
+    TEST_ASSERT_EQUAL(3, log_burst(FLOOD_ID, 10));
+
+    /* A long pause refills the bucket up to the burst size only. */
+    m_now += 10000;
+    TEST_ASSERT_EQUAL(5, log_burst(FLOOD_ID, 20));
+
+    /* At twice the rate, every second log is accepted. */
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        m_now += 50;
+        log_std(FLOOD_ID, i);
+    }
+    uint32_t const flood_cnt = m_out.std_cnt[FLOOD_ID];
+
+    log_process();
+    TEST_ASSERT_EQUAL(20, m_out.std_cnt[FLOOD_ID] - flood_cnt);
+
+    /* Hexdumps take tokens from the same bucket. */
+    uint8_t const data[16] = {0};
+    uint32_t const sev_mid = NRF_LOG_SEVERITY_INFO | (FLOOD_ID << NRF_LOG_MODULE_ID_POS);
+
+    m_now += 100;
+    nrf_log_frontend_hexdump(sev_mid, data, sizeof(data));
+    nrf_log_frontend_hexdump(sev_mid, data, sizeof(data));
+    log_process();
+    TEST_ASSERT_EQUAL(1, m_out.hexdump_cnt[FLOOD_ID]);
+
+    /* The timestamp wraps around. */
+    m_now = UINT32_MAX - 50;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 1));
+    TEST_ASSERT_EQUAL(1, log_burst(FLOOD_ID, 5));
+    m_now += 150;
+    TEST_ASSERT_EQUAL(1, log_burst(FLOOD_ID, 5));
+    m_now += 99;
+    TEST_ASSERT_EQUAL(0, log_burst(FLOOD_ID, 5));
+    m_now += 1;
+    TEST_ASSERT_EQUAL(1, log_burst(FLOOD_ID, 5));
+
+    /* Sampling is applied first: 10 of 20 logs are sampled and 5 of them pass the limit. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 5));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_sampling_set(FLOOD_ID, 2));
+    TEST_ASSERT_EQUAL(5, log_burst(FLOOD_ID, 20));
+    TEST_ASSERT_EQUAL(0, log_burst(FLOOD_ID, 20));
+
+    /* Rate 0 removes the limit. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 0, 0));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_sampling_set(FLOOD_ID, 0));
+    TEST_ASSERT_EQUAL(20, log_burst(FLOOD_ID, 20));
+}
+
+
+static void test_summary(void)
+{
+    uint32_t const summary_cnt = m_out.summary_cnt;
+
+    m_now = 0;
+    log_init(timestamp_get);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(FLOOD_ID, 10, 5));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_log_module_rate_limit_set(NOISY_ID, 1, 1));
+
+    /* Suppressed logs are counted per module and reported once per interval. */
+    TEST_ASSERT_EQUAL(5, log_burst(FLOOD_ID, 20));
+    TEST_ASSERT_EQUAL(1, log_burst(NOISY_ID, 4));
+    TEST_ASSERT_EQUAL(10, log_burst(QUIET_ID, 10));
+    TEST_ASSERT_EQUAL(summary_cnt, m_out.summary_cnt);
+
+    m_now = NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS - 1;
+    log_process();
+    TEST_ASSERT_EQUAL(summary_cnt, m_out.summary_cnt);
+
+    m_now = NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS;
+    log_process();
+    TEST_ASSERT_EQUAL(summary_cnt + 1, m_out.summary_cnt);
+    TEST_ASSERT(strcmp(m_out.summary, "flood=15 noisy=3") == 0);
+
+    /* The counters start over, and nothing is reported while nothing is suppressed. */
+    m_now += 2 * NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS;
+    log_process();
+    TEST_ASSERT_EQUAL(summary_cnt + 1, m_out.summary_cnt);
+
+    TEST_ASSERT_EQUAL(1, log_burst(NOISY_ID, 3));
+    m_now += NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS;
+    log_process();
+    TEST_ASSERT_EQUAL(summary_cnt + 2, m_out.summary_cnt);
+    TEST_ASSERT(strcmp(m_out.summary, "noisy=2") == 0);
+
+    /* The counters saturate. */
+    for (uint32_t i = 0; i < 70000; i++)
+    {
+        log_std(NOISY_ID, i);
+    }
+    m_now += NRF_LOG_RATE_LIMIT_SUMMARY_INTERVAL_MS;
+    log_process();
+    TEST_ASSERT_EQUAL(summary_cnt + 3, m_out.summary_cnt);
+    TEST_ASSERT(strcmp(m_out.summary, "noisy=65535") == 0);
+}
+
+
+int main(void)
+{
+    printf("test_log_rate_limit\n");
+
+    TEST_RUN(test_params);
+    TEST_RUN(test_sampling);
+    TEST_RUN(test_bucket);
+    TEST_RUN(test_summary);
+
+    return 0;
+}
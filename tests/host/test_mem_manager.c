@@ -0,0 +1,333 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* mem_manager against a reference model.
+ *
+ * The model keeps one free flag per block and returns the lowest free block of the smallest
+ * fitting category that has one. Every reservation of the module under test must return exactly
+ * the block the model picks, and the fragmentation statistics must match the model. The test
+ * reports the time per reserve/free operation. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "mem_manager.h"
+
+#define CAT_COUNT       7
+#define SLOT_COUNT      600
+#define CHECK_OPS       200000
+#define BENCH_OPS       4000000
+
+static uint32_t const m_size[CAT_COUNT] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_XSMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_SMALL_BLOCK_SIZE,
+    MEMORY_MANAGER_MEDIUM_BLOCK_SIZE,
+    MEMORY_MANAGER_LARGE_BLOCK_SIZE,
+    MEMORY_MANAGER_XLARGE_BLOCK_SIZE,
+    MEMORY_MANAGER_XXLARGE_BLOCK_SIZE,
+};
+
+static uint32_t const m_count[CAT_COUNT] =
+{
+    MEMORY_MANAGER_XXSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_XSMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_SMALL_BLOCK_COUNT,
+    MEMORY_MANAGER_MEDIUM_BLOCK_COUNT,
+    MEMORY_MANAGER_LARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XLARGE_BLOCK_COUNT,
+    MEMORY_MANAGER_XXLARGE_BLOCK_COUNT,
+};
+
+#define MAX_BLOCKS_PER_CAT  64
+
+static uint8_t * m_base[CAT_COUNT];                     /* Address of block 0 of each category. */
+static bool      m_used[CAT_COUNT][MAX_BLOCKS_PER_CAT];
+
+static struct
+{
+    uint8_t * p_mem;
+    uint32_t  cat;
+    uint32_t  index;
+} m_slot[SLOT_COUNT];
+
+static nrf_mem_frag_stats_t m_expected;
+
+
+static uint32_t random_size(void)
+{
+    /* Mostly small requests, as in a typical application, with some of every category. */
+    uint32_t const cat = ((uint32_t)rand() % 2) ? ((uint32_t)rand() % 3) : ((uint32_t)rand() % CAT_COUNT);
+    uint32_t const min = (cat == 0) ? 1 : (m_size[cat - 1] + 1);
+
+    return min + ((uint32_t)rand() % (m_size[cat] - min + 1));
+}
+
+
+/* Block the module is expected to return for a request, from the model. */
+static bool model_pick(uint32_t size, uint32_t * p_cat, uint32_t * p_index)
+{
+    for (uint32_t cat = 0; cat < CAT_COUNT; cat++)
+    {
+        if (m_size[cat] < size)
+        {
+            continue;
+        }
+        for (uint32_t index = 0; index < m_count[cat]; index++)
+        {
+            if (!m_used[cat][index])
+            {
+                *p_cat   = cat;
+                *p_index = index;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+static void model_free_stats_update(void)
+{
+    m_expected.free_bytes   = 0;
+    m_expected.largest_free = 0;
+
+    for (uint32_t cat = 0; cat < CAT_COUNT; cat++)
+    {
+        for (uint32_t index = 0; index < m_count[cat]; index++)
+        {
+            if (!m_used[cat][index])
+            {
+                m_expected.free_bytes  += m_size[cat];
+                m_expected.largest_free = m_size[cat];
+            }
+        }
+    }
+}
+
+
+static void stats_check(void)
+{
+    nrf_mem_frag_stats_t stats;
+
+    model_free_stats_update();
+    nrf_mem_frag_stats_get(&stats);
+
+    TEST_ASSERT_EQUAL(m_expected.requested_bytes, stats.requested_bytes);
+    TEST_ASSERT_EQUAL(m_expected.reserved_bytes,  stats.reserved_bytes);
+    TEST_ASSERT_EQUAL(m_expected.spilled,         stats.spilled);
+    TEST_ASSERT_EQUAL(m_expected.failed,          stats.failed);
+    TEST_ASSERT_EQUAL(m_expected.free_bytes,      stats.free_bytes);
+    TEST_ASSERT_EQUAL(m_expected.largest_free,    stats.largest_free);
+}
+
+
+/* Blocks of each category are contiguous and handed out from the lowest address. */
+static void test_layout(void)
+{
+    static uint8_t * p_mem[CAT_COUNT][MAX_BLOCKS_PER_CAT];
+
+    for (uint32_t cat = 0; cat < CAT_COUNT; cat++)
+    {
+        TEST_ASSERT(m_count[cat] <= MAX_BLOCKS_PER_CAT);
+
+        for (uint32_t index = 0; index < m_count[cat]; index++)
+        {
+            uint32_t size = m_size[cat];
+
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_mem_reserve(&p_mem[cat][index], &size));
+            TEST_ASSERT_EQUAL(m_size[cat], size);
+            TEST_ASSERT(p_mem[cat][index] == p_mem[cat][0] + index * m_size[cat]);
+        }
+        m_base[cat] = p_mem[cat][0];
+    }
+
+    /* All blocks are in use. */
+    uint8_t * p_buf;
+    uint32_t  size = 1;
+    TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE, nrf_mem_reserve(&p_buf, &size));
+
+    for (uint32_t cat = 0; cat < CAT_COUNT; cat++)
+    {
+        for (uint32_t index = 0; index < m_count[cat]; index++)
+        {
+            nrf_free(p_mem[cat][index]);
+        }
+    }
+
+    /* Requests larger than the largest block are rejected. */
+    size = m_size[CAT_COUNT - 1] + 1;
+    TEST_ASSERT(nrf_mem_reserve(&p_buf, &size) != NRF_SUCCESS);
+}
+
+
+/* Random reservations and frees, each checked against the model. */
+static void test_model(void)
+{
+    nrf_mem_diagnose_reset();
+    memset(&m_expected, 0, sizeof(m_expected));
+
+    for (uint32_t op = 0; op < CHECK_OPS; op++)
+    {
+        uint32_t const i = (uint32_t)rand() % SLOT_COUNT;
+
+        if (m_slot[i].p_mem != NULL)
+        {
+            nrf_free(m_slot[i].p_mem);
+            m_used[m_slot[i].cat][m_slot[i].index] = false;
+            m_slot[i].p_mem = NULL;
+        }
+        else
+        {
+            uint32_t const requested = random_size();
+            uint32_t       size      = requested;
+            uint8_t      * p_mem;
+            uint32_t       cat;
+            uint32_t       index;
+            ret_code_t     ret = nrf_mem_reserve(&p_mem, &size);
+
+            if (model_pick(requested, &cat, &index))
+            {
+                TEST_ASSERT_EQUAL(NRF_SUCCESS, ret);
+                TEST_ASSERT(p_mem == m_base[cat] + index * m_size[cat]);
+                TEST_ASSERT_EQUAL(m_size[cat], size);
+
+                m_used[cat][index] = true;
+                m_slot[i].p_mem    = p_mem;
+                m_slot[i].cat      = cat;
+                m_slot[i].index    = index;
+
+                m_expected.requested_bytes += requested;
+                m_expected.reserved_bytes  += m_size[cat];
+                if ((cat > 0) && (requested <= m_size[cat - 1]))
+                {
+                    m_expected.spilled++;
+                }
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM | NRF_ERROR_MEMORY_MANAGER_ERR_BASE, ret);
+                m_expected.failed++;
+            }
+        }
+
+        if ((op % 1000) == 0)
+        {
+            stats_check();
+        }
+    }
+
+    stats_check();
+
+    for (uint32_t i = 0; i < SLOT_COUNT; i++)
+    {
+        if (m_slot[i].p_mem != NULL)
+        {
+            nrf_free(m_slot[i].p_mem);
+            m_used[m_slot[i].cat][m_slot[i].index] = false;
+            m_slot[i].p_mem = NULL;
+        }
+    }
+
+    stats_check();
+}
+
+
+/* Same operation mix as test_model, without the model. */
+static void bench(void)
+{
+    uint32_t sizes[1024];
+    uint32_t fails = 0;
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        sizes[i] = random_size();
+    }
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t op = 0; op < BENCH_OPS; op++)
+    {
+        uint32_t const i = (uint32_t)rand() % SLOT_COUNT;
+
+        if (m_slot[i].p_mem != NULL)
+        {
+            nrf_free(m_slot[i].p_mem);
+            m_slot[i].p_mem = NULL;
+        }
+        else
+        {
+            uint32_t size = sizes[op % ARRAY_SIZE(sizes)];
+
+            if (nrf_mem_reserve(&m_slot[i].p_mem, &size) != NRF_SUCCESS)
+            {
+                m_slot[i].p_mem = NULL;
+                fails++;
+            }
+        }
+    }
+
+    uint64_t const elapsed = test_time_ns() - start;
+
+    printf("    %u blocks, %u operations (%u failed): %.1f ns per operation\n",
+           MEMORY_MANAGER_XXSMALL_BLOCK_COUNT + MEMORY_MANAGER_XSMALL_BLOCK_COUNT +
+           MEMORY_MANAGER_SMALL_BLOCK_COUNT   + MEMORY_MANAGER_MEDIUM_BLOCK_COUNT +
+           MEMORY_MANAGER_LARGE_BLOCK_COUNT   + MEMORY_MANAGER_XLARGE_BLOCK_COUNT +
+           MEMORY_MANAGER_XXLARGE_BLOCK_COUNT,
+           BENCH_OPS, fails, (double)elapsed / BENCH_OPS);
+}
+
+
+int main(void)
+{
+    printf("test_mem_manager\n");
+
+    srand(1);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_mem_init());
+
+    TEST_RUN(test_layout);
+    TEST_RUN(test_model);
+
+    bench();
+
+    return 0;
+}
@@ -0,0 +1,713 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* Peer Data Storage RAM cache of record locations (PM_RAM_CACHE_ENABLED), on an FDS model.
+ *
+ * The FDS model keeps records in a RAM table, applies queued operations only when
+ * fds_test_process() runs, the way FDS does from its flash callback, and counts the flash
+ * searches. Garbage collection moves every record and increments the run count, so cached
+ * descriptors go stale exactly as they do on a device. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_common.h"
+#include "fds.h"
+#include "peer_manager_types.h"
+#include "peer_manager_internal.h"
+#include "peer_data_storage.h"
+#include "peer_id.h"
+
+#define FLASH_RECORDS   64
+#define RECORD_WORDS    4
+#define OP_QUEUE_SIZE   16
+
+typedef struct
+{
+    fds_header_t hdr;
+    uint32_t     data[RECORD_WORDS];
+    bool         valid;
+} flash_record_t;
+
+typedef enum
+{
+    OP_WRITE,
+    OP_UPDATE,
+    OP_DEL_RECORD,
+    OP_DEL_FILE,
+} op_type_t;
+
+typedef struct
+{
+    op_type_t type;
+    uint32_t  record_id;     // Record written, or record deleted.
+    uint32_t  old_record_id; // Record replaced by an update.
+    uint16_t  file_id;
+    uint16_t  record_key;
+    uint16_t  length_words;
+    uint32_t  data[RECORD_WORDS];
+} op_t;
+
+static flash_record_t     m_flash[2][FLASH_RECORDS]; // GC moves the records to the other half.
+static uint32_t           m_flash_half;
+static uint16_t           m_gc_run_count;
+static uint32_t           m_record_id;
+static fds_cb_t           m_fds_cb;
+static op_t               m_ops[OP_QUEUE_SIZE];
+static uint32_t           m_op_count;
+
+static uint32_t           m_find_count;      // Flash searches by file ID and record key.
+static uint32_t           m_id_lookup_count; // Searches by record ID for stale descriptors.
+
+static pm_evt_id_t        m_last_evt_id;
+
+
+static flash_record_t * record_by_id(uint32_t record_id)
+{
+    for (uint32_t i = 0; i < FLASH_RECORDS; i++)
+    {
+        flash_record_t * p_rec = &m_flash[m_flash_half][i];
+
+        if (p_rec->valid && (p_rec->hdr.record_id == record_id))
+        {
+            return p_rec;
+        }
+    }
+    return NULL;
+}
+
+
+// Resolves a descriptor the way FDS does: the cached address is trusted as long as garbage
+// collection has not run since, otherwise the record is looked up by its ID.
+static flash_record_t * record_by_desc(fds_record_desc_t * p_desc)
+{
+    flash_record_t * p_rec = (flash_record_t *)p_desc->p_record;
+
+    if ((p_rec != NULL) && (p_desc->gc_run_count == m_gc_run_count))
+    {
+        return (p_rec->valid && (p_rec->hdr.record_id == p_desc->record_id)) ? p_rec : NULL;
+    }
+
+    m_id_lookup_count++;
+    p_rec = record_by_id(p_desc->record_id);
+    if (p_rec != NULL)
+    {
+        p_desc->p_record     = (uint32_t const *)p_rec;
+        p_desc->gc_run_count = m_gc_run_count;
+    }
+    return p_rec;
+}
+
+
+static ret_code_t record_find(uint16_t            const * p_file_id,
+                              uint16_t            const * p_key,
+                              fds_record_desc_t         * p_desc,
+                              fds_find_token_t          * p_token)
+{
+    flash_record_t * p_start = (flash_record_t *)p_token->p_addr;
+    uint32_t         i       = (p_start == NULL) ? 0 : (uint32_t)(p_start - m_flash[m_flash_half]) + 1;
+
+    for (; i < FLASH_RECORDS; i++)
+    {
+        flash_record_t * p_rec = &m_flash[m_flash_half][i];
+
+        if (   p_rec->valid
+            && ((p_file_id == NULL) || (p_rec->hdr.file_id    == *p_file_id))
+            && ((p_key     == NULL) || (p_rec->hdr.record_key == *p_key)))
+        {
+            p_token->p_addr      = (uint32_t const *)p_rec;
+            p_desc->record_id    = p_rec->hdr.record_id;
+            p_desc->p_record     = (uint32_t const *)p_rec;
+            p_desc->gc_run_count = m_gc_run_count;
+            return NRF_SUCCESS;
+        }
+    }
+    return FDS_ERR_NOT_FOUND;
+}
+
+
+static ret_code_t op_push(op_t const * p_op)
+{
+    if (m_op_count == OP_QUEUE_SIZE)
+    {
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+    m_ops[m_op_count++] = *p_op;
+    return NRF_SUCCESS;
+}
+
+
+static void record_add(op_t const * p_op)
+{
+    for (uint32_t i = 0; i < FLASH_RECORDS; i++)
+    {
+        flash_record_t * p_rec = &m_flash[m_flash_half][i];
+
+        if (!p_rec->valid && (p_rec->hdr.record_id == 0))
+        {
+            p_rec->hdr.record_id    = p_op->record_id;
+            p_rec->hdr.file_id      = p_op->file_id;
+            p_rec->hdr.record_key   = p_op->record_key;
+            p_rec->hdr.length_words = p_op->length_words;
+            memcpy(p_rec->data, p_op->data, sizeof(p_rec->data));
+            p_rec->valid            = true;
+            return;
+        }
+    }
+    TEST_ASSERT(false);
+}
+
+
+ret_code_t fds_register(fds_cb_t cb)
+{
+    m_fds_cb = cb;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t fds_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t fds_record_find(uint16_t             file_id,
+                           uint16_t             record_key,
+                           fds_record_desc_t  * p_desc,
+                           fds_find_token_t   * p_token)
+{
+    m_find_count++;
+    return record_find(&file_id, &record_key, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_find_by_key(uint16_t            record_key,
+                                  fds_record_desc_t * p_desc,
+                                  fds_find_token_t  * p_token)
+{
+    return record_find(NULL, &record_key, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_find_in_file(uint16_t            file_id,
+                                   fds_record_desc_t * p_desc,
+                                   fds_find_token_t  * p_token)
+{
+    return record_find(&file_id, NULL, p_desc, p_token);
+}
+
+
+ret_code_t fds_record_open(fds_record_desc_t * p_desc, fds_flash_record_t * p_flash_record)
+{
+    flash_record_t * p_rec = record_by_desc(p_desc);
+
+    if (p_rec == NULL)
+    {
+        return FDS_ERR_NOT_FOUND;
+    }
+    p_desc->record_is_open     = true;
+    p_flash_record->p_header   = &p_rec->hdr;
+    p_flash_record->p_data     = p_rec->data;
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t fds_record_close(fds_record_desc_t * p_desc)
+{
+    p_desc->record_is_open = false;
+    return NRF_SUCCESS;
+}
+
+
+static ret_code_t record_queue(op_type_t           type,
+                               fds_record_desc_t * p_desc,
+                               fds_record_t const * p_record)
+{
+    op_t op =
+    {
+        .type          = type,
+        .record_id     = ++m_record_id,
+        .old_record_id = (p_desc != NULL) ? p_desc->record_id : 0,
+        .file_id       = p_record->file_id,
+        .record_key    = p_record->key,
+        .length_words  = (uint16_t)p_record->data.length_words,
+    };
+
+    TEST_ASSERT(p_record->data.length_words <= RECORD_WORDS);
+    memcpy(op.data, p_record->data.p_data, p_record->data.length_words * sizeof(uint32_t));
+
+    ret_code_t ret = op_push(&op);
+    if ((ret == NRF_SUCCESS) && (p_desc != NULL))
+    {
+        p_desc->record_id    = op.record_id;
+        p_desc->p_record     = NULL;
+        p_desc->gc_run_count = m_gc_run_count;
+    }
+    return ret;
+}
+
+
+ret_code_t fds_record_write(fds_record_desc_t * p_desc, fds_record_t const * p_record)
+{
+    return record_queue(OP_WRITE, p_desc, p_record);
+}
+
+
+ret_code_t fds_record_update(fds_record_desc_t * p_desc, fds_record_t const * p_record)
+{
+    return record_queue(OP_UPDATE, p_desc, p_record);
+}
+
+
+ret_code_t fds_record_delete(fds_record_desc_t * p_desc)
+{
+    flash_record_t * p_rec = record_by_desc(p_desc);
+    op_t             op    =
+    {
+        .type       = OP_DEL_RECORD,
+        .record_id  = p_desc->record_id,
+        .file_id    = (p_rec != NULL) ? p_rec->hdr.file_id    : 0,
+        .record_key = (p_rec != NULL) ? p_rec->hdr.record_key : 0,
+    };
+    return op_push(&op);
+}
+
+
+ret_code_t fds_file_delete(uint16_t file_id)
+{
+    op_t op =
+    {
+        .type    = OP_DEL_FILE,
+        .file_id = file_id,
+    };
+    return op_push(&op);
+}
+
+
+ret_code_t fds_record_id_from_desc(fds_record_desc_t const * p_desc, uint32_t * p_record_id)
+{
+    *p_record_id = p_desc->record_id;
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Applies the queued operations to the flash model and sends their events. */
+static void fds_test_process(void)
+{
+    for (uint32_t i = 0; i < m_op_count; i++)
+    {
+        op_t const * p_op = &m_ops[i];
+        fds_evt_t    evt  = {.result = NRF_SUCCESS};
+
+        switch (p_op->type)
+        {
+            case OP_WRITE:
+            case OP_UPDATE:
+            {
+                flash_record_t * p_old = record_by_id(p_op->old_record_id);
+
+                record_add(p_op);
+                if ((p_op->type == OP_UPDATE) && (p_old != NULL))
+                {
+                    p_old->valid = false;
+                }
+                evt.id                      = (p_op->type == OP_WRITE) ? FDS_EVT_WRITE
+                                                                       : FDS_EVT_UPDATE;
+                evt.write.record_id         = p_op->record_id;
+                evt.write.file_id           = p_op->file_id;
+                evt.write.record_key        = p_op->record_key;
+                evt.write.is_record_updated = (p_op->type == OP_UPDATE);
+            } break;
+
+            case OP_DEL_RECORD:
+            {
+                flash_record_t * p_rec = record_by_id(p_op->record_id);
+
+                if (p_rec != NULL)
+                {
+                    p_rec->valid = false;
+                }
+                evt.id             = FDS_EVT_DEL_RECORD;
+                evt.del.record_id  = p_op->record_id;
+                evt.del.file_id    = p_op->file_id;
+                evt.del.record_key = p_op->record_key;
+            } break;
+
+            case OP_DEL_FILE:
+                for (uint32_t j = 0; j < FLASH_RECORDS; j++)
+                {
+                    if (m_flash[m_flash_half][j].hdr.file_id == p_op->file_id)
+                    {
+                        m_flash[m_flash_half][j].valid = false;
+                    }
+                }
+                evt.id             = FDS_EVT_DEL_FILE;
+                evt.del.file_id    = p_op->file_id;
+                evt.del.record_key = FDS_RECORD_KEY_DIRTY;
+                break;
+        }
+
+        m_fds_cb(&evt);
+    }
+    m_op_count = 0;
+}
+
+
+/**@brief Moves the valid records to the other flash half, in reverse order, as garbage
+ *        collection does when it copies them to the swap page. */
+static void fds_test_gc(void)
+{
+    uint32_t const from = m_flash_half;
+    uint32_t       n    = 0;
+
+    memset(m_flash[!from], 0, sizeof(m_flash[0]));
+    for (int32_t i = FLASH_RECORDS - 1; i >= 0; i--)
+    {
+        if (m_flash[from][i].valid)
+        {
+            m_flash[!from][n++] = m_flash[from][i];
+        }
+    }
+    memset(m_flash[from], 0xFF, sizeof(m_flash[0]));
+    m_flash_half = !from;
+    m_gc_run_count++;
+
+    fds_evt_t evt = {.id = FDS_EVT_GC, .result = NRF_SUCCESS};
+    m_fds_cb(&evt);
+}
+
+
+void pdb_pds_evt_handler(pm_evt_t * p_event)
+{
+    m_last_evt_id = p_event->evt_id;
+}
+
+
+static uint32_t value_make(pm_peer_id_t peer_id, pm_peer_data_id_t data_id, uint32_t version)
+{
+    return ((uint32_t)peer_id << 16) | ((uint32_t)data_id << 8) | version;
+}
+
+
+static void store(pm_peer_id_t peer_id, pm_peer_data_id_t data_id, uint32_t version)
+{
+    static uint32_t      buf[RECORD_WORDS];
+    pm_peer_data_const_t data =
+    {
+        .data_id      = data_id,
+        .length_words = RECORD_WORDS,
+        .p_all_data   = buf,
+    };
+
+    for (uint32_t i = 0; i < RECORD_WORDS; i++)
+    {
+        buf[i] = value_make(peer_id, data_id, version) + (i << 24);
+    }
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, pds_peer_data_store(peer_id, &data, NULL));
+}
+
+
+/**@brief Reads a record and returns its version, or UINT32_MAX if it is not found. */
+static uint32_t read(pm_peer_id_t peer_id, pm_peer_data_id_t data_id)
+{
+    uint32_t       buf[RECORD_WORDS];
+    uint32_t const len  = sizeof(buf);
+    pm_peer_data_t data = {.p_all_data = buf};
+
+    ret_code_t ret = pds_peer_data_read(peer_id, data_id, &data, &len);
+    if (ret == NRF_ERROR_NOT_FOUND)
+    {
+        return UINT32_MAX;
+    }
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, ret);
+    TEST_ASSERT_EQUAL(RECORD_WORDS, data.length_words);
+    for (uint32_t i = 0; i < RECORD_WORDS; i++)
+    {
+        TEST_ASSERT_EQUAL(value_make(peer_id, data_id, buf[0] & 0xFF) + (i << 24), buf[i]);
+    }
+    TEST_ASSERT_EQUAL(value_make(peer_id, data_id, 0), buf[0] & 0xFFFF00);
+    return buf[0] & 0xFF;
+}
+
+
+static pm_ram_cache_stats_t stats_get(void)
+{
+    pm_ram_cache_stats_t stats;
+    pds_ram_cache_stats_get(&stats);
+    return stats;
+}
+
+
+/**@brief Stores one record per (peer, data ID) and lets them reach flash. */
+static pm_peer_id_t peer_add(void)
+{
+    pm_peer_id_t peer_id = pds_peer_id_allocate();
+
+    TEST_ASSERT(peer_id != PM_PEER_ID_INVALID);
+    store(peer_id, PM_PEER_DATA_ID_BONDING, 1);
+    store(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, 1);
+    store(peer_id, PM_PEER_DATA_ID_PEER_RANK, 1);
+    fds_test_process();
+    return peer_id;
+}
+
+
+static void test_hit(void)
+{
+    pm_peer_id_t         peer_id = peer_add();
+    pm_ram_cache_stats_t before  = stats_get();
+    uint32_t             finds   = m_find_count;
+
+    // The first read searches flash, the following ones use the cached location.
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(finds + 1, m_find_count);
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    }
+    TEST_ASSERT_EQUAL(finds + 1, m_find_count);
+
+    pm_ram_cache_stats_t after = stats_get();
+    TEST_ASSERT_EQUAL(before.misses + 1, after.misses);
+    TEST_ASSERT_EQUAL(before.hits + 10, after.hits);
+}
+
+
+static void test_negative(void)
+{
+    pm_peer_id_t peer_id = peer_add();
+    uint32_t     finds   = m_find_count;
+
+    // Data that was never stored is searched for once.
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING));
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING));
+    TEST_ASSERT_EQUAL(finds + 1, m_find_count);
+
+    // A read while the write is still queued caches "not found" again; the write event must
+    // clear it, or the record would stay invisible.
+    store(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING, 1);
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING));
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING));
+
+    fds_test_process();
+    TEST_ASSERT_EQUAL(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, m_last_evt_id);
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_SERVICE_CHANGED_PENDING));
+}
+
+
+static void test_update(void)
+{
+    pm_peer_id_t peer_id = peer_add();
+
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+
+    // The old record stays readable until the update has been written.
+    store(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, 2);
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+
+    uint32_t finds = m_find_count;
+    fds_test_process();
+    TEST_ASSERT_EQUAL(2, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+    TEST_ASSERT_EQUAL(finds + 1, m_find_count);
+
+    // An update of an update goes through the refreshed entry.
+    store(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, 3);
+    fds_test_process();
+    TEST_ASSERT_EQUAL(3, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+    TEST_ASSERT_EQUAL(3, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+}
+
+
+static void test_delete(void)
+{
+    pm_peer_id_t peer_id = peer_add();
+
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_PEER_RANK));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, pds_peer_data_delete(peer_id, PM_PEER_DATA_ID_PEER_RANK));
+
+    // A read before the delete is done refreshes the entry, the delete event clears it.
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_PEER_RANK));
+    fds_test_process();
+    TEST_ASSERT_EQUAL(PM_EVT_PEER_DATA_UPDATE_SUCCEEDED, m_last_evt_id);
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_PEER_RANK));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NOT_FOUND,
+                      pds_peer_data_delete(peer_id, PM_PEER_DATA_ID_PEER_RANK));
+
+    // The other data of the peer is untouched.
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+}
+
+
+static void test_peer_delete(void)
+{
+    pm_peer_id_t peer_id = peer_add();
+
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, pds_peer_id_free(peer_id));
+    TEST_ASSERT(pds_peer_id_is_deleted(peer_id));
+
+    fds_test_process();
+    TEST_ASSERT_EQUAL(PM_EVT_PEER_DELETE_SUCCEEDED, m_last_evt_id);
+    TEST_ASSERT(!pds_peer_id_is_allocated(peer_id));
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+
+    // A new peer that gets the same ID does not see the data of the old one.
+    TEST_ASSERT_EQUAL(peer_id, pds_peer_id_allocate());
+    TEST_ASSERT_EQUAL(UINT32_MAX, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    store(peer_id, PM_PEER_DATA_ID_BONDING, 5);
+    fds_test_process();
+    TEST_ASSERT_EQUAL(5, read(peer_id, PM_PEER_DATA_ID_BONDING));
+}
+
+
+static void test_gc(void)
+{
+    pm_peer_id_t peer_id = peer_add();
+
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+
+    fds_test_gc();
+
+    // The cached locations are stale; opening the record finds it by ID, without a search, and
+    // the refreshed location is cached.
+    uint32_t finds   = m_find_count;
+    uint32_t lookups = m_id_lookup_count;
+
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(lookups + 1, m_id_lookup_count);
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(lookups + 1, m_id_lookup_count);
+    TEST_ASSERT_EQUAL(finds, m_find_count);
+
+    // An update through a stale location replaces the right record.
+    store(peer_id, PM_PEER_DATA_ID_GATT_LOCAL, 2);
+    fds_test_process();
+    TEST_ASSERT_EQUAL(2, read(peer_id, PM_PEER_DATA_ID_GATT_LOCAL));
+    TEST_ASSERT_EQUAL(1, read(peer_id, PM_PEER_DATA_ID_BONDING));
+
+    // Only one GATT_LOCAL record is left in flash.
+    fds_find_token_t  ftok  = {0};
+    fds_record_desc_t desc;
+    uint32_t          count = 0;
+    while (fds_record_find(peer_id + PEER_ID_TO_FILE_ID,
+                           PM_PEER_DATA_ID_GATT_LOCAL + DATA_ID_TO_RECORD_KEY,
+                           &desc,
+                           &ftok) == NRF_SUCCESS)
+    {
+        count++;
+    }
+    TEST_ASSERT_EQUAL(1, count);
+}
+
+
+static void test_eviction(void)
+{
+    pm_peer_id_t peers[PM_RAM_CACHE_SIZE + 1];
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(peers); i++)
+    {
+        peers[i] = peer_add();
+    }
+
+    // Fill the cache, then use the oldest entry so that the second oldest is evicted instead.
+    for (uint32_t i = 0; i < PM_RAM_CACHE_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL(1, read(peers[i], PM_PEER_DATA_ID_BONDING));
+    }
+    TEST_ASSERT_EQUAL(1, read(peers[0], PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(1, read(peers[PM_RAM_CACHE_SIZE], PM_PEER_DATA_ID_BONDING));
+
+    uint32_t finds = m_find_count;
+    TEST_ASSERT_EQUAL(1, read(peers[0], PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(1, read(peers[PM_RAM_CACHE_SIZE], PM_PEER_DATA_ID_BONDING));
+    for (uint32_t i = 2; i < PM_RAM_CACHE_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL(1, read(peers[i], PM_PEER_DATA_ID_BONDING));
+    }
+    TEST_ASSERT_EQUAL(finds, m_find_count);
+
+    TEST_ASSERT_EQUAL(1, read(peers[1], PM_PEER_DATA_ID_BONDING));
+    TEST_ASSERT_EQUAL(finds + 1, m_find_count);
+
+    // Reconnecting to peers in turn, more than fit in the cache, costs one search per
+    // reconnection once the cache has settled.
+    pm_ram_cache_stats_t before = {0};
+    for (uint32_t round = 0; round < 3; round++)
+    {
+        if (round == 1)
+        {
+            before = stats_get();
+        }
+        for (uint32_t i = 0; i < ARRAY_SIZE(peers); i++)
+        {
+            for (uint32_t j = 0; j < 4; j++)
+            {
+                TEST_ASSERT_EQUAL(1, read(peers[i], PM_PEER_DATA_ID_BONDING));
+            }
+        }
+    }
+    pm_ram_cache_stats_t after = stats_get();
+    printf("  %u peers, cache size %u: %u hits, %u misses\n",
+           (unsigned)ARRAY_SIZE(peers), PM_RAM_CACHE_SIZE,
+           (unsigned)(after.hits - before.hits), (unsigned)(after.misses - before.misses));
+    TEST_ASSERT_EQUAL(before.misses + 2 * ARRAY_SIZE(peers), after.misses);
+    TEST_ASSERT_EQUAL(before.hits + 6 * ARRAY_SIZE(peers), after.hits);
+}
+
+
+int main(void)
+{
+    printf("test_pds_cache\n");
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, pds_init());
+
+    TEST_RUN(test_hit);
+    TEST_RUN(test_negative);
+    TEST_RUN(test_update);
+    TEST_RUN(test_delete);
+    TEST_RUN(test_peer_delete);
+    TEST_RUN(test_gc);
+    TEST_RUN(test_eviction);
+
+    return 0;
+}
@@ -0,0 +1,379 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_queue span access, against a reference model of the queue contents.
+ *
+ * Random sequences of in/out, reserve/commit and peek/consume operations are run in both queue
+ * modes. After each operation the queue must hold the same elements, in the same order, as the
+ * model. The benchmark compares span access with copying through a local buffer. */
+
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_queue.h"
+
+#define QUEUE_SIZE      7
+#define OP_MAX_COUNT    9
+#define MODEL_OPS       200000
+
+#define BENCH_ELEMENTS  2000000
+#define BENCH_BATCH     8
+#define BENCH_SIZE      128
+
+NRF_QUEUE_DEF(uint32_t, m_queue_no_overflow, QUEUE_SIZE, NRF_QUEUE_MODE_NO_OVERFLOW);
+NRF_QUEUE_DEF(uint32_t, m_queue_overflow,    QUEUE_SIZE, NRF_QUEUE_MODE_OVERFLOW);
+
+typedef struct
+{
+    uint8_t data[BENCH_SIZE];
+} bench_elem_t;
+
+NRF_QUEUE_DEF(bench_elem_t, m_queue_copy,  64, NRF_QUEUE_MODE_NO_OVERFLOW);
+NRF_QUEUE_DEF(bench_elem_t, m_queue_spans, 64, NRF_QUEUE_MODE_NO_OVERFLOW);
+
+/* Expected contents of the queue, oldest element first. */
+static uint32_t m_model[QUEUE_SIZE];
+static size_t   m_model_cnt;
+static uint32_t m_seq;
+
+
+static void model_push(uint32_t value)
+{
+    if (m_model_cnt == QUEUE_SIZE)
+    {
+        memmove(m_model, m_model + 1, (QUEUE_SIZE - 1) * sizeof(uint32_t));
+        m_model_cnt--;
+    }
+    m_model[m_model_cnt++] = value;
+}
+
+
+static void model_drop(size_t count)
+{
+    memmove(m_model, m_model + count, (m_model_cnt - count) * sizeof(uint32_t));
+    m_model_cnt -= count;
+}
+
+
+static uint32_t span_elem_get(nrf_queue_span_t const * p_spans, size_t idx)
+{
+    if (idx < p_spans[0].count)
+    {
+        return ((uint32_t *)p_spans[0].p_data)[idx];
+    }
+    return ((uint32_t *)p_spans[1].p_data)[idx - p_spans[0].count];
+}
+
+
+static void span_elem_set(nrf_queue_span_t const * p_spans, size_t idx, uint32_t value)
+{
+    if (idx < p_spans[0].count)
+    {
+        ((uint32_t *)p_spans[0].p_data)[idx] = value;
+    }
+    else
+    {
+        ((uint32_t *)p_spans[1].p_data)[idx - p_spans[0].count] = value;
+    }
+}
+
+
+static void op_in(nrf_queue_t const * p_queue, size_t count)
+{
+    uint32_t data[OP_MAX_COUNT];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        data[i] = m_seq + i;
+    }
+
+    size_t const written = nrf_queue_in(p_queue, data, count);
+    for (size_t i = 0; i < written; i++)
+    {
+        model_push(data[i]);
+    }
+    m_seq += written;
+}
+
+
+static void op_out(nrf_queue_t const * p_queue, size_t count)
+{
+    uint32_t data[OP_MAX_COUNT];
+
+    size_t const read = nrf_queue_out(p_queue, data, count);
+    TEST_ASSERT_EQUAL(MIN(count, m_model_cnt), read);
+    for (size_t i = 0; i < read; i++)
+    {
+        TEST_ASSERT_EQUAL(m_model[i], data[i]);
+    }
+    model_drop(read);
+}
+
+
+static void op_reserve(nrf_queue_t const * p_queue, size_t count, bool overflow)
+{
+    nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+    uint32_t         value = 0;
+
+    size_t const reserved = nrf_queue_spans_reserve(p_queue, count, spans);
+    TEST_ASSERT_EQUAL(reserved, spans[0].count + spans[1].count);
+    for (size_t i = 0; i < reserved; i++)
+    {
+        span_elem_set(spans, i, m_seq + i);
+    }
+
+    /* In overflow mode, the oldest elements are dropped when space is reserved. */
+    size_t const available = QUEUE_SIZE - m_model_cnt;
+    if (overflow && (reserved > available))
+    {
+        model_drop(reserved - available);
+    }
+
+    /* Nothing else is written while the reservation is open. */
+    if (reserved > 0)
+    {
+        TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM, nrf_queue_push(p_queue, &value));
+    }
+
+    size_t const committed = (reserved > 0) ? ((size_t)rand() % (reserved + 1)) : 0;
+    nrf_queue_spans_commit(p_queue, committed);
+    for (size_t i = 0; i < committed; i++)
+    {
+        model_push(m_seq + i);
+    }
+    m_seq += reserved;
+}
+
+
+static void op_peek(nrf_queue_t const * p_queue, size_t count, bool overflow)
+{
+    nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+
+    size_t const peeked = nrf_queue_spans_peek(p_queue, count, spans);
+    TEST_ASSERT_EQUAL(MIN(count, m_model_cnt), peeked);
+    TEST_ASSERT_EQUAL(peeked, spans[0].count + spans[1].count);
+    for (size_t i = 0; i < peeked; i++)
+    {
+        TEST_ASSERT_EQUAL(m_model[i], span_elem_get(spans, i));
+    }
+
+    /* Peeked elements are not overwritten in overflow mode. */
+    if (overflow && (peeked > 0))
+    {
+        uint32_t const   value    = m_seq++;
+        ret_code_t const err_code = nrf_queue_push(p_queue, &value);
+
+        if (m_model_cnt == QUEUE_SIZE)
+        {
+            TEST_ASSERT_EQUAL(NRF_ERROR_NO_MEM, err_code);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, err_code);
+            model_push(value);
+        }
+    }
+
+    size_t const consumed = (peeked > 0) ? ((size_t)rand() % (peeked + 1)) : 0;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_spans_consume(p_queue, consumed));
+    model_drop(consumed);
+}
+
+
+static void model_run(nrf_queue_t const * p_queue, bool overflow)
+{
+    nrf_queue_reset(p_queue);
+    m_model_cnt = 0;
+    m_seq       = 0;
+    srand(overflow ? 2 : 1);
+
+    for (uint32_t op = 0; op < MODEL_OPS; op++)
+    {
+        size_t const count = 1 + ((size_t)rand() % OP_MAX_COUNT);
+
+        switch (rand() % 4)
+        {
+            case 0:
+                op_in(p_queue, count);
+                break;
+
+            case 1:
+                op_out(p_queue, count);
+                break;
+
+            case 2:
+                op_reserve(p_queue, count, overflow);
+                break;
+
+            default:
+                op_peek(p_queue, count, overflow);
+                break;
+        }
+
+        TEST_ASSERT_EQUAL(m_model_cnt, nrf_queue_utilization_get(p_queue));
+    }
+}
+
+
+static void test_model_no_overflow(void)
+{
+    model_run(&m_queue_no_overflow, false);
+}
+
+
+static void test_model_overflow(void)
+{
+    model_run(&m_queue_overflow, true);
+}
+
+
+/* Consuming fails if the peeked elements were taken by another read operation. */
+static void test_peek_invalidated(void)
+{
+    nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+    uint32_t         data[3] = {1, 2, 3};
+    uint32_t         value;
+
+    nrf_queue_reset(&m_queue_no_overflow);
+    TEST_ASSERT_EQUAL(3, nrf_queue_in(&m_queue_no_overflow, data, 3));
+
+    /* Elements popped after the peek. */
+    TEST_ASSERT_EQUAL(2, nrf_queue_spans_peek(&m_queue_no_overflow, 2, spans));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_pop(&m_queue_no_overflow, &value));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, nrf_queue_spans_consume(&m_queue_no_overflow, 2));
+    TEST_ASSERT_EQUAL(2, nrf_queue_utilization_get(&m_queue_no_overflow));
+
+    /* More elements than peeked. */
+    TEST_ASSERT_EQUAL(1, nrf_queue_spans_peek(&m_queue_no_overflow, 1, spans));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_PARAM, nrf_queue_spans_consume(&m_queue_no_overflow, 2));
+
+    /* Queue reset after the peek. */
+    TEST_ASSERT(nrf_queue_element_peek(&m_queue_no_overflow) != NULL);
+    nrf_queue_reset(&m_queue_no_overflow);
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, nrf_queue_spans_consume(&m_queue_no_overflow, 1));
+
+    /* A fresh peek is valid again. */
+    TEST_ASSERT_EQUAL(2, nrf_queue_in(&m_queue_no_overflow, data, 2));
+    TEST_ASSERT_EQUAL(2, nrf_queue_spans_peek(&m_queue_no_overflow, 2, spans));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_spans_consume(&m_queue_no_overflow, 2));
+    TEST_ASSERT(nrf_queue_is_empty(&m_queue_no_overflow));
+}
+
+
+static void test_bench(void)
+{
+    volatile uint32_t sink = 0;
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t batch = 0; batch < BENCH_ELEMENTS / BENCH_BATCH; batch++)
+    {
+        bench_elem_t data[BENCH_BATCH];
+        uint32_t     sum = 0;
+
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            memset(data[i].data, (int)(batch + i), BENCH_SIZE);
+        }
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_write(&m_queue_copy, data, BENCH_BATCH));
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_read(&m_queue_copy, data, BENCH_BATCH));
+        for (uint32_t i = 0; i < BENCH_BATCH; i++)
+        {
+            for (uint32_t j = 0; j < BENCH_SIZE; j++)
+            {
+                sum += data[i].data[j];
+            }
+        }
+        sink += sum;
+    }
+
+    uint64_t const copy_end = test_time_ns();
+
+    for (uint32_t batch = 0; batch < BENCH_ELEMENTS / BENCH_BATCH; batch++)
+    {
+        nrf_queue_span_t spans[NRF_QUEUE_SPANS_MAX];
+        uint32_t         idx = 0;
+        uint32_t         sum = 0;
+
+        TEST_ASSERT_EQUAL(BENCH_BATCH, nrf_queue_spans_reserve(&m_queue_spans, BENCH_BATCH, spans));
+        for (uint32_t s = 0; s < NRF_QUEUE_SPANS_MAX; s++)
+        {
+            for (size_t i = 0; i < spans[s].count; i++)
+            {
+                memset(((bench_elem_t *)spans[s].p_data)[i].data, (int)(batch + idx++), BENCH_SIZE);
+            }
+        }
+        nrf_queue_spans_commit(&m_queue_spans, BENCH_BATCH);
+
+        TEST_ASSERT_EQUAL(BENCH_BATCH, nrf_queue_spans_peek(&m_queue_spans, BENCH_BATCH, spans));
+        for (uint32_t s = 0; s < NRF_QUEUE_SPANS_MAX; s++)
+        {
+            for (size_t i = 0; i < spans[s].count; i++)
+            {
+                for (uint32_t j = 0; j < BENCH_SIZE; j++)
+                {
+                    sum += ((bench_elem_t *)spans[s].p_data)[i].data[j];
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_queue_spans_consume(&m_queue_spans, BENCH_BATCH));
+        sink += sum;
+    }
+
+    uint64_t const spans_end = test_time_ns();
+
+    printf("    %u-byte elements in batches of %u: write/read %.1f ns, spans %.1f ns per element\n",
+           BENCH_SIZE, BENCH_BATCH,
+           (double)(copy_end - start) / BENCH_ELEMENTS,
+           (double)(spans_end - copy_end) / BENCH_ELEMENTS);
+}
+
+
+int main(void)
+{
+    printf("test_queue\n");
+
+    TEST_RUN(test_model_no_overflow);
+    TEST_RUN(test_model_overflow);
+    TEST_RUN(test_peek_invalidated);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_ringbuf multi-producer mode.
+ *
+ * The stress test runs producer threads against one consumer. Each producer writes
+ * sequence-numbered records and yields between allocating and committing some of them, so that
+ * commits complete out of order. The consumer checks that every producer's records arrive
+ * complete, without gaps and in order. The benchmark compares uncontended put and get with the
+ * single-producer functions. */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_ringbuf.h"
+
+#define PRODUCERS       4
+#define RECORDS         250000
+#define BENCH_OPS       2000000
+
+NRF_RINGBUF_MP_DEF(m_ringbuf_16,   16);
+NRF_RINGBUF_MP_DEF(m_ringbuf_64,   64);
+NRF_RINGBUF_MP_DEF(m_ringbuf_1024, 1024);
+
+NRF_RINGBUF_DEF(m_ringbuf_bench_sp,    1024);
+NRF_RINGBUF_MP_DEF(m_ringbuf_bench_mp, 1024);
+
+typedef struct
+{
+    uint32_t producer;
+    uint32_t seq;
+} record_t;
+
+typedef struct
+{
+    nrf_ringbuf_t const * p_ringbuf;
+    uint32_t              producer;
+} producer_arg_t;
+
+
+static void * producer_thread(void * p_arg)
+{
+    producer_arg_t const * p_producer = p_arg;
+
+    for (uint32_t seq = 0; seq < RECORDS; )
+    {
+        record_t const record = {p_producer->producer, seq};
+        uint8_t      * p_data;
+        size_t         length = sizeof(record);
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_mp_alloc(p_producer->p_ringbuf, &p_data, &length));
+        if (length == 0)
+        {
+            (void) sched_yield();
+            continue;
+        }
+
+        /* Records never straddle the end of the buffer, whose size is a multiple of theirs. */
+        TEST_ASSERT_EQUAL(sizeof(record), length);
+        memcpy(p_data, &record, sizeof(record));
+
+        /* Widen the window in which other producers commit first. */
+        if ((seq & 7) == 0)
+        {
+            (void) sched_yield();
+        }
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_mp_put(p_producer->p_ringbuf, p_data, length));
+        seq++;
+    }
+
+    return NULL;
+}
+
+
+static void stress_run(nrf_ringbuf_t const * p_ringbuf, size_t size)
+{
+    pthread_t      thread[PRODUCERS];
+    producer_arg_t arg[PRODUCERS];
+    uint32_t       next_seq[PRODUCERS] = {0};
+    uint64_t       received            = 0;
+
+    nrf_ringbuf_init(p_ringbuf);
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+        arg[i] = (producer_arg_t){p_ringbuf, i};
+        TEST_ASSERT(pthread_create(&thread[i], NULL, producer_thread, &arg[i]) == 0);
+    }
+
+    while (received < (uint64_t)PRODUCERS * RECORDS)
+    {
+        uint8_t * p_data;
+        size_t    length = 256;
+
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_get(p_ringbuf, &p_data, &length, true));
+        if (length == 0)
+        {
+            (void) sched_yield();
+            continue;
+        }
+
+        /* Only whole, committed records are published. */
+        TEST_ASSERT_EQUAL(0, length % sizeof(record_t));
+        for (size_t offset = 0; offset < length; offset += sizeof(record_t))
+        {
+            record_t record;
+
+            memcpy(&record, p_data + offset, sizeof(record));
+            TEST_ASSERT(record.producer < PRODUCERS);
+            TEST_ASSERT_EQUAL(next_seq[record.producer], record.seq);
+            next_seq[record.producer]++;
+            received++;
+        }
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_free(p_ringbuf, length));
+    }
+
+    uint64_t const elapsed = test_time_ns() - start;
+
+    for (uint32_t i = 0; i < PRODUCERS; i++)
+    {
+        TEST_ASSERT(pthread_join(thread[i], NULL) == 0);
+    }
+
+    printf("    %4u-byte buffer: %u producers, %.2f M records/s\n",
+           (unsigned)size, PRODUCERS, (double)received * 1000.0 / elapsed);
+}
+
+
+static void test_stress(void)
+{
+    stress_run(&m_ringbuf_16,   16);
+    stress_run(&m_ringbuf_64,   64);
+    stress_run(&m_ringbuf_1024, 1024);
+}
+
+
+static void test_bench(void)
+{
+    uint8_t   data[8] = {0};
+    uint8_t * p_data;
+    size_t    length;
+
+    nrf_ringbuf_init(&m_ringbuf_bench_sp);
+    nrf_ringbuf_init(&m_ringbuf_bench_mp);
+
+    uint64_t const start = test_time_ns();
+
+    for (uint32_t i = 0; i < BENCH_OPS; i++)
+    {
+        length = sizeof(data);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_cpy_put(&m_ringbuf_bench_sp, data, &length));
+        length = 64;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_get(&m_ringbuf_bench_sp, &p_data, &length, true));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_free(&m_ringbuf_bench_sp, length));
+    }
+
+    uint64_t const sp_end = test_time_ns();
+
+    for (uint32_t i = 0; i < BENCH_OPS; i++)
+    {
+        length = sizeof(data);
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_mp_cpy_put(&m_ringbuf_bench_mp, data, &length));
+        length = 64;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_get(&m_ringbuf_bench_mp, &p_data, &length, true));
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_ringbuf_free(&m_ringbuf_bench_mp, length));
+    }
+
+    uint64_t const mp_end = test_time_ns();
+
+    printf("    8-byte put and get: single-producer %.1f ns, multi-producer %.1f ns\n",
+           (double)(sp_end - start) / BENCH_OPS, (double)(mp_end - sp_end) / BENCH_OPS);
+}
+
+
+int main(void)
+{
+    printf("test_ringbuf\n");
+
+    TEST_RUN(test_stress);
+    TEST_RUN(test_bench);
+
+    return 0;
+}
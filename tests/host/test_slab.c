@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2021, Nordic Semiconductor ASA
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+/* nrf_slab size classes, statistics and lock-free free lists.
+ *
+ * The stress test runs allocating threads against one instance. Each thread fills its elements
+ * with its own pattern and checks it before freeing, so an element handed out twice is detected.
+ * Afterwards every block must be allocatable again. */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "sdk_config.h"
+#include "nrf_slab.h"
+
+#define STRESS_THREADS  4
+#define STRESS_OPS      1000000
+
+NRF_BALLOC_DEF(m_pool_16, 16, 8);
+NRF_BALLOC_DEF(m_pool_32, 32, 8);
+NRF_BALLOC_DEF(m_pool_64, 64, 4);
+NRF_SLAB_DEF(m_slab, &m_pool_16, &m_pool_32, &m_pool_64);
+
+#define SLAB_BLOCKS     (8 + 8 + 4)
+
+NRF_BALLOC_DEF(m_pool_12, 12, 8);
+NRF_SLAB_DEF(m_slab_bad, &m_pool_12);
+
+
+static uint32_t slab_drain(size_t size, void ** pp_element, uint32_t max)
+{
+    uint32_t count = 0;
+
+    while ((count < max) && ((pp_element[count] = nrf_slab_alloc(&m_slab, size)) != NULL))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+
+static void slab_release(void ** pp_element, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        nrf_slab_free(&m_slab, pp_element[i]);
+    }
+}
+
+
+static void test_init(void)
+{
+    /* Element sizes must be powers of two. */
+    TEST_ASSERT(nrf_slab_init(&m_slab_bad) != NRF_SUCCESS);
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_slab_init(&m_slab));
+}
+
+
+/* Requests spill to larger classes when their class is exhausted. */
+static void test_spill(void)
+{
+    void                 * p_element[SLAB_BLOCKS + 1];
+    nrf_slab_class_stats_t stats;
+
+    uint32_t const count = slab_drain(10, p_element, ARRAY_SIZE(p_element));
+    TEST_ASSERT_EQUAL(SLAB_BLOCKS, count);
+    TEST_ASSERT_EQUAL(16, nrf_slab_element_size_get(&m_slab, p_element[0]));
+    TEST_ASSERT_EQUAL(64, nrf_slab_element_size_get(&m_slab, p_element[count - 1]));
+
+    /* Larger than the largest class. */
+    TEST_ASSERT(nrf_slab_alloc(&m_slab, 65) == NULL);
+
+    slab_release(p_element, count);
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, nrf_slab_class_stats_get(&m_slab, 2, &stats, true));
+    TEST_ASSERT_EQUAL(64, stats.element_size);
+    TEST_ASSERT_EQUAL(4,  stats.pool_size);
+    TEST_ASSERT_EQUAL(0,  stats.in_use);
+    TEST_ASSERT_EQUAL(4,  stats.max_in_use);
+    TEST_ASSERT(nrf_slab_class_stats_get(&m_slab, 3, &stats, false) != NRF_SUCCESS);
+
+    /* Freed elements are reused from the free lists. */
+    TEST_ASSERT_EQUAL(4, slab_drain(33, p_element, ARRAY_SIZE(p_element)));
+    slab_release(p_element, 4);
+}
+
+
+static void * stress_thread(void * p_arg)
+{
+    uint8_t const id   = (uint8_t)(uintptr_t)p_arg;
+    unsigned      seed = id;
+
+    for (uint32_t op = 0; op < STRESS_OPS; op++)
+    {
+        size_t const    size = 1 + ((size_t)rand_r(&seed) % 64);
+        uint8_t * const p    = nrf_slab_alloc(&m_slab, size);
+
+        if (p == NULL)
+        {
+            continue;
+        }
+
+        memset(p, id, size);
+        for (size_t i = 0; i < size; i++)
+        {
+            TEST_ASSERT_EQUAL(id, p[i]);
+        }
+        nrf_slab_free(&m_slab, p);
+    }
+
+    return NULL;
+}
+
+
+static void test_stress(void)
+{
+    pthread_t thread[STRESS_THREADS];
+    void    * p_element[SLAB_BLOCKS + 1];
+
+    uint64_t const start = test_time_ns();
+
+    for (uintptr_t i = 0; i < STRESS_THREADS; i++)
+    {
+        TEST_ASSERT(pthread_create(&thread[i], NULL, stress_thread, (void *)(i + 1)) == 0);
+    }
+    for (uint32_t i = 0; i < STRESS_THREADS; i++)
+    {
+        TEST_ASSERT(pthread_join(thread[i], NULL) == 0);
+    }
+
+    uint64_t const elapsed = test_time_ns() - start;
+
+    /* No element was lost. */
+    uint32_t const count = slab_drain(1, p_element, ARRAY_SIZE(p_element));
+    TEST_ASSERT_EQUAL(SLAB_BLOCKS, count);
+    slab_release(p_element, count);
+
+    printf("    %u threads, %u alloc/free pairs each: %.1f ns per pair\n",
+           STRESS_THREADS, STRESS_OPS, (double)elapsed / STRESS_OPS);
+}
+
+
+/* Heap functions served from the built-in instance. */
+static void test_malloc(void)
+{
+    uint8_t * p = nrf_slab_calloc(4, 8);
+
+    TEST_ASSERT(p != NULL);
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        TEST_ASSERT_EQUAL(0, p[i]);
+        p[i] = (uint8_t)i;
+    }
+
+    /* Growing keeps the contents, shrinking keeps the element. */
+    uint8_t * p_grown = nrf_slab_realloc(p, 100);
+    TEST_ASSERT(p_grown != NULL);
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        TEST_ASSERT_EQUAL(i, p_grown[i]);
+    }
+    TEST_ASSERT(nrf_slab_realloc(p_grown, 10) == p_grown);
+
+    /* The total size of calloc must not overflow. */
+    TEST_ASSERT(nrf_slab_calloc(SIZE_MAX / 2, 4) == NULL);
+    TEST_ASSERT(nrf_slab_calloc(SIZE_MAX, SIZE_MAX) == NULL);
+
+    TEST_ASSERT(nrf_slab_malloc(257) == NULL);
+    TEST_ASSERT(nrf_slab_realloc(p_grown, 0) == NULL);
+    nrf_slab_malloc_free(NULL);
+}
+
+
+int main(void)
+{
+    printf("test_slab\n");
+
+    TEST_RUN(test_init);
+    TEST_RUN(test_spill);
+    TEST_RUN(test_stress);
+    TEST_RUN(test_malloc);
+
+    return 0;
+}